@@ -7,6 +7,7 @@
 #include <vapor/OptionParser.h>
 #include <vapor/CFuncs.h>
 #include <vapor/VDCNetCDF.h>
+#include <vapor/VDCCopyPipeline.h>
 #include <vapor/DCCF.h>
 #include <vapor/FileUtils.h>
 #include <vapor/SetHDF5PluginPath.h>
@@ -17,6 +18,7 @@ using namespace VAPoR;
 struct opt_t {
     int                     nthreads;
     int                     numts;
+    int                     inflight;
     std::vector<string>     vars;
     std::vector<string>     xvars;
     OptionParser::Boolean_T help;
@@ -26,6 +28,10 @@ OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                           "Specify number of execution threads "
                                           "0 => use number of cores"},
                                          {"numts", 1, "-1", "Number of timesteps to be included in the VDC. Default (-1) includes all timesteps."},
+                                         {"inflight", 1, "0",
+                                          "Maximum number of time steps held in memory when "
+                                          "reading time steps while earlier ones are compressed "
+                                          "and written. 0 => copy one time step at a time"},
                                          {"vars", 1, "",
                                           "Colon delimited list of variable names "
                                           "to be copied to the VDC"},
@@ -36,8 +42,9 @@ OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                          {NULL}};
 
 OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)}, {"numts", Wasp::CvtToInt, &opt.numts, sizeof(opt.numts)},
-                                        {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},          {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},
-                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},         {NULL}};
+                                        {"inflight", Wasp::CvtToInt, &opt.inflight, sizeof(opt.inflight)}, {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},
+                                        {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},       {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
 
 string ProgName;
 
@@ -222,6 +229,29 @@ vector<string> remove_vector(vector<string> v1, vector<string> v2)
     return (newvec);
 }
 
+// Copy coordinate variables, then data variables, reading time steps
+// while earlier ones are compressed and written
+//
+int CopyPipelined(DCCF &dccf, VDCNetCDF &vdc, const vector<string> &coordvars, const vector<string> &datavars)
+{
+    VDCCopyPipeline pipeline(dccf, vdc, opt.inflight);
+    pipeline.SetProgressCallback([](const string &varname, size_t ts) {
+        if (ts == 0) cout << "Copying variable " << varname << endl;
+        cout << "  Time step " << ts << endl;
+    });
+
+    int estatus = 0;
+    if (pipeline.Copy(coordvars, opt.numts, true) < 0) {
+        estatus = 1;
+    } else if (pipeline.Copy(datavars, opt.numts, false) < 0) {
+        estatus = 1;
+    }
+
+    pipeline.PrintStats(cout);
+
+    return (estatus);
+}
+
 int main(int argc, char **argv)
 {
     VAPoR::SetHDF5PluginPath();
@@ -274,13 +304,18 @@ int main(int argc, char **argv)
     // be both data and coordinate). If a coord variable is also
     // a data variable, skip it and handle below
     //
-    vector<string> varnames = dccf.GetCoordVarNames();
-    vector<string> dvarnames = dccf.GetDataVarNames();
-    for (int i = 0; i < varnames.size(); i++) {
-        // Skip coordinate varibles that are also data variables
-        //
-        if (find(dvarnames.begin(), dvarnames.end(), varnames[i]) != dvarnames.end()) continue;
+    vector<string> varnames = remove_vector(dccf.GetCoordVarNames(), dccf.GetDataVarNames());
+    vector<string> dvarnames;
+    if (opt.vars.size()) {
+        dvarnames = opt.vars;
+    } else {
+        dvarnames = dccf.GetDataVarNames();
+    }
+    dvarnames = remove_vector(dvarnames, opt.xvars);
+
+    if (opt.inflight > 0) return (CopyPipelined(dccf, vdc, varnames, dvarnames));
 
+    for (int i = 0; i < varnames.size(); i++) {
         int nts = dccf.GetNumTimeSteps(varnames[i]);
         nts = opt.numts != -1 && nts > opt.numts ? opt.numts : nts;
         VAssert(nts >= 0);
@@ -297,13 +332,7 @@ int main(int argc, char **argv)
         }
     }
 
-    if (opt.vars.size()) {
-        varnames = opt.vars;
-    } else {
-        varnames = dccf.GetDataVarNames();
-    }
-
-    varnames = remove_vector(varnames, opt.xvars);
+    varnames = dvarnames;
 
     // Now copy data variables
     //
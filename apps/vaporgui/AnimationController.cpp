@@ -164,6 +164,22 @@ void AnimationController::playNextFrame()
 
     setCurrentTimestep(currentFrame);
 
+    // Start reading the next few frames in the background while this
+    // one is being rendered
+    //
+    vector<size_t> prefetch;
+    int            frame = currentFrame;
+    for (int i = 0; i < _prefetchFrames; i++) {
+        frame += (int)(_direction * frameStepSize);
+        if (frame < startFrame || frame > endFrame) {
+            if (!loop) break;
+            frame = frame < startFrame ? endFrame : startFrame;
+        }
+        if (frame == currentFrame) break;
+        prefetch.push_back(frame);
+    }
+    _controlExec->PrefetchTimesteps(prefetch);
+
     // playNextFrame() is called via a timer and bypasses main event
     // loop. So we need to call updateTab ourselves
     //
@@ -18,6 +18,10 @@ class AnimationController : public QObject {
     int                 _direction;
     bool                _animationOn = false;
 
+    // Number of frames ahead of the current frame to prefetch while playing
+    //
+    static const int _prefetchFrames = 2;
+
 public:
     AnimationController(VAPoR::ControlExec *ce);
     void Update();
@@ -7,6 +7,7 @@
 #include <vapor/OptionParser.h>
 #include <vapor/CFuncs.h>
 #include <vapor/VDCNetCDF.h>
+#include <vapor/VDCCopyPipeline.h>
 #include <vapor/DCWRF.h>
 #include <vapor/FileUtils.h>
 #include <vapor/SetHDF5PluginPath.h>
@@ -17,6 +18,7 @@ using namespace VAPoR;
 struct opt_t {
     int                     nthreads;
     int                     numts;
+    int                     inflight;
     std::vector<string>     vars;
     std::vector<string>     xvars;
     OptionParser::Boolean_T help;
@@ -26,6 +28,10 @@ OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                           "Specify number of execution threads "
                                           "0 => use number of cores"},
                                          {"numts", 1, "-1", "Number of timesteps to be included in the VDC. Default (-1) includes all timesteps."},
+                                         {"inflight", 1, "0",
+                                          "Maximum number of time steps held in memory when "
+                                          "reading time steps while earlier ones are compressed "
+                                          "and written. 0 => copy one time step at a time"},
                                          {"vars", 1, "",
                                           "Colon delimited list of variable names "
                                           "to be copied to the VDC"},
@@ -36,8 +42,9 @@ OptionParser::OptDescRec_T set_opts[] = {{"nthreads", 1, "0",
                                          {NULL}};
 
 OptionParser::Option_T get_options[] = {{"nthreads", Wasp::CvtToInt, &opt.nthreads, sizeof(opt.nthreads)}, {"numts", Wasp::CvtToInt, &opt.numts, sizeof(opt.numts)},
-                                        {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},          {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},
-                                        {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},         {NULL}};
+                                        {"inflight", Wasp::CvtToInt, &opt.inflight, sizeof(opt.inflight)}, {"vars", Wasp::CvtToStrVec, &opt.vars, sizeof(opt.vars)},
+                                        {"xvars", Wasp::CvtToStrVec, &opt.xvars, sizeof(opt.xvars)},       {"help", Wasp::CvtToBoolean, &opt.help, sizeof(opt.help)},
+                                        {NULL}};
 
 // Return a new vector containing elements of v1 with any elements from
 // v2 removed
@@ -53,6 +60,29 @@ vector<string> remove_vector(vector<string> v1, vector<string> v2)
 
 string ProgName;
 
+// Copy coordinate variables, then data variables, reading time steps
+// while earlier ones are compressed and written
+//
+int CopyPipelined(DCWRF &dcwrf, VDCNetCDF &vdc, const vector<string> &coordvars, const vector<string> &datavars)
+{
+    VDCCopyPipeline pipeline(dcwrf, vdc, opt.inflight);
+    pipeline.SetProgressCallback([](const string &varname, size_t ts) {
+        if (ts == 0) cout << "Copying variable " << varname << endl;
+        cout << "  Time step " << ts << endl;
+    });
+
+    int estatus = 0;
+    if (pipeline.Copy(coordvars, opt.numts, true) < 0) {
+        estatus = 1;
+    } else if (pipeline.Copy(datavars, opt.numts, false) < 0) {
+        estatus = 1;
+    }
+
+    pipeline.PrintStats(cout);
+
+    return (estatus);
+}
+
 int main(int argc, char **argv)
 {
     VAPoR::SetHDF5PluginPath();
@@ -99,6 +129,16 @@ int main(int argc, char **argv)
     if (rc < 0) { return (1); }
 
     vector<string> varnames = dcwrf.GetCoordVarNames();
+    vector<string> dvarnames;
+    if (opt.vars.size()) {
+        dvarnames = opt.vars;
+    } else {
+        dvarnames = dcwrf.GetDataVarNames();
+    }
+    dvarnames = remove_vector(dvarnames, opt.xvars);
+
+    if (opt.inflight > 0) return (CopyPipelined(dcwrf, vdc, varnames, dvarnames));
+
     for (int i = 0; i < varnames.size(); i++) {
         int nts = dcwrf.GetNumTimeSteps(varnames[i]);
         nts = opt.numts != -1 && nts > opt.numts ? opt.numts : nts;
@@ -116,13 +156,7 @@ int main(int argc, char **argv)
         }
     }
 
-    if (opt.vars.size()) {
-        varnames = opt.vars;
-    } else {
-        varnames = dcwrf.GetDataVarNames();
-    }
-
-    varnames = remove_vector(varnames, opt.xvars);
+    varnames = dvarnames;
 
     int estatus = 0;
     for (int i = 0; i < varnames.size(); i++) {
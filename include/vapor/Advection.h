@@ -7,6 +7,7 @@
 #define ADVECTION_H
 
 #include "vapor/Particle.h"
+#include "vapor/Stream.h"
 #include "vapor/Field.h"
 #include "vapor/common.h"
 #include <string>
@@ -57,8 +58,8 @@ public:
     void UseSeedParticles(const std::vector<Particle> &seeds);
 
     // Retrieve the resulting particles as "streams."
-    size_t                       GetNumberOfStreams() const;
-    const std::vector<Particle> &GetStreamAt(size_t i) const;
+    size_t        GetNumberOfStreams() const;
+    const Stream &GetStreamAt(size_t i) const;
 
     // Retrieve the maximum number of particles in any stream
     size_t GetMaxNumOfPart() const;
@@ -76,9 +77,9 @@ public:
     auto GetPropertyVarNames() const -> std::vector<std::string>;
 
 private:
-    std::vector<std::vector<Particle>> _streams;
-    std::string                        _valueVarName;
-    std::vector<std::string>           _propertyVarNames;
+    std::vector<Stream>      _streams;
+    std::string              _valueVarName;
+    std::vector<std::string> _propertyVarNames;
 
     const float      _lowerAngle, _upperAngle;          // Thresholds for step size adjustment
     float            _lowerAngleCos, _upperAngleCos;    // Cosine values of the threshold angles
@@ -96,6 +97,13 @@ private:
     int _advectRK4(Field *, const Particle &, double deltaT,      // Input
                    Particle &p1) const;                           // Output
 
+    // Same as above, but advect a cohort of particles, each with its own deltaT.
+    // rvs receives the return value for each particle.
+    void _advectEuler(Field *, const std::vector<Particle> &, const std::vector<double> &deltaTs,    // Input
+                      std::vector<Particle> &p1s, std::vector<int> &rvs) const;                      // Output
+    void _advectRK4(Field *, const std::vector<Particle> &, const std::vector<double> &deltaTs,      // Input
+                    std::vector<Particle> &p1s, std::vector<int> &rvs) const;                        // Output
+
     // Get an adjust factor for deltaT based on how curvy the past two steps are.
     //   A value in range (0.0, 1.0) means shrink deltaT.
     //   A value in range (1.0, inf) means enlarge deltaT.
@@ -109,9 +117,10 @@ private:
     // Print return code if it's non-zero and compiled in debug mode.
     void _printNonZero(int rtn, const char *file, const char *func, int line) const;
 
-    void        _calculateParticleIntegratedValue(Particle &p, const Particle &prev, const Field *scalarField, const bool skipNonZero, const float distScale,
+    // Calculate the integrated value of particle i in stream s from particle i - 1
+    void        _calculateParticleIntegratedValue(Stream &s, size_t i, const Field *scalarField, const bool skipNonZero, const float distScale,
                                                   const std::vector<double> &integrateWithinVolumeMin, const std::vector<double> &integrateWithinVolumeMax) const;
-    static bool _isParticleInsideVolume(const Particle &p, const std::vector<double> &min, const std::vector<double> &max);
+    static bool _isParticleInsideVolume(const glm::vec3 &loc, const std::vector<double> &min, const std::vector<double> &max);
 };
 }; // namespace flow
 
@@ -2,6 +2,8 @@
 
 #include <array>
 #include <iostream>
+#include <list>
+#include <memory>
 #include <vapor/MyBase.h>
 #include <vapor/utils.h>
 #include <vapor/DC.h>
@@ -25,9 +27,18 @@ public:
     std::array<double, 3>      GetBrickOrigin() const;
     std::array<double, 3>      GetBrickSize() const;
 
+    // Read the subregion [min, max] of a variable at a timestep
+    //
+    // Data files are memory mapped and the region is copied straight out of
+    // the mapping, in parallel over Z. The file for the following timestep
+    // is mapped too, and the kernel is asked to read it ahead. Files that
+    // cannot be mapped are read with stdio instead. Data are byte swapped
+    // if DATA_ENDIAN differs from the host's byte order.
+    //
     template<class T> int ReadRegion(std::string varname, size_t ts, const std::vector<size_t> &min, const std::vector<size_t> &max, T region);
 
 private:
+    class MappedFile;
     std::string _currentFilePath;
 
     float                    _time;
@@ -41,10 +52,10 @@ private:
     std::array<double, 3>    _brickOrigin;
     std::array<double, 3>    _brickSize;
     size_t                   _byteOffset;
+    std::string              _dataEndian;
 
     // These values are currently parsed and assigned, but are unimplemented (not used)
     bool                  _divideBrick;
-    std::string           _dataEndian;
     std::string           _centering;
     int                   _dataComponents;
     std::array<size_t, 3> _dataBricklets;
@@ -56,6 +67,7 @@ private:
     std::array<double, 3> _tmpBrickOrigin;
     std::array<double, 3> _tmpBrickSize;
     size_t                _tmpByteOffset;
+    std::string           _tmpDataEndian;
 
     // Note - _tmpGridSize is an array of int type
     //      - _gridSize is of type size_t
@@ -84,6 +96,10 @@ private:
     bool _brickOriginAssigned;
     bool _brickSizeAssigned;
     bool _byteOffsetAssigned;
+    bool _dataEndianAssigned;
+
+    // Memory mapped data files, most recently used first
+    std::list<std::pair<std::string, std::shared_ptr<MappedFile>>> _mappedFiles;
 
     // _dataFileMap allows us to access binary data files with a
     // varname/timestep pair
@@ -101,7 +117,13 @@ private:
 
     void _findTokenValue(std::string &line) const;
 
-    int _sizeOfFormat(DC::XType) const;
+    int  _sizeOfFormat(DC::XType) const;
+    bool _swapBytes() const;
+
+    std::shared_ptr<MappedFile> _mapFile(const std::string &path);
+    void                        _readAhead(const std::string &varname, size_t ts, const std::vector<size_t> &min, const std::vector<size_t> &max);
+    template<class T> int       _readRegionMapped(const MappedFile &file, const std::vector<size_t> &min, const std::vector<size_t> &max, T region) const;
+    template<class T> int       _readRegionStdio(const std::string &dataFile, const std::vector<size_t> &min, const std::vector<size_t> &max, T region) const;
 
     int _invalidVarNameError() const;
     int _invalidFileSizeError(size_t numElements) const;
@@ -121,9 +143,9 @@ private:
     static const std::string ORIGIN_TOKEN;
     static const std::string BRICK_SIZE_TOKEN;
     static const std::string OFFSET_TOKEN;
+    static const std::string ENDIAN_TOKEN;
 
     // These tokens are currently parsed but are not used
-    static const std::string ENDIAN_TOKEN;
     static const std::string CENTERING_TOKEN;
     static const std::string DIVIDE_BRICK_TOKEN;
     static const std::string DATA_BRICKLETS_TOKEN;
@@ -134,12 +156,12 @@ private:
     static const DC::XType             _defaultFormat;
     static const std::string           _defaultVar;
     static const size_t                _defaultByteOffset;
+    static const std::string           _defaultEndian;
     static const std::array<double, 3> _defaultOrigin;
     static const std::array<double, 3> _defaultBrickSize;
     static const std::array<size_t, 3> _defaultGridSize;
 
     // These defaults are currently unimplemented in the BOV reader logic
-    static const std::string           _defaultEndian;
     static const std::string           _defaultCentering;
     static const bool                  _defaultDivBrick;
     static const std::array<size_t, 3> _defaultBricklets;
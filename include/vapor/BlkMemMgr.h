@@ -23,7 +23,7 @@ namespace VAPoR {
 //! can only be freed by calling RequestMemSize() with a zero value
 //! after all instances of this class have been destroyed
 //
-class BlkMemMgr : public Wasp::MyBase {
+class VDF_API BlkMemMgr : public Wasp::MyBase {
 public:
     //! Initialize a memory allocator
     //
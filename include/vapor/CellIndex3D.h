@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vapor/common.h>
+
+namespace VAPoR {
+
+//
+//! \class CellIndex3D
+//! \brief A uniform grid index of the cells of a 3D mesh
+//!
+//! The bounding box of the mesh is divided into a regular lattice of bins,
+//! sized so that each holds a few cells on average. Every cell is listed
+//! in each bin its bounding box overlaps. The cells that may contain a
+//! point are found by computing the bin containing the point, with no
+//! searching.
+//!
+//! The bins are stored as a single array of cell IDs, with an offset into
+//! it for each bin, so looking up a bin doesn't allocate memory and the
+//! cells of a bin are contiguous. The bounding box of each cell is also
+//! stored, so most candidate cells can be rejected without reading their
+//! nodes.
+//!
+//! \sa UnstructuredGrid3D
+//
+class VDF_API CellIndex3D {
+public:
+    //! Build the index
+    //!
+    //! The bounding boxes are computed, and the cells binned, in parallel.
+    //!
+    //! \param[in] ncells Number of cells in the mesh
+    //! \param[in] getBox Returns the bounding box of cell \p cell in
+    //! \p min and \p max. If it returns false the cell is not indexed,
+    //! e.g. because it is degenerate. Must be safe to call concurrently.
+    //! \param[in] cellsPerBin The average number of cells per bin aimed for
+    //
+    CellIndex3D(size_t ncells, const std::function<bool(size_t cell, float min[3], float max[3])> &getBox, float cellsPerBin = 2.0);
+
+    //! Return the cells that may contain a point
+    //!
+    //! \param[in] pt The point
+    //! \param[out] cells Set to the first of the returned cell IDs, which
+    //! remain valid for the lifetime of the index
+    //!
+    //! \retval n The number of cells returned. Zero if \p pt is outside
+    //! the bounding box of the mesh
+    //
+    size_t GetCells(const double pt[3], const uint32_t *&cells) const;
+
+    //! Test whether a point is inside the bounding box of a cell
+    //!
+    //! \retval inside False if \p pt is outside the bounding box of
+    //! \p cell, or \p cell was not indexed
+    //
+    bool InsideBox(size_t cell, const double pt[3]) const
+    {
+        const float *b = &_boxes[cell * 6];
+        return (pt[0] >= b[0] && pt[0] <= b[3] && pt[1] >= b[1] && pt[1] <= b[4] && pt[2] >= b[2] && pt[2] <= b[5]);
+    }
+
+    size_t GetNumCells() const { return (_boxes.size() / 6); }
+
+    //! Return the number of bins along each axis
+    //
+    void GetBinDimensions(size_t dims[3]) const;
+
+private:
+    float                 _min[3];
+    float                 _max[3];
+    size_t                _dims[3];
+    double                _scale[3];      // Bins per unit length
+    std::vector<float>    _boxes;         // min xyz, max xyz of each cell
+    std::vector<size_t>   _binStart;      // Offset of each bin's cells in _binCells
+    std::vector<uint32_t> _binCells;
+
+    bool _binRange(const float min[3], const float max[3], size_t bmin[3], size_t bmax[3]) const;
+};
+};    // namespace VAPoR
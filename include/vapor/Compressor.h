@@ -283,6 +283,17 @@ public:
     //!
     bool &KeepAppOnOff() { return (_keepapp); };
 
+    //! Set or get the full sort attribute
+    //!
+    //! Compress() and Decompose() retain the wavelet coefficients with the
+    //! largest magnitude. By default these are found with a linear time
+    //! selection algorithm. When this attribute is set the coefficients are
+    //! instead found by sorting all of them, which is slower. Both methods
+    //! produce identical results; the attribute exists mainly for
+    //! benchmarking and verification.
+    //!
+    bool &FullSortOnOff() { return (_full_sort_flag); };
+
     //! Set or get the min range clamping attribute
     //!
     //! When set, this attribute will clamp the minimum data value
@@ -353,6 +364,7 @@ private:
     size_t *       _L;    // wavelet coefficient book keeping array
     size_t         _LLen;
     bool           _keepapp;    // if true, approximation coeffs are not used in compression
+    bool           _full_sort_flag;    // if true, sort all coeffs. instead of selecting
     bool           _clamp_min_flag;
     bool           _clamp_max_flag;
     bool           _epsilon_flag;
@@ -28,6 +28,7 @@
 #include <vapor/Texture.h>
 
 #include <glm/glm.hpp>
+#include <memory>
 
 namespace VAPoR {
 
@@ -76,9 +77,18 @@ private:
 
     } _cacheParams;
 
+    // Vertices of each contour level, the sampled slice of 3D variables,
+    // and the range of values in tiles of cells. Kept while only the
+    // contour values change, so that only new levels are extracted
+    //
+    struct ContourCache;
+    std::unique_ptr<ContourCache> _contourCache;
+
     int  _buildCache(bool fast);
     bool _isCacheDirty() const;
+    bool _isGeometryCacheDirty() const;
     void _saveCacheParams();
+    void _extractLevels(const Grid *grid, const Grid *heightGrid, int dims, const vector<double> &levels, float Z0);
 
     void _clearCache() { _cacheParams.varName.clear(); }
 
@@ -204,6 +204,23 @@ public:
     //!
     int Paint(string name, bool force = false);
 
+    //! Prefetch the data needed to render future time steps
+    //!
+    //! For every enabled renderer, in every visualizer, this method
+    //! requests that the variables used by the renderer be read
+    //! asynchronously into the data cache for each of the global time
+    //! steps in \p timesteps, using the renderer's refinement level,
+    //! compression level, and region of interest. Pending prefetch requests
+    //! made by earlier calls are discarded. Intended to be called during
+    //! animation, e.g. to request time steps ts+1..ts+k while time step
+    //! ts is being rendered.
+    //!
+    //! \param[in] timesteps Ordered list of global time steps to prefetch
+    //!
+    //! \sa DataMgr::Prefetch()
+    //
+    void PrefetchTimesteps(const vector<size_t> &timesteps);
+
     //! Activate or Deactivate a renderer
 
     //!
@@ -520,6 +537,31 @@ public:
     //!
     int EnableAnimationCapture(string winName, bool doEnable, string filename = "");
 
+    //! Enable or disable asynchronous image capture
+    //!
+    //! When enabled, images captured by EnableImageCapture() and
+    //! EnableAnimationCapture() are read back from the GPU and encoded in
+    //! the background while subsequent frames are rendered.
+    //! WaitForImageCapture() must be called to ensure the files are
+    //! complete.
+    //!
+    //! \param[in] winName Visualizer name
+    //! \param[in] onOff true to enable asynchronous capture
+    //!
+    //! \sa Visualizer::SetImageCaptureAsync()
+    //
+    int SetImageCaptureAsync(string winName, bool onOff);
+
+    //! Wait for all images captured asynchronously to be written
+    //!
+    //! The OpenGL context for the window \p winName must be active.
+    //!
+    //! \param[in] winName Visualizer name
+    //! \retval status A negative int is returned if any image failed to
+    //! be written
+    //
+    int WaitForImageCapture(string winName);
+
     //! Make string conformant for library
     //!
     //! Many of the methods provided by the API accept string arguments
@@ -182,6 +182,10 @@ public:
     //
     virtual bool InsideGrid(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     //! Returns reference to RegularGrid instance containing X user coordinates
     //!
     //! Returns reference to RegularGrid instance passed to constructor
@@ -263,11 +267,27 @@ private:
 
     bool _insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double lambda[4], double zwgt[2]) const;
 
+    // Same as above, but uses caller provided storage for the cell nodes and the
+    // interpolated Z coordinates of a column. If useHint is true, i, j, and k
+    // on input hold a guess for the cell containing the point.
+    //
+    bool _insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double lambda[4], double zwgt[2], std::vector<DimsType> &nodes, std::vector<double> &zcoords,
+                     bool useHint) const;
+
+    // Find the Z weights of a point known to be inside face (i, j) of the
+    // horizontal grid. Returns false if the point is above or below the grid.
+    //
+    bool _insideColumn(double x, double y, double z, size_t i, size_t j, size_t &k, double zwgt[2], std::vector<double> &zcoords, bool useHint) const;
+
+    // Interpolate the value at a point given the cell and weights found by _insideGrid()
+    //
+    float _interpolateLinear(size_t i, size_t j, size_t k, const double lambda[4], const double zwgt[2]) const;
+
     void _getIndicesHelper(const std::vector<double> &coords, std::vector<size_t> &indices) const;
 
-    bool _insideGridHelperStretched(double z, size_t &k, double zwgt[2]) const;
+    bool _insideGridHelperStretched(double z, size_t &k, double zwgt[2], bool useHint) const;
 
-    bool _insideGridHelperTerrain(double x, double y, double z, const size_t &i, const size_t &j, size_t &k, double zwgt[2]) const;
+    bool _insideGridHelperTerrain(double x, double y, double z, const size_t &i, const size_t &j, size_t &k, double zwgt[2], std::vector<double> &zcoords, bool useHint) const;
 
     std::shared_ptr<QuadTreeRectangleP> _makeQuadTreeRectangle() const;
 };
@@ -1763,6 +1763,33 @@ public:
     //
     virtual bool VariableExists(size_t ts, string varname, int reflevel = 0, int lod = 0) const { return (variableExists(ts, varname, reflevel, lod)); };
 
+    //! Return precomputed per-block value ranges for a variable
+    //!
+    //! Some data collections record the minimum and maximum value of every
+    //! storage block of a variable when it is written. This method returns
+    //! those ranges, which allow the range of a variable, or of a
+    //! block-aligned region of it, to be bounded without reading the
+    //! variable. The ranges bound the variable's values at every
+    //! refinement level and level-of-detail, but are not necessarily tight
+    //! for approximations.
+    //!
+    //! \param[in] ts A valid time step between 0 and GetNumTimesteps()-1
+    //! \param[in] varname A valid data variable name
+    //! \param[out] bdims The number of blocks along each spatial dimension,
+    //! ordered from fastest to slowest varying. Empty if block ranges are
+    //! not available for the variable
+    //! \param[out] ranges A min/max pair for each block, with blocks
+    //! ordered fastest varying dimension first. A pair of NaNs indicates a
+    //! block containing no valid (non-missing) data
+    //!
+    //! \retval status A negative int is returned on failure. Success is
+    //! returned, with empty \p bdims and \p ranges, if block ranges are not
+    //! available
+    //!
+    //! \sa GetDimLensAtLevel()
+    //
+    virtual int GetBlockRanges(size_t ts, string varname, std::vector<size_t> &bdims, std::vector<double> &ranges) { return (getBlockRanges(ts, varname, bdims, ranges)); }
+
     //! Get dimensions of hyperslice read by ReadSlice
     //!
     //! Returns the dimensions of a hyperslice when the variable
@@ -2212,6 +2239,15 @@ protected:
     //
     virtual bool variableExists(size_t ts, string varname, int reflevel = 0, int lod = 0) const = 0;
 
+    //! \copydoc GetBlockRanges()
+    //
+    virtual int getBlockRanges(size_t ts, string varname, std::vector<size_t> &bdims, std::vector<double> &ranges)
+    {
+        bdims.clear();
+        ranges.clear();
+        return (0);
+    }
+
 private:
     virtual bool _getCoordVarDimensions(string varname, bool spatial, vector<DC::Dimension> &dimensions, long ts) const;
 
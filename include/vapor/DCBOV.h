@@ -61,10 +61,10 @@ class BOVCollection;
 //! - BRICK_SIZE   (type: three floating point values,   default: 1., 1., 1.)
 //! - VARIABLE     (type: one alphanumeric string value, default: "brickVar")
 //! - BYTE_OFFSET  (type: one integer value,             default: 0)
+//! - DATA_ENDIAN  (type: string of either LITTLE or BIG, default: LITTLE)
 //!
 //! The following BOV tags are currently unsupported.  They can be included in a BOV header,
 //! but they will be unused.
-//! - DATA_ENDIAN
 //! - CENTERING
 //! - DIVIDE_BRICK
 //! - DATA_BRICKLETS
@@ -1,6 +1,14 @@
 #include <vector>
 #include <iostream>
 #include <list>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
+#include <set>
+#include <tuple>
 #include "vapor/VAssert.h"
 #include <vapor/BlkMemMgr.h>
 #include <vapor/DC.h>
@@ -13,6 +21,7 @@
 #include <vapor/UDUnitsClass.h>
 #include <vapor/GridHelper.h>
 #include <vapor/DerivedVarMgr.h>
+#include <vapor/PyramidCache.h>
 
 #ifndef DataMgvV3_0_h
     #define DataMgvV3_0_h
@@ -139,6 +148,23 @@ public:
     //!
     //! \param[in] files A list of file paths
     //!
+    //! \param[in] options A list of options, passed on to the data
+    //! collection. The DataMgr recognizes the following:
+    //! - \c -pyramid_cache Cache downsampled copies of variables on disk
+    //! (see PyramidCache). Data variables on structured grids that are
+    //! stored at a single resolution gain additional, coarser refinement
+    //! levels. Each level is downsampled from the native resolution data
+    //! until a background thread has built the cached copies of the
+    //! variable, after which it is read from the cache.
+    //! - \c -quadtree_cache Save the quad trees used to locate points in
+    //! curvilinear and unstructured grids on disk, and read them back in
+    //! later sessions instead of rebuilding them (see
+    //! GridHelper::DefaultQuadTreeCacheDir()).
+    //! - \c -netcdf_index Passed on to the netCDF based data collections
+    //! (WRF, CF, MPAS, and particle data), which then keep the metadata of
+    //! their files in an index on disk (see NetCDFMetaIndex::DefaultPath()),
+    //! so that later sessions need not read the header of every file.
+    //!
     //! \retval status A negative int is returned on failure and an error
     //! message will be logged with MyBase::SetErrMsg()
     //!
@@ -410,6 +436,9 @@ public:
     int GetNumTimeSteps() const;
 
     //! \copydoc DC::GetNumRefLevels()
+    //!
+    //! If the \c -pyramid_cache option was passed to Initialize() the
+    //! count includes any levels provided by the pyramid cache.
     //
     size_t GetNumRefLevels(string varname) const;
 
@@ -469,6 +498,51 @@ public:
 
     VAPoR::Grid *GetVariable(size_t ts, string varname, int level, int lod, DimsType min, DimsType max, bool lock = false);
 
+    //! Asynchronously read a variable hyperslab into the cache
+    //!
+    //! This method queues a request to read the hyperslab specified by
+    //! \p ts, \p varname, \p level, \p lod, \p min, and \p max (see
+    //! GetVariable()) and returns immediately. The request is serviced by a
+    //! background thread, which places the data in the memory cache. A
+    //! subsequent call to GetVariable() with the same arguments will then
+    //! be satisfied from the cache. Typical use is to request time step
+    //! \p ts + 1 while time step \p ts is being rendered.
+    //!
+    //! Prefetching never evicts data from the cache: if there is
+    //! insufficient free cache memory to hold the hyperslab the request is
+    //! silently discarded. Errors encountered while servicing a request
+    //! are not reported.
+    //!
+    //! Native variables are read from disk without blocking other calls to
+    //! this class, except those that must read from the data collection
+    //! themselves. Derived variables, and levels computed by downsampling,
+    //! are read like GetVariable() reads them, blocking other calls.
+    //!
+    //! \retval status A negative int is returned if the request could not
+    //! be queued
+    //!
+    //! \sa CancelPrefetch(), WaitForPrefetch()
+    //
+    int Prefetch(size_t ts, string varname, int level, int lod, CoordType min, CoordType max);
+
+    //! \copydoc Prefetch()
+    //!
+    //! This version of the method prefetches the entire variable.
+    //
+    int Prefetch(size_t ts, string varname, int level, int lod);
+
+    //! Discard all pending prefetch requests
+    //!
+    //! Requests that have been queued with Prefetch() but not yet started
+    //! are discarded. A request that is currently being serviced runs to
+    //! completion.
+    //
+    void CancelPrefetch();
+
+    //! Block until all pending prefetch requests have been serviced
+    //
+    void WaitForPrefetch();
+
     //! Compute the coordinate extents of a variable
     //!
     //! This method finds the spatial domain extents of a variable
@@ -499,9 +573,22 @@ public:
     //! results returned by this method are equivalent to calling the
     //! Grid::GetRange() method on a grid returned by DataMgr::GetVariable
     //! using the same arguments provided here.
+    //!
+    //! If the data collection provides per-block value ranges (see
+    //! GetBlockRanges()) the range is computed from the ranges of the
+    //! blocks intersecting the ROI, without reading the variable. In this
+    //! case the returned range is guaranteed to contain the values of the
+    //! variable, but may be wider than the range of the ROI itself, or of
+    //! a lossy approximation of the variable.
     //
     int GetDataRange(size_t ts, string varname, int level, int lod, CoordType min, CoordType max, std::vector<double> &range);
 
+    //! \copydoc DC::GetBlockRanges()
+    //!
+    //! Block ranges are not available for derived variables.
+    //
+    int GetBlockRanges(size_t ts, string varname, std::vector<size_t> &bdims, std::vector<double> &ranges);
+
     //! \copydoc DC::GetDimLensAtLevel()
     //!
     virtual int GetDimLensAtLevel(string varname, int level, std::vector<size_t> &dims_at_level, long ts) const
@@ -742,8 +829,54 @@ protected:
         void *              blks;
     } region_t;
 
-    // a list of all allocated regions
-    std::list<region_t> _regionsList;
+    // Key uniquely identifying a cached region
+    //
+    class region_key_t {
+    public:
+        region_key_t(size_t ts, const string &varname, int level, int lod, const DimsType &bmin, const DimsType &bmax)
+        : ts(ts), varname(varname), level(level), lod(lod), bmin(bmin), bmax(bmax)
+        {
+        }
+        region_key_t(const region_t &r) : region_key_t(r.ts, r.varname, r.level, r.lod, r.bmin, r.bmax) {}
+
+        bool operator==(const region_key_t &rhs) const
+        {
+            return (ts == rhs.ts && level == rhs.level && lod == rhs.lod && bmin == rhs.bmin && bmax == rhs.bmax && varname == rhs.varname);
+        }
+
+        size_t   ts;
+        string   varname;
+        int      level;
+        int      lod;
+        DimsType bmin;
+        DimsType bmax;
+    };
+
+    struct region_key_hash_t {
+        size_t operator()(const region_key_t &k) const
+        {
+            size_t h = std::hash<string>()(k.varname);
+            auto   combine = [&h](size_t v) { h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2); };
+            combine(k.ts);
+            combine((size_t)k.level);
+            combine((size_t)k.lod);
+            for (auto v : k.bmin) combine(v);
+            for (auto v : k.bmax) combine(v);
+            return (h);
+        }
+    };
+
+    typedef std::list<region_t>::iterator region_itr_t;
+
+    // A list of all allocated regions, ordered from least to most recently
+    // used. The list is indexed by region key, by block address (for
+    // unlocking), and by variable name (for purging) so that none of the
+    // cache operations need to scan the entire list.
+    //
+    std::list<region_t>                                               _regionsList;
+    std::unordered_map<region_key_t, region_itr_t, region_key_hash_t> _regionsIndex;
+    std::unordered_map<const void *, region_itr_t>                    _regionsByBlks;
+    std::unordered_map<string, std::unordered_set<const void *>>      _regionsByVar;
 
     VAPoR::BlkMemMgr *_blk_mem_mgr;
 
@@ -758,6 +891,109 @@ protected:
     std::map<const Grid *, vector<float *>> _lockedFloatBlks;
     std::map<const Grid *, vector<int *>>   _lockedIntBlks;
 
+    // Serializes access to the caches, and to the rest of the state of
+    // this class, between client threads and the prefetch thread
+    //
+    mutable std::recursive_mutex _mutex;
+
+    // Serializes reads from the data collection. When both are needed,
+    // _mutex is locked first. The prefetch thread reads native variables
+    // with only _dcMutex locked, so that clients are not held up by its
+    // I/O. The data collection's metadata doesn't change after
+    // Initialize(), and may be queried while a read is in progress.
+    //
+    mutable std::recursive_mutex _dcMutex;
+
+    typedef struct {
+        size_t    ts;
+        string    varname;
+        int       level;
+        int       lod;
+        CoordType min;
+        CoordType max;
+        bool      useExts;
+    } prefetch_req_t;
+
+    std::deque<prefetch_req_t> _prefetchQueue;
+    std::mutex                 _prefetchMutex;
+    std::condition_variable    _prefetchCV;
+    std::condition_variable    _prefetchDoneCV;
+    std::thread                _prefetchThread;
+    bool                       _prefetchShutdown;
+    bool                       _prefetchBusy;
+    bool                       _prefetchNoEvict;
+
+    // A region of a native variable, read by the prefetch thread without
+    // _mutex locked, and then copied into the cache
+    //
+    typedef struct {
+        size_t                     ts;
+        string                     varname;
+        int                        level;
+        int                        lod;
+        size_t                     ndims;
+        bool                       isInt;        // connectivity (int) or float data
+        DimsType                   file_bs;      // block size on disk
+        DimsType                   file_dims;    // dimensions on disk
+        DimsType                   grid_dims;
+        DimsType                   grid_bs;
+        DimsType                   grid_bmin;
+        DimsType                   grid_bmax;
+        std::vector<unsigned char> blks;         // region, blocked as in the cache
+    } prefetch_read_t;
+
+    int  _queuePrefetch(const prefetch_req_t &req);
+    void _prefetchWorker();
+    void _stopPrefetch();
+
+    // Find the regions of the native variables needed by a request that
+    // aren't cached. Returns 1 if the request needs derived variables or
+    // downsampling, and must be serviced by GetVariable()
+    //
+    int _planPrefetch(const prefetch_req_t &req, std::vector<prefetch_read_t> &reads);
+
+    template<typename T> int _readPrefetch(prefetch_read_t &read) const;
+
+    // Downsampled copies of data variables stored at a single resolution
+    // (see the -pyramid_cache option). Levels of a variable coarser than
+    // its native level are pyramid levels
+    //
+    typedef struct {
+        size_t ts;
+        string varname;
+        int    lod;
+    } pyramid_req_t;
+
+    PyramidCache                              _pyramid;
+    bool                                      _pyramidEnabled;
+    bool                                      _quadTreeCacheEnabled;
+    mutable std::map<string, int>             _pyramidLevelsCache;    // number of pyramid levels of each variable
+    std::set<std::tuple<size_t, string, int>> _pyramidRequested;      // variables queued for building
+    std::deque<pyramid_req_t>                 _pyramidQueue;
+    std::mutex                                _pyramidMutex;
+    std::condition_variable                   _pyramidCV;
+    std::thread                               _pyramidThread;
+    bool                                      _pyramidShutdown;
+
+    size_t _nativeNumRefLevels(string varname) const;
+    int    _pyramidLevels(string varname) const;
+
+    // Dimensions of a variable at a level stored by the data collection,
+    // or computed by a derived variable. Unlike GetDimLensAtLevel(),
+    // pyramid levels are not counted
+    //
+    int _nativeDimLensAtLevel(string varname, int level, std::vector<size_t> &dims_at_level, std::vector<size_t> &bs_at_level, long ts) const;
+
+    // Read a region of a pyramid level from the cache, queuing the
+    // variable to be built if it isn't cached. Only float data are cached
+    //
+    bool _readPyramid(size_t ts, string varname, int level, int lod, const DimsType &grid_dims, const DimsType &min, const DimsType &max, float *region);
+    template<typename T> bool _readPyramid(size_t ts, string varname, int level, int lod, const DimsType &grid_dims, const DimsType &min, const DimsType &max, T *region) { return (false); }
+
+    void _queuePyramid(size_t ts, string varname, int lod);
+    void _pyramidWorker();
+    void _stopPyramid();
+
     // Get the immediate variable dependencies of a variable
     //
     std::vector<string> _get_var_dependencies_1(string varname) const;
@@ -808,6 +1044,8 @@ protected:
 
     int _find_bounding_grid(size_t ts, string varname, int level, int lod, CoordType min, CoordType max, DimsType &min_ui, DimsType &max_ui);
 
+    bool _getDataRangeFromBlocks(size_t ts, string varname, int level, const DimsType &min_ui, const DimsType &max_ui, std::vector<double> &range);
+
     void _setupCoordVecsHelper(string data_varname, const DimsType &data_dimlens, const DimsType &data_bmin, const DimsType &data_bmax, string coord_varname, int order, DimsType &coord_dimlens,
                                DimsType &coord_bmin, DimsType &coord_bmax, bool structured, long ts) const;
 
@@ -852,6 +1090,8 @@ protected:
     bool _free_lru();
     void _free_var(string varname);
 
+    void _erase_region(region_itr_t itr);
+
     int _level_correction(string varname, int &level) const;
     int _lod_correction(string varname, int &lod) const;
 
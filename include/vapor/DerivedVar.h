@@ -1,5 +1,7 @@
 #include <iostream>
 #include <functional>
+#include <list>
+#include <cstdint>
 #include <vapor/DC.h>
 #include <vapor/MyBase.h>
 #include <vapor/Proj4API.h>
@@ -285,8 +287,25 @@ private:
     Proj4API            _proj4API;
     DC::CoordVar        _coordVarInfo;
 
+    // Projected coordinates of recent reads, most recently used first.
+    // An entry is reused for a read of the same region whose lat-lon
+    // coordinates hash to the same value. Lat-lon coordinates are often
+    // stored for every time step but don't change, and the projection
+    // string is fixed for the variable, so no time step is reprojected
+    //
+    struct ProjCacheEntry {
+        std::vector<size_t> min, max;
+        int                 lod;
+        uint64_t            hash;
+        std::vector<float>  region;
+    };
+    static const size_t       _projCacheMaxEntries = 4;
+    std::list<ProjCacheEntry> _projCache;
+
     int _setupVar();
 
+    int _transform(const std::vector<size_t> &min, const std::vector<size_t> &max, int lod, float *lonBuf, float *latBuf, size_t n, float *region);
+
     int _readRegionHelperCylindrical(DC::FileTable::FileObject *f, const std::vector<size_t> &min, const std::vector<size_t> &max, float *region);
     int _readRegionHelper1D(DC::FileTable::FileObject *f, const std::vector<size_t> &min, const std::vector<size_t> &max, float *region);
     int _readRegionHelper2D(DC::FileTable::FileObject *f, const std::vector<size_t> &min, const std::vector<size_t> &max, float *region);
@@ -41,6 +41,15 @@ public:
     virtual int GetVelocity(double time, const glm::vec3 &pos,    // input
                             glm::vec3 &vel) const = 0;            // output
 
+    //
+    // Get the velocity values of a batch of n particles, each at its own position and time.
+    // Each element of rvs receives the value GetVelocity() would return for that particle.
+    // The default implementation calls GetVelocity() for each particle; derived classes
+    // may override it to amortize the cost of the queries.
+    //
+    virtual void GetVelocities(const double *times, const glm::vec3 *pos, size_t n,    // input
+                               glm::vec3 *vels, int *rvs) const;                       // output
+
     //
     // Returns the number of empty velocity variable names.
     // It is 3 when the object is newly created, or is used to represent a scalar field
@@ -54,6 +63,14 @@ public:
     virtual auto LockParams() -> int = 0;
     virtual auto UnlockParams() -> int = 0;
 
+    //
+    // Optionally, also lock in the data needed to answer queries at times within
+    // [startT, endT]. It is only meaningful between LockParams() and UnlockParams().
+    // Returns 0 if queries within that range can then be made from multiple threads
+    // concurrently, and non-zero if they must be made from one thread at a time.
+    //
+    virtual auto LockTimeRange(double startT, double endT) -> int { return 0; }
+
     // Class members
     bool                       IsSteady = false;
     std::string                ScalarName = "";
@@ -272,6 +272,47 @@ public:
         return (GetValue(coords));
     }
 
+    //! Get the reconstructed values of the sampled scalar function at a batch of points
+    //!
+    //! This method is equivalent to calling GetValue() for each of the \p n points
+    //! in \p coords, but lets derived classes amortize the cost of locating the
+    //! cells containing the points. E.g. the cell containing the previous point
+    //! may be tested first, so batches of nearby points, such as particles
+    //! moving along neighboring trajectories, benefit the most.
+    //!
+    //! \param[in] coords An array of \p n points in user coordinates
+    //! \param[in] n The number of points
+    //! \param[out] values An array of \p n elements, receiving the reconstructed
+    //! value at each point
+    //!
+    //! \sa GetValue()
+    //!
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const;
+
+    //! Resample the grid onto a regular lattice
+    //!
+    //! The lattice spans the user extents of the grid with \p dims samples
+    //! along each axis, each placed at the center of its lattice cell. Rows
+    //! of the lattice are sampled in parallel, each with a single call to
+    //! GetValues(), so grids that locate cells coherently, such as
+    //! CurvilinearGrid and LayeredGrid, walk from one sample's cell to the
+    //! next. This is intended for renderers that need a regular copy of a
+    //! non-regular grid, e.g. to upload as a 3D texture.
+    //!
+    //! \param[in] dims The number of samples along each axis. Scaling the
+    //! grid's dimensions changes the output resolution.
+    //! \param[out] values An array of dims[0]*dims[1]*dims[2] elements,
+    //! receiving the resampled values with the X index varying fastest
+    //! \param[out] missingMask If not NULL, an array of the same size as
+    //! \p values, receiving 255 where the resampled value is the missing
+    //! value and 0 elsewhere
+    //!
+    //! \retval hasMissing True if any resampled value is the missing value
+    //!
+    //! \sa GetValues(), GetUserExtents()
+    //!
+    bool ResampleRegular(const DimsType &dims, float *values, unsigned char *missingMask = NULL) const;
+
     //! Return the extents of the user coordinate system
     //!
     //! This pure virtual method returns min and max extents of
@@ -555,6 +596,77 @@ public:
         GetRange(min3, max3, range);
     }
 
+    //! Visit the grid values in contiguous spans
+    //!
+    //! Calls \p f for every run of consecutive grid values that is
+    //! contiguous in memory, i.e. each row of each block, clipped to the
+    //! index region bounded by \p min and \p max. \p f receives a pointer
+    //! to the first value of the span, the number of values in the span,
+    //! and the grid indices of the first value:
+    //!
+    //! \code
+    //! grid->ForEachBlock(min, max, [&](const float *span, size_t n, const DimsType &origin) {
+    //!     for (size_t i = 0; i < n; i++) sum += span[i];
+    //! });
+    //! \endcode
+    //!
+    //! This is much cheaper than the element by element Iterator or
+    //! AccessIJK(), and loops over a span can be vectorized. Spans are
+    //! not visited in index order.
+    //!
+    //! \param[in] min Minimum indices of the region, inclusive
+    //! \param[in] max Maximum indices of the region, inclusive. Indices
+    //! outside the grid are clamped to it.
+    //! \param[in] f The visitor
+    //! \param[in] parallel If true \p f is called concurrently from multiple
+    //! threads. Each thread can be told apart with omp_get_thread_num().
+    //!
+    template<typename F> void ForEachBlock(const DimsType &min, const DimsType &max, F f, bool parallel = false) const
+    {
+        if (!_blks.size()) return;
+
+        DimsType cMin, cMax, bMin, nb;
+        for (int i = 0; i < 3; i++) {
+            cMin[i] = std::min(min[i], _dims[i] - 1);
+            cMax[i] = std::min(max[i], _dims[i] - 1);
+            if (cMin[i] > cMax[i]) return;
+            bMin[i] = cMin[i] / _bs[i];
+            nb[i] = cMax[i] / _bs[i] - bMin[i] + 1;
+        }
+
+        // A unit of work is an XY plane of a block, so that grids stored
+        // in a single block are still split between threads
+        //
+        const long nUnits = nb[0] * nb[1] * (cMax[2] - cMin[2] + 1);
+
+        // Guarded because this header is included by code built without
+        // OpenMP, where the pragma would be reported as unknown
+        //
+#ifdef USE_OMP
+        #pragma omp parallel for schedule(dynamic) if (parallel)
+#endif
+        for (long u = 0; u < nUnits; u++) {
+            size_t xb = bMin[0] + u % nb[0];
+            size_t yb = bMin[1] + (u / nb[0]) % nb[1];
+            size_t k = cMin[2] + u / (nb[0] * nb[1]);
+            size_t zb = k / _bs[2];
+
+            size_t i0 = std::max(cMin[0], xb * _bs[0]);
+            size_t i1 = std::min(cMax[0], (xb + 1) * _bs[0] - 1);
+            size_t j0 = std::max(cMin[1], yb * _bs[1]);
+            size_t j1 = std::min(cMax[1], (yb + 1) * _bs[1] - 1);
+
+            const float *blk = _blks[zb * _bdims[0] * _bdims[1] + yb * _bdims[0] + xb];
+            const float *plane = blk + (k % _bs[2]) * _bs[0] * _bs[1];
+            for (size_t j = j0; j <= j1; j++) f(plane + (j % _bs[1]) * _bs[0] + i0 % _bs[0], i1 - i0 + 1, DimsType{i0, j, k});
+        }
+    }
+
+    template<typename F> void ForEachBlock(F f, bool parallel = false) const
+    {
+        ForEachBlock(DimsType{0, 0, 0}, _dims, f, parallel);
+    }
+
     //! Return true if the specified point lies inside the grid
     //!
     //! This method can be used to determine if a point expressed in
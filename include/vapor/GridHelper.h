@@ -11,6 +11,7 @@
 #include <vapor/StretchedGrid.h>
 #include <vapor/UnstructuredGrid2D.h>
 #include <vapor/UnstructuredGridLayered.h>
+#include <vapor/CellIndex3D.h>
 
 #ifndef GRIDMGR_H
     #define GRIDMGR_H
@@ -21,7 +22,7 @@ class UnstructuredGrid3D;
 
 class VDF_API GridHelper : public Wasp::MyBase {
 public:
-    GridHelper(size_t max_size = 10) : _qtrCache(max_size) {}
+    GridHelper(size_t max_size = 10) : _qtrCache(max_size), _cellIndexCache(max_size) {}
 
     ~GridHelper();
 
@@ -30,6 +31,32 @@ public:
     bool IsUnstructured(std::string gridType) const;
     bool IsStructured(std::string gridType) const;
 
+    //! Return the default directory for saved quad trees
+    //!
+    //! Quad trees used to locate points in curvilinear and unstructured
+    //! grids are expensive to build. If enabled (see the DataMgr option
+    //! \c -quadtree_cache) they are saved to disk so that later
+    //! sessions can read them instead. If the environment variable
+    //! VAPOR_QUADTREE_CACHE is set its value is returned, and an empty
+    //! value disables saving. Otherwise the trees are saved in a hidden
+    //! directory, ".vapor_quadtree", in the directory containing the
+    //! first of \p files.
+    //!
+    //! \param[in] files Paths to the files of a data set
+    //
+    static string DefaultQuadTreeCacheDir(const std::vector<string> &files);
+
+    //! Set the directory where quad trees are saved
+    //!
+    //! Saved trees are named after a fingerprint of the coordinates and
+    //! connectivity they were built from, and are only reused for grids
+    //! with identical coordinates.
+    //!
+    //! \param[in] dir Path to the directory, which is created when the
+    //! first tree is saved. If empty, trees are not saved or read.
+    //
+    void SetQuadTreeCacheDir(const string &dir) { _qtrCacheDir = dir; }
+
     //	var: variable info
     //  roi_dims: spatial dimensions of ROI
     //	dims: spatial dimensions of full variable domain in voxels
@@ -113,6 +140,8 @@ private:
     };
 
     lru_cache<string, std::shared_ptr<const QuadTreeRectangleP>> _qtrCache;
+    string                                                       _qtrCacheDir;
+    lru_cache<string, std::shared_ptr<const CellIndex3D>>        _cellIndexCache;
 
     RegularGrid *_make_grid_regular(const DimsType &dims, const std::vector<float *> &blkvec, const DimsType &bs, const DimsType &bmin, const DimsType &bmax
 
@@ -144,6 +173,13 @@ private:
     void _makeGridHelper(const DC::DataVar &var, const DimsType &roi_dims, const DimsType &dims, Grid *g) const;
 
     string _getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const DimsType &bmin, const DimsType &bmax) const;
+
+    // Read a saved tree into the in-memory cache under key. Returns NULL if
+    // there is none
+    //
+    std::shared_ptr<const QuadTreeRectangleP> _readQuadTreeRectangle(const string &key, uint64_t fingerprint);
+
+    void _writeQuadTreeRectangle(uint64_t fingerprint, const QuadTreeRectangleP &qtr) const;
 };
 
 };    // namespace VAPoR
@@ -23,6 +23,8 @@
 #include <string>
 #include <vector>
 #include <climits>
+#include <map>
+#include <tuple>
 #include <vapor/MyBase.h>
 #include <vapor/StructuredGrid.h>
 #include <vapor/RenderParams.h>
@@ -54,6 +56,12 @@ public:
     int    getTimestepOfUpdate() { return _timestepOfUpdate; }
     string getVarnameOfUpdate() { return _varnameOfUpdate; }
 
+    // Number of histograms restored from the result cache, and computed
+    // from the grid, by Populate()
+    //
+    long getCacheHits() const { return _cacheHits; }
+    long getCacheMisses() const { return _cacheMisses; }
+
     int  Populate(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp);
     bool NeedsUpdate(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp);
     int  PopulateIfNeeded(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp);
@@ -79,11 +87,39 @@ private:
     string _varnameOfUpdate;
     bool   autoSetProperties = false;
 
+    // Bin counts of one thread. The counts of all threads are summed once
+    // the grid has been binned
+    //
+    struct Counts {
+        vector<unsigned int> bins, below, above;
+        long                 numBelow = 0, numAbove = 0;
+    };
+
+    // Populated histograms, keyed by everything that determines the bins,
+    // so that revisiting e.g. a time step does not re-read the grid
+    //
+    typedef std::tuple<const VAPoR::DataMgr *, string, size_t, int, int, vector<double>, vector<double>, int, float, float> CacheKey;
+    struct CacheEntry {
+        Counts counts;
+        float  minData, maxData;
+        long   lastUsed;
+    };
+    static const size_t            _cacheMaxEntries = 32;
+    std::map<CacheKey, CacheEntry> _cache;
+    long                           _cacheClock = 0;
+    long                           _cacheHits = 0, _cacheMisses = 0;
+
     static vector<float> getDataSamplesIterating(const VAPoR::Grid *grid, const int stride);
     static vector<float> getDataSamplesSampling(const VAPoR::Grid *grid, const vector<double> &minExts, const vector<double> &maxExts);
     
     void populateIteratingHistogram(const VAPoR::Grid *grid, const int stride);
     void populateSamplingHistogram(const VAPoR::Grid *grid, const vector<double> &minExts, const vector<double> &maxExts);
+    void binValue(float val, unsigned int *bins, unsigned int *below, unsigned int *above, long &numBelow, long &numAbove) const;
+    void newCounts(Counts &counts) const;
+    void sumCounts(const vector<Counts> &threadCounts);
+    void storeCounts(Counts &counts) const;
+    void loadCounts(const Counts &counts);
+    static VAPoR::Grid *getGrid(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp);
     static int  calculateStride(const std::string &varName, VAPoR::DataMgr *dm, const VAPoR::RenderParams *rp);
     static bool shouldUseSampling(const std::string &varName, VAPoR::DataMgr *dm, const VAPoR::RenderParams *rp);
     void setProperties(float mnData, float mxData, string var, int ts);
@@ -20,6 +20,13 @@ public:
     virtual int Write(const unsigned char *buffer, const unsigned int width, const unsigned int height) = 0;
     virtual ~ImageWriter(){};
 
+    const std::string &GetPath() const { return path; }
+
+    //! Returns true if Write() may be called concurrently with other
+    //! writers on threads other than the one that created this writer
+    //
+    virtual bool IsThreadSafe() const { return true; }
+
     static ImageWriter *CreateImageWriterForFile(const std::string &path);
     static void         RegisterFactory(ImageWriterFactory *factory);
 
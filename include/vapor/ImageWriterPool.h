@@ -0,0 +1,93 @@
+#pragma once
+
+#include <vapor/MyBase.h>
+#include <vapor/ImageWriter.h>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace VAPoR {
+
+//! \class ImageWriterPool
+//! \ingroup Public_Render
+//! \brief Encodes and writes images on a pool of worker threads
+//!
+//! Encoding an image, particularly a large one, can take as long as
+//! rendering it. This class lets the render thread hand finished frames
+//! off to worker threads, so the next frame can be rendered while
+//! earlier ones are encoded and written. The number of queued frames is
+//! bounded, so memory use stays fixed when encoding is slower than
+//! rendering.
+//!
+//! Writers that are not thread safe (see ImageWriter::IsThreadSafe())
+//! are run on the thread calling Write().
+//!
+//! \sa Visualizer::SetImageCaptureAsync()
+//
+class RENDER_API ImageWriterPool : public Wasp::MyBase {
+public:
+    //! \param[in] nThreads Number of worker threads. If less than 1 one
+    //! less than the number of hardware threads is used, but at least one
+    //! \param[in] maxQueued Maximum number of images waiting to be written.
+    //! If less than 1 twice the number of worker threads is used.
+    //
+    ImageWriterPool(int nThreads = 0, int maxQueued = 0);
+
+    //! Waits for all queued images to be written
+    //
+    ~ImageWriterPool();
+
+    //! Queue an image to be written
+    //!
+    //! Blocks while the queue is full.
+    //!
+    //! \param[in] writer The writer for the image file. Ownership is
+    //! transferred to the pool.
+    //! \param[in] pixels RGB pixel data, 3 bytes per pixel, top row first
+    //! \param[in] width Image width in pixels
+    //! \param[in] height Image height in pixels
+    //!
+    //! \retval status A negative int is returned if any image queued
+    //! before this one failed to be written since the last call to
+    //! Write() or Wait()
+    //
+    int Write(std::unique_ptr<ImageWriter> writer, std::vector<unsigned char> pixels, int width, int height);
+
+    //! Wait for all queued images to be written
+    //!
+    //! \retval status A negative int is returned if any image failed to
+    //! be written since the last call to Write() or Wait()
+    //
+    int Wait();
+
+    int GetNumThreads() const { return ((int)_threads.size()); }
+
+private:
+    class Job {
+    public:
+        std::unique_ptr<ImageWriter> writer;
+        std::vector<unsigned char>   pixels;
+        int                          width = 0;
+        int                          height = 0;
+    };
+
+    std::vector<std::thread> _threads;
+    size_t                   _maxQueued;
+
+    std::mutex               _mutex;
+    std::condition_variable  _cond;
+    std::deque<Job>          _queue;
+    int                      _busy;    // Jobs taken off the queue but not yet written
+    bool                     _stop;
+    std::vector<std::string> _failed;    // Paths of images that failed to be written
+
+    void _worker();
+    bool _write(Job &job);
+    int  _reportFailures();
+};
+
+}    // namespace VAPoR
@@ -105,6 +105,10 @@ public:
     //!
     bool InsideGrid(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     //! \copydoc Grid::GetPeriodic()
     //!
     //! Only horizonal dimensions can be periodic. Layered (third) dimension
@@ -262,6 +266,12 @@ private:
     double _interpolateVaryingCoord(size_t i0, size_t j0, size_t k0, double x, double y) const;
 
     bool _insideGrid(const CoordType &coords, DimsType &indices, double wgts[3]) const;
+
+    // Same as above, but uses caller provided storage for the interpolated Z coordinates
+    // of a column. If useHint is true, indices on input hold a guess for the cell containing
+    // the point.
+    //
+    bool _insideGrid(const CoordType &coords, DimsType &indices, double wgts[3], std::vector<double> &zcoords, bool useHint) const;
 };
 };    // namespace VAPoR
 #endif
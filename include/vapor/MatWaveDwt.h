@@ -194,7 +194,25 @@ public:
     int idwt3d(const long *cLLL, const long *cLLH, const long *cLHL, const long *cLHH, const long *cHLL, const long *cHLH, const long *cHHL, const long *cHHH, const size_t L[27], long *sigOut);
     int idwt3d(const int *cLLL, const int *cLLH, const int *cLHL, const int *cLHH, const int *cHLL, const int *cHLH, const int *cHHL, const int *cHHH, const size_t L[27], int *sigOut);
 
+    //! Set or get the lifting scheme flag
+    //!
+    //! When set, floating point transforms with the bior2.2 (CDF 5/3) and
+    //! bior4.4 (CDF 9/7) wavelets and symw boundary extension are computed
+    //! with a lifting scheme factorization of the filters. Multidimensional
+    //! transforms are then performed in place along each axis, processing
+    //! whole rows (or planes) at a time, without transposing the data. The
+    //! resulting coefficients agree with the convolution based
+    //! transform to within floating point round off. If the flag is not
+    //! set, or the wavelet has no lifting factorization, the
+    //! convolution based transform is used. By default the flag is set.
+    //!
+    //! \retval flag A reference to the lifting scheme flag
+    //
+    bool &LiftingOnOff() { return (_lifting); };
+
 private:
+    bool _lifting;
+
     // 1D buffers
     Wasp::SmartBuf _dwt1dSmartBuf;
 
@@ -231,18 +231,15 @@ public:
     //!
     //! When disabled calls to SetErrMsg() report no error messages
     //! either through the error message callback or the error message
-    //! FILE pointer.
+    //! FILE pointer. The setting is per thread: disabling error reporting
+    //! on one thread doesn't silence errors reported by other threads.
     //!
     //! \param[in] enable Boolean flag to enable or disable error reporting
+    //! \retval prev The previous setting for the calling thread
     //!
-    static bool EnableErrMsg(bool enable)
-    {
-        bool prev = Enabled;
-        Enabled = enable;
-        return (prev);
-    };
+    static bool EnableErrMsg(bool enable);
 
-    static bool GetEnableErrMsg() { return Enabled; }
+    static bool GetEnableErrMsg();
 
     // N.B. the error codes/messages are stored in static class members!!!
     static char *     ErrMsg;
@@ -255,7 +252,6 @@ public:
     static int         DiagMsgSize;
     static FILE *      DiagMsgFilePtr;
     static DiagMsgCB_T DiagMsgCB;
-    static bool        Enabled;
 
 protected:
     void SetClassName(const string &name) { _className = name; };
@@ -12,6 +12,7 @@
 #include <netcdf.h>
 #include <vapor/MyBase.h>
 #include <vapor/NetCDFSimple.h>
+#include <vapor/NetCDFMetaIndex.h>
 
 namespace VAPoR {
 
@@ -122,6 +123,20 @@ public:
     //! time step of a variable.
     //!
     virtual int Initialize(const std::vector<string> &files, const std::vector<string> &time_dimnames, const std::vector<string> &time_coordvar);
+
+    //! Set the location of the file metadata index
+    //!
+    //! If \p path is not empty, subsequent calls to Initialize() take the
+    //! metadata of files from the index stored at \p path, instead of
+    //! reading every file header, and add the metadata of any files not
+    //! found there to the index. By default no index is used.
+    //!
+    //! \param[in] path Path to the index file, or an empty string to
+    //! disable the index
+    //!
+    //! \sa NetCDFMetaIndex::DefaultPath()
+    //
+    void SetMetaIndexPath(const string &path) { _metaIndexPath = path; }
     
     //! Return a boolean indicating whether a variable exists in the
     //! data collection.
@@ -651,9 +666,11 @@ private:
     std::vector<size_t>              _dimLens;     // Names of all dimensions
     std::vector<bool>                _dimIsTimeVarying;
     string                           _missingValAttName;
-    std::map<string, vector<double>> _timesMap;      // map variable to time
-    std::vector<double>              _times;         // all valid time coordinates
-    std::vector<string>              _failedVars;    // Varibles that could not be added
+    std::map<string, vector<double>> _timesMap;         // map variable to time
+    std::vector<double>              _times;            // all valid time coordinates
+    std::vector<string>              _failedVars;       // Varibles that could not be added
+    NetCDFMetaIndex *                _metaIndex;        // Cached file metadata, may be NULL
+    string                           _metaIndexPath;    // Location of _metaIndex, empty if disabled
 
     //
     // file handle for an open variable
@@ -681,6 +698,8 @@ private:
 
     void ReInitialize();
 
+    void _LoadMetaIndex();
+
     int _InitializeTimesMap(const std::vector<string> &files, const std::vector<string> &time_dimnames, const std::vector<string> &time_coordvars, std::map<string, std::vector<double>> &timesMap,
                             std::map<string, size_t> &timeDimLens, std::vector<double> &times, int &file_org) const;
 
@@ -0,0 +1,157 @@
+#ifndef _NetCDFMetaIndex_h_
+#define _NetCDFMetaIndex_h_
+
+#include <vector>
+#include <map>
+#include <string>
+#include <vapor/MyBase.h>
+#include <vapor/NetCDFSimple.h>
+
+namespace VAPoR {
+
+//
+//! \class NetCDFMetaIndex
+//! \brief An on-disk index of netCDF file metadata
+//!
+//! Opening a collection of netCDF files requires reading the header
+//! (dimensions, attributes and variable definitions) of every file, and
+//! the time coordinates of some. For collections of thousands of files
+//! this dominates the time needed to open a data set. This class records
+//! the metadata of each file in a single index file, so that subsequent
+//! opens of the same collection need not open the netCDF files at all.
+//!
+//! Entries are keyed by file path and fingerprinted by the file's
+//! modification time and size. An entry whose fingerprint no longer matches
+//! its file is discarded, and the file is read again.
+//!
+//! \sa NetCDFSimple::Initialize(), NetCDFCollection::Initialize()
+//
+class VDF_API NetCDFMetaIndex : public Wasp::MyBase {
+public:
+    //! Metadata of a single netCDF file, as read by NetCDFSimple
+    //
+    class FileInfo {
+    public:
+        long long                                           mtime = 0;
+        long long                                           size = 0;
+        std::vector<string>                                 dimnames;
+        std::vector<size_t>                                 dims;
+        std::vector<string>                                 unlimited_dimnames;
+        std::vector<std::pair<string, std::vector<double>>> flt_atts;
+        std::vector<std::pair<string, std::vector<long>>>   int_atts;
+        std::vector<std::pair<string, string>>              str_atts;
+        std::vector<NetCDFSimple::Variable>                 variables;
+        std::map<string, std::vector<double>>               coordvars;    // values of 1D variables
+    };
+
+    NetCDFMetaIndex();
+    virtual ~NetCDFMetaIndex();
+
+    //! Return the default location of the index for a collection of files
+    //!
+    //! The index is only used when enabled with
+    //! NetCDFCollection::SetMetaIndexPath(), which the netCDF based data
+    //! collections do when given the \c -netcdf_index option.
+    //!
+    //! If the environment variable VAPOR_NETCDF_INDEX is set its value is
+    //! returned, and an empty value disables the index. Otherwise the index
+    //! is a hidden sidecar file, ".vapor_netcdf_index", in the directory
+    //! containing the first of \p files.
+    //!
+    //! \param[in] files Paths to the netCDF files of a collection
+    //! \retval path Path to the index file, or an empty string if no index
+    //! should be used
+    //
+    static string DefaultPath(const std::vector<string> &files);
+
+    //! Load an index from disk
+    //!
+    //! Any entries currently held are discarded. A missing, unreadable, or
+    //! out of date index file is not an error: the index is simply
+    //! empty and will be rebuilt as files are read.
+    //!
+    //! \param[in] path Path to the index file. Saved to by Save()
+    //! \retval status A negative int is returned on failure
+    //
+    int Load(const string &path);
+
+    //! Return the path of the index file passed to Load()
+    //
+    string GetPath() const { return (_path); }
+
+    //! Write the index to disk if it has changed since it was loaded
+    //!
+    //! The index is written to a temporary file which is then renamed, so
+    //! concurrent readers never see a partially written index.
+    //!
+    //! \retval status A negative int is returned if the index could not be
+    //! written
+    //
+    int Save();
+
+    //! Look up the metadata for a netCDF file
+    //!
+    //! \param[in] file Path to the netCDF file
+    //! \retval info A pointer to the file's metadata, or NULL if the file
+    //! is not in the index or has changed since it was indexed. The pointer
+    //! is valid until the next call to a non-const method.
+    //
+    const FileInfo *Find(const string &file);
+
+    //! Add or replace the metadata for a netCDF file
+    //!
+    //! The fingerprint of \p info is set from the file on disk.
+    //!
+    //! \param[in] file Path to the netCDF file
+    //! \param[in] info The file's metadata
+    //
+    void Insert(const string &file, const FileInfo &info);
+
+    //! Look up the values of a cached 1D variable
+    //!
+    //! \param[in] file Path to the netCDF file
+    //! \param[in] varname Name of a 1D variable in \p file
+    //! \param[out] values The variable's values
+    //! \retval found True if \p file is indexed and up to date, and the
+    //! values of \p varname were stored with SetCoordVar()
+    //
+    bool GetCoordVar(const string &file, const string &varname, std::vector<double> &values);
+
+    //! Cache the values of a 1D variable
+    //!
+    //! Has no effect if \p file is not in the index
+    //!
+    //! \param[in] file Path to the netCDF file
+    //! \param[in] varname Name of a 1D variable in \p file
+    //! \param[in] values The variable's values
+    //
+    void SetCoordVar(const string &file, const string &varname, const std::vector<double> &values);
+
+    //! Return the number of lookups that did and did not find an up to
+    //! date entry
+    //
+    void GetStats(size_t &hits, size_t &misses) const
+    {
+        hits = _hits;
+        misses = _misses;
+    }
+
+private:
+    class Entry {
+    public:
+        FileInfo info;
+        bool     checked = false;    // fingerprint compared against file?
+    };
+
+    string                  _path;
+    std::map<string, Entry> _entries;
+    bool                    _dirty;
+    size_t                  _hits;
+    size_t                  _misses;
+
+    static bool _fingerprint(const string &file, long long &mtime, long long &size);
+};
+
+};    // namespace VAPoR
+
+#endif
@@ -13,6 +13,8 @@
 
 namespace VAPoR {
 
+class NetCDFMetaIndex;
+
 //
 //! \class NetCDFSimple
 //! \brief NetCDFSimple API interface
@@ -138,6 +140,23 @@ public:
     //!
     virtual int Initialize(string path);
 
+    //! Initialize the class instance from a metadata index
+    //!
+    //! This method behaves like Initialize(string), but if \p index
+    //! contains an up to date entry for \p path the file's metadata are
+    //! copied from the index and the file is not opened. Otherwise the file
+    //! is read and its metadata are added to \p index.
+    //!
+    //! \param[in] path Path to the netCDF file
+    //! \param[in] index Metadata index. If NULL this method is equivalent
+    //! to Initialize(string)
+    //!
+    //! \retval status A negative int is returned on failure
+    //!
+    //! \sa NetCDFMetaIndex
+    //
+    virtual int Initialize(string path, NetCDFMetaIndex *index);
+
     //! Open the named variable for reading
     //!
     //! This method prepares a netCDF variable
@@ -11,5 +11,6 @@ public:
 
     static std::vector<std::string> GetFileExtensions();
     int                             Write(const unsigned char *buffer, const unsigned int width, const unsigned int height);
+    bool                            IsThreadSafe() const;
 };
 }    // namespace VAPoR
@@ -542,11 +542,7 @@ private:
             emitStateChange();
         }
 
-        void Rebase()
-        {
-            if (_state0) delete _state0;
-            _state0 = _rootNode ? new XmlNode(*_rootNode) : NULL;
-        }
+        void Rebase() { _state0 = _rootNode ? _takeSnapshot() : XmlNode::SnapshotPtr(); }
         void Save(const XmlNode *node, string description);
         void BeginGroup(string descripion);
         void EndGroup();
@@ -567,9 +563,9 @@ private:
         }
         bool GetUndoEnabled() const { return _addToUndoEnabled; }
 
-        const XmlNode *GetTopUndo(string &description) const;
-        const XmlNode *GetTopRedo(string &description) const;
-        const XmlNode *GetBase() const { return (_state0); }
+        XmlNode::SnapshotPtr GetTopUndo(string &description) const;
+        XmlNode::SnapshotPtr GetTopRedo(string &description) const;
+        XmlNode::SnapshotPtr GetBase() const { return (_state0); }
 
         bool Undo();
         bool Redo();
@@ -584,23 +580,29 @@ private:
         void RegisterIntermediateStateChangeCB(std::function<void()> callback) { _intermediateStateChangeCBs.push_back(callback); }
 
     private:
-        bool           _enabled;
-        bool           _addToUndoEnabled = true;
-        int            _stackSize;
-        const XmlNode *_rootNode;
-        const XmlNode *_state0;
+        bool                 _enabled;
+        bool                 _addToUndoEnabled = true;
+        int                  _stackSize;
+        const XmlNode *      _rootNode;
+        XmlNode::SnapshotPtr _state0;
+
+        // Successive snapshots of the state tree share unchanged subtrees,
+        // so each one costs only the nodes on the paths to the changes
+        //
+        XmlNode::SnapshotPtr _lastSnap;
 
-        std::stack<string>                       _groups;
-        std::deque<std::pair<string, XmlNode *>> _undoStack;
-        std::deque<std::pair<string, XmlNode *>> _redoStack;
+        std::stack<string>                                  _groups;
+        std::deque<std::pair<string, XmlNode::SnapshotPtr>> _undoStack;
+        std::deque<std::pair<string, XmlNode::SnapshotPtr>> _redoStack;
 
         std::vector<bool *>                _stateChangeFlags;
         std::vector<std::function<void()>> _stateChangeCBs;
         std::vector<std::function<void()>> _intermediateStateChangeCBs;
 
-        void cleanStack(int maxN, std::deque<std::pair<string, XmlNode *>> &s);
-        void emitStateChange();
-        void emitIntermediateStateChange();
+        void                 cleanStack(int maxN, std::deque<std::pair<string, XmlNode::SnapshotPtr>> &s);
+        XmlNode::SnapshotPtr _takeSnapshot();
+        void                 emitStateChange();
+        void                 emitIntermediateStateChange();
     };
 
     map<string, DataMgr *> _dataMgrMap;
@@ -51,6 +51,9 @@ public:
     //! \note As with the proj4 C library the transformations are
     //! performed in place, modifiying the input values
     //!
+    //! Large arrays are split into chunks that are transformed in
+    //! parallel, each thread with its own copy of the projections.
+    //!
     //! \param[in,out] x array of longitudes or PCS X values
     //! \param[in,out] y array of latitudes or PCS Y values
     //! \param[in] n num elements in x, y, and z
@@ -0,0 +1,128 @@
+#ifndef _PyramidCache_h_
+#define _PyramidCache_h_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <vapor/MyBase.h>
+#include <vapor/Grid.h>
+
+namespace VAPoR {
+
+//
+//! \class PyramidCache
+//! \brief An on-disk cache of downsampled copies of variables
+//!
+//! Data collections that are not multiresolution (e.g. CF, WRF and BOV
+//! data) store each variable at its native resolution only. Coarse
+//! approximations must be computed by reading the full resolution data and
+//! downsampling it, which for large grids is as expensive as reading the
+//! full resolution variable. This class stores a pyramid of successively
+//! downsampled copies of a variable, each half the resolution of the
+//! previous along every axis, so that coarse levels can be read directly.
+//!
+//! Every level of a (variable, time step, lod) is built in a single pass
+//! over the native resolution data, which is read one Z plane at a time.
+//! Each level is stored in its own file, tiled in XY so that subregions
+//! can be read without reading the whole level.
+//!
+//! Files are written in native byte order: the cache is for the machine
+//! that wrote it. Each file records a fingerprint, derived from the paths,
+//! modification times and sizes of the data set's files. Levels whose
+//! fingerprint doesn't match the data set are ignored, and rebuilt.
+//!
+//! \sa DataMgr
+//
+class VDF_API PyramidCache : public Wasp::MyBase {
+public:
+    PyramidCache();
+    virtual ~PyramidCache();
+
+    //! Return the default cache directory for a data set
+    //!
+    //! If the environment variable VAPOR_PYRAMID_CACHE is set its value is
+    //! returned, and an empty value disables the cache. Otherwise the
+    //! cache is a hidden directory, ".vapor_pyramid", in the directory
+    //! containing the first of \p files.
+    //!
+    //! \param[in] files Paths to the files of a data set
+    //! \retval dir Path to the cache directory, or an empty string if no
+    //! cache should be used
+    //
+    static string DefaultDir(const std::vector<string> &files);
+
+    //! Set the cache directory and the data set whose variables are cached
+    //!
+    //! The directory is created when the first level is stored.
+    //!
+    //! \param[in] dir Path to the cache directory
+    //! \param[in] files Paths to the files of the data set
+    //
+    void Initialize(const string &dir, const std::vector<string> &files);
+
+    //! Return the cache directory passed to Initialize()
+    //
+    string GetDir() const { return (_dir); }
+
+    //! Return the number of downsampled levels built for a variable
+    //!
+    //! Levels are added until the largest dimension of the next level
+    //! would be smaller than 64.
+    //!
+    //! \param[in] dims Native dimensions of the variable
+    //
+    static int NumLevels(const DimsType &dims);
+
+    //! Return the dimensions of a level
+    //!
+    //! \param[in] dims Native dimensions of the variable
+    //! \param[in] level Number of times the native grid is halved. Zero
+    //! is the native grid.
+    //
+    static DimsType DimsAtLevel(const DimsType &dims, int level);
+
+    //! Read a subregion of a stored level
+    //!
+    //! \param[in] varname Variable name
+    //! \param[in] ts Time step
+    //! \param[in] lod Level of detail the level was built from
+    //! \param[in] dims Dimensions of the level
+    //! \param[in] min Minimum voxel coordinates of the region
+    //! \param[in] max Maximum voxel coordinates of the region
+    //! \param[out] region Region values, ordered X fastest
+    //!
+    //! \retval found True if an up to date copy of the level is stored
+    //! and was read
+    //
+    bool ReadRegion(const string &varname, size_t ts, int lod, const DimsType &dims, const DimsType &min, const DimsType &max, float *region) const;
+
+    //! Build and store all levels of a variable
+    //!
+    //! The levels are written to temporary files, which are renamed once
+    //! complete, so readers never see a partially written level. Errors
+    //! are not reported with SetErrMsg(), as levels are typically built on
+    //! a background thread.
+    //!
+    //! \param[in] varname Variable name
+    //! \param[in] ts Time step
+    //! \param[in] lod Level of detail read by \p readPlane
+    //! \param[in] dims Native dimensions of the variable
+    //! \param[in] readPlane Reads native Z plane \p z into \p plane. A
+    //! negative return value aborts the build.
+    //!
+    //! \retval status A negative int is returned if a plane could not be
+    //! read or a level could not be written
+    //
+    int Build(const string &varname, size_t ts, int lod, const DimsType &dims, const std::function<int(size_t z, float *plane)> &readPlane) const;
+
+private:
+    string             _dir;
+    string             _prefix;         // file name prefix identifying the data set
+    unsigned long long _fingerprint;    // hash of the data set's file modification times and sizes
+
+    string _path(const string &varname, size_t ts, int lod, const DimsType &dims) const;
+};
+
+};    // namespace VAPoR
+
+#endif
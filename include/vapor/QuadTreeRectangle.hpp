@@ -84,6 +84,26 @@ public:
         T _left, _top, _right, _bottom;
     };
 
+    //! A tree node in flat form
+    //!
+    //! Flatten() converts a tree to an array of flat_node_t and a separate
+    //! array holding the payloads of all nodes. Neither array contains
+    //! pointers, so a flattened tree can be written to disk and searched
+    //! in place after being read back, or memory mapped, without any
+    //! conversion. The root is the first node.
+    //
+    class flat_node_t {
+    public:
+        T        _left, _top, _right, _bottom;
+        uint32_t _level;
+        uint32_t _is_leaf;
+        uint64_t _child0;       // Index of first of four children
+        uint64_t _payload0;     // Index of first payload in payload array
+        uint64_t _npayloads;
+
+        bool contains(T x, T y) const { return ((_left <= x) && (_right >= x) && (_top <= y) && (_bottom >= y)); }
+    };
+
     //! Construct a QuadTreeRectangle instance for a defined 2D region
     //!
     //! This contstructor initiates a 2D quad tree with specified min
@@ -251,6 +271,82 @@ public:
         }
     }
 
+    //! Convert the tree to flat form
+    //!
+    //! \param[out] nodes The nodes of the tree, in the order they are
+    //! stored in the tree. The root is the first element.
+    //! \param[out] payloads The payloads of all nodes. The payloads of
+    //! node \a i are the \a nodes[i]._npayloads elements starting at
+    //! \a nodes[i]._payload0
+    //!
+    //! \sa GetPayloadContained(const flat_node_t *, const S *, T, T, std::vector<S> &)
+    //
+    void Flatten(std::vector<flat_node_t> &nodes, std::vector<S> &payloads) const
+    {
+        VAssert(_rootidx == 0);
+
+        nodes.resize(_nodes.size());
+        payloads.clear();
+
+        size_t npayloads = 0;
+        for (size_t i = 0; i < _nodes.size(); i++) npayloads += _nodes[i].get_payloads().size();
+        payloads.reserve(npayloads);
+
+        for (size_t i = 0; i < _nodes.size(); i++) {
+            const node_t &     node = _nodes[i];
+            const rectangle_t &r = node.bounds();
+            flat_node_t &      f = nodes[i];
+
+            f._left = r._left;
+            f._top = r._top;
+            f._right = r._right;
+            f._bottom = r._bottom;
+            f._level = (uint32_t)node.get_level();
+            f._is_leaf = node.get_is_leaf() ? 1 : 0;
+            f._child0 = node.get_child0();
+            f._payload0 = payloads.size();
+            f._npayloads = node.get_payloads().size();
+
+            payloads.insert(payloads.end(), node.get_payloads().begin(), node.get_payloads().end());
+        }
+    }
+
+    //! Search a tree in flat form
+    //!
+    //! Equivalent to the GetPayloadContained() method for a tree that
+    //! has been converted with Flatten().
+    //!
+    //! \param[in] nodes The nodes of the tree
+    //! \param[in] payloads The payloads of the tree
+    //! \sa Flatten()
+    //
+    static void GetPayloadContained(const flat_node_t *nodes, const S *payloads, T x, T y, std::vector<S> &result)
+    {
+        result.clear();
+
+        flat_get_payload_contains(nodes, payloads, 0, x, y, result);
+    }
+
+    //! Return statistics about a tree in flat form
+    //!
+    //! \copydetails GetStats()
+    //
+    static void GetStats(const flat_node_t *nodes, size_t nnodes, std::vector<size_t> &payload_histo, std::vector<size_t> &level_histo)
+    {
+        payload_histo.clear();
+        level_histo.clear();
+
+        for (size_t i = 0; i < nnodes; i++) {
+            size_t b = nodes[i]._npayloads;
+            if (b >= payload_histo.size()) { payload_histo.resize(b + 1, 0); }
+            payload_histo[b] += 1;
+
+            b = nodes[i]._level;
+            if (b >= level_histo.size()) { level_histo.resize(b + 1, 0); }
+            level_histo[b] += 1;
+        }
+    }
+
     friend std::ostream &operator<<(std::ostream &os, const QuadTreeRectangle &q)
     {
         os << "Num nodes : " << q._nodes.size() << std::endl;
@@ -386,6 +482,8 @@ private:
         }
         const std::vector<S> &get_payloads() const { return (_payloads); }
         size_t                get_level() const { return (_level); }
+        bool                  get_is_leaf() const { return (_is_leaf); }
+        size_t                get_child0() const { return (_child0); }
 
     private:
         int            _level;
@@ -395,6 +493,21 @@ private:
         std::vector<S> _payloads;
     };
 
+    static void flat_get_payload_contains(const flat_node_t *nodes, const S *payloads, size_t nidx, T x, T y, std::vector<S> &result)
+    {
+        const flat_node_t &node = nodes[nidx];
+
+        if (!node.contains(x, y)) return;
+
+        if (node._npayloads) { result.insert(result.end(), payloads + node._payload0, payloads + node._payload0 + node._npayloads); }
+        if (node._is_leaf) return;
+
+        for (int q = 0; q < 4; q++) {
+            size_t child = node._child0 + q;
+            if (nodes[child].contains(x, y)) { flat_get_payload_contains(nodes, payloads, child, x, y, result); }
+        }
+    }
+
     std::vector<node_t> _nodes;
     size_t              _rootidx;
     size_t              _maxDepth;
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vapor/VAssert.h>
 #include <vapor/Grid.h>
 #include <vapor/QuadTreeRectangle.hpp>
@@ -19,6 +21,13 @@ namespace VAPoR {
 //! \brief This class wraps QuadTreeRectangleP with parallel
 //! tree construction
 //!
+//! Trees may be saved to disk with Write() and read back with Read(),
+//! which is far cheaper than constructing the tree again. A tree that
+//! has been read is stored in flat form (see
+//! QuadTreeRectangle::Flatten()), memory mapped from its file where the
+//! platform allows, and is searched in place. Such trees cannot be
+//! modified: Insert() fails.
+//!
 //
 class QuadTreeRectangleP {
 public:
@@ -73,18 +82,64 @@ public:
     //
     void GetStats(std::vector<size_t> &payload_histo, std::vector<size_t> &level_histo) const;
 
+    //! Write the tree to a file
+    //!
+    //! The tree is written in flat form, in native byte order, to a
+    //! temporary file that is renamed to \p path once complete.
+    //!
+    //! \param[in] path Path to the file
+    //! \param[in] fingerprint A value identifying the coordinates the tree
+    //! was built from. Read() returns the tree only if passed the same value.
+    //!
+    //! \retval status False if the file could not be written
+    //
+    bool Write(const std::string &path, uint64_t fingerprint) const;
+
+    //! Read a tree written by Write()
+    //!
+    //! \param[in] path Path to the file
+    //! \param[in] fingerprint Must match the value passed to Write()
+    //!
+    //! \retval qtr The tree, or NULL if the file doesn't exist, is not a
+    //! tree written by this version of the class on this platform, or its
+    //! fingerprint doesn't match \p fingerprint
+    //
+    static std::shared_ptr<const QuadTreeRectangleP> Read(const std::string &path, uint64_t fingerprint);
+
     friend std::ostream &operator<<(std::ostream &os, const QuadTreeRectangleP &q)
     {
         for (int i = 0; i < q._qtrs.size(); i++) {
             os << "Bin " << i << std::endl;
             os << q._qtrs[i] << std::endl;
         }
+        for (int i = 0; i < q._flat.size(); i++) {
+            os << "Bin " << i << std::endl;
+            os << "Num nodes : " << q._flat[i]._nnodes << std::endl;
+        }
         return (os);
     }
 
 private:
+    class storage;
+
+    // A subtree in flat form, pointing into _storage
+    //
+    class flat_tree_t {
+    public:
+        const QuadTreeRectangle<float, pType>::flat_node_t *_nodes;
+        size_t                                              _nnodes;
+        const pType *                                       _payloads;
+    };
+
     float                                          _left;
     float                                          _right;
     std::vector<QuadTreeRectangle<float, pType> *> _qtrs;
+
+    // Only used by trees returned by Read(), in which case _qtrs is empty
+    //
+    std::vector<flat_tree_t>       _flat;
+    std::shared_ptr<const storage> _storage;
+
+    int _getBin(float x) const;
 };
 };    // namespace VAPoR
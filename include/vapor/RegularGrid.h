@@ -74,6 +74,10 @@ public:
     //
     virtual bool InsideGrid(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     class ConstCoordItrRG : public Grid::ConstCoordItrAbstract {
     public:
         ConstCoordItrRG(const RegularGrid *rg, bool begin);
@@ -0,0 +1,107 @@
+/*
+ * Defines a stream, the trajectory of a single seed particle in flow integration.
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "vapor/common.h"
+#include "vapor/Particle.h"
+#include <glm/glm.hpp>
+#include <cmath>
+#include <vector>
+
+namespace flow {
+//
+// A stream stores its particles as a structure of arrays: one contiguous
+// array for each of x, y, z, time, and value, plus one contiguous column
+// for each property attached to the particles. Each particle costs 24
+// bytes (float x, y, z and value, double time) plus 4 bytes per property.
+// An array of Particle objects with a linked list of properties per
+// particle cost 32 bytes plus a heap node of about 32 bytes per property:
+// 1.3x more without properties, 2.3x with one and 3x or more with two or
+// more. Passes over a single field or property touch only that array and
+// can be vectorized.
+//
+// Time is kept in double precision, as unsteady advection compares
+// particle times against the time steps of the data.
+//
+// Particles are passed in and out by value. Special particles (separators)
+// are stored like all other particles, and have NaN for their properties.
+//
+// Stream is not expected to serve as a base class.
+class FLOW_API Stream final {
+public:
+    // Constructors.
+    // This class complies with rule of zero.
+    Stream() = default;
+
+    size_t size() const { return _time.size(); }
+    bool   empty() const { return _time.empty(); }
+    void   reserve(size_t n);
+    void   clear();
+
+    //
+    // Append a particle at the end of the stream, or insert one before position i.
+    // Property columns are padded with NaN.
+    //
+    void push_back(const Particle &p);
+    void insert(size_t i, const Particle &p);
+
+    //
+    // Retrieve or overwrite the particle at position i. Properties are not affected.
+    //
+    Particle operator[](size_t i) const { return Particle(_x[i], _y[i], _z[i], _time[i], _value[i]); }
+    Particle back() const { return (*this)[size() - 1]; }
+    void     Set(size_t i, const Particle &p);
+
+    //
+    // Per-field access to the particle at position i
+    //
+    glm::vec3 GetLocation(size_t i) const { return glm::vec3(_x[i], _y[i], _z[i]); }
+    double    GetTime(size_t i) const { return _time[i]; }
+    float     GetValue(size_t i) const { return _value[i]; }
+    void      SetValue(size_t i, float v) { _value[i] = v; }
+    bool      IsSpecial(size_t i) const { return (std::isnan(_time[i]) && std::isnan(_value[i])); }
+
+    //
+    // The contiguous arrays backing the stream, each with size() elements
+    //
+    const float * X() const { return _x.data(); }
+    const float * Y() const { return _y.data(); }
+    const float * Z() const { return _z.data(); }
+    const double *Times() const { return _time.data(); }
+    const float * Values() const { return _value.data(); }
+    float *       Values() { return _value.data(); }
+
+    //
+    // The "property" columns allow the user to keep one or more arbitrary values that
+    // are associated with each particle. It's up to the user to keep a record on
+    // what these values at each column stand for.
+    //
+    // Add a property column, initialized to NaN, and return its index.
+    size_t AddProperty();
+    // Remove the property column at a certain index.
+    // If the index is out of bound, then nothing is performed
+    void   RemoveProperty(size_t k);
+    void   ClearProperties();
+    size_t GetNumOfProperties() const { return _properties.size(); }
+
+    float        GetProperty(size_t k, size_t i) const { return _properties[k][i]; }
+    void         SetProperty(size_t k, size_t i, float v) { _properties[k][i] = v; }
+    const float *Property(size_t k) const { return _properties[k].data(); }
+    float *      Property(size_t k) { return _properties[k].data(); }
+
+    // Approximate number of bytes of heap memory held by this stream
+    size_t GetMemoryUsage() const;
+
+private:
+    std::vector<float>              _x, _y, _z;
+    std::vector<double>             _time;
+    std::vector<float>              _value;
+    std::vector<std::vector<float>> _properties;
+};
+
+};    // namespace flow
+
+#endif
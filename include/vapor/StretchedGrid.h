@@ -89,10 +89,21 @@ public:
         return (GetIndicesCell(coords, indices, dummy));
     };
 
+    //! Same as GetIndicesCell(const CoordType &, DimsType &, double[3]), but
+    //! on input \p indices holds a guess for the cell containing the point,
+    //! such as the cell found for a nearby point. The guess is tested before
+    //! searching the grid.
+    //
+    bool GetIndicesCellHint(const CoordType &coords, DimsType &indices, double wgts[3]) const;
+
     // \copydoc GetGrid::InsideGrid()
     //
     virtual bool InsideGrid(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     //! Returns reference to vector containing X user coordinates
     //!
     //! Returns reference to vector passed to constructor
@@ -161,7 +172,9 @@ private:
 
     void _stretchedGrid(const std::vector<double> &xcoords, const std::vector<double> &ycoords, const std::vector<double> &zcoords);
 
-    bool _insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double &xwgt, double &ywgt, double &zwgt) const;
+    // If useHint is true, i, j, and k on input hold a guess for the cell containing the point
+    //
+    bool _insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double &xwgt, double &ywgt, double &zwgt, bool useHint = false) const;
 };
 };    // namespace VAPoR
 #endif
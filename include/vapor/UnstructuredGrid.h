@@ -196,6 +196,31 @@ public:
     VDF_API friend std::ostream &operator<<(std::ostream &o, const UnstructuredGrid &sg);
 
 protected:
+    //! Storage for one value per vertex of a face
+    //!
+    //! Faces with up to 16 vertices are stored on the stack, so that
+    //! locating a point doesn't allocate memory. Larger faces use the heap.
+    //
+    template<typename T> class FaceBuffer {
+    public:
+        FaceBuffer(size_t n) : _ptr(n <= _capacity ? _stack : new T[n]) {}
+        ~FaceBuffer()
+        {
+            if (_ptr != _stack) delete[] _ptr;
+        }
+        FaceBuffer(const FaceBuffer &) = delete;
+        FaceBuffer &operator=(const FaceBuffer &) = delete;
+
+        T *      data() { return (_ptr); }
+        T &      operator[](size_t i) { return (_ptr[i]); }
+        const T &operator[](size_t i) const { return (_ptr[i]); }
+
+    private:
+        static const size_t _capacity = 16;
+        T                   _stack[_capacity];
+        T *                 _ptr;
+    };
+
     const int *_vertexOnFace;
     const int *_faceOnVertex;
     const int *_faceOnFace;
@@ -58,12 +58,7 @@ public:
 
     virtual void GetUserCoordinates(const DimsType &indices, CoordType &coords) const override;
 
-    bool GetIndicesCell(const CoordType &coords, DimsType &indices) const override
-    {
-        std::vector<double>              lambda;
-        std::vector<std::vector<size_t>> nodes;
-        return (GetIndicesCell(coords, indices, nodes, lambda));
-    }
+    bool GetIndicesCell(const CoordType &coords, DimsType &indices) const override;
     // For grandparent inheritance of
     // Grid::GetIndicesCell(const double coords[3], size_t indices[3])
     //
@@ -77,12 +72,36 @@ public:
     //!
     bool GetIndicesCell(const CoordType &coords, DimsType &indices, std::vector<std::vector<size_t>> &nodes, std::vector<double> &lambda) const;
 
+    //! Locate the face containing a point, without allocating memory
+    //!
+    //! \param[in] coords Coordinates of the point. Only X and Y are used.
+    //! \param[in,out] face The face containing \p coords. If \p useHint
+    //! is true, on input a guess for the face, e.g. the face found for a
+    //! nearby point. The guess and its neighbors are tested before
+    //! searching the whole grid.
+    //! \param[out] nodes Indices of the vertices of \p face. Must have
+    //! room for GetMaxVertexPerFace() elements
+    //! \param[out] lambda Interpolation weights of the vertices in
+    //! \p nodes. Must have room for GetMaxVertexPerFace() elements
+    //! \param[out] nlambda Number of vertices of \p face
+    //! \param[in] useHint If true, \p face is tested first
+    //!
+    //! \retval inside False if \p coords is not inside the grid
+    //!
+    //! \sa GetIndicesCell()
+    //
+    bool FindFace(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const;
+
     bool InsideGrid(const CoordType &coords) const override;
 
     float GetValueNearestNeighbor(const CoordType &coords) const override;
 
     float GetValueLinear(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     /////////////////////////////////////////////////////////////////////////////
     //
     // Iterators
@@ -133,15 +152,19 @@ private:
     UnstructuredGridCoordless                 _zug;
     std::shared_ptr<const QuadTreeRectangleP> _qtr;
 
-    bool _insideGrid(const CoordType &coords, size_t &face, std::vector<size_t> &nodes, double *lambda, int &nlambda) const;
+    bool _insideGrid(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const;
 
-    bool _insideGridNodeCentered(const CoordType &coords, size_t &face, std::vector<size_t> &nodes, double *lambda, int &nlambda) const;
+    bool _insideGridNodeCentered(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const;
 
-    bool _insideGridFaceCentered(const CoordType &coords, size_t &face, std::vector<size_t> &nodes, double *lambda, int &nlambda) const;
+    bool _insideGridFaceCentered(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const;
 
     bool _pointInsideBoundingRectangle(const double pt[], const double verts[], int n) const;
 
-    bool _insideFace(size_t face, double pt[2], std::vector<size_t> &node_indices, double *lambda, int &nlambda) const;
+    bool _insideFace(size_t face, const double pt[2], size_t *node_indices, double *lambda, int &nlambda) const;
+
+    bool _insideNeighborFace(size_t &face, const double pt[2], size_t *node_indices, double *lambda, int &nlambda) const;
+
+    float _interpolateLinear(const size_t *nodes, const double *lambda, int nlambda) const;
 
     std::shared_ptr<QuadTreeRectangleP> _makeQuadTreeRectangle() const;
 };
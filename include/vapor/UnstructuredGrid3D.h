@@ -6,6 +6,7 @@
 #include <vapor/common.h>
 #include <vapor/UnstructuredGrid2D.h>
 #include <vapor/QuadTreeRectangle.hpp>
+#include <vapor/CellIndex3D.h>
 
 
 #ifdef WIN32
@@ -15,25 +16,39 @@
 namespace VAPoR {
 
 //! \class UnstructuredGrid3D
-//! \brief class for a Layered unstructured grid.
+//! \brief class for a fully unstructured 3D grid.
+//!
+//! The cells are tetrahedra, pyramids, wedges (triangular prisms) or
+//! hexahedra, distinguished by their number of nodes (4, 5, 6 or 8). The
+//! nodes of a cell are ordered following the UGRID convention: the nodes
+//! of the bottom face counter-clockwise, followed by the top face or apex.
+//! Other cells are ignored when locating points.
+//!
+//! Points are located with a CellIndex3D. Values are interpolated with
+//! barycentric coordinates in tetrahedra, and trilinearly in the other
+//! cells, pyramids and wedges being treated as hexahedra with collapsed
+//! edges.
 //!
 //
 class VDF_API UnstructuredGrid3D : public UnstructuredGrid {
 public:
-    //! Construct a unstructured grid sampling Layered scalar function
+    //! Construct a unstructured grid sampling a 3D scalar function
     //!
+    //! \param[in] index A CellIndex3D instance for the cells of the grid,
+    //! e.g. one returned by GetCellIndex() for another grid with the same
+    //! coordinates. If NULL the class will build its own.
     //
     UnstructuredGrid3D(const DimsType &vertexDims, const DimsType &faceDims, const DimsType &edgeDims, const DimsType &bs, const std::vector<float *> &blks, const int *vertexOnFace,
                        const int *faceOnVertex, const int *faceOnFace,
                        Location location,    // node,face, edge
                        size_t maxVertexPerFace, size_t maxFacePerVertex, long nodeOffset, long cellOffset, const UnstructuredGridCoordless &xug, const UnstructuredGridCoordless &yug,
-                       const UnstructuredGridCoordless &zug);
+                       const UnstructuredGridCoordless &zug, std::shared_ptr<const CellIndex3D> index = nullptr);
 
     UnstructuredGrid3D(const std::vector<size_t> &vertexDims, const std::vector<size_t> &faceDims, const std::vector<size_t> &edgeDims, const std::vector<size_t> &bs, const std::vector<float *> &blks,
                        const int *vertexOnFace, const int *faceOnVertex, const int *faceOnFace,
                        Location location,    // node,face, edge
                        size_t maxVertexPerFace, size_t maxFacePerVertex, long nodeOffset, long cellOffset, const UnstructuredGridCoordless &xug, const UnstructuredGridCoordless &yug,
-                       const UnstructuredGridCoordless &zug);
+                       const UnstructuredGridCoordless &zug, std::shared_ptr<const CellIndex3D> index = nullptr);
 
     UnstructuredGrid3D() = default;
     virtual ~UnstructuredGrid3D() = default;
@@ -54,6 +69,12 @@ public:
     float        GetValueNearestNeighbor(const CoordType &coords) const override;
     float        GetValueLinear(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
+    std::shared_ptr<const CellIndex3D> GetCellIndex() const { return (_index); }
+
 
     /////////////////////////////////////////////////////////////////////////////
     //
@@ -107,6 +128,25 @@ private:
     UnstructuredGridCoordless _yug;
     UnstructuredGridCoordless _zug;
 
-    bool _insideGrid(const CoordType &coords, DimsType &cindices, std::vector<size_t> &nodes2D, std::vector<double> &lambda, float zwgt[2]) const;
+    std::shared_ptr<const CellIndex3D> _index;
+
+    static const int maxCellNodes = 8;
+
+    std::shared_ptr<CellIndex3D> _makeCellIndex() const;
+
+    // Return the number of nodes of a cell, and their indices in nodes.
+    // Zero if the cell is not a supported type
+    //
+    int _cellNodes(size_t cell, size_t nodes[maxCellNodes]) const;
+
+    bool _insideCell(size_t cell, const double pt[3], size_t nodes[maxCellNodes], double lambda[maxCellNodes], int &nnodes) const;
+
+    // Search for the cell containing a point. If useHint is true, cell on
+    // input is a guess for the cell containing the point, which is tested
+    // first, followed by the cells sharing a node with it.
+    //
+    bool _insideGrid(const CoordType &coords, size_t &cell, size_t nodes[maxCellNodes], double lambda[maxCellNodes], int &nnodes, bool useHint) const;
+
+    float _interpolateLinear(const size_t nodes[maxCellNodes], const double lambda[maxCellNodes], int nnodes) const;
 };
 };    // namespace VAPoR
@@ -62,6 +62,10 @@ public:
 
     float GetValueLinear(const CoordType &coords) const override;
 
+    //! \copydoc Grid::GetValues()
+    //
+    virtual void GetValues(const CoordType *coords, size_t n, float *values) const override;
+
     /////////////////////////////////////////////////////////////////////////////
     //
     // Iterators
@@ -111,7 +115,13 @@ private:
     UnstructuredGrid2D        _ug2d;
     UnstructuredGridCoordless _zug;
 
-    bool _insideGrid(const CoordType &coords, DimsType &cindices, std::vector<size_t> &nodes2D, std::vector<double> &lambda, float zwgt[2]) const;
+    bool _insideGrid(const CoordType &coords, DimsType &cindices, size_t *nodes2D, double *lambda, int &nlambda, float zwgt[2], bool useHint) const;
+
+    float _layerZ(const size_t *nodes2D, const double *lambda, int nlambda, size_t k) const;
+
+    bool _findLayer(const size_t *nodes2D, const double *lambda, int nlambda, double z, size_t &k, double &z0, double &z1, bool useHint) const;
+
+    float _interpolateLinear(const size_t *nodes2D, const double *lambda, int nlambda, size_t k0, const float zwgt[2]) const;
 };
 };    // namespace VAPoR
 
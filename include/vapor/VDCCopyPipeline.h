@@ -0,0 +1,135 @@
+#include <vector>
+#include <string>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include "vapor/MyBase.h"
+#include "vapor/DC.h"
+#include "vapor/VDCNetCDF.h"
+
+#ifndef _VDCCopyPipeline_H_
+    #define _VDCCopyPipeline_H_
+
+namespace VAPoR {
+
+//! \class VDCCopyPipeline
+//!	\ingroup Public_VDC
+//!
+//! \brief Copy variables from a DC to a VDC with overlapped reading,
+//! compression, and writing
+//!
+//! VDCNetCDF::CopyVar() reads, compresses, and writes a variable one
+//! time step after the other, so processors are idle while data are
+//! read and the disk is idle while data are compressed. This class copies
+//! variables with a two stage pipeline: a reader thread reads
+//! time steps from the source DC into memory while a writer thread
+//! compresses and writes earlier time steps to the VDC. The reader runs
+//! ahead across variable boundaries, so the next variable is read
+//! while the current one is still being written. At most \p inflight
+//! time steps are held in memory at once.
+//!
+//! Compression within the writer is performed by the VDC's WASP worker
+//! threads (see VDCNetCDF::VDCNetCDF()). Neither the NetCDF library nor
+//! the DC and VDC classes are thread safe. Hence all calls into the DC and
+//! VDC are serialized by an I/O lock, which the VDC releases while its
+//! worker threads compress blocks (see VDCNetCDF::SetIOMutex()).
+//!
+class VDF_API VDCCopyPipeline : public Wasp::MyBase {
+public:
+    //! Invoked by the writer thread after each time step is written
+    //
+    typedef std::function<void(const string &varname, size_t ts)> ProgressCallback;
+
+    //! Class constructor
+    //!
+    //! \param[in] dc The initialized source data collection
+    //! \param[in] vdc The destination VDC, initialized for appending, and
+    //! defining all of the variables to be copied
+    //! \param[in] inflight Maximum number of time steps held in memory
+    //! by the pipeline. Values less than 2 are treated as 2.
+    //
+    VDCCopyPipeline(DC &dc, VDCNetCDF &vdc, int inflight);
+    virtual ~VDCCopyPipeline();
+
+    //! Set a function to report progress
+    //
+    void SetProgressCallback(ProgressCallback callback) { _progress = callback; }
+
+    //! Copy variables from the DC to the VDC
+    //!
+    //! Time steps 0 to \p numts - 1 of each of the variables named by
+    //! \p varnames are copied, in order. If a data variable has a
+    //! mask variable in the VDC that does not yet exist on disk the mask is
+    //! computed from the source variable's missing value and written
+    //! before the variable itself, as done by cf2vdc.
+    //!
+    //! \param[in] varnames Names of the variables to copy
+    //! \param[in] numts Maximum number of time steps to copy, or -1
+    //! to copy all time steps
+    //! \param[in] stopOnError If true stop at the first failure.
+    //! Otherwise continue with the remaining time steps and variables.
+    //!
+    //! \retval status A negative int is returned if any time step of
+    //! any variable failed to be copied
+    //
+    int Copy(const std::vector<string> &varnames, int numts, bool stopOnError);
+
+    //! Print throughput statistics of each pipeline stage
+    //!
+    //! Statistics are accumulated over all calls to Copy()
+    //
+    void PrintStats(std::ostream &o) const;
+
+private:
+    // A single time step of a variable
+    //
+    class Item {
+    public:
+        string                     varname;
+        size_t                     ts = 0;
+        bool                       isFloat = true;
+        std::vector<float>         fdata;
+        std::vector<int>           idata;
+        string                     maskvar;
+        std::vector<unsigned char> mask;
+        int                        status = 0;
+    };
+
+    // Per-stage statistics
+    //
+    class Stats {
+    public:
+        size_t items = 0;
+        size_t bytes = 0;
+        double busy = 0.0;       // seconds spent reading or writing
+        double stalled = 0.0;    // seconds waiting on the other stage
+    };
+
+    DC &       _dc;
+    VDCNetCDF &_vdc;
+    int        _inflight;
+
+    ProgressCallback _progress;
+
+    std::mutex                        _ioMutex;    // Serializes DC, VDC, and NetCDF calls
+    std::mutex                        _queueMutex;
+    std::condition_variable           _queueCond;
+    std::deque<std::unique_ptr<Item>> _queue;
+    int                               _nfree;    // Free buffers
+    bool                              _abort;
+
+    Stats  _readStats;
+    Stats  _writeStats;
+    double _wallTime;
+
+    void _reader(std::vector<string> varnames, int numts);
+    int  _read(Item &item);
+    int  _write(Item &item);
+    int  _writeMask(const Item &item);
+};
+};    // namespace VAPoR
+
+#endif
@@ -1,7 +1,9 @@
 #include <vector>
 #include <map>
+#include <list>
 #include <algorithm>
 #include <iostream>
+#include <mutex>
 #include "vapor/VDC.h"
 #include "vapor/WASP.h"
 
@@ -169,6 +171,45 @@ public:
     //
     int SetFill(int fillmode);
 
+    //! Share the NetCDF library with other application threads
+    //!
+    //! Provide a mutex that the application holds whenever it calls
+    //! into this class, and around any other use of the NetCDF library.
+    //! The mutex is released while data are compressed or decompressed,
+    //! so that other threads may perform I/O concurrently.
+    //!
+    //! \sa WASP::SetIOMutex()
+    //
+    void SetIOMutex(std::mutex *mutex);
+
+    //! Set the maximum number of idle data files kept open for reading
+    //!
+    //! When the VDC is opened for reading (VDC::R) data files remain
+    //! open after the variables read from them are closed, so that later
+    //! reads from the same files, e.g. of other time steps, need not reopen
+    //! them and parse their headers. Descriptors returned by
+    //! OpenVariableRead() for the same variable, refinement level, and
+    //! level-of-detail share a single open file. Once more than \p n files
+    //! are open the least recently used files that are not in use are
+    //! closed. A value of 0 closes files as soon as they are no longer in
+    //! use. The default is 32.
+    //!
+    //! \sa GetOpenFileStats()
+    //
+    void SetOpenFileLimit(size_t n);
+
+    //! Return statistics of the open data file pool
+    //!
+    //! \param[out] hits Number of reads that used a file that was already
+    //! open
+    //! \param[out] misses Number of reads that required a file to be
+    //! opened
+    //! \param[out] opens Number of data files opened for reading
+    //!
+    //! \sa SetOpenFileLimit()
+    //
+    void GetOpenFileStats(size_t &hits, size_t &misses, size_t &opens) const;
+
 protected:
     #ifndef DOXYGEN_SKIP_THIS
     virtual int _WriteMasterMeta();
@@ -185,6 +226,8 @@ protected:
 
     virtual bool variableExists(size_t ts, string varname, int reflevel = 0, int lod = 0) const;
 
+    virtual int getBlockRanges(size_t ts, string varname, std::vector<size_t> &bdims, std::vector<double> &ranges);
+
 private:
     string _version;
     WASP * _master;    // Master NetCDF file
@@ -215,6 +258,64 @@ private:
         double _mv;
     };
 
+    // A bounded pool of WASP files opened for reading. Files are
+    // reference counted: a file may be shared by any number of readers of
+    // the same variable, level, and lod. Idle files are kept open, and
+    // the least recently used are closed once the pool exceeds its
+    // capacity.
+    //
+    class WASPPool {
+    public:
+        WASPPool(int nthreads, size_t capacity);
+        ~WASPPool();
+
+        // Return a file with the variable opened for reading
+        //
+        WASP *Acquire(string path, string varname, int level, int lod);
+
+        // Return a file for querying metadata. The open variable, if any,
+        // is not changed
+        //
+        WASP *Acquire(string path);
+
+        // Returns false if 'wasp' isn't managed by the pool
+        //
+        bool Release(WASP *wasp);
+
+        void Clear();
+        void SetCapacity(size_t capacity);
+        void SetIOMutex(std::mutex *mutex);
+
+        size_t GetHits() const { return (_hits); }
+        size_t GetMisses() const { return (_misses); }
+        size_t GetOpens() const { return (_opens); }
+
+    private:
+        class Entry {
+        public:
+            WASP * wasp;
+            string path;
+            string varname;
+            int    level;
+            int    lod;
+            bool   varOpen;
+            int    refcount;
+        };
+
+        int              _nthreads;
+        size_t           _capacity;
+        std::mutex *     _ioMutex;
+        std::list<Entry> _entries;    // Most recently used first
+        size_t           _hits;
+        size_t           _misses;
+        size_t           _opens;
+
+        WASP *_open(string path);
+        void  _evict();
+    };
+
+    WASPPool _pool;
+
     Wasp::SmartBuf _sb_slice_buffer;
     Wasp::SmartBuf _mask_buffer;
 
@@ -223,6 +324,8 @@ private:
     size_t _variable_threshold;
     int    _nthreads;
 
+    std::mutex *_ioMutex;    // Application's NetCDF lock, if any
+
     int _WriteMasterDimensions();
     int _WriteMasterAttributes(string prefix, const map<string, Attribute> &atts);
     int _WriteMasterAttributes();
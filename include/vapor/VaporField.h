@@ -69,6 +69,10 @@ public:
                             glm::vec3 &vel) const override;       // output
     virtual int GetScalar(double time, const glm::vec3 &pos,      // input
                           float &scalar) const override;          // output
+    // Steady fields sample each velocity component of a batch of particles with one
+    // call to Grid::GetValues(). Unsteady fields query one particle at a time.
+    virtual void GetVelocities(const double *times, const glm::vec3 *pos, size_t n,    // input
+                               glm::vec3 *vels, int *rvs) const override;              // output
 
     //
     // Functions for interaction with VAPOR components
@@ -106,6 +110,18 @@ public:
     virtual auto LockParams() -> int override;
     virtual auto UnlockParams() -> int override;
 
+    //
+    // For unsteady fields, resolve the grids of all time steps spanning [startT, endT]
+    // once, and keep them in a table that is read-only until UnlockParams().
+    // Queries within that range then retrieve grids from the table without locking
+    // or allocating, so multiple threads can query this field concurrently.
+    // If the grids don't fit in the cache, or some of them can't be read, no table is
+    // kept, queries fall back to _getAGrid(), and a non-zero value is returned.
+    // Grids returned by _getAGrid() may be evicted by a later _getAGrid() call,
+    // so in that case queries must not be made concurrently.
+    //
+    virtual auto LockTimeRange(double startT, double endT) -> int override;
+
 private:
     //
     // Member variables
@@ -131,6 +147,11 @@ private:
     // Note on the cached scalar and velocity grids:
     // they act as a cache of _recentGrids, so kind of like a cache of cache.
     // This is due to the not-so-cheap cost of constructing keys and querying _recentGrids.
+    size_t                                          _c_table_ts0 = 0;    // first time step in the table
+    std::vector<std::array<const VAPoR::Grid *, 4>> _c_grid_table;       // 3 velocity grids + 1 scalar grid
+    // Note on the grid table:
+    // it is the unsteady counterpart of the cached grids above. Entry i keeps the grids
+    // of time step (_c_table_ts0 + i), which stay owned by _recentGrids.
 
     //
     // Member functions
@@ -145,6 +166,13 @@ private:
     // This failure will also be recorded to MyBase.
     // Note 1: If a variable name is empty, we then return a ConstantField.
     const VAPoR::Grid *_getAGrid(size_t timestep, const std::string &varName) const;
+
+    // Retrieve a grid from the grid table if the time step is in there, or from _getAGrid() otherwise.
+    // idx is 0, 1, 2 for the velocity variables, and 3 for the scalar variable.
+    const VAPoR::Grid *_getATableGrid(size_t timestep, int idx) const;
+
+    // Build the key that _recentGrids uses to identify a grid.
+    GridKey _makeKey(size_t timestep, const std::string &varName) const;
 };
 };    // namespace flow
 
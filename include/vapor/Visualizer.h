@@ -23,6 +23,8 @@
 #pragma once
 
 #include <map>
+#include <deque>
+#include <memory>
 #include <vapor/DataStatus.h>
 #include <vapor/ParamsMgr.h>
 #include <vapor/Renderer.h>
@@ -31,6 +33,9 @@
 
 namespace VAPoR {
 
+class ImageWriter;
+class ImageWriterPool;
+
 //! \class Visualizer
 //! \ingroup Public_Render
 //! \brief A class for performing OpenGL rendering in VAPOR GUI Window
@@ -153,6 +158,29 @@ public:
         return 0;
     }
 
+    //! Enable or disable asynchronous image capture
+    //!
+    //! By default captured images are read back from the GPU and encoded
+    //! before paintEvent() returns. When asynchronous capture is enabled
+    //! the read back is started at the end of paintEvent(), and the image
+    //! is collected by the next capture and encoded on worker threads
+    //! while later frames are rendered. Hence an image file may not be
+    //! complete until WaitForImageCapture() is called.
+    //!
+    //! \sa WaitForImageCapture(), ImageWriterPool
+    //
+    void SetImageCaptureAsync(bool onOff) { _asyncCapture = onOff; }
+    bool GetImageCaptureAsync() const { return _asyncCapture; }
+
+    //! Finish writing all captured images
+    //!
+    //! Must be called from the visualizer's OpenGL context.
+    //!
+    //! \return zero if successful, or -1 if any image captured
+    //! asynchronously since the last call failed to be written
+    //
+    int WaitForImageCapture();
+
     //! Draw a text banner at x, y coordinates
     //
     void DrawText(string text, int x, int y, int size, float color[3], int type = 0) { _vizFeatures->AddText(text, x, y, size, color, type); }
@@ -180,6 +208,23 @@ private:
     //! \return zero if successful
     int _captureImage(std::string path);
 
+    // Image captured asynchronously, waiting for its pixels to be read
+    // back into a pixel buffer object
+    //
+    class PendingCapture {
+    public:
+        std::unique_ptr<ImageWriter> writer;
+        unsigned int                 pbo = 0;
+        int                          width = 0;
+        int                          height = 0;
+        int                          crop[4] = {0, 0, 0, 0};    // x, y, width, height. Top row is y = 0
+    };
+
+    int  _createImageWriter(std::string path, int width, int height, std::unique_ptr<ImageWriter> &writer, int crop[4]) const;
+    int  _captureImageAsync(std::unique_ptr<ImageWriter> writer, int width, int height, const int crop[4]);
+    int  _flushPendingCaptures(size_t keep);
+    void _deletePixelBuffers();
+
     void _loadMatricesFromViewpointParams();
 
     //! Definition of OpenGL Vendors
@@ -219,6 +264,11 @@ private:
     bool   _imageCaptureEnabled;
     bool   _animationCaptureEnabled;
     string _captureImageFile;
+    bool   _asyncCapture;
+
+    std::unique_ptr<ImageWriterPool> _imageWriterPool;
+    std::deque<PendingCapture>       _pendingCaptures;
+    std::vector<unsigned int>        _freePixelBuffers;
 
     vector<Renderer *> _renderers;
     vector<Renderer *> _renderersToDestroy;
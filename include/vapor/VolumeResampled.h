@@ -4,13 +4,33 @@
 
 namespace VAPoR {
 
+//! \class VolumeResampled
+//! \ingroup Public_Render
+//!
+//! \brief Renders a non-regular grid by resampling it onto a regular grid
+//!
+//! The grid is resampled with Grid::ResampleRegular() and rendered by
+//! VolumeRegular. The resolution of the resampled grid is that of the
+//! original grid multiplied by the resolution scale. The secondary (color
+//! mapped) variable is resampled onto the same lattice.
+
 class VolumeResampled : public VolumeRegular {
 public:
-    VolumeResampled(GLManager *gl) : VolumeRegular(gl) {}
+    VolumeResampled(GLManager *gl, VolumeRenderer *renderer) : VolumeRegular(gl, renderer), _resolutionScale(1.f) {}
 
     static std::string GetName() { return "Resampled"; }
 
     virtual int LoadData(const Grid *grid);
+    virtual int LoadSecondaryData(const Grid *grid);
+
+    void  SetResolutionScale(float scale) { _resolutionScale = scale; }
+    float GetResolutionScale() const { return _resolutionScale; }
+
+private:
+    float    _resolutionScale;
+    DimsType _resampledDims;
+
+    int _loadDataResampled(const Grid *grid, Texture3D *dataTexture, Texture3D *missingTexture, bool *hasMissingData);
 };
 
 }    // namespace VAPoR
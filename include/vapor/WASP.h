@@ -5,6 +5,7 @@
 #include <vector>
 #include <map>
 #include <iostream>
+#include <mutex>
 #include <netcdf.h>
 #include <vapor/NetCDFCpp.h>
 #include <vapor/Compressor.h>
@@ -344,6 +345,60 @@ public:
     //!
     int InqVarWASP(string varname, bool &wasp) const;
 
+    //! Return the per-block value ranges of a variable
+    //!
+    //! Files written with WASP version 4 or later record the minimum and
+    //! maximum of the unmasked values of every block of a blocked
+    //! variable as it is written. Because reconstructed blocks are
+    //! clamped to the range of the original block data the ranges
+    //! bound the values returned at any level and level-of-detail.
+    //!
+    //! \param[in] varname The name of the variable
+    //! \param[out] bdims The number of blocks along each dimension, in
+    //! NetCDF order (slowest varying first), including any
+    //! unblocked (e.g. time) dimensions. Empty if no ranges are available
+    //! \param[out] ranges A min/max pair for each block, ordered like
+    //! \p bdims. A pair of NaNs indicates a block with no valid data.
+    //!
+    //! \retval status Returns a negative value on failure. Success is
+    //! returned, with empty \p bdims and \p ranges, if the variable has no
+    //! block ranges
+    //
+    virtual int InqVarBlockRanges(string varname, vector<size_t> &bdims, vector<double> &ranges) const;
+
+    //! Share the NetCDF library with other application threads
+    //!
+    //! The NetCDF library is not thread safe. An application that
+    //! accesses NetCDF files from more than one of its own threads (e.g.
+    //! reading one data set while writing another) may serialize its
+    //! NetCDF calls with a mutex. If the mutex is provided here
+    //! the caller must hold it when calling any method of this class.
+    //! While blocks are transformed by the WASP worker threads the
+    //! caller's hold on \p mutex is released, and the worker threads
+    //! acquire it only to read or write individual blocks, allowing other
+    //! threads to perform I/O concurrently with compression and
+    //! decompression.
+    //!
+    //! \param[in] mutex A mutex held by callers of this class, or NULL
+    //! (the default) if NetCDF calls don't need to be coordinated with
+    //! other threads
+    //
+    void SetIOMutex(std::mutex *mutex) { _ioMutex = mutex; }
+
+    //! Enable or disable staged reads of compressed variables
+    //!
+    //! By default the encoded blocks of a compressed read are fetched in
+    //! large batches, one read per file, and then reconstructed in
+    //! parallel. If disabled each block is fetched individually by the
+    //! worker thread that reconstructs it. Both give identical results.
+    //! Staged reads apply to the external types NC_FLOAT, NC_DOUBLE,
+    //! NC_INT, NC_INT64 and NC_SHORT.
+    //!
+    //! \param[in] enable Boolean enabling staged reads
+    //
+    void SetStagedReads(bool enable) { _stagedReads = enable; }
+    bool GetStagedReads() const { return (_stagedReads); }
+
     //! Prepare a variable for writing
     //!
     //! Compressed or blocked variables must be opened prior to writing.
@@ -628,6 +683,13 @@ public:
     //! NetCDF attribute name specifying WASP version number
     static string AttNameVersion() { return ("WASP.Version"); }
 
+    //! Name of the NetCDF variable holding the per-block ranges of
+    //! variable \p name
+    static string BlockRangeVarName(string name) { return (name + ".WASP.BlockRange"); }
+
+    //! NetCDF dimension name for the min/max pair of a block range
+    static string DimNameBlockRange() { return ("WASP.BlockRange"); }
+
 private:
     Wasp::EasyThreads * _et;
     int                 _nthreads;
@@ -640,6 +702,8 @@ private:
     Wasp::SmartBuf      _blockbuf;          // Dynamic storage for blocks
     Wasp::SmartBuf      _coeffbuf;          // Dynamic storage wavelet coefficients
     Wasp::SmartBuf      _sigbuf;            // Dynamic storage encoded signficance maps
+    std::mutex *        _ioMutex;           // Application's NetCDF lock
+    bool                _stagedReads;       // Fetch encoded blocks in batches?
 
     bool                 _open;                // compressed variable open for reading or writing?
     string               _open_wname;          // wavelet name of opened variable
@@ -661,6 +725,7 @@ private:
                            vector<string> &encoded_dim_names, vector<size_t> &encoded_dims) const;
 
     int _InqDimlen(string name, size_t &len) const;
+    bool _hasBlockRanges(string varname) const;
 
     void _get_encoding_vectors(string wname, vector<size_t> bs, vector<size_t> cratios, int xtype, vector<size_t> &ncoeffs, vector<size_t> &encoded_dims) const;
 
@@ -676,6 +741,12 @@ private:
 
     template<class T> int _GetVara(vector<size_t> start, vector<size_t> count, bool unblock_flag, T *data);
 
+    // Fetch the encoded blocks of a compressed read in large batches, then
+    // reconstruct each batch in parallel. The staging buffer is freed
+    // before returning
+    //
+    int _getVaraStaged(const vector<size_t> &start, const vector<size_t> &count, const vector<size_t> &bs, const vector<size_t> &encoded_dims, const vector<void *> &argvec);
+
     static void _dims_at_level(vector<size_t> dims, vector<size_t> bs, int level, string wname, vector<size_t> &dims_level, vector<size_t> &bs_level);
 
     static vector<string> mkmultipaths(string path, int n);
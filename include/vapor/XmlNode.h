@@ -10,6 +10,7 @@
 #include <vector>
 #include <string>
 #include <stack>
+#include <memory>
 #include <vapor/MyBase.h>
 #ifdef WIN32
     #pragma warning(disable : 4251)
@@ -50,7 +51,7 @@ class PARAMS_API XmlNode : public Wasp::MyBase {
 public:
     //! Constructor for the XmlNode class.
     //!
-    //! Create's a new Xml node
+    //! Creates a new Xml node
     //!
     //! \param[in] tag Name of Xml node
     //! \param[in] attrs A list of Xml attribute names and values for this node
@@ -66,13 +67,26 @@ public:
 
     //! Copy constructor for the XmlNode class.
     //!
-    //! Create's a new XmlNode node from an existing one. The new
+    //! Creates a new XmlNode node from an existing one. The new
     //! node will be parentless.
     //!
     //! \param[in] node XmlNode instance from which to construct a copy
     //!
     XmlNode(const XmlNode &node);
 
+    class Snapshot;
+
+    //! Construct an XmlNode tree from a snapshot
+    //!
+    //! Creates a new, parentless, XmlNode tree equal to the tree from which
+    //! \p snapshot was taken.
+    //!
+    //! \param[in] snapshot A snapshot returned by TakeSnapshot()
+    //!
+    //! \sa TakeSnapshot()
+    //
+    XmlNode(const Snapshot &snapshot);
+
     virtual XmlNode *Clone() { return new XmlNode(*this); };
 
     //! Destructor
@@ -88,17 +102,29 @@ public:
     //!
     //! \retval tag A reference to the node's tag
     //
-    string &Tag() { return (_tag); }
+    string &Tag()
+    {
+        _setModified();
+        return (_tag);
+    }
 
     string GetTag() const { return (_tag); }
 
-    void SetTag(string tag) { _tag = tag; }
+    void SetTag(string tag)
+    {
+        _setModified();
+        _tag = tag;
+    }
 
     //! Set or get that node's attributes
     //!
     //! \retval attrs A reference to the node's attributes
     //
-    map<string, string> &Attrs() { return (_attrmap); }
+    map<string, string> &Attrs()
+    {
+        _setModified();
+        return (_attrmap);
+    }
 
     // These methods set or get XML character data, possibly formatting
     // the data in the process. The paramter 'tag' identifies the XML
@@ -466,6 +492,58 @@ public:
     bool operator==(const XmlNode &rhs) const;
     bool operator!=(const XmlNode &rhs) const { return (!(*this == rhs)); };
 
+    //! \class Snapshot
+    //! \brief An immutable copy of an XmlNode tree
+    //!
+    //! Snapshots of a tree share the subtrees that did not change between
+    //! them. Hence keeping many snapshots of a large tree costs little more
+    //! than the parts of the tree that changed, and comparing two snapshots
+    //! only visits the subtrees that differ.
+    //!
+    //! \sa TakeSnapshot()
+    //
+    class PARAMS_API Snapshot {
+    public:
+        //! Equivalence operator. Same semantics as XmlNode::operator==()
+        //
+        bool operator==(const Snapshot &rhs) const;
+        bool operator!=(const Snapshot &rhs) const { return (!(*this == rhs)); };
+
+    private:
+        map<string, vector<long>>               _longmap;
+        map<string, vector<double>>             _doublemap;
+        map<string, string>                     _stringmap;
+        map<string, string>                     _attrmap;
+        vector<std::shared_ptr<const Snapshot>> _children;
+        string                                  _tag;
+        size_t                                  _asciiLimit;
+
+        bool                            _equalData(const XmlNode &node) const;
+        std::shared_ptr<const Snapshot> _findChild(const string &tag, size_t hint) const;
+
+        friend class XmlNode;
+    };
+
+    typedef std::shared_ptr<const Snapshot> SnapshotPtr;
+
+    //! Take a snapshot of the tree rooted at this node
+    //!
+    //! Every node records whether it, or any of its descendants, has
+    //! been modified since the last snapshot was taken. Unmodified
+    //! subtrees are not copied: the corresponding subtree of \p prev is
+    //! shared instead. Modified nodes are compared with their
+    //! counterparts in \p prev, and shared too if they are equal.
+    //! Hence \p prev should be the snapshot returned by the previous
+    //! call for this tree, or a snapshot of a tree equal to the one
+    //! returned by the previous call.
+    //!
+    //! \param[in] prev A previous snapshot of this tree, or NULL, in which
+    //! case the whole tree is copied
+    //!
+    //! \retval snapshot A snapshot of the tree
+    //
+    SnapshotPtr TakeSnapshot(const SnapshotPtr &prev) const;
+
     //! Return boolean indicating if this node is the root of the tree
     //!
     //! This method returns true if the node is the root if the tree. I.e.
@@ -521,6 +599,11 @@ private:
 
     size_t   _asciiLimit;    // length limit beyond which element data are encoded
     XmlNode *_parent;        // Node's parent
+
+    mutable bool _modified;    // Node or descendants changed since last snapshot
+
+    void _setModified();
+    void _setModifiedAll();
 };
 // ostream& VAPoR::operator<< (ostream& os, const XmlNode& node);
 
@@ -141,6 +141,13 @@ COMMON_API void Transpose(const float *a, float *b, size_t s1, size_t s2);
 //
 COMMON_API bool BinarySearchRange(const std::vector<double> &sorted, double x, size_t &i);
 
+// Same as BinarySearchRange(), but on input 'i' holds a guess for the
+// interval containing 'x', e.g. the result of a previous search for a nearby
+// value. The guess is tested first, and 'sorted' is only searched if the
+// guess is wrong. The result is identical to BinarySearchRange()'s.
+//
+COMMON_API bool BinarySearchRangeHint(const std::vector<double> &sorted, double x, size_t &i);
+
 //! Floating point comparison for near equality.
 //!
 //! Perform a floating point comparison to see if two values are nearly equal;
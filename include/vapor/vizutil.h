@@ -103,6 +103,50 @@ double SignedTriArea2D(const double a[2], const double b[2], const double c[2]);
 //! are positive.
 bool BarycentricCoordsTri(const double verts[], const double pt[], double lambda[]);
 
+//! Compute the Barycentric coordinates for a point inside a tetrahedron
+//!
+//! \param[in] verts a 12-element array of 3D tetrahedron Cartesian
+//! coordinates, ordered x1, y1, z1, x2, y2, z2, etc.
+//! \param[in] pt the 3D Cartesian coordinates
+//! \param[out] lambda Barycentric coordinates for point \p pt.
+//!
+//! \retval inside a flag indicating whether the point \p pt
+//! is inside (or on a face) of the tetrahedron. I.e. all of the
+//! Barycentric coordinates are positive. False if the tetrahedron
+//! is degenerate.
+//
+bool BarycentricCoordsTet(const double verts[], const double pt[], double lambda[]);
+
+//! Compute the trilinear interpolation weights for a point inside a
+//! hexahedron
+//!
+//! The parametric coordinates of the point are found with Newton's
+//! method, so the hexahedron may be distorted, provided it is not
+//! inverted. The ordering of the vertices follows the UGRID (and VTK)
+//! convention: the bottom face counter-clockwise, followed by the top face.
+//!
+//!       7*--------*6
+//!       /|       /|
+//!      / |      / |
+//!     /  |     /  |
+//!    /  3*----/---*2
+//!  4*--------*5  /
+//!   |  /     |  /
+//!   | /      | /
+//!   |/       |/
+//!  0*--------*1
+//!
+//! \param[in] verts a 24-element array of 3D hexahedron Cartesian
+//! coordinates, ordered x1, y1, z1, x2, y2, z2, etc.
+//! \param[in] pt the 3D Cartesian coordinates
+//! \param[out] lambda The eight interpolation weights for point \p pt.
+//!
+//! \retval inside a flag indicating whether the point \p pt
+//! is inside (or on a face) of the hexahedron. I.e. all of the
+//! weights are positive.
+//
+bool TrilinearCoordsHex(const double verts[], const double pt[], double lambda[]);
+
 //! Compute the Wachspress coordinates for a point inside an irregular,
 //! convex, n-sided, planar polygon.
 //!
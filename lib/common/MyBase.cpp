@@ -63,10 +63,23 @@ FILE *MyBase::DiagMsgFilePtr = NULL;
 #endif
 void (*MyBase::DiagMsgCB)(const char *msg) = NULL;
 
-bool MyBase::Enabled = true;
+namespace {
+// Error reporting is enabled or disabled separately for each thread
+//
+thread_local bool enabled = true;
+};    // namespace
 
 MyBase::MyBase() { SetClassName("MyBase"); }
 
+bool MyBase::EnableErrMsg(bool enable)
+{
+    bool prev = enabled;
+    enabled = enable;
+    return (prev);
+}
+
+bool MyBase::GetEnableErrMsg() { return (enabled); }
+
 void MyBase::_SetErrMsg(char **msgbuf, int *msgbufsz, const char *format, va_list args)
 {
     int       done = 0;
@@ -121,7 +134,7 @@ void MyBase::SetErrMsg(const char *format, ...)
 {
     va_list args;    // initialize to make valgrind shutup
 
-    if (!Enabled) return;
+    if (!enabled) return;
     ErrCode = 1;
 
     va_start(args, format);
@@ -137,7 +150,7 @@ void MyBase::SetErrMsg(int errcode, const char *format, ...)
 {
     va_list args;    // initialize to make valgrind shutup
 
-    if (!Enabled) return;
+    if (!enabled) return;
     ErrCode = errcode;
 
     va_start(args, format);
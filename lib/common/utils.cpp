@@ -218,6 +218,19 @@ bool Wasp::BinarySearchRange(const vector<double> &sorted, double x, size_t &i)
     return (true);
 }
 
+bool Wasp::BinarySearchRangeHint(const vector<double> &sorted, double x, size_t &i)
+{
+    // Only intervals of ascending vectors are tested. The last interval is
+    // closed, all others are half open, as in BinarySearchRange().
+    //
+    size_t n = sorted.size();
+    if (n > 1 && i + 1 < n && sorted[0] <= sorted[n - 1]) {
+        if (sorted[i] <= x && (x < sorted[i + 1] || (i + 2 == n && x == sorted[i + 1]))) return (true);
+    }
+
+    return (BinarySearchRange(sorted, x, i));
+}
+
 #ifdef DEPRECATED
 //
 // Remove after release 3.5
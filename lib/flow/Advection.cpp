@@ -1,5 +1,6 @@
 #include <iostream>
 #include "vapor/Advection.h"
+#include "vapor/OpenMPSupport.h"
 #include <fstream>
 #include <algorithm>
 
@@ -23,6 +24,9 @@ void Advection::UseSeedParticles(const std::vector<Particle> &seeds)
       _streams[i].push_back(seeds[i]);
 
     _separatorCount.assign(seeds.size(), 0);
+
+    // Properties belonged to the old streams
+    _propertyVarNames.clear();
 }
 
 int Advection::CheckReady() const
@@ -46,137 +50,186 @@ int Advection::AdvectSteps(Field *velocity, double deltaT, size_t maxSteps, ADVE
       return PARAMS_ERROR;
 
     // The particle advection process can be parallelized per particle
-    // Each stream represents a trajectory for a single particle
-    #pragma omp parallel for
-    for (size_t streamIdx = 0; streamIdx < _streams.size(); streamIdx++) {
-        auto& s = _streams[streamIdx];
-        size_t numberOfSteps = s.size() - _separatorCount[streamIdx];
-        while (numberOfSteps < maxSteps) {
-            auto &past0 = s.back();
-            if (past0.IsSpecial())    // If the last particle is marked "special,"
-                break;                // terminate stream immediately.
-
-            double dt = deltaT;
-            if (s.size() > 2)    // If there are at least 3 particles in the stream and
-            {                    // neither is a separator, we also adjust *dt*
-                const auto &past1 = s[s.size() - 2];
-                const auto &past2 = s[s.size() - 3];
-                if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
-                    // We enforce a factor of 20.0f as a limit of how much the step size
-                    // can be adjusted by _calcAdjustFactor().
-                    // I.e., the adjusted value can be at most 20X larger or 20X smaller.
-                    // The choice of 20.0f is just an empirical value that seems to work well.
-                    double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
-                    dt = past0.time - past1.time;    // step size used by last integration
-                    dt *= _calcAdjustFactor(past2, past1, past0);
-                    if (dt > 0)    // integrate forward
-                        dt = glm::clamp(dt, mindt, maxdt);
-                    else    // integrate backward
-                        dt = glm::clamp(dt, maxdt, mindt);
+    // Each stream represents a trajectory for a single particle.
+    // Streams are advected in cohorts: each round takes one step for all active
+    // streams of a cohort, so the velocity field is queried for all of them at once.
+    // Cohorts are kept small enough that all threads get a few of them.
+    const size_t maxCohortSize = 64;
+    const size_t cohortSize = glm::clamp(_streams.size() / (4 * size_t(omp_get_max_threads())), size_t(1), maxCohortSize);
+    const size_t numCohorts = (_streams.size() + cohortSize - 1) / cohortSize;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t cohortIdx = 0; cohortIdx < numCohorts; cohortIdx++) {
+        const size_t firstStream = cohortIdx * cohortSize;
+        const size_t lastStream = std::min(firstStream + cohortSize, _streams.size());
+
+        std::vector<size_t> active;    // indices of streams that are still advecting
+        for (size_t streamIdx = firstStream; streamIdx < lastStream; streamIdx++) active.push_back(streamIdx);
+
+        std::vector<Particle> past0s, p1s;
+        std::vector<double>   dts;
+        std::vector<int>      rvs;
+
+        while (!active.empty()) {
+            // Find the step size of every active stream, and drop the streams that are done
+            size_t numActive = 0;
+            past0s.resize(active.size());
+            dts.resize(active.size());
+            for (size_t streamIdx : active) {
+                auto&  s = _streams[streamIdx];
+                size_t numberOfSteps = s.size() - _separatorCount[streamIdx];
+                if (numberOfSteps >= maxSteps) continue;
+
+                // Particles are retrieved from the stream by value. Changes to
+                // past0 are written back with Set().
+                Particle past0 = s.back();
+                if (past0.IsSpecial())    // If the last particle is marked "special,"
+                    continue;             // terminate stream immediately.
+
+                double dt = deltaT;
+                if (s.size() > 2)    // If there are at least 3 particles in the stream and
+                {                    // neither is a separator, we also adjust *dt*
+                    const Particle past1 = s[s.size() - 2];
+                    const Particle past2 = s[s.size() - 3];
+                    if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
+                        // We enforce a factor of 20.0f as a limit of how much the step size
+                        // can be adjusted by _calcAdjustFactor().
+                        // I.e., the adjusted value can be at most 20X larger or 20X smaller.
+                        // The choice of 20.0f is just an empirical value that seems to work well.
+                        double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
+                        dt = past0.time - past1.time;    // step size used by last integration
+                        dt *= _calcAdjustFactor(past2, past1, past0);
+                        if (dt > 0)    // integrate forward
+                            dt = glm::clamp(dt, mindt, maxdt);
+                        else    // integrate backward
+                            dt = glm::clamp(dt, maxdt, mindt);
+                    }
                 }
+
+                active[numActive] = streamIdx;
+                past0s[numActive] = past0;
+                dts[numActive] = dt;
+                numActive++;
             }
+            active.resize(numActive);
+            past0s.resize(numActive);
+            dts.resize(numActive);
+            if (active.empty()) break;
 
-            Particle p1;
-            int      rv = 0;
+            p1s.assign(numActive, Particle());
+            rvs.assign(numActive, 0);
             switch (method) {
             case ADVECTION_METHOD::EULER:
-                rv = _advectEuler(velocity, past0, dt, p1);
-                _printNonZero(rv, __FILE__, __func__, __LINE__);
+                _advectEuler(velocity, past0s, dts, p1s, rvs);
                 break;
             case ADVECTION_METHOD::RK4:
-                rv = _advectRK4(velocity, past0, dt, p1);
-                _printNonZero(rv, __FILE__, __func__, __LINE__);
+                _advectRK4(velocity, past0s, dts, p1s, rvs);
                 break;
             }
 
-            if (rv == SUCCESS) {
-                // Bookmark_1
-                // The new particle *may* be the same as the old particle in case
-                // there's a sink, meaning the velocity is zero.
-                // In that case, we mark p1 as "special" and terminate the current stream.
-                if (p1.location == past0.location) {
-                    p1.SetSpecial(true);
-                    s.emplace_back(p1);
-                    _separatorCount[streamIdx]++;
-                    break;
-                } else {
-                    happened = true;
-                    s.emplace_back(p1);
-                    numberOfSteps++;
-                }
-            } else if (rv == MISSING_VAL) {
-                // Bookmark_2
-                // This is the annoying part: there are multiple possiblities.
-                // 1) past0 is really located at a missing value location;
-                // 2) past0 is inside the volume, but really close to the boundary,
-                //    causing RK4 method to fail;
-                // 3) past0 is not at a missing location, but out of the volume.
-                //
-                // Note that we need to detect and deal with each of these possibilities
-                //   here instead of using the periodic capabilities of a grid class,
-                //   because the advection code needs to have knowledge when a pathline
-                //   exits from one side and comes back from another sice, and record
-                //   this event by inserting a separator. The separator will later be used
-                //   by the rendering code to break a pathline into segments.
-
-                glm::vec3 vel;
-                bool isMissing = (velocity->GetVelocity(past0.time, past0.location, vel) == MISSING_VAL);
-                bool isInside = velocity->InsideVolumeVelocity(past0.time, past0.location);
-
-                if (isInside && isMissing) {    // Case 1)
-                    // We identified a particle at a bad location.
-                    // We mark it as special, and terminate the current stream.
-                    past0.SetSpecial(true);
-                    _separatorCount[streamIdx]++;
-                    break;
-                } else if (isInside && (!isMissing)) {    // Case 2)
-                    // Use Euler advection for this particle.
-                    rv = _advectEuler(velocity, past0, dt, p1);
-                    assert(rv == 0);
-                    s.emplace_back(p1);
-                    numberOfSteps++;
-                } else {    // Case 3)
-                    // We identified a particle that's out of the volume.
-                    // We treat it depending on field periodicity.
-                    // In case of no periodicity, we mark this particle special and
-                    //    terminate the current stream.
-                    // In case of periodicity enabled, we apply it!
-                    if ((!_isPeriodic[0]) && (!_isPeriodic[1]) && (!_isPeriodic[2])) {
-                        past0.SetSpecial(true);
+            // Append the new particles, and drop the streams that terminate
+            numActive = 0;
+            for (size_t a = 0; a < active.size(); a++) {
+                const size_t streamIdx = active[a];
+                auto&        s = _streams[streamIdx];
+                Particle     past0 = past0s[a];
+                Particle     p1 = p1s[a];
+                const double dt = dts[a];
+                int          rv = rvs[a];
+                bool         terminate = false;
+
+                if (rv == SUCCESS) {
+                    // Bookmark_1
+                    // The new particle *may* be the same as the old particle in case
+                    // there's a sink, meaning the velocity is zero.
+                    // In that case, we mark p1 as "special" and terminate the current stream.
+                    if (p1.location == past0.location) {
+                        p1.SetSpecial(true);
+                        s.push_back(p1);
                         _separatorCount[streamIdx]++;
-                        break;
+                        terminate = true;
                     } else {
-                        auto loc = past0.location;
-                        for (int i = 0; i < 3; i++) {
-                            if (_isPeriodic[i]) 
-                              loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
-                        }
-
-                        // Notice that loc isn't guaranteed to be inside the volume right now,
-                        // since periodic ain't enabled for all directions.
-                        // As a result, we need to test again
-                        if (velocity->InsideVolumeVelocity(past0.time, loc)) {
-                            past0.location = loc;
-                            Particle separator;
-                            separator.SetSpecial(true);
-                            auto it = s.end();
-                            --it;
-                            s.insert(it, separator);
-                            _separatorCount[streamIdx]++;
-                        } else {
+                        happened = true;
+                        s.push_back(p1);
+                    }
+                } else if (rv == MISSING_VAL) {
+                    // Bookmark_2
+                    // This is the annoying part: there are multiple possiblities.
+                    // 1) past0 is really located at a missing value location;
+                    // 2) past0 is inside the volume, but really close to the boundary,
+                    //    causing RK4 method to fail;
+                    // 3) past0 is not at a missing location, but out of the volume.
+                    //
+                    // Note that we need to detect and deal with each of these possibilities
+                    //   here instead of using the periodic capabilities of a grid class,
+                    //   because the advection code needs to have knowledge when a pathline
+                    //   exits from one side and comes back from another sice, and record
+                    //   this event by inserting a separator. The separator will later be used
+                    //   by the rendering code to break a pathline into segments.
+
+                    glm::vec3 vel;
+                    bool isMissing = (velocity->GetVelocity(past0.time, past0.location, vel) == MISSING_VAL);
+                    bool isInside = velocity->InsideVolumeVelocity(past0.time, past0.location);
+
+                    if (isInside && isMissing) {    // Case 1)
+                        // We identified a particle at a bad location.
+                        // We mark it as special, and terminate the current stream.
+                        past0.SetSpecial(true);
+                        s.Set(s.size() - 1, past0);
+                        _separatorCount[streamIdx]++;
+                        terminate = true;
+                    } else if (isInside && (!isMissing)) {    // Case 2)
+                        // Use Euler advection for this particle.
+                        rv = _advectEuler(velocity, past0, dt, p1);
+                        assert(rv == 0);
+                        s.push_back(p1);
+                    } else {    // Case 3)
+                        // We identified a particle that's out of the volume.
+                        // We treat it depending on field periodicity.
+                        // In case of no periodicity, we mark this particle special and
+                        //    terminate the current stream.
+                        // In case of periodicity enabled, we apply it!
+                        if ((!_isPeriodic[0]) && (!_isPeriodic[1]) && (!_isPeriodic[2])) {
                             past0.SetSpecial(true);
+                            s.Set(s.size() - 1, past0);
                             _separatorCount[streamIdx]++;
-                            break;
+                            terminate = true;
+                        } else {
+                            auto loc = past0.location;
+                            for (int i = 0; i < 3; i++) {
+                                if (_isPeriodic[i]) 
+                                  loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
+                            }
+
+                            // Notice that loc isn't guaranteed to be inside the volume right now,
+                            // since periodic ain't enabled for all directions.
+                            // As a result, we need to test again
+                            if (velocity->InsideVolumeVelocity(past0.time, loc)) {
+                                past0.location = loc;
+                                s.Set(s.size() - 1, past0);
+                                Particle separator;
+                                separator.SetSpecial(true);
+                                s.insert(s.size() - 1, separator);
+                                _separatorCount[streamIdx]++;
+                            } else {
+                                past0.SetSpecial(true);
+                                s.Set(s.size() - 1, past0);
+                                _separatorCount[streamIdx]++;
+                                terminate = true;
+                            }
                         }
                     }
-                }
 
-            }       // end (rv == MISSING_VAL) condition
-            else    // Advection wasn't successful for other reasons
-                break;
+                }       // end (rv == MISSING_VAL) condition
+                else    // Advection wasn't successful for other reasons
+                    terminate = true;
+
+                if (!terminate) active[numActive++] = streamIdx;
+            }    // end loop for the active streams of this round
+            active.resize(numActive);
 
-        }    // end loop for particle
-    }        // end loop for streams
+        }    // end loop for rounds
+    }        // end loop for cohorts
 
     velocity->UnlockParams();
 
@@ -191,11 +244,24 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
     int ready = CheckReady();
     if (ready != 0) return ready;
 
-    bool   happened = false;
-    size_t streamIdx = 0;
-    size_t maxSteps = 10000;
-    for (auto &s : _streams)    // Process one stream at a time
-    {
+    // User parameters are not gonna change while this function executes, and all queries
+    // fall in [startT, targetT + deltaT] (a step that isn't adjusted may go past targetT),
+    // so lock both of them.
+    if (velocity->LockParams() != 0) return PARAMS_ERROR;
+    const bool parallel = (velocity->LockTimeRange(startT, targetT + deltaT) == 0);
+
+    // Another termination criterion: when advecting more than 10,000 steps.
+    // Every stream gets the same limit, so that the result doesn't depend on
+    // the order in which streams are advected.
+    bool         happened = false;
+    const size_t maxSteps = 10000;
+
+    // The particle advection process can be parallelized per particle, as in AdvectSteps(),
+    // but only if the velocity field can be queried by multiple threads, i.e. all the grids
+    // needed are locked in. Otherwise grids retrieved by one thread may be evicted by another.
+    #pragma omp parallel for reduction(|| : happened) if (parallel)
+    for (size_t streamIdx = 0; streamIdx < _streams.size(); streamIdx++) {
+        auto &   s = _streams[streamIdx];
         Particle p0 = s.back();    // Start from the last particle in this stream
         if (p0.time < startT)      // Skip this stream if it didn't advance to startT
             continue;
@@ -210,10 +276,9 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
             // Check if the particle is inside of the volume.
             // Wrap it along periodic dimensions if applicable.
             if (!velocity->InsideVolumeVelocity(p0.time, p0.location)) {
-                bool locChanged = false;
-                auto itr = s.end();
-                --itr;    // pointing to the last element
-                auto loc = itr->location;
+                bool     locChanged = false;
+                Particle last = s.back();
+                auto     loc = last.location;
                 for (int i = 0; i < 3; i++) {
                     if (_isPeriodic[i]) {
                         loc[i] = _applyPeriodic(loc[i], _periodicBounds[i][0], _periodicBounds[i][1]);
@@ -229,13 +294,14 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
                 }
 
                 // See if the new location is inside of the volume
-                if (velocity->InsideVolumeVelocity(itr->time, loc)) {
-                    itr->location = loc;
-                    p0 = *itr;    // p0 is equal to the wrapped particle
+                if (velocity->InsideVolumeVelocity(last.time, loc)) {
+                    last.location = loc;
+                    s.Set(s.size() - 1, last);
+                    p0 = last;    // p0 is equal to the wrapped particle
 
                     Particle separator;
                     separator.SetSpecial(true);
-                    s.insert(itr, separator);
+                    s.insert(s.size() - 1, separator);
                     _separatorCount[streamIdx]++;
                 } else {  // Still outside, so we terminate the stream!
                     Particle separator;
@@ -251,8 +317,8 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
             {                    // we also adjust *dt*
                 double mindt = deltaT / 20.0, maxdt = deltaT * 20.0;
                 maxdt = glm::min(maxdt, targetT - p0.time);
-                const auto &past1 = s[s.size() - 2];
-                const auto &past2 = s[s.size() - 3];
+                const Particle past1 = s[s.size() - 2];
+                const Particle past2 = s[s.size() - 3];
                 if ((!past1.IsSpecial()) && (!past2.IsSpecial())) {
                     dt = p0.time - past1.time;    // step size used by last integration
                     dt *= _calcAdjustFactor(past2, past1, p0);
@@ -310,12 +376,10 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
 
                     if (velocity->InsideVolumeVelocity(p0.time, loc)) {
                         p1.SetSpecial(true);
-                        auto it = s.end();
-                        --it;
-                        s.insert(it, p1);
-                        it = s.end();
-                        --it;
-                        it->location = loc;
+                        s.insert(s.size() - 1, p1);
+                        Particle last = s.back();
+                        last.location = loc;
+                        s.Set(s.size() - 1, last);
                         _separatorCount[streamIdx]++;
                     } else {
                         p1.SetSpecial(true);
@@ -326,11 +390,7 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
                 }
             } // finish handling missing value
 
-            // Another termination criterion: when advecting at least 10,000 steps and
-            // more than 10X more than the previous max num of steps.
-            //
             if (++thisStep == maxSteps) {
-                thisStep = maxSteps / 10;
                 p1.SetSpecial(true);
                 s.push_back(p1);
                 _separatorCount[streamIdx]++;
@@ -338,12 +398,10 @@ int Advection::AdvectTillTime(Field *velocity, double startT, double deltaT, dou
             }
         }    // Finish advecting one particle
 
-        maxSteps = std::max(maxSteps, thisStep * 10);
-
-        streamIdx++;
-
     }    // Finish advecting all particles
 
+    velocity->UnlockParams();
+
     if (happened)
         return ADVECT_HAPPENED;
     else
@@ -359,17 +417,17 @@ int Advection::CalculateParticleValues(Field *scalar, bool skipNonZero)
         _valueVarName = scalar->ScalarName;
 
         for (auto &s : _streams) {
-            for (auto &p : s) {
+            for (size_t i = 0; i < s.size(); i++) {
                 // Skip this particle if it's a separator
-                if (p.IsSpecial()) continue;
+                if (s.IsSpecial(i)) continue;
 
                 // Do not evaluate this particle if its value is non-zero
-                if (skipNonZero && p.value != 0.0f) continue;
+                if (skipNonZero && s.GetValue(i) != 0.0f) continue;
 
                 float value;
-                int   rv = scalar->GetScalar(p.time, p.location, value);
-                if (rv == 0)            // The end of a stream could be outside of the volume,
-                    p.value = value;    // so let's only color it when the return value is 0.
+                int   rv = scalar->GetScalar(s.GetTime(i), s.GetLocation(i), value);
+                if (rv == 0)                // The end of a stream could be outside of the volume,
+                    s.SetValue(i, value);    // so let's only color it when the return value is 0.
             }
         }
 
@@ -387,15 +445,14 @@ int Advection::CalculateParticleValues(Field *scalar, bool skipNonZero)
         for (size_t i = 0; i < mostSteps; i++) {
             for (auto &s : _streams) {
                 if (i < s.size()) {
-                    auto &p = s[i];
-                    if (p.IsSpecial()) continue;
+                    if (s.IsSpecial(i)) continue;
 
                     // Do not evaluate this particle if its value is non-zero
-                    if (skipNonZero && p.value != 0.0f) continue;
+                    if (skipNonZero && s.GetValue(i) != 0.0f) continue;
 
                     float val;
-                    int   rv = scalar->GetScalar(p.time, p.location, val);
-                    if (rv == 0) p.value = val;
+                    int   rv = scalar->GetScalar(s.GetTime(i), s.GetLocation(i), val);
+                    if (rv == 0) s.SetValue(i, val);
                 }
             }    // end of a stream
         }        // end of all steps
@@ -415,13 +472,9 @@ int Advection::CalculateParticleIntegratedValues(Field *scalar, const bool skipN
         _valueVarName = scalar->ScalarName;
 
         for (auto &s : _streams) {
-            if (s.size() && !s[0].IsSpecial()) s[0].value = 0;
+            if (s.size() && !s.IsSpecial(0)) s.SetValue(0, 0);
 
-            for (int i = 1; i < s.size(); i++) {
-                auto &prev = s[i - 1];
-                auto &p = s[i];
-                _calculateParticleIntegratedValue(p, prev, scalar, skipNonZero, distScale, integrateWithinVolumeMin, integrateWithinVolumeMax);
-            }
+            for (size_t i = 1; i < s.size(); i++) { _calculateParticleIntegratedValue(s, i, scalar, skipNonZero, distScale, integrateWithinVolumeMin, integrateWithinVolumeMax); }
         }
 
         scalar->UnlockParams();
@@ -436,15 +489,11 @@ int Advection::CalculateParticleIntegratedValues(Field *scalar, const bool skipN
         _valueVarName = scalar->ScalarName;
 
         for (auto &s : _streams)
-            if (s.size() && !s[0].IsSpecial()) s[0].value = 0;
+            if (s.size() && !s.IsSpecial(0)) s.SetValue(0, 0);
 
         for (size_t i = 1; i < mostSteps; i++) {
             for (auto &s : _streams) {
-                if (i < s.size()) {
-                    auto &prev = s[i - 1];
-                    auto &p = s[i];
-                    _calculateParticleIntegratedValue(p, prev, scalar, skipNonZero, distScale, integrateWithinVolumeMin, integrateWithinVolumeMax);
-                }
+                if (i < s.size()) { _calculateParticleIntegratedValue(s, i, scalar, skipNonZero, distScale, integrateWithinVolumeMin, integrateWithinVolumeMax); }
             }    // end of a stream
         }        // end of all steps
     }
@@ -452,33 +501,34 @@ int Advection::CalculateParticleIntegratedValues(Field *scalar, const bool skipN
     return 0;
 }
 
-void Advection::_calculateParticleIntegratedValue(Particle &p, const Particle &prev, const Field *scalarField, const bool skipNonZero, const float distScale,
+void Advection::_calculateParticleIntegratedValue(Stream &s, size_t i, const Field *scalarField, const bool skipNonZero, const float distScale,
                                                   const std::vector<double> &integrateWithinVolumeMin, const std::vector<double> &integrateWithinVolumeMax) const
 {
     // Skip this particle if it is a separator
-    if (p.IsSpecial()) return;
-    if (prev.IsSpecial()) {
-        p.value = 0;
+    if (s.IsSpecial(i)) return;
+    if (s.IsSpecial(i - 1)) {
+        s.SetValue(i, 0);
         return;
     }
 
     // Do not evaluate this particle if its value is non-zero
-    if (skipNonZero && p.value != 0.0f) return;
+    if (skipNonZero && s.GetValue(i) != 0.0f) return;
 
-    if (!_isParticleInsideVolume(p, integrateWithinVolumeMin, integrateWithinVolumeMax)) {
-        p.value = prev.value;
+    const glm::vec3 loc = s.GetLocation(i);
+    if (!_isParticleInsideVolume(loc, integrateWithinVolumeMin, integrateWithinVolumeMax)) {
+        s.SetValue(i, s.GetValue(i - 1));
         return;
     }
 
     float value;
-    int   rv = scalarField->GetScalar(p.time, p.location, value);
+    int   rv = scalarField->GetScalar(s.GetTime(i), loc, value);
     if (rv != 0) {    // If non-0, then outside the volume
-        p.value = prev.value;
+        s.SetValue(i, s.GetValue(i - 1));
         return;
     }
 
-    float dist = glm::distance(prev.location, p.location);
-    p.value = prev.value + value * dist * distScale;
+    float dist = glm::distance(s.GetLocation(i - 1), loc);
+    s.SetValue(i, s.GetValue(i - 1) + value * dist * distScale);
 }
 
 void Advection::SetAllStreamValuesToFinalValue(int realNSamples)
@@ -487,18 +537,18 @@ void Advection::SetAllStreamValuesToFinalValue(int realNSamples)
         float finalValue = 0;
 
         int sampleCount = 0;
-        for (auto &p : s) {
-            if (!p.IsSpecial()) {
-                finalValue = p.value;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (!s.IsSpecial(i)) {
+                finalValue = s.GetValue(i);
                 sampleCount++;
             }
             if (sampleCount == realNSamples) break;
         }
 
         int setCount = 0;
-        for (auto &p : s) {
-            if (!p.IsSpecial()) {
-                p.value = finalValue;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (!s.IsSpecial(i)) {
+                s.SetValue(i, finalValue);
                 setCount++;
             }
             if (setCount == sampleCount) break;
@@ -516,10 +566,13 @@ int Advection::CalculateParticleProperties(Field *scalar)
 
     // Test if this scalar field is the same as the one used to calculate particle values,
     //   if so, copy over the values.
+    // Each stream gets a new property column, initialized to NaN.
+    // The column index is the same for all streams.
+    size_t k = 0;
+    for (auto &s : _streams) k = s.AddProperty();
+
     if (scalar->ScalarName == _valueVarName) {
-        for (auto &s : _streams) {
-            for (auto &p : s) { p.AttachProperty(p.value); }
-        }
+        for (auto &s : _streams) std::copy(s.Values(), s.Values() + s.size(), s.Property(k));
 
         return 0;
     }
@@ -529,14 +582,14 @@ int Advection::CalculateParticleProperties(Field *scalar)
         if (scalar->LockParams() != 0) return PARAMS_ERROR;
 
         for (auto &s : _streams) {
-            for (auto &p : s) {
-                if (p.IsSpecial()) continue;
+            for (size_t i = 0; i < s.size(); i++) {
+                if (s.IsSpecial(i)) continue;
 
                 // At the end of a flow line, a particle might be outside of the volume.
                 // We attach something in that case as well.
                 float val = std::nanf("1");
-                scalar->GetScalar(p.time, p.location, val);
-                p.AttachProperty(val);
+                scalar->GetScalar(s.GetTime(i), s.GetLocation(i), val);
+                s.SetProperty(k, i, val);
             }
         }
     } else {
@@ -547,12 +600,11 @@ int Advection::CalculateParticleProperties(Field *scalar)
         for (size_t i = 0; i < mostSteps; i++) {
             for (auto &s : _streams) {
                 if (i < s.size()) {
-                    auto &p = s[i];
-                    if (p.IsSpecial()) continue;
+                    if (s.IsSpecial(i)) continue;
 
                     float value = std::nanf("1");
-                    scalar->GetScalar(p.time, p.location, value);
-                    p.AttachProperty(value);
+                    scalar->GetScalar(s.GetTime(i), s.GetLocation(i), value);
+                    s.SetProperty(k, i, value);
                 }
             }
         }
@@ -566,8 +618,8 @@ void Advection::CalculateParticleHistogram(std::vector<double> &outBounds, std::
     std::vector<float> samples;
 
     for (const auto &s : _streams)
-        for (const auto &p : s)
-            if (!p.IsSpecial()) samples.push_back(p.value);
+        for (size_t i = 0; i < s.size(); i++)
+            if (!s.IsSpecial(i)) samples.push_back(s.GetValue(i));
 
     auto  bounds = std::minmax_element(samples.begin(), samples.end());
     float minValue = *bounds.first;
@@ -621,6 +673,94 @@ int Advection::_advectRK4(Field *velocity, const Particle &p0, double dt, Partic
     return 0;
 }
 
+void Advection::_advectEuler(Field *velocity, const std::vector<Particle> &p0s, const std::vector<double> &dts, std::vector<Particle> &p1s, std::vector<int> &rvs) const
+{
+    const size_t           n = p0s.size();
+    std::vector<double>    times(n);
+    std::vector<glm::vec3> locs(n), v0s(n);
+    for (size_t i = 0; i < n; i++) {
+        times[i] = p0s[i].time;
+        locs[i] = p0s[i].location;
+    }
+
+    velocity->GetVelocities(times.data(), locs.data(), n, v0s.data(), rvs.data());
+
+    for (size_t i = 0; i < n; i++) {
+        _printNonZero(rvs[i], __FILE__, __func__, __LINE__);
+        if (rvs[i] != 0) continue;
+        float dt32 = float(dts[i]);    // glm is strict about data types (which is a good thing).
+        p1s[i].location = p0s[i].location + dt32 * v0s[i];
+        p1s[i].time = p0s[i].time + dts[i];
+    }
+}
+
+void Advection::_advectRK4(Field *velocity, const std::vector<Particle> &p0s, const std::vector<double> &dts, std::vector<Particle> &p1s, std::vector<int> &rvs) const
+{
+    // Same as the single particle version, but each of the 4 stages is evaluated for
+    // all particles at once. A particle that fails a stage skips the remaining ones.
+    const size_t           n = p0s.size();
+    std::vector<glm::vec3> k[4];
+    for (auto &ki : k) ki.resize(n);
+
+    std::vector<size_t>    idx(n);    // particles still being integrated
+    std::vector<double>    times(n);
+    std::vector<glm::vec3> locs(n), vels(n);
+    std::vector<int>       stageRvs(n);
+    for (size_t i = 0; i < n; i++) {
+        idx[i] = i;
+        rvs[i] = 0;
+    }
+
+    for (int stage = 0; stage < 4 && !idx.empty(); stage++) {
+        for (size_t a = 0; a < idx.size(); a++) {
+            const size_t    i = idx[a];
+            const Particle &p0 = p0s[i];
+            const double    dt_half = dts[i] * 0.5;
+            const float     dt32 = float(dts[i]);        // glm is strict about data types (which is a good thing).
+            const float     dt_half32 = float(dt_half);    // glm is strict about data types (which is a good thing).
+            switch (stage) {
+            case 0:
+                times[a] = p0.time;
+                locs[a] = p0.location;
+                break;
+            case 1:
+                times[a] = p0.time + dt_half;
+                locs[a] = p0.location + dt_half32 * k[0][i];
+                break;
+            case 2:
+                times[a] = p0.time + dt_half;
+                locs[a] = p0.location + dt_half32 * k[1][i];
+                break;
+            case 3:
+                times[a] = p0.time + dts[i];
+                locs[a] = p0.location + dt32 * k[2][i];
+                break;
+            }
+        }
+
+        velocity->GetVelocities(times.data(), locs.data(), idx.size(), vels.data(), stageRvs.data());
+
+        size_t numOk = 0;
+        for (size_t a = 0; a < idx.size(); a++) {
+            const size_t i = idx[a];
+            _printNonZero(stageRvs[a], __FILE__, __func__, __LINE__);
+            if (stageRvs[a] != 0) {
+                rvs[i] = stageRvs[a];
+                continue;
+            }
+            k[stage][i] = vels[a];
+            idx[numOk++] = i;
+        }
+        idx.resize(numOk);
+    }
+
+    for (size_t i : idx) {
+        const float dt32 = float(dts[i]);
+        p1s[i].location = p0s[i].location + dt32 / 6.0f * (k[0][i] + 2.0f * (k[1][i] + k[2][i]) + k[3][i]);
+        p1s[i].time = p0s[i].time + dts[i];
+    }
+}
+
 float Advection::_calcAdjustFactor(const Particle &p2, const Particle &p1, const Particle &p0) const
 {
     glm::vec3 p2p1 = p1.location - p2.location;
@@ -642,7 +782,7 @@ float Advection::_calcAdjustFactor(const Particle &p2, const Particle &p1, const
 
 size_t Advection::GetNumberOfStreams() const { return _streams.size(); }
 
-const std::vector<Particle> &Advection::GetStreamAt(size_t i) const
+const Stream &Advection::GetStreamAt(size_t i) const
 {
     // Since this function is almost always used together with GetNumberOfStreams(),
     // I'm offloading the range check to std::vector.
@@ -664,8 +804,7 @@ size_t Advection::GetMaxNumOfPart() const
 void Advection::ClearParticleProperties()
 {
     _propertyVarNames.clear();
-    for (auto &stream : _streams)
-        for (auto &part : stream) part.ClearProperty();
+    for (auto &stream : _streams) stream.ClearProperties();
 }
 
 void Advection::RemoveParticleProperty(const std::string &varToRemove)
@@ -678,17 +817,17 @@ void Advection::RemoveParticleProperty(const std::string &varToRemove)
     else {
         auto rmI = std::distance(_propertyVarNames.begin(), itr);
         _propertyVarNames.erase(itr);
-        for (auto &stream : _streams)
-            for (auto &part : stream) part.RemoveProperty(rmI);
+        for (auto &stream : _streams) stream.RemoveProperty(rmI);
     }
 }
 
 void Advection::ResetParticleValues()
 {
+    // Separators keep their NaN value, everything else is set to zero
     for (auto &stream : _streams) {
-        std::for_each(stream.begin(), stream.end(), [](Particle &p) {
-            if (!p.IsSpecial()) p.value = 0.0f;
-        });
+        float *       values = stream.Values();
+        const double *times = stream.Times();
+        for (size_t i = 0; i < stream.size(); i++) values[i] = (std::isnan(times[i]) && std::isnan(values[i])) ? values[i] : 0.0f;
     }
 }
 
@@ -752,9 +891,9 @@ auto Advection::GetValueVarName() const -> std::string { return _valueVarName; }
 
 auto Advection::GetPropertyVarNames() const -> std::vector<std::string> { return _propertyVarNames; }
 
-bool Advection::_isParticleInsideVolume(const Particle &p, const std::vector<double> &min, const std::vector<double> &max)
+bool Advection::_isParticleInsideVolume(const glm::vec3 &loc, const std::vector<double> &min, const std::vector<double> &max)
 {
-    if (p.location[0] < min[0] || p.location[1] < min[1] || p.location[0] > max[0] || p.location[1] > max[1]) { return false; }
-    if (min.size() > 2 && (p.location[2] < min[2] || p.location[2] > max[2])) { return false; }
+    if (loc[0] < min[0] || loc[1] < min[1] || loc[0] > max[0] || loc[1] > max[1]) { return false; }
+    if (min.size() > 2 && (loc[2] < min[2] || loc[2] > max[2])) { return false; }
     return true;
 }
@@ -2,7 +2,6 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <iterator>    // std::distance
 #include <cctype>
 #include "vapor/AdvectionIO.h"
 #include "vapor/UDUnitsClass.h"
@@ -50,23 +49,24 @@ auto flow::OutputFlowlinesNumSteps(const Advection *adv, const char *filename, s
     for (size_t s_idx = 0; s_idx < adv->GetNumberOfStreams(); s_idx++) {
         const auto &stream = adv->GetStreamAt(s_idx);
 
+        // A quick sanity check
+        assert(stream.GetNumOfProperties() == propertyNames.size());
+
         size_t step = 0;
-        for (const auto &p : stream) {
-            if (!p.IsSpecial()) {
+        for (size_t i = 0; i < stream.size(); i++) {
+            if (!stream.IsSpecial(i)) {
                 // Let's convert the time!
-                udunits.DecodeTime(p.time, &year, &month, &day, &hour, &minute, &second);
+                const double time = stream.GetTime(i);
+                udunits.DecodeTime(time, &year, &month, &day, &hour, &minute, &second);
 
                 // Let's also convert geo coordinates if needed.
-                cX = p.location.x;
-                cY = p.location.y;
+                cX = stream.X()[i];
+                cY = stream.Y()[i];
                 if (needGeoConversion) { proj4API.Transform(&cX, &cY, 1); }
 
-                std::fprintf(f, "%lu, %f, %f, %f, %.4d-%.2d-%.2d_%.2d:%.2d:%.2d, %f", s_idx, cX, cY, p.location.z, year, month, day, hour, minute, second, p.time);
+                std::fprintf(f, "%lu, %f, %f, %f, %.4d-%.2d-%.2d_%.2d:%.2d:%.2d, %f", s_idx, cX, cY, stream.Z()[i], year, month, day, hour, minute, second, time);
 
-                auto props = p.GetPropertyList();
-                // A quick sanity check
-                assert(std::distance(props.cbegin(), props.cend()) == propertyNames.size());
-                for (const auto &val : props) std::fprintf(f, ", %f", val);
+                for (size_t k = 0; k < stream.GetNumOfProperties(); k++) std::fprintf(f, ", %f", stream.GetProperty(k, i));
 
                 std::fprintf(f, "\n");    // end of one line
                 step++;
@@ -123,24 +123,25 @@ auto flow::OutputFlowlinesMaxTime(const Advection *adv, const char *filename, do
     for (size_t s_idx = 0; s_idx < adv->GetNumberOfStreams(); s_idx++) {
         const auto &stream = adv->GetStreamAt(s_idx);
 
-        for (const auto &p : stream) {
-            if (p.time > maxTime) break;
+        // A quick sanity check
+        assert(stream.GetNumOfProperties() == propertyNames.size());
+
+        for (size_t i = 0; i < stream.size(); i++) {
+            const double time = stream.GetTime(i);
+            if (time > maxTime) break;
 
-            if (!p.IsSpecial()) {
+            if (!stream.IsSpecial(i)) {
                 // Let's convert the time!
-                udunits.DecodeTime(p.time, &year, &month, &day, &hour, &minute, &second);
+                udunits.DecodeTime(time, &year, &month, &day, &hour, &minute, &second);
 
                 // Let's also convert geo coordinates if needed.
-                cX = p.location.x;
-                cY = p.location.y;
+                cX = stream.X()[i];
+                cY = stream.Y()[i];
                 if (needGeoConversion) { proj4API.Transform(&cX, &cY, 1); }
 
-                std::fprintf(f, "%lu, %f, %f, %f, %.4d-%.2d-%.2d_%.2d:%.2d:%.2d, %f", s_idx, cX, cY, p.location.z, year, month, day, hour, minute, second, p.time);
+                std::fprintf(f, "%lu, %f, %f, %f, %.4d-%.2d-%.2d_%.2d:%.2d:%.2d, %f", s_idx, cX, cY, stream.Z()[i], year, month, day, hour, minute, second, time);
 
-                auto props = p.GetPropertyList();
-                // A quick sanity check
-                assert(std::distance(props.cbegin(), props.cend()) == propertyNames.size());
-                for (const auto &val : props) std::fprintf(f, ", %f", val);
+                for (size_t k = 0; k < stream.GetNumOfProperties(); k++) std::fprintf(f, ", %f", stream.GetProperty(k, i));
 
                 std::fprintf(f, "\n");    // end of one line
             }
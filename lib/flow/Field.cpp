@@ -7,3 +7,8 @@ int Field::GetNumOfEmptyVelocityNames() const
 {
     return std::count_if(VelocityNames.begin(), VelocityNames.end(), [](const std::string &e) { return e.empty(); });
 }
+
+void Field::GetVelocities(const double *times, const glm::vec3 *pos, size_t n, glm::vec3 *vels, int *rvs) const
+{
+    for (size_t i = 0; i < n; i++) rvs[i] = GetVelocity(times[i], pos[i], vels[i]);
+}
@@ -0,0 +1,73 @@
+#include "vapor/Stream.h"
+
+using namespace flow;
+
+void Stream::reserve(size_t n)
+{
+    _x.reserve(n);
+    _y.reserve(n);
+    _z.reserve(n);
+    _time.reserve(n);
+    _value.reserve(n);
+    for (auto &prop : _properties) prop.reserve(n);
+}
+
+void Stream::clear()
+{
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _time.clear();
+    _value.clear();
+    _properties.clear();
+}
+
+void Stream::push_back(const Particle &p)
+{
+    _x.push_back(p.location.x);
+    _y.push_back(p.location.y);
+    _z.push_back(p.location.z);
+    _time.push_back(p.time);
+    _value.push_back(p.value);
+    for (auto &prop : _properties) prop.push_back(std::nanf("1"));
+}
+
+void Stream::insert(size_t i, const Particle &p)
+{
+    _x.insert(_x.begin() + i, p.location.x);
+    _y.insert(_y.begin() + i, p.location.y);
+    _z.insert(_z.begin() + i, p.location.z);
+    _time.insert(_time.begin() + i, p.time);
+    _value.insert(_value.begin() + i, p.value);
+    for (auto &prop : _properties) prop.insert(prop.begin() + i, std::nanf("1"));
+}
+
+void Stream::Set(size_t i, const Particle &p)
+{
+    _x[i] = p.location.x;
+    _y[i] = p.location.y;
+    _z[i] = p.location.z;
+    _time[i] = p.time;
+    _value[i] = p.value;
+}
+
+size_t Stream::AddProperty()
+{
+    _properties.emplace_back(size(), std::nanf("1"));
+    return _properties.size() - 1;
+}
+
+void Stream::RemoveProperty(size_t k)
+{
+    if (k < _properties.size()) _properties.erase(_properties.begin() + k);
+}
+
+void Stream::ClearProperties() { _properties.clear(); }
+
+size_t Stream::GetMemoryUsage() const
+{
+    size_t bytes = (_x.capacity() + _y.capacity() + _z.capacity() + _value.capacity()) * sizeof(float) + _time.capacity() * sizeof(double);
+    bytes += _properties.capacity() * sizeof(std::vector<float>);
+    for (const auto &prop : _properties) bytes += prop.capacity() * sizeof(float);
+    return bytes;
+}
@@ -68,8 +68,12 @@ auto VaporField::LockParams() -> int
 
     _params->GetBox()->GetExtents(_c_ext_min, _c_ext_max);
 
-    for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = _getAGrid(_c_currentTS, this->VelocityNames[i]); }
-    _c_scalar_grid = _getAGrid(_c_currentTS, this->ScalarName);
+    // Unsteady fields query more than the current time step. Their grids are
+    // resolved by LockTimeRange() instead.
+    if (IsSteady) {
+        for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = _getAGrid(_c_currentTS, this->VelocityNames[i]); }
+        _c_scalar_grid = _getAGrid(_c_currentTS, this->ScalarName);
+    }
 
     _params_locked = true;
     return 0;
@@ -86,11 +90,76 @@ auto VaporField::UnlockParams() -> int
 
     for (int i = 0; i < 3; i++) { _c_velocity_grids[i] = nullptr; }
     _c_scalar_grid = nullptr;
+    _c_table_ts0 = 0;
+    _c_grid_table.clear();
 
     _params_locked = false;
     return 0;
 }
 
+auto VaporField::LockTimeRange(double startT, double endT) -> int
+{
+    _c_table_ts0 = 0;
+    _c_grid_table.clear();
+    if (!_params_locked) return PARAMS_ERROR;
+
+    // Steady fields answer locked queries from the grids cached by LockParams().
+    if (IsSteady) return 0;
+
+    // Queries at times outside of the data are answered without retrieving grids.
+    if (_timestamps.empty()) return TIME_ERROR;
+    const double minT = std::max(std::min(startT, endT), _timestamps.front());
+    const double maxT = std::min(std::max(startT, endT), _timestamps.back());
+    if (minT > maxT) return 0;
+
+    // Locate the time steps spanning [minT, maxT]
+    size_t first = 0, last = 0;
+    if (LocateTimestamp(minT, first) != 0) return TIME_ERROR;
+    if (LocateTimestamp(maxT, last) != 0) return TIME_ERROR;
+    if (_timestamps[last] < maxT) last++;
+
+    // Only resolve the grids this field is used for, and make sure they all fit
+    // in _recentGrids, which keeps their ownership.
+    const bool   useVelocity = GetNumOfEmptyVelocityNames() < 3;
+    const bool   useScalar = !ScalarName.empty();
+    const size_t numGrids = (last - first + 1) * ((useVelocity ? 3 : 0) + (useScalar ? 1 : 0));
+    if (numGrids == 0) return 0;
+    if (numGrids > _recentGrids.capacity()) return GRID_ERROR;
+
+    std::vector<std::array<const VAPoR::Grid *, 4>> table(last - first + 1, {{nullptr, nullptr, nullptr, nullptr}});
+
+    // Resolving a grid could evict another grid resolved earlier in the same pass,
+    // so repeat until a pass finds all of them still in the cache.
+    for (size_t pass = 0; pass < numGrids; pass++) {
+        for (size_t ts = first; ts <= last; ts++) {
+            for (int i = 0; i < 4; i++) {
+                if (i < 3 ? useVelocity : useScalar) table[ts - first][i] = _getAGrid(ts, i < 3 ? VelocityNames[i] : ScalarName);
+            }
+        }
+
+        // A grid that can't be read will be requested again by every query,
+        // so the table would be incomplete.
+        bool allCached = true;
+        for (size_t ts = first; ts <= last && allCached; ts++) {
+            for (int i = 0; i < 4 && allCached; i++) {
+                if (!(i < 3 ? useVelocity : useScalar)) continue;
+                const auto *grid = table[ts - first][i];
+                if (grid == nullptr) return GRID_ERROR;
+                const auto &grid_wrapper = _recentGrids.query(_makeKey(ts, i < 3 ? VelocityNames[i] : ScalarName));
+                allCached = (grid_wrapper != nullptr && grid_wrapper->grid() == grid);
+            }
+        }
+
+        if (allCached) {
+            _c_table_ts0 = first;
+            _c_grid_table = std::move(table);
+            return 0;
+        }
+    }
+
+    return GRID_ERROR;
+}
+
 bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
 {
     const std::array<double, 3> coords{pos.x, pos.y, pos.z};
@@ -122,16 +191,16 @@ bool VaporField::InsideVolumeVelocity(double time, const glm::vec3 &pos) const
         if (rv != 0) return false;
 
         // Then test if pos is inside of time step "floor"
-        for (auto &v : VelocityNames) {
-            grid = _getAGrid(floor, v);
+        for (int i = 0; i < 3; i++) {
+            grid = _getATableGrid(floor, i);
             if (grid == nullptr) return false;
             if (!grid->InsideGrid(coords)) return false;
         }
 
         // If time is larger than _timestamps[floor], we also need to test _timestamps[floor+1]
         if (time > _timestamps[floor]) {
-            for (auto &v : VelocityNames) {
-                grid = _getAGrid(floor + 1, v);
+            for (int i = 0; i < 3; i++) {
+                grid = _getATableGrid(floor + 1, i);
                 if (grid == nullptr) return false;
                 if (!grid->InsideGrid(coords)) return false;
             }
@@ -172,13 +241,13 @@ bool VaporField::InsideVolumeScalar(double time, const glm::vec3 &pos) const
         if (rv != 0) return false;
 
         // Then test if pos is inside of time step "floor"
-        grid = _getAGrid(floor, ScalarName);
+        grid = _getATableGrid(floor, 3);
         if (grid == nullptr) return false;
         if (!grid->InsideGrid(coords)) return false;
 
         // If time is larger than _timestamps[floor], we also need to test _timestamps[floor+1]
         if (time > _timestamps[floor]) {
-            grid = _getAGrid(floor + 1, ScalarName);
+            grid = _getATableGrid(floor + 1, 3);
             if (grid == nullptr) return false;
             if (!grid->InsideGrid(coords)) return false;
         }
@@ -252,7 +321,7 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
         }
     }    // Finish steady case
     else {
-        float mult = _params->GetVelocityMultiplier();
+        float mult = _params_locked ? _c_vel_mult : _params->GetVelocityMultiplier();
 
         // First check if the query time is within range
         if (time < _timestamps.front() || time > _timestamps.back()) return TIME_ERROR;
@@ -266,7 +335,7 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
         glm::vec3 floorVelocity(0.f, 0.f, 0.f);
         glm::vec3 ceilingVelocity(0.f, 0.f, 0.f);
         for (int i = 0; i < 3; i++) {
-            grid = _getAGrid(floorTS, VelocityNames[i]);
+            grid = _getATableGrid(floorTS, i);
             if (grid == nullptr) return GRID_ERROR;
             floorVelocity[i] = grid->GetValue(coords);
             missingV[i] = grid->GetMissingValue();
@@ -282,7 +351,7 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
             // We need to make sure there aren't duplicate time stamps
             VAssert(_timestamps[floorTS + 1] > _timestamps[floorTS]);
             for (int i = 0; i < 3; i++) {
-                grid = _getAGrid(floorTS + 1, VelocityNames[i]);
+                grid = _getATableGrid(floorTS + 1, i);
                 if (grid == nullptr) return GRID_ERROR;
                 ceilingVelocity[i] = grid->GetValue(coords);
                 missingV[i] = grid->GetMissingValue();
@@ -297,6 +366,57 @@ int VaporField::GetVelocity(double time, const glm::vec3 &pos, glm::vec3 &veloci
     }    // end of unsteady condition
 }
 
+void VaporField::GetVelocities(const double *times, const glm::vec3 *pos, size_t n, glm::vec3 *vels, int *rvs) const
+{
+    // In case of unsteady field, each particle may need a different pair of time steps.
+    if (!IsSteady) {
+        Field::GetVelocities(times, pos, n, vels, rvs);
+        return;
+    }
+
+    std::array<const VAPoR::Grid *, 3> grids;
+    for (int i = 0; i < 3; i++) {
+        if (_params_locked) {
+            grids[i] = _c_velocity_grids[i];
+        } else {
+            auto currentTS = _params->GetCurrentTimestep();
+            grids[i] = _getAGrid(currentTS, VelocityNames[i]);
+        }
+        if (grids[i] == nullptr) {
+            std::fill(rvs, rvs + n, int(GRID_ERROR));
+            return;
+        }
+    }
+    float mult = _params_locked ? _c_vel_mult : _params->GetVelocityMultiplier();
+
+    // Particles are processed in chunks. Each velocity component of all particles
+    // in a chunk is sampled with one call to Grid::GetValues().
+    const size_t     chunkSize = 64;
+    VAPoR::CoordType coords[chunkSize];
+    float            values[chunkSize];
+    for (size_t p0 = 0; p0 < n; p0 += chunkSize) {
+        const size_t m = std::min(chunkSize, n - p0);
+        for (size_t p = 0; p < m; p++) {
+            coords[p] = {pos[p0 + p].x, pos[p0 + p].y, pos[p0 + p].z};
+            rvs[p0 + p] = SUCCESS;
+        }
+
+        for (int i = 0; i < 3; i++) {
+            grids[i]->GetValues(coords, m, values);
+            const float missingV = grids[i]->GetMissingValue();
+            for (size_t p = 0; p < m; p++) {
+                vels[p0 + p][i] = values[p];
+                // If missing values are represented using NaN, you cannot compare equality with them!
+                if (values[p] == missingV || (std::isnan(missingV) && std::isnan(values[p]))) rvs[p0 + p] = MISSING_VAL;
+            }
+        }
+
+        for (size_t p = 0; p < m; p++) {
+            if (rvs[p0 + p] == SUCCESS) vels[p0 + p] *= mult;
+        }
+    }
+}
+
 int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) const
 {
     // When this variable doesn't exist, it doesn't make sense to get a scalar value
@@ -328,7 +448,7 @@ int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) cons
         size_t floorTS = 0;
         int    rv = LocateTimestamp(time, floorTS);
         VAssert(rv == 0);
-        grid = _getAGrid(floorTS, ScalarName);
+        grid = _getATableGrid(floorTS, 3);
         if (grid == nullptr) return GRID_ERROR;
         float floorScalar = grid->GetValue(coords);
         if (floorScalar == grid->GetMissingValue()) { return MISSING_VAL; }
@@ -337,7 +457,7 @@ int VaporField::GetScalar(double time, const glm::vec3 &pos, float &scalar) cons
             scalar = floorScalar;
             return 0;
         } else {
-            grid = _getAGrid(floorTS + 1, ScalarName);
+            grid = _getATableGrid(floorTS + 1, 3);
             if (grid == nullptr) return GRID_ERROR;
 
             float ceilingScalar = grid->GetValue(coords);
@@ -507,14 +627,14 @@ int VaporField::CalcDeltaTFromCurrentTimeStep(double &delT) const
     return 0;
 }
 
-const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &varName) const
+GridKey VaporField::_makeKey(size_t timestep, const std::string &varName) const
 {
     GridKey key;
     if (_params_locked) {
-        // Because in unsteady case, both currentTS and currentTS will be queried,
-        // so we do a sanity check here. The assertion will be gone in release mode.
-        assert(timestep == _c_currentTS);
-        key.Reset(_c_currentTS, _c_refLev, _c_compLev, varName, _c_ext_min, _c_ext_max);
+        // Because in steady case, only currentTS will be queried,
+        // we do a sanity check here. The assertion will be gone in release mode.
+        assert(!IsSteady || timestep == _c_currentTS);
+        key.Reset(timestep, _c_refLev, _c_compLev, varName, _c_ext_min, _c_ext_max);
     } else {
         std::vector<double> extMin, extMax;
         _params->GetBox()->GetExtents(extMin, extMax);
@@ -522,6 +642,26 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
         int compLevel = _params->GetCompressionLevel();
         key.Reset(timestep, refLevel, compLevel, varName, extMin, extMax);
     }
+    return key;
+}
+
+const VAPoR::Grid *VaporField::_getATableGrid(size_t timestep, int idx) const
+{
+    if (timestep >= _c_table_ts0 && timestep - _c_table_ts0 < _c_grid_table.size()) {
+        const auto *grid = _c_grid_table[timestep - _c_table_ts0][idx];
+        if (grid) return grid;
+    }
+    return _getAGrid(timestep, idx < 3 ? VelocityNames[idx] : ScalarName);
+}
+
+const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &varName) const
+{
+    const GridKey key = _makeKey(timestep, varName);
+
+    // Note that we use a lock here, so no two threads querying _datamgr simultaneously,
+    // and no thread queries _recentGrids while another one is inserting into it.
+    // Multi-threaded queries are expected to go through the grid table instead.
+    const std::lock_guard<std::mutex> lock_gd(_grid_operation_mutex);
 
     // First check if we have the requested grid in our cache.
     // If it exists, return the grid directly.
@@ -535,9 +675,6 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
     // 2) ask for it from the data manager,
     //
 
-    // Note that we use a lock here, so no two threads querying _datamgr simultaneously.
-    const std::lock_guard<std::mutex> lock_gd(_grid_operation_mutex);
-
     VAPoR::Grid *grid = nullptr;
     if (key.emptyVar()) {
         // In case of an empty variable name, we generate a constantGrid with zeros.
@@ -548,7 +685,7 @@ const VAPoR::Grid *VaporField::_getAGrid(size_t timestep, const std::string &var
         if (_params_locked) {
             VAPoR::Grid::CopyToArr3(_c_ext_min, extMin);
             VAPoR::Grid::CopyToArr3(_c_ext_max, extMax);
-            grid = _datamgr->GetVariable(_c_currentTS, varName, _c_refLev, _c_compLev, extMin, extMax, true);
+            grid = _datamgr->GetVariable(timestep, varName, _c_refLev, _c_compLev, extMin, extMax, true);
         } else {
             _params->GetBox()->GetExtents(extMin, extMax);
             int refLevel = _params->GetRefinementLevel();
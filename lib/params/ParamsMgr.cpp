@@ -21,6 +21,7 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <memory>
 
 #include <vapor/ParamsMgr.h>
 #include <vapor/ViewpointParams.h>
@@ -1076,9 +1077,11 @@ bool ParamsMgr::undoRedoHelper()
 
     // Get top of **undo** stack
     //
-    const XmlNode *newNode = _ssave.GetTopUndo(description);
-    if (!newNode) { newNode = _ssave.GetBase(); }
-    if (!newNode) return (false);    // nothing to undo - shouldnt get here
+    XmlNode::SnapshotPtr snapshot = _ssave.GetTopUndo(description);
+    if (!snapshot) { snapshot = _ssave.GetBase(); }
+    if (!snapshot) return (false);    // nothing to undo - shouldnt get here
+
+    std::unique_ptr<XmlNode> newNode(new XmlNode(*snapshot));
 
     // Need to disable state saving so the undo itself doesn't trigger
     // saving of intermediate state
@@ -1088,7 +1091,7 @@ bool ParamsMgr::undoRedoHelper()
 
     // Load the new Xml tree (which destroys the old one)
     //
-    LoadState(newNode);
+    LoadState(newNode.get());
 
     // Restore state saving
     //
@@ -1140,7 +1143,8 @@ ParamsMgr::PMgrStateSave::PMgrStateSave(int stackSize) : StateSave()
     _enabled = true;
     _stackSize = stackSize;
     _rootNode = NULL;
-    _state0 = NULL;
+    _state0.reset();
+    _lastSnap.reset();
     _undoStack.clear();
     _redoStack.clear();
 }
@@ -1149,7 +1153,6 @@ ParamsMgr::PMgrStateSave::~PMgrStateSave()
 {
     cleanStack(0, _undoStack);
     cleanStack(0, _redoStack);
-    if (_state0) delete _state0;
 }
 
 void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
@@ -1165,19 +1168,24 @@ void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
     vector<string> pathvec = node->GetPathVec();
     if ((!pathvec.size()) || (pathvec[0] != _rootTag)) { return; }
 
+    if (!_groups.empty()) { return; }
+
+    // Snapshots share unchanged subtrees with the previous one, so
+    // taking and comparing them only visits the nodes that changed
+    //
+    XmlNode::SnapshotPtr snapshot;
+    if (GetUndoEnabled() || !_state0) snapshot = _takeSnapshot();
+
     if (GetUndoEnabled()) {
-        const XmlNode *topNode = NULL;
-        string         s;
-        topNode = GetTopUndo(s);
-        if (topNode && (*topNode == *_rootNode)) {
+        string               s;
+        XmlNode::SnapshotPtr topNode = GetTopUndo(s);
+        if (topNode && (*topNode == *snapshot)) {
             // Don't save tree if no changes
             return;
         }
     }
 
-    if (!_groups.empty()) { return; }
-
-    if (!_state0) { _state0 = new XmlNode(*_rootNode); }
+    if (!_state0) { _state0 = snapshot; }
 
     // Delete oldest elements if needed
     //
@@ -1185,7 +1193,7 @@ void ParamsMgr::PMgrStateSave::Save(const XmlNode *node, string description)
 
     // It not inside a group push this element onto the stack
     //
-    if (GetUndoEnabled()) _undoStack.push_back(make_pair(description, new XmlNode(*_rootNode)));
+    if (GetUndoEnabled()) _undoStack.push_back(make_pair(description, snapshot));
 
 //#define DEBUG
 #ifdef DEBUG
@@ -1223,17 +1231,18 @@ void ParamsMgr::PMgrStateSave::EndGroup()
     //
     if (_groups.size()) return;
 
-    const XmlNode *topNode = NULL;
-    string         s;
-    topNode = GetTopUndo(s);
+    XmlNode::SnapshotPtr snapshot = _takeSnapshot();
 
-    if (topNode && (*topNode == *_rootNode)) {
+    string               s;
+    XmlNode::SnapshotPtr topNode = GetTopUndo(s);
+
+    if (topNode && (*topNode == *snapshot)) {
         // Don't save tree if no changes
         //
         return;
     }
 
-    if (!_state0) { _state0 = new XmlNode(*_rootNode); }
+    if (!_state0) { _state0 = snapshot; }
 
 #ifdef DEBUG
     cout << "ParamsMgr::PMgrStateSave::EndGroup() : saving "
@@ -1248,34 +1257,34 @@ void ParamsMgr::PMgrStateSave::EndGroup()
     //
     cleanStack(0, _redoStack);
 
-    _undoStack.push_back(make_pair(desc, new XmlNode(*_rootNode)));
+    _undoStack.push_back(make_pair(desc, snapshot));
 
     emitStateChange();
 }
 
 void ParamsMgr::PMgrStateSave::IntermediateChange() { emitIntermediateStateChange(); }
 
-const XmlNode *ParamsMgr::PMgrStateSave::GetTopUndo(string &description) const
+XmlNode::SnapshotPtr ParamsMgr::PMgrStateSave::GetTopUndo(string &description) const
 {
     VAssert(_rootNode);
     description.clear();
 
     if (!_undoStack.size()) return (NULL);
 
-    const pair<string, XmlNode *> &p1 = _undoStack.back();
+    const pair<string, XmlNode::SnapshotPtr> &p1 = _undoStack.back();
 
     description = p1.first;
     return (p1.second);
 }
 
-const XmlNode *ParamsMgr::PMgrStateSave::GetTopRedo(string &description) const
+XmlNode::SnapshotPtr ParamsMgr::PMgrStateSave::GetTopRedo(string &description) const
 {
     VAssert(_rootNode);
     description.clear();
 
     if (!_redoStack.size()) return (NULL);
 
-    const pair<string, XmlNode *> &p1 = _redoStack.back();
+    const pair<string, XmlNode::SnapshotPtr> &p1 = _redoStack.back();
 
     description = p1.first;
     return (p1.second);
@@ -1287,7 +1296,7 @@ bool ParamsMgr::PMgrStateSave::Undo()
 
     if (!_undoStack.size()) return (false);
 
-    pair<string, XmlNode *> &p1 = _undoStack.back();
+    pair<string, XmlNode::SnapshotPtr> &p1 = _undoStack.back();
 
     // Delete oldest elements if needed
     //
@@ -1297,6 +1306,10 @@ bool ParamsMgr::PMgrStateSave::Undo()
 
     _undoStack.pop_back();
 
+    // The state tree is about to be replaced by this snapshot
+    //
+    _lastSnap = _undoStack.size() ? _undoStack.back().second : _state0;
+
     emitStateChange();
 
     return (true);
@@ -1308,7 +1321,7 @@ bool ParamsMgr::PMgrStateSave::Redo()
 
     if (!_redoStack.size()) return (false);
 
-    pair<string, XmlNode *> &p1 = _redoStack.back();
+    pair<string, XmlNode::SnapshotPtr> &p1 = _redoStack.back();
 
     // Delete oldest elements if needed
     //
@@ -1318,6 +1331,8 @@ bool ParamsMgr::PMgrStateSave::Redo()
 
     _redoStack.pop_back();
 
+    _lastSnap = _undoStack.back().second;
+
     emitStateChange();
 
     return (true);
@@ -1332,17 +1347,23 @@ void ParamsMgr::PMgrStateSave::Clear()
     while (_groups.size()) _groups.pop();
 }
 
-void ParamsMgr::PMgrStateSave::cleanStack(int maxN, std::deque<std::pair<string, XmlNode *>> &s)
+void ParamsMgr::PMgrStateSave::cleanStack(int maxN, std::deque<std::pair<string, XmlNode::SnapshotPtr>> &s)
 {
-    // Delete oldest elements if needed
+    // Delete oldest elements if needed. Subtrees still shared with
+    // other snapshots are kept alive by them
     //
-    while (s.size() > maxN) {
-        pair<string, XmlNode *> &p1 = s.front();
+    while (s.size() > maxN) { s.pop_front(); }
+}
 
-        if (p1.second) { delete p1.second; }
+XmlNode::SnapshotPtr ParamsMgr::PMgrStateSave::_takeSnapshot()
+{
+    VAssert(_rootNode);
 
-        s.pop_front();
-    }
+    // Trees installed by Reinit() are new, so all of their nodes are
+    // marked modified and _lastSnap only serves to share equal subtrees
+    //
+    _lastSnap = _rootNode->TakeSnapshot(_lastSnap);
+    return (_lastSnap);
 }
 
 void ParamsMgr::PMgrStateSave::emitStateChange()
@@ -101,6 +101,7 @@ XmlNode::XmlNode(const string &tag, const map<string, string> &attrs, size_t num
     _tag.clear();
     _asciiLimit = 1024;
     _parent = NULL;
+    _modified = true;
 
     _tag = tag;
     _attrmap = attrs;
@@ -124,6 +125,7 @@ XmlNode::XmlNode(const string &tag, size_t numChildrenHint)
     _tag.clear();
     _asciiLimit = 1024;
     _parent = NULL;
+    _modified = true;
 
     _tag = tag;
 
@@ -144,6 +146,7 @@ XmlNode::XmlNode()
     _tag.clear();
     _asciiLimit = 1024;
     _parent = NULL;
+    _modified = true;
 
 #ifdef MEMCHECK
     _allocatedNodes.push_back(this);
@@ -152,7 +155,8 @@ XmlNode::XmlNode()
 
 XmlNode::XmlNode(const XmlNode &rhs)
 : _longmap(rhs._longmap), _doublemap(rhs._doublemap), _stringmap(rhs._stringmap), _attrmap(rhs._attrmap), _children(rhs._children), _tag(rhs._tag), _asciiLimit(rhs._asciiLimit),
-  _parent(NULL)    // Set parent to NULL
+  _parent(NULL),    // Set parent to NULL
+  _modified(true)
 {
     _children.clear();
     for (int i = 0; i < rhs._children.size(); i++) { AddChild(rhs._children[i]); }
@@ -164,6 +168,7 @@ XmlNode::XmlNode(const XmlNode &rhs)
 
 XmlNode &XmlNode::operator=(const XmlNode &rhs)
 {
+    _setModified();
     DeleteAll();
     MyBase::operator=(rhs);
 
@@ -176,6 +181,7 @@ XmlNode &XmlNode::operator=(const XmlNode &rhs)
     _tag = rhs._tag;
     _asciiLimit = rhs._asciiLimit;
     _parent = NULL;    // Set parent to NULL
+    _modified = true;
 
     _children.clear();
     for (int i = 0; i < rhs._children.size(); i++) { AddChild(rhs._children[i]); }
@@ -223,6 +229,7 @@ XmlNode::~XmlNode()
 void XmlNode::SetElementLong(const string &tag, const vector<long> &values)
 {
     VAssert(IsValidXMLElement(tag));
+    _setModified();
     _longmap[tag] = values;
 }
 
@@ -240,6 +247,7 @@ void XmlNode::SetElementLong(const vector<string> &tags, const vector<long> &val
 
     string tag = tags[tags.size() - 1];
     VAssert(IsValidXMLElement(tag));
+    currNode->_setModified();
     currNode->_longmap[tag] = values;
 }
 
@@ -257,6 +265,7 @@ void XmlNode::SetElementDouble(const vector<string> &tags, const vector<double>
 
     string tag = tags[tags.size() - 1];
     VAssert(IsValidXMLElement(tag));
+    currNode->_setModified();
     currNode->_doublemap[tag] = values;
 }
 
@@ -280,6 +289,7 @@ bool XmlNode::HasElementLong(const string &tag) const
 void XmlNode::SetElementDouble(const string &tag, const vector<double> &values)
 {
     VAssert(IsValidXMLElement(tag));
+    _setModified();
     _doublemap[tag] = values;
 }
 
@@ -305,6 +315,7 @@ void XmlNode::SetElementString(const string &tag, const string &str)
 {
     VAssert(IsValidXMLElement(tag));
 
+    _setModified();
     _stringmap[tag] = str;
 }
 
@@ -377,6 +388,7 @@ XmlNode *XmlNode::NewChild(const string &tag, const map<string, string> &attrs,
 
     mychild->_parent = this;
 
+    _setModified();
     _children.push_back(mychild);
     return (mychild);
 }
@@ -389,10 +401,11 @@ XmlNode *XmlNode::AddChild(const XmlNode &child)
 
     // Delete duplicates
     //
-    if (HasChild(mychild->Tag())) { DeleteChild(mychild->Tag()); }
+    if (HasChild(mychild->_tag)) { DeleteChild(mychild->_tag); }
 
     mychild->_parent = this;
 
+    _setModified();
     _children.push_back(mychild);
     return (mychild);
 }
@@ -404,6 +417,7 @@ int XmlNode::ReplaceChild(XmlNode *prevChildNode, XmlNode *newChildNode)
         XmlNode *node = _children[index];
         if (node == prevChildNode) {
             delete node;
+            _setModified();
             _children[index] = new XmlNode(*newChildNode);
             newChildNode->_parent = this;
 
@@ -536,15 +550,16 @@ void XmlNode::SetParent(XmlNode *parent)
 
     // Delete duplicates on new parent
     //
-    if (parent && parent->HasChild(Tag())) { parent->DeleteChild(Tag()); }
+    if (parent && parent->HasChild(_tag)) { parent->DeleteChild(_tag); }
 
     // Remove from current parent's list of children
     //
     if (_parent) {
+        _parent->_setModified();
         vector<XmlNode *>::iterator itr = _parent->_children.begin();
         for (; itr != _parent->_children.end(); ++itr) {
             XmlNode *node = *itr;
-            if (node->Tag() == Tag()) {
+            if (node->_tag == _tag) {
                 _parent->_children.erase(itr);
                 break;
             }
@@ -553,15 +568,23 @@ void XmlNode::SetParent(XmlNode *parent)
 
     // If new parent is not NULL
     //
-    if (parent) { parent->_children.push_back(this); }
+    if (parent) {
+        parent->_setModified();
+        parent->_children.push_back(this);
+    }
 
     _parent = parent;
+
+    // Snapshots of the new parent do not contain this subtree
+    //
+    _setModifiedAll();
 }
 
 // Recursively delete all descendants of this node
 //
 void XmlNode::DeleteAll()
 {
+    if (!_children.empty()) _setModified();
     for (int i = 0; i < (int)_children.size(); i++) {
         if (_children[i]) {
             XmlNode *node = _children[i];
@@ -617,6 +640,109 @@ ostream &XmlNode::streamOut(ostream &os, const XmlNode &node)
     return os;
 }
 
+XmlNode::XmlNode(const Snapshot &snapshot)
+: _longmap(snapshot._longmap), _doublemap(snapshot._doublemap), _stringmap(snapshot._stringmap), _attrmap(snapshot._attrmap), _tag(snapshot._tag), _asciiLimit(snapshot._asciiLimit), _parent(NULL),
+  _modified(true)
+{
+    _children.reserve(snapshot._children.size());
+    for (int i = 0; i < snapshot._children.size(); i++) {
+        XmlNode *mychild = new XmlNode(*snapshot._children[i]);
+        mychild->_parent = this;
+        _children.push_back(mychild);
+    }
+
+#ifdef MEMCHECK
+    _allocatedNodes.push_back(this);
+#endif
+}
+
+XmlNode::SnapshotPtr XmlNode::TakeSnapshot(const SnapshotPtr &prev) const
+{
+    // Nothing in this subtree changed since prev was taken
+    //
+    if (prev && !_modified && prev->_tag == _tag) return (prev);
+
+    vector<SnapshotPtr> children;
+    children.reserve(_children.size());
+
+    bool same = prev && prev->_children.size() == _children.size();
+    for (int i = 0; i < _children.size(); i++) {
+        SnapshotPtr prevChild = prev ? prev->_findChild(_children[i]->_tag, i) : SnapshotPtr();
+        children.push_back(_children[i]->TakeSnapshot(prevChild));
+
+        if (same && children.back() != prev->_children[i]) same = false;
+    }
+    _modified = false;
+
+    // Modified but changed back, or only descendants changed and they
+    // all changed back
+    //
+    if (same && prev->_equalData(*this)) return (prev);
+
+    std::shared_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->_longmap = _longmap;
+    snapshot->_doublemap = _doublemap;
+    snapshot->_stringmap = _stringmap;
+    snapshot->_attrmap = _attrmap;
+    snapshot->_children = std::move(children);
+    snapshot->_tag = _tag;
+    snapshot->_asciiLimit = _asciiLimit;
+
+    return (snapshot);
+}
+
+void XmlNode::_setModified()
+{
+    // Ancestors of a modified node are always modified, so stop at the
+    // first one that is
+    //
+    for (XmlNode *node = this; node && !node->_modified; node = node->_parent) node->_modified = true;
+}
+
+void XmlNode::_setModifiedAll()
+{
+    _setModified();
+    for (int i = 0; i < _children.size(); i++) _children[i]->_setModifiedAll();
+}
+
+bool XmlNode::Snapshot::operator==(const Snapshot &rhs) const
+{
+    if (this == &rhs) return (true);
+
+    if (_longmap != rhs._longmap) return (false);
+    if (_doublemap != rhs._doublemap) return (false);
+    if (_stringmap != rhs._stringmap) return (false);
+    if (_attrmap != rhs._attrmap) return (false);
+    if (_tag != rhs._tag) return (false);
+
+    if (_children.size() != rhs._children.size()) return (false);
+    for (int i = 0; i < _children.size(); i++) {
+        // Shared subtrees are equal without looking at them
+        //
+        if (_children[i] == rhs._children[i]) continue;
+        if (!(*(_children[i]) == *(rhs._children[i]))) return (false);
+    }
+
+    return (true);
+}
+
+bool XmlNode::Snapshot::_equalData(const XmlNode &node) const
+{
+    return (_longmap == node._longmap && _doublemap == node._doublemap && _stringmap == node._stringmap && _attrmap == node._attrmap && _tag == node._tag);
+}
+
+XmlNode::SnapshotPtr XmlNode::Snapshot::_findChild(const string &tag, size_t hint) const
+{
+    // Children rarely move, so try the same position first
+    //
+    if (hint < _children.size() && _children[hint]->_tag == tag) return (_children[hint]);
+
+    for (int i = 0; i < _children.size(); i++) {
+        if (_children[i]->_tag == tag) return (_children[i]);
+    }
+    return (SnapshotPtr());
+}
+
 namespace VAPoR {
 std::ostream &operator<<(ostream &os, const VAPoR::XmlNode &node)
 {
@@ -21,6 +21,9 @@
 #include <sstream>
 #include <string>
 #include <iterator>
+#include <map>
+#include <limits>
+#include <algorithm>
 
 #include <vapor/glutil.h>    // Must be included first!!!
 
@@ -38,6 +41,7 @@
 #include <vapor/GLManager.h>
 #include <vapor/LegacyGL.h>
 #include <vapor/ArbitrarilyOrientedRegularGrid.h>
+#include <vapor/OpenMPSupport.h>
 
 using namespace VAPoR;
 
@@ -48,6 +52,24 @@ struct ContourRenderer::VertexData {
 };
 #pragma pack(pop)
 
+struct ContourRenderer::ContourCache {
+    std::unique_ptr<Grid> slice;
+
+    // Cells are grouped in tiles of TileSize x TileSize. tileMin and
+    // tileMax hold the range of the non-missing node values of each tile,
+    // and are empty until the first extraction
+    //
+    DimsType      cellDims = {1, 1, 1};
+    DimsType      nTiles = {1, 1, 1};
+    vector<float> tileMin, tileMax;
+
+    std::map<double, vector<VertexData>> levels;
+};
+
+namespace {
+const size_t TileSize = 32;
+}
+
 static RendererRegistrar<ContourRenderer> registrar(ContourRenderer::GetClassType(), ContourParams::GetClassType());
 
 ContourRenderer::ContourRenderer(const ParamsMgr *pm, string winName, string dataSetName, string instName, DataMgr *dataMgr)
@@ -82,6 +104,20 @@ void ContourRenderer::_saveCacheParams()
 }
 
 bool ContourRenderer::_isCacheDirty() const
+{
+    if (_isGeometryCacheDirty()) return true;
+
+    ContourParams *p = (ContourParams *)GetActiveParams();
+    if (_cacheParams.contourValues != p->GetContourValues(_cacheParams.varName)) return true;
+
+    return false;
+}
+
+// Everything that the geometry depends on but the contour values. The
+// colormap and opacity are applied when drawing, so changing them keeps the
+// sampled slice and the extracted contours. The line thickness is not used.
+//
+bool ContourRenderer::_isGeometryCacheDirty() const
 {
     ContourParams *p = (ContourParams *)GetActiveParams();
     if (_cacheParams.varName != p->GetVariableName()) return true;
@@ -89,7 +125,6 @@ bool ContourRenderer::_isCacheDirty() const
     if (_cacheParams.ts != p->GetCurrentTimestep()) return true;
     if (_cacheParams.level != p->GetRefinementLevel()) return true;
     if (_cacheParams.lod != p->GetCompressionLevel()) return true;
-    if (_cacheParams.lineThickness != p->GetLineThickness()) return true;
     if (_cacheParams.sliceRotation != p->GetSlicePlaneRotation()) return true;
     if (_cacheParams.sliceNormal != p->GetSlicePlaneNormal()) return true;
     if (_cacheParams.sliceOrigin != p->GetSlicePlaneOrigin()) return true;
@@ -97,13 +132,11 @@ bool ContourRenderer::_isCacheDirty() const
     if (_cacheParams.sliceResolution != p->GetValueDouble(RenderParams::SampleRateTag, 200)) return true;
     if (_cacheParams.sliceOrientationMode != p->GetValueLong(RenderParams::SlicePlaneOrientationModeTag, 0)) return true;
 
-    vector<double> min, max, contourValues;
+    vector<double> min, max;
     p->GetBox()->GetExtents(min, max);
-    contourValues = p->GetContourValues(_cacheParams.varName);
 
     if (_cacheParams.boxMin != min) return true;
     if (_cacheParams.boxMax != max) return true;
-    if (_cacheParams.contourValues != contourValues) return true;
 
     return false;
 }
@@ -130,39 +163,182 @@ static vector<double> ToDoubleVec(const glm::vec3 &v)
 }
 
 
+// Extract the contour lines for levels, and add them to the cache. Tiles
+// of cells are processed in parallel, each thread appending to its own
+// buffers. If the cache already has the range of values of each tile,
+// tiles that can't contain any of the levels are skipped, otherwise the
+// ranges are computed along the way.
+//
+void ContourRenderer::_extractLevels(const Grid *grid, const Grid *heightGrid, int dims, const vector<double> &levels, float Z0)
+{
+    ContourCache &cache = *_contourCache;
+    if (levels.empty()) return;
+
+    // Edges are tested in single precision, as are the vertices
+    //
+    vector<float> contours(levels.begin(), levels.end());
+
+    double mv = grid->GetMissingValue();
+    size_t maxNodes = grid->GetMaxVertexPerCell();
+
+    const bool buildIndex = cache.tileMin.empty();
+    if (buildIndex) {
+        cache.cellDims = grid->GetCellDimensions();
+        for (int d = 0; d < 3; d++) cache.nTiles[d] = d < 2 ? (cache.cellDims[d] + TileSize - 1) / TileSize : cache.cellDims[d];
+        size_t n = cache.nTiles[0] * cache.nTiles[1] * cache.nTiles[2];
+        cache.tileMin.assign(n, std::numeric_limits<float>::max());
+        cache.tileMax.assign(n, std::numeric_limits<float>::lowest());
+    }
+    const DimsType &cellDims = cache.cellDims;
+    const DimsType &nTiles = cache.nTiles;
+    const long      nTilesTotal = cache.tileMin.size();
+
+    int                                nThreads = omp_get_max_threads();
+    vector<vector<vector<VertexData>>> threadVertices(nThreads, vector<vector<VertexData>>(contours.size()));
+
+    #pragma omp parallel
+    {
+        vector<vector<VertexData>> &out = threadVertices[omp_get_thread_num()];
+        vector<DimsType>            nodes(maxNodes);
+        vector<float>               values(maxNodes);
+        vector<CoordType>           coords(maxNodes);
+
+        #pragma omp for schedule(dynamic)
+        for (long tile = 0; tile < nTilesTotal; tile++) {
+            if (!buildIndex) {
+                // The tile contains a level if tileMin <= level < tileMax
+                //
+                auto first = std::lower_bound(contours.begin(), contours.end(), cache.tileMin[tile]);
+                if (first == contours.end() || !(*first < cache.tileMax[tile])) continue;
+            }
+
+            size_t   ti = tile % nTiles[0], tj = (tile / nTiles[0]) % nTiles[1], tk = tile / (nTiles[0] * nTiles[1]);
+            DimsType cmin = {ti * TileSize, tj * TileSize, tk};
+            DimsType cmax = {std::min(cmin[0] + TileSize, cellDims[0]), std::min(cmin[1] + TileSize, cellDims[1]), tk + 1};
+
+            float tileMin = std::numeric_limits<float>::max();
+            float tileMax = std::numeric_limits<float>::lowest();
+
+            for (size_t k = cmin[2]; k < cmax[2]; k++) {
+                for (size_t j = cmin[1]; j < cmax[1]; j++) {
+                    for (size_t i = cmin[0]; i < cmax[0]; i++) {
+                        grid->GetCellNodes(DimsType{i, j, k}, nodes);
+
+                        bool  hasMissing = false;
+                        float cellMin = std::numeric_limits<float>::max();
+                        float cellMax = std::numeric_limits<float>::lowest();
+                        for (int n = 0; n < nodes.size(); n++) {
+                            values[n] = grid->GetValueAtIndex(nodes[n]);
+                            if (values[n] == mv) {
+                                hasMissing = true;
+                                continue;
+                            }
+                            cellMin = std::min(cellMin, values[n]);
+                            cellMax = std::max(cellMax, values[n]);
+                        }
+                        tileMin = std::min(tileMin, cellMin);
+                        tileMax = std::max(tileMax, cellMax);
+                        if (hasMissing) continue;
+
+                        // An edge of the cell crosses a level if cellMin <= level < cellMax
+                        //
+                        auto ci = std::lower_bound(contours.begin(), contours.end(), cellMin) - contours.begin();
+                        if (ci == contours.size() || !(contours[ci] < cellMax)) continue;
+
+                        for (int n = 0; n < nodes.size(); n++) grid->GetUserCoordinates(nodes[n], coords[n]);
+
+                        for (; ci < contours.size() && contours[ci] < cellMax; ci++) {
+                            float contour = contours[ci];
+                            for (int a = nodes.size() - 1, b = 0; b < nodes.size(); a++, b++) {
+                                if (a == nodes.size()) a = 0;
+
+                                if ((values[a] <= contour && values[b] <= contour) || (values[a] > contour && values[b] > contour)) continue;
+
+                                float t = (contour - values[a]) / (values[b] - values[a]);
+                                float v[3];
+                                v[0] = coords[a][0] + t * (coords[b][0] - coords[a][0]);
+                                v[1] = coords[a][1] + t * (coords[b][1] - coords[a][1]);
+                                v[2] = coords[a][2] + t * (coords[b][2] - coords[a][2]);
+
+                                if (dims == 2) v[2] = Z0;
+
+                                if (heightGrid) {
+                                    float aHeight = heightGrid->GetValueAtIndex(nodes[a]);
+                                    float bHeight = heightGrid->GetValueAtIndex(nodes[b]);
+                                    v[2] = aHeight + t * (bHeight - aHeight);
+                                }
+
+                                out[ci].push_back({v[0], v[1], v[2], contour});
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (buildIndex) {
+                cache.tileMin[tile] = tileMin;
+                cache.tileMax[tile] = tileMax;
+            }
+        }
+    }
+
+    for (int ci = 0; ci < levels.size(); ci++) {
+        vector<VertexData> &vertices = cache.levels[levels[ci]];
+        size_t              n = 0;
+        for (const auto &out : threadVertices) n += out[ci].size();
+        vertices.reserve(n);
+        for (const auto &out : threadVertices) vertices.insert(vertices.end(), out[ci].begin(), out[ci].end());
+    }
+}
+
 int ContourRenderer::_buildCache(bool fast)
 {
     ContourParams *cParams = (ContourParams *)GetActiveParams();
+    if (_isGeometryCacheDirty() || !_contourCache) _contourCache.reset(new ContourCache);
     _saveCacheParams();
 
-    vector<VertexData> vertices;
-
     if (cParams->GetVariableName().empty()) {
         MyBase::SetErrMsg("Missing Variable");
         return 1;
     }
     vector<double> contours = cParams->GetContourValues(_cacheParams.varName);
+    std::sort(contours.begin(), contours.end());
+    contours.erase(std::unique(contours.begin(), contours.end()), contours.end());
 
     CoordType boxMin = {0.0, 0.0, 0.0};
     CoordType boxMax = {0.0, 0.0, 0.0};
     Grid::CopyToArr3(_cacheParams.boxMin, boxMin);
     Grid::CopyToArr3(_cacheParams.boxMax, boxMax);
 
-    Grid *grid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.varName, _cacheParams.level, _cacheParams.lod, boxMin, boxMax);
-    Grid *grid2 = nullptr;
-    Grid *heightGrid = nullptr;
+    // Variables are read again even if only the contour values changed,
+    // which is cheap as the data manager caches them. The slice of a 3D
+    // variable isn't, so it's kept
+    //
+    std::unique_ptr<Grid> dataGrid, heightGrid;
+    const Grid *          grid = _contourCache->slice.get();
     _sliceQuad.clear();
 
-    int dims = grid->GetTopologyDim();
-    if (!_cacheParams.heightVarName.empty() && dims == 2) { heightGrid = _dataMgr->GetVariable(_cacheParams.ts, _cacheParams.heightVarName, _cacheParams.level, _cacheParams.lod, boxMin, boxMax); }
-    if (grid == NULL || (heightGrid == NULL && !_cacheParams.heightVarName.empty())) {
-        if (grid) delete grid;
-        if (grid2) delete grid2;
-        if (heightGrid) delete heightGrid;
+    if (!grid) {
+        dataGrid.reset(_dataMgr->GetVariable(_cacheParams.ts, _cacheParams.varName, _cacheParams.level, _cacheParams.lod, boxMin, boxMax));
+        grid = dataGrid.get();
+    }
+    if (grid == NULL) {
+        _contourCache.reset();
         return -1;
     }
 
-    if (dims == 3) {
+    // The cached slice is 2D, but sampled from a 3D variable
+    //
+    int dims = _contourCache->slice ? 3 : grid->GetTopologyDim();
+    if (!_cacheParams.heightVarName.empty() && dims == 2) {
+        heightGrid.reset(_dataMgr->GetVariable(_cacheParams.ts, _cacheParams.heightVarName, _cacheParams.level, _cacheParams.lod, boxMin, boxMax));
+        if (heightGrid == NULL) {
+            _contourCache.reset();
+            return -1;
+        }
+    }
+
+    if (dims == 3 && !_contourCache->slice) {
         planeDescription pd;
         pd.boxMin = ToCoordType(_cacheParams.boxMin);
         pd.boxMax = ToCoordType(_cacheParams.boxMax);
@@ -182,7 +358,8 @@ int ContourRenderer::_buildCache(bool fast)
         DimsType dims = {pd.sideSize, pd.sideSize, 1};
 
         ArbitrarilyOrientedRegularGrid *grid2d = new ArbitrarilyOrientedRegularGrid(grid, pd, dims);
-        grid2 = grid;
+        _contourCache->slice.reset(grid2d);
+        dataGrid.reset();
         grid = grid2d;
 
         CoordType corner1, corner2, corner3, corner4;
@@ -200,62 +377,34 @@ int ContourRenderer::_buildCache(bool fast)
 
         if (fast) {
             _cacheParams.varName = "";
-            if (grid) delete grid;
-            if (grid2) delete grid2;
-            if (heightGrid) delete heightGrid;
+            _contourCache.reset();
             return 0;
         }
     }
 
-    double mv = grid->GetMissingValue();
-    float  Z0 = GetDefaultZ(_dataMgr, _cacheParams.ts);
-
-    Grid::ConstCellIterator it = grid->ConstCellBegin(boxMin, boxMax);
-
-    size_t           maxNodes = grid->GetMaxVertexPerCell();
-    vector<DimsType> nodes(maxNodes);
-
-    vector<float>     values(maxNodes);
-    vector<CoordType> coords(maxNodes);
-
-    Grid::ConstCellIterator end = grid->ConstCellEnd();
-    for (; it != end; ++it) {
-        const DimsType &cell = *it;
-        grid->GetCellNodes(cell, nodes);
-
-        bool hasMissing = false;
-        for (int i = 0; i < nodes.size(); i++) {
-            grid->GetUserCoordinates(nodes[i], coords[i]);
-            values[i] = grid->GetValueAtIndex(nodes[i]);
-            if (values[i] == mv) { hasMissing = true; }
-        }
-        if (hasMissing) continue;
-
-        for (int ci = 0; ci != contours.size(); ci++) {
-            for (int a = nodes.size() - 1, b = 0; b < nodes.size(); a++, b++) {
-                if (a == nodes.size()) a = 0;
-                float contour = contours[ci];
-
-                if ((values[a] <= contour && values[b] <= contour) || (values[a] > contour && values[b] > contour)) continue;
-
-                float t = (contour - values[a]) / (values[b] - values[a]);
-                float v[3];
-                v[0] = coords[a][0] + t * (coords[b][0] - coords[a][0]);
-                v[1] = coords[a][1] + t * (coords[b][1] - coords[a][1]);
-                v[2] = coords[a][2] + t * (coords[b][2] - coords[a][2]);
+    // Drop the levels that were removed, and extract the ones that were added
+    //
+    auto &levels = _contourCache->levels;
+    for (auto itr = levels.begin(); itr != levels.end();) {
+        if (std::binary_search(contours.begin(), contours.end(), itr->first))
+            ++itr;
+        else
+            itr = levels.erase(itr);
+    }
 
-                if (dims == 2) v[2] = Z0;
+    vector<double> newLevels;
+    for (double c : contours) {
+        if (!levels.count(c)) newLevels.push_back(c);
+    }
 
-                if (heightGrid) {
-                    float aHeight = heightGrid->GetValueAtIndex(nodes[a]);
-                    float bHeight = heightGrid->GetValueAtIndex(nodes[b]);
-                    v[2] = aHeight + t * (bHeight - aHeight);
-                }
+    float Z0 = GetDefaultZ(_dataMgr, _cacheParams.ts);
+    _extractLevels(grid, heightGrid.get(), dims, newLevels, Z0);
 
-                vertices.push_back({v[0], v[1], v[2], contour});
-            }
-        }
-    }
+    vector<VertexData> vertices;
+    size_t             nVertices = 0;
+    for (const auto &level : levels) nVertices += level.second.size();
+    vertices.reserve(nVertices);
+    for (const auto &level : levels) vertices.insert(vertices.end(), level.second.begin(), level.second.end());
 
     _nVertices = vertices.size();
     glBindVertexArray(_VAO);
@@ -264,10 +413,6 @@ int ContourRenderer::_buildCache(bool fast)
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    if (grid) delete grid;
-    if (grid2) delete grid2;
-    if (heightGrid) delete heightGrid;
-
     return 0;
 }
 
@@ -166,6 +166,49 @@ int ControlExec::Paint(string winName, bool fast)
     return rc;
 }
 
+void ControlExec::PrefetchTimesteps(const vector<size_t> &timesteps)
+{
+    vector<string> dataSetNames = _dataStatus->GetDataMgrNames();
+    for (const auto &dataSetName : dataSetNames) {
+        DataMgr *dataMgr = _dataStatus->GetDataMgr(dataSetName);
+        if (!dataMgr) continue;
+
+        dataMgr->CancelPrefetch();
+
+        vector<RenderParams *> rParams;
+        vector<string>         winNames = _paramsMgr->GetVisualizerNames();
+        for (const auto &winName : winNames) {
+            vector<RenderParams *> v;
+            _paramsMgr->GetRenderParams(winName, dataSetName, v);
+            for (auto rp : v) {
+                if (rp->IsEnabled()) rParams.push_back(rp);
+            }
+        }
+        if (rParams.empty()) continue;
+
+        for (auto ts : timesteps) {
+            size_t local_ts = _dataStatus->MapGlobalToLocalTimeStep(dataSetName, ts);
+
+            for (auto rp : rParams) {
+                vector<string> candidates = rp->GetFieldVariableNames();
+                candidates.push_back(rp->GetVariableName());
+                candidates.push_back(rp->GetColorMapVariableName());
+                candidates.push_back(rp->GetHeightVariableName());
+
+                vector<string> varnames;
+                for (const auto &v : candidates) {
+                    if (!v.empty() && !STLUtils::Contains(varnames, v)) varnames.push_back(v);
+                }
+
+                CoordType minExts, maxExts;
+                rp->GetBox()->GetExtents(minExts, maxExts);
+
+                for (const auto &varname : varnames) { (void)dataMgr->Prefetch(local_ts, varname, rp->GetRefinementLevel(), rp->GetCompressionLevel(), minExts, maxExts); }
+            }
+        }
+    }
+}
+
 int ControlExec::ActivateRender(string winName, string dataSetName, string renderType, string renderName, bool on)
 {
     if (!_dataStatus->GetDataMgrNames().size()) {
@@ -586,6 +629,33 @@ int ControlExec::EnableAnimationCapture(string winName, bool onOff, string filen
     return 0;
 }
 
+int ControlExec::SetImageCaptureAsync(string winName, bool onOff)
+{
+    Visualizer *v = getVisualizer(winName);
+    if (!v) {
+        SetErrMsg("Invalid Visualizer \"%s\"", winName.c_str());
+        return -1;
+    }
+
+    v->SetImageCaptureAsync(onOff);
+    return 0;
+}
+
+int ControlExec::WaitForImageCapture(string winName)
+{
+    Visualizer *v = getVisualizer(winName);
+    if (!v) {
+        SetErrMsg("Invalid Visualizer \"%s\"", winName.c_str());
+        return -1;
+    }
+
+    if (v->WaitForImageCapture() < 0) {
+        SetErrMsg("Visualizer (%s) failed to write captured images", winName.c_str());
+        return -1;
+    }
+    return 0;
+}
+
 string ControlExec::MakeStringConformant(string s)
 {
     if (s.empty()) s += "_";
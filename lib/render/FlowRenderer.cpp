@@ -417,14 +417,14 @@ int FlowRenderer::_renderAdvection(const flow::Advection *adv)
         }
 
         for (int s = 0; s < nStreams; s++) {
-            const vector<flow::Particle> &stream = adv->GetStreamAt(s);
+            const flow::Stream &stream = adv->GetStreamAt(s);
             sv.clear();
             int sn = stream.size();
             if (_cache_isSteady) sn = std::min(sn, (int)maxSamples);
 
             for (int i = 0; i < sn + 1; i++) {
                 // "IsSpecial" means don't render this sample.
-                if (i == sn || stream[i].IsSpecial()) {
+                if (i == sn || stream.IsSpecial(i)) {
                     int svn = sv.size();
 
                     if (svn < 2) {
@@ -445,13 +445,12 @@ int FlowRenderer::_renderAdvection(const flow::Advection *adv)
                     sizes.push_back(svn + 2);
                     sv.clear();
                 } else {
-                    const flow::Particle &p = stream[i];
-
                     if (_cache_isSteady) {
-                        sv.push_back({p.location, p.value});
+                        sv.push_back({stream.GetLocation(i), stream.GetValue(i)});
                     } else {
-                        if (p.time > _timestamps.at(_cache_currentTS)) continue;
-                        if (p.time >= startingTime) sv.push_back({p.location, p.value});
+                        double time = stream.GetTime(i);
+                        if (time > _timestamps.at(_cache_currentTS)) continue;
+                        if (time >= startingTime) sv.push_back({stream.GetLocation(i), stream.GetValue(i)});
                     }
                 }
             }
@@ -656,7 +655,7 @@ int FlowRenderer::_renderFromAnAdvectionLegacy(const flow::Advection *adv, FlowP
         for (size_t s = 0; s < numOfStreams; s++) {
             const auto &stream = adv->GetStreamAt(s);
             for (size_t i = 0; i < stream.size() && i < numOfPart; i++) {
-                const auto &p = stream[i];
+                const flow::Particle p = stream[i];
                 _particleHelper1(vec, p, singleColor);
             }    // Finish processing a stream
             if (!vec.empty()) {
@@ -673,7 +672,8 @@ int FlowRenderer::_renderFromAnAdvectionLegacy(const flow::Advection *adv, FlowP
         std::vector<float> vec;
         for (size_t s = 0; s < numOfStreams; s++) {
             const auto &stream = adv->GetStreamAt(s);
-            for (const auto &p : stream) {
+            for (size_t i = 0; i < stream.size(); i++) {
+                const flow::Particle p = stream[i];
                 if (p.IsSpecial())    // If p is a separator, directly send it to the helper function
                 {
                     _particleHelper1(vec, p, singleColor);
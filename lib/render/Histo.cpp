@@ -19,6 +19,8 @@
 #include <vapor/MyBase.h>
 #include <vapor/DataMgrUtils.h>
 #include <vapor/Histo.h>
+#include <vapor/OpenMPSupport.h>
+#include <vapor/utils.h>
 #include <cassert>
 using namespace VAPoR;
 using namespace Wasp;
@@ -86,7 +88,9 @@ void Histo::setBins(const vector<long> &bins)
     for (int i = 0; i < _numBins; i++) _binArray[i] = bins[i];
 }
 
-void Histo::addToBin(float val)
+void Histo::addToBin(float val) { binValue(val, _binArray, _below, _above, _numSamplesBelow, _numSamplesAbove); }
+
+void Histo::binValue(float val, unsigned int *bins, unsigned int *below, unsigned int *above, long &numBelow, long &numAbove) const
 {
     // The additional checks below are because
     // 1. The data min/max are imperfect, e.g. calculated max is 1 but E value of 1.1
@@ -98,22 +102,22 @@ void Histo::addToBin(float val)
     //    >  1 * array size = out of bounds
 
     if (val < _minMapData) {
-        _numSamplesBelow++;
-        if (_below) {
+        numBelow++;
+        if (below) {
             assert(_minMapData - _minData > 0);
             int index = (val - _minData) / (_minMapData - _minData) * _nBinsBelow;
 
             if (index >= _nBinsBelow) index = _nBinsBelow - 1;
-            if (index >= 0) _below[index]++;
+            if (index >= 0) below[index]++;
         }
     } else if (val > _maxMapData) {
-        _numSamplesAbove++;
-        if (_above) {
+        numAbove++;
+        if (above) {
             assert(_maxData - _maxMapData > 0);
             int index = (val - _maxMapData) / (_maxData - _maxMapData) * _nBinsAbove;
 
             if (index < 0) index = 0;
-            if (index < _nBinsAbove) _above[index]++;
+            if (index < _nBinsAbove) above[index]++;
         }
     } else {
         int intVal = 0;
@@ -124,7 +128,7 @@ void Histo::addToBin(float val)
 
         if (intVal < 0) intVal = 0;
         if (intVal >= _numBins) intVal = _numBins - 1;
-        _binArray[intVal]++;
+        bins[intVal]++;
     }
 }
 
@@ -261,17 +265,48 @@ int Histo::Populate(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::Rende
     if (_below) memset(_below, 0, _nBinsBelow * sizeof(*_below));
     if (_above) memset(_above, 0, _nBinsAbove * sizeof(*_above));
 
-    auto samples = GetDataSamples(varName, dm, rp);
-    for (const auto &sample : samples)
-        addToBin(sample);
+    // The data range is part of the key check as well: it changes when a
+    // variable is redefined or its data are purged from the DataMgr
+    //
+    CacheKey key(dm, varName, ts, refLevel, lod, minExtsVec, maxExtsVec, _numBins, _minMapData, _maxMapData);
+    auto     itr = _cache.find(key);
+    if (itr != _cache.end() && itr->second.minData == _minData && itr->second.maxData == _maxData) {
+        loadCounts(itr->second.counts);
+        itr->second.lastUsed = ++_cacheClock;
+        _cacheHits++;
+    } else {
+        _cacheMisses++;
+        Grid *grid = getGrid(varName, dm, rp);
+        if (grid) {
+            if (shouldUseSampling(varName, dm, rp))
+                populateSamplingHistogram(grid, minExtsVec, maxExtsVec);
+            else
+                populateIteratingHistogram(grid, calculateStride(varName, dm, rp));
+
+            dm->UnlockGrid(grid);
+            delete grid;
+
+            if (itr == _cache.end() && _cache.size() >= _cacheMaxEntries) {
+                auto lru = _cache.begin();
+                for (auto i = _cache.begin(); i != _cache.end(); ++i)
+                    if (i->second.lastUsed < lru->second.lastUsed) lru = i;
+                _cache.erase(lru);
+            }
+            CacheEntry &entry = _cache[key];
+            storeCounts(entry.counts);
+            entry.minData = _minData;
+            entry.maxData = _maxData;
+            entry.lastUsed = ++_cacheClock;
+        }
+    }
 
     calculateMaxBinSize();
     _populated = true;
 
     return 0;
 }
-    
-vector<float> Histo::GetDataSamples(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp)
+
+Grid *Histo::getGrid(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp)
 {
     size_t         ts = rp->GetCurrentTimestep();
     int            refLevel = rp->GetRefinementLevel();
@@ -283,13 +318,22 @@ vector<float> Histo::GetDataSamples(const std::string &varName, VAPoR::DataMgr *
     CoordType maxExts = {0.0, 0.0, 0.0};
     Grid::CopyToArr3(minExtsVec, minExts);
     Grid::CopyToArr3(maxExtsVec, maxExts);
-    
+
     Grid *grid;
     int   rc = DataMgrUtils::GetGrids(dm, ts, varName, minExts, maxExts, true, &refLevel, &lod, &grid);
-
-    if (rc < 0) return vector<float>();
+    if (rc < 0) return nullptr;
 
     grid->SetInterpolationOrder(1);
+    return grid;
+}
+
+vector<float> Histo::GetDataSamples(const std::string &varName, VAPoR::DataMgr *dm, VAPoR::RenderParams *rp)
+{
+    vector<double> minExtsVec, maxExtsVec;
+    rp->GetBox()->GetExtents(minExtsVec, maxExtsVec);
+
+    Grid *grid = getGrid(varName, dm, rp);
+    if (!grid) return vector<float>();
 
     vector<float> samples;
     if (shouldUseSampling(varName, dm, rp))
@@ -332,22 +376,61 @@ int Histo::PopulateIfNeeded(const std::string &varName, VAPoR::DataMgr *dm, VAPo
     return Populate(varName, dm, rp);
 }
 
+// Calls f(thread, value) for every stride'th value of the grid, skipping
+// missing values
+//
+template<typename F> static void forEachStridedValue(const Grid *grid, const int stride, F f, bool parallel)
+{
+    const float    missingValue = grid->GetMissingValue();
+    const DimsType dims = grid->GetDimensions();
+
+    grid->ForEachBlock(
+        [&](const float *span, size_t n, const DimsType &origin) {
+            int    thread = omp_get_thread_num();
+            size_t index = origin[0] + dims[0] * (origin[1] + dims[1] * origin[2]);
+            for (size_t i = (stride - index % stride) % stride; i < n; i += stride) {
+                if (span[i] != missingValue) f(thread, span[i]);
+            }
+        },
+        parallel);
+}
+
 vector<float> Histo::getDataSamplesIterating(const Grid *grid, const int stride)
 {
     VAssert(grid);
+    VAssert(stride > 0);
     vector<float> samples;
 
-    float               missingValue = grid->GetMissingValue();
-    Grid::ConstIterator enditr = grid->cend();
+    forEachStridedValue(grid, stride, [&](int, float v) { samples.push_back(v); }, false);
 
-    for (auto itr = grid->cbegin(); itr != enditr; itr += stride) {
-        float v = *itr;
-        if (v != missingValue) samples.push_back(v);
-    }
-    
     return samples;
 }
 
+// The samples are binned directly, without being copied, by all threads,
+// each into its own counts
+//
+void Histo::populateIteratingHistogram(const Grid *grid, const int stride)
+{
+    VAssert(grid);
+    VAssert(stride > 0);
+
+    int            nThreads = omp_get_max_threads();
+    vector<Counts> threadCounts(nThreads);
+    for (auto &counts : threadCounts) newCounts(counts);
+
+    forEachStridedValue(
+        grid, stride,
+        [&](int thread, float v) {
+            Counts &      counts = threadCounts[thread];
+            unsigned int *below = counts.below.empty() ? nullptr : counts.below.data();
+            unsigned int *above = counts.above.empty() ? nullptr : counts.above.data();
+            binValue(v, counts.bins.data(), below, above, counts.numBelow, counts.numAbove);
+        },
+        true);
+
+    sumCounts(threadCounts);
+}
+
 #define X 0
 #define Y 1
 #define Z 2
@@ -402,6 +485,54 @@ vector<float> Histo::getDataSamplesSampling(const Grid *grid, const vector<doubl
     return samples;
 }
 
+void Histo::populateSamplingHistogram(const Grid *grid, const vector<double> &minExts, const vector<double> &maxExts)
+{
+    VAssert(grid);
+    VAssert(minExts.size() == 3 && maxExts.size() == 3);
+
+    std::vector<double> deltas = {(maxExts[X] - minExts[X]) / SAMPLE_RATE, (maxExts[Y] - minExts[Y]) / SAMPLE_RATE, (maxExts[Z] - minExts[Z]) / SAMPLE_RATE};
+
+    int iSamples = deltas[X] == 0 ? 1 : SAMPLE_RATE;
+    int jSamples = deltas[Y] == 0 ? 1 : SAMPLE_RATE;
+    int kSamples = deltas[Z] == 0 ? 1 : SAMPLE_RATE;
+
+    const float missingValue = grid->GetMissingValue();
+
+    // The grid caches its extents on first use. Do that here rather than
+    // from several threads at once
+    //
+    CoordType minu, maxu;
+    grid->GetUserExtents(minu, maxu);
+
+    int            nThreads = omp_get_max_threads();
+    vector<Counts> threadCounts(nThreads);
+    for (auto &counts : threadCounts) newCounts(counts);
+
+    #pragma omp parallel
+    {
+        Counts &            counts = threadCounts[omp_get_thread_num()];
+        unsigned int *      below = counts.below.empty() ? nullptr : counts.below.data();
+        unsigned int *      above = counts.above.empty() ? nullptr : counts.above.data();
+        std::vector<double> coords(3, 0.0);
+
+        #pragma omp for schedule(dynamic)
+        for (int jk = 0; jk < jSamples * kSamples; jk++) {
+            int j = jk % jSamples;
+            int k = jk / jSamples;
+            coords[Z] = minExts[Z] + deltas[Z] / 2.f + k * deltas[Z];
+            coords[Y] = minExts[Y] + deltas[Y] / 2.f + j * deltas[Y];
+
+            for (int i = 0; i < iSamples; i++) {
+                coords[X] = minExts[X] + deltas[X] / 2.f + i * deltas[X];
+                float varValue = grid->GetValue(coords);
+                if (varValue != missingValue) binValue(varValue, counts.bins.data(), below, above, counts.numBelow, counts.numAbove);
+            }
+        }
+    }
+
+    sumCounts(threadCounts);
+}
+
 #undef X
 #undef Y
 #undef Z
@@ -449,3 +580,42 @@ void Histo::_getDataRange(const std::string &varName, VAPoR::DataMgr *d, VAPoR::
     *min = range[0];
     *max = range[1];
 }
+
+void Histo::newCounts(Counts &counts) const
+{
+    counts.bins.assign(_numBins, 0);
+    counts.below.assign(_nBinsBelow, 0);
+    counts.above.assign(_nBinsAbove, 0);
+    counts.numBelow = 0;
+    counts.numAbove = 0;
+}
+
+void Histo::sumCounts(const vector<Counts> &threadCounts)
+{
+    for (const auto &counts : threadCounts) {
+        for (int i = 0; i < _numBins; i++) _binArray[i] += counts.bins[i];
+        for (int i = 0; i < _nBinsBelow; i++) _below[i] += counts.below[i];
+        for (int i = 0; i < _nBinsAbove; i++) _above[i] += counts.above[i];
+        _numSamplesBelow += counts.numBelow;
+        _numSamplesAbove += counts.numAbove;
+    }
+}
+
+void Histo::storeCounts(Counts &counts) const
+{
+    counts.bins.assign(_binArray, _binArray + _numBins);
+    counts.below.assign(_below, _below + _nBinsBelow);
+    counts.above.assign(_above, _above + _nBinsAbove);
+    counts.numBelow = _numSamplesBelow;
+    counts.numAbove = _numSamplesAbove;
+}
+
+void Histo::loadCounts(const Counts &counts)
+{
+    VAssert(counts.bins.size() == _numBins && counts.below.size() == _nBinsBelow && counts.above.size() == _nBinsAbove);
+    std::copy(counts.bins.begin(), counts.bins.end(), _binArray);
+    std::copy(counts.below.begin(), counts.below.end(), _below);
+    std::copy(counts.above.begin(), counts.above.end(), _above);
+    _numSamplesBelow = counts.numBelow;
+    _numSamplesAbove = counts.numAbove;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include "vapor/ImageWriterPool.h"
+
+using namespace VAPoR;
+using namespace Wasp;
+
+ImageWriterPool::ImageWriterPool(int nThreads, int maxQueued) : _busy(0), _stop(false)
+{
+    if (nThreads < 1) nThreads = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+    if (maxQueued < 1) maxQueued = 2 * nThreads;
+    _maxQueued = maxQueued;
+
+    for (int i = 0; i < nThreads; i++) _threads.push_back(std::thread(&ImageWriterPool::_worker, this));
+}
+
+ImageWriterPool::~ImageWriterPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cond.notify_all();
+
+    // Workers drain the queue before exiting
+    //
+    for (auto &t : _threads) t.join();
+}
+
+int ImageWriterPool::Write(std::unique_ptr<ImageWriter> writer, std::vector<unsigned char> pixels, int width, int height)
+{
+    Job job;
+    job.writer = std::move(writer);
+    job.pixels = std::move(pixels);
+    job.width = width;
+    job.height = height;
+
+    if (!job.writer->IsThreadSafe()) {
+        if (!_write(job)) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _failed.push_back(job.writer->GetPath());
+        }
+        return (_reportFailures());
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cond.wait(lock, [this] { return (_queue.size() < _maxQueued); });
+        _queue.push_back(std::move(job));
+    }
+    _cond.notify_all();
+
+    return (_reportFailures());
+}
+
+int ImageWriterPool::Wait()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cond.wait(lock, [this] { return (_queue.empty() && _busy == 0); });
+    }
+    return (_reportFailures());
+}
+
+void ImageWriterPool::_worker()
+{
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, [this] { return (!_queue.empty() || _stop); });
+            if (_queue.empty()) return;    // Stopped and drained
+
+            job = std::move(_queue.front());
+            _queue.pop_front();
+            _busy++;
+        }
+        _cond.notify_all();    // Room in the queue
+
+        bool ok = _write(job);
+
+        // Close the file before the image is reported as written
+        //
+        string path = job.writer->GetPath();
+        job.writer.reset();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!ok) _failed.push_back(path);
+            _busy--;
+        }
+        _cond.notify_all();
+    }
+}
+
+bool ImageWriterPool::_write(Job &job) { return (job.writer->Write(job.pixels.data(), job.width, job.height) >= 0); }
+
+int ImageWriterPool::_reportFailures()
+{
+    std::vector<string> failed;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        failed.swap(_failed);
+    }
+
+    for (auto &path : failed) SetErrMsg("Failed to write image file \"%s\"", path.c_str());
+    return (failed.empty() ? 0 : -1);
+}
@@ -1,7 +1,13 @@
 #include "vapor/PNGWriter.h"
 #include "vapor/VAssert.h"
 
-#define USE_PYTHON_PNG 1
+// libpng is used when the build finds it (see lib/render/CMakeLists.txt)
+//
+#ifdef USE_LIBPNG
+    #define USE_PYTHON_PNG 0
+#else
+    #define USE_PYTHON_PNG 1
+#endif
 
 #if USE_PYTHON_PNG
     #include "vapor/MyPython.h"
@@ -18,6 +24,11 @@ std::vector<std::string> PNGWriter::GetFileExtensions() { return {"png"}; }
 
 PNGWriter::PNGWriter(const string &path) : ImageWriter(path) {}
 
+// The embedded interpreter's lock is held by the thread that initialized it,
+// whereas libpng keeps all of its state in the structures of each write
+//
+bool PNGWriter::IsThreadSafe() const { return (!USE_PYTHON_PNG); }
+
 int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, const unsigned int height)
 {
 #if USE_PYTHON_PNG
@@ -87,20 +98,25 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     return 0;
 #else
-    int         code = 0;
-    FILE *      fp = NULL;
-    png_structp png_ptr = NULL;
-    png_infop   info_ptr = NULL;
-    png_bytep   row = NULL;
+    VAssert(format == Format::RGB);
 
-    fp = fopen(file, "wb");
-    if (!fp) return -1;
+    FILE *fp = fopen(path.c_str(), "wb");
+    if (!fp) {
+        MyBase::SetErrMsg("Unable to open PNG file for writing: \"%s\"", path.c_str());
+        return -1;
+    }
 
-    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (png_ptr == NULL) VAssert(0);
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop   info_ptr = png_ptr ? png_create_info_struct(png_ptr) : NULL;
 
-    info_ptr = png_create_info_struct(png_ptr);
-    if (info_ptr == NULL) VAssert(0);
+    // libpng reports errors by jumping back here
+    //
+    if (!info_ptr || setjmp(png_jmpbuf(png_ptr))) {
+        png_destroy_write_struct(&png_ptr, &info_ptr);
+        fclose(fp);
+        MyBase::SetErrMsg("Failed to write PNG file \"%s\"", path.c_str());
+        return -1;
+    }
 
     png_init_io(png_ptr, fp);
 
@@ -108,13 +124,17 @@ int PNGWriter::Write(const unsigned char *buffer, const unsigned int width, cons
 
     png_write_info(png_ptr, info_ptr);
 
-    #error Functionality Not Finished
+    // Rows are stored top to bottom, as for the python writer
+    //
+    for (unsigned int y = 0; y < height; y++) png_write_row(png_ptr, (png_const_bytep)(buffer + (size_t)y * width * 3));
 
     png_write_end(png_ptr, NULL);
-    if (fp) fclose(fp);
-    if (info_ptr) png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
-    if (png_ptr) png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+    png_destroy_write_struct(&png_ptr, &info_ptr);
 
+    if (fclose(fp) != 0) {
+        MyBase::SetErrMsg("Failed to write PNG file \"%s\"", path.c_str());
+        return -1;
+    }
     return 0;
 #endif
 }
@@ -440,28 +440,28 @@ int RayCaster::UserCoordinates::Update2ndVariable(const RayCasterParams *params,
 
 void RayCaster::UserCoordinates::IterateAGrid(const StructuredGrid *grid, size_t numOfVert, float *dataBuf, unsigned char *maskBuf)
 {
-    StructuredGrid::ConstIterator valItr = grid->cbegin();
-
-    if (grid->HasMissingData()) {
-        float missingValue = grid->GetMissingValue();
-        float dataValue;
-        for (size_t i = 0; i < numOfVert; i++) {
-            dataValue = *valItr;
-            if (dataValue == missingValue) {
-                dataBuf[i] = 0.0f;
-                maskBuf[i] = 127u;
+    const auto &gridDims = grid->GetDimensions();
+    VAssert(numOfVert == gridDims[0] * gridDims[1] * gridDims[2]);
+
+    const bool  hasMissing = grid->HasMissingData();
+    const float missingValue = grid->GetMissingValue();
+
+    grid->ForEachBlock(
+        [&](const float *span, size_t n, const DimsType &origin) {
+            size_t offset = origin[0] + gridDims[0] * (origin[1] + gridDims[1] * origin[2]);
+            float *data = dataBuf + offset;
+            if (hasMissing) {
+                unsigned char *mask = maskBuf + offset;
+                for (size_t i = 0; i < n; i++) {
+                    bool missing = span[i] == missingValue;
+                    data[i] = missing ? 0.0f : span[i];
+                    mask[i] = missing ? 127u : 0u;
+                }
             } else {
-                dataBuf[i] = dataValue;
-                maskBuf[i] = 0u;
+                std::copy(span, span + n, data);
             }
-            ++valItr;
-        }
-    } else {
-        for (size_t i = 0; i < numOfVert; i++) {
-            dataBuf[i] = *valItr;
-            ++valItr;
-        }
-    }
+        },
+        true);
 }
 
 void RayCaster::UserCoordinates::FillCoordsXYPlane(const StructuredGrid *grid, size_t planeIdx, float *coords)
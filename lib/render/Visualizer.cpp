@@ -45,6 +45,7 @@
 #include <vapor/ShaderManager.h>
 
 #include "vapor/ImageWriter.h"
+#include "vapor/ImageWriterPool.h"
 #include "vapor/GeoTIFWriter.h"
 
 using namespace VAPoR;
@@ -61,6 +62,7 @@ Visualizer::Visualizer(const ParamsMgr *pm, const DataStatus *dataStatus, string
     _insideGLContext = false;
     _imageCaptureEnabled = false;
     _animationCaptureEnabled = false;
+    _asyncCapture = false;
 
     _renderers.clear();
     _renderersToDestroy.clear();
@@ -82,6 +84,13 @@ Visualizer::~Visualizer()
 
     if (_screenQuadVAO) glDeleteVertexArrays(1, &_screenQuadVAO);
     if (_screenQuadVBO) glDeleteBuffers(1, &_screenQuadVBO);
+
+    // Don't lose the last frames of an asynchronous capture
+    //
+    if (_imageWriterPool) {
+        (void)WaitForImageCapture();
+        _deletePixelBuffers();
+    }
 }
 
 int Visualizer::resizeGL(int wid, int ht) { return 0; }
@@ -490,16 +499,14 @@ int Visualizer::_captureImage(std::string path)
     // Turn off the single capture flag
     _imageCaptureEnabled = false;
 
-    ViewpointParams *vpParams = getActiveViewpointParams();
-    int              width, height;
+    int width, height;
     //	vpParams->GetWindowSize(width, height);
     _framebuffer.GetSize(&width, &height);
 
-    vector<unsigned char> framebuffer(3 * width * height);
-    int                   writeReturn = -1;
-    _getPixelData(framebuffer.data());
-
     if (STLUtils::BeginsWith(path, ":RAM:")) {
+        vector<unsigned char> framebuffer(3 * width * height);
+        _getPixelData(framebuffer.data());
+
         void *ptr;
         sscanf(path.c_str(), ":RAM:%p", &ptr);
 
@@ -508,101 +515,207 @@ int Visualizer::_captureImage(std::string path)
         return 0;
     }
 
+    std::unique_ptr<ImageWriter> writer;
+    int                          crop[4];
+    if (_createImageWriter(path, width, height, writer, crop) < 0) return -1;
+
+    if (_asyncCapture) return _captureImageAsync(std::move(writer), width, height, crop);
+
+    // Asynchronous capture may have been turned off with images still
+    // waiting to be read back
+    //
+    int rc = _flushPendingCaptures(0);
+
+    vector<unsigned char> framebuffer(3 * width * height);
+    _getPixelData(framebuffer.data());
+
+    if (crop[2] != width || crop[3] != height) {
+        vector<unsigned char> croppedFB(3 * crop[2] * crop[3]);
+        for (int y = 0; y < crop[3]; y++) memcpy(&croppedFB[3 * y * crop[2]], &framebuffer[3 * ((y + crop[1]) * width + crop[0])], 3 * crop[2]);
+
+        framebuffer = croppedFB;
+    }
+
+    if (writer->Write(framebuffer.data(), crop[2], crop[3]) < 0) rc = -1;
+    return rc;
+}
+
+int Visualizer::_createImageWriter(std::string path, int width, int height, std::unique_ptr<ImageWriter> &writer, int crop[4]) const
+{
+    crop[0] = 0;
+    crop[1] = 0;
+    crop[2] = width;
+    crop[3] = height;
+
+    ViewpointParams *vpParams = getActiveViewpointParams();
+
     if (FileUtils::Extension(path) == "") path += ".png";
-    bool         geoTiffOutput = vpParams->GetProjectionType() == ViewpointParams::MapOrthographic && (FileUtils::Extension(path) == "tif" || FileUtils::Extension(path) == "tiff");
-    ImageWriter *writer = nullptr;
+    bool geoTiffOutput = vpParams->GetProjectionType() == ViewpointParams::MapOrthographic && (FileUtils::Extension(path) == "tif" || FileUtils::Extension(path) == "tiff");
 
     if (geoTiffOutput)
-        writer = new GeoTIFWriter(path);
+        writer.reset(new GeoTIFWriter(path));
     else
-        writer = ImageWriter::CreateImageWriterForFile(path);
-    if (writer == nullptr) goto captureImageEnd;
+        writer.reset(ImageWriter::CreateImageWriterForFile(path));
+    if (!writer) return -1;
+
+    if (!geoTiffOutput) return 0;
 
-    if (geoTiffOutput) {
-        VAssert(_dataStatus->GetDataMgrNames().size());
-        string projString = _dataStatus->GetDataMgr(_dataStatus->GetDataMgrNames()[0])->GetMapProjection();
+    VAssert(_dataStatus->GetDataMgrNames().size());
+    string projString = _dataStatus->GetDataMgr(_dataStatus->GetDataMgrNames()[0])->GetMapProjection();
 
-        CoordType dataMinExtents, dataMaxExtents;
-        _dataStatus->GetActiveExtents(_paramsMgr, _winName, _getCurrentTimestep(), dataMinExtents, dataMaxExtents);
+    CoordType dataMinExtents, dataMaxExtents;
+    _dataStatus->GetActiveExtents(_paramsMgr, _winName, _getCurrentTimestep(), dataMinExtents, dataMaxExtents);
 
-        double m[16];
-        vpParams->GetModelViewMatrix(m);
-        double posvec[3], upvec[3], dirvec[3];
-        vpParams->ReconstructCamera(m, posvec, upvec, dirvec);
+    double m[16];
+    vpParams->GetModelViewMatrix(m);
+    double posvec[3], upvec[3], dirvec[3];
+    vpParams->ReconstructCamera(m, posvec, upvec, dirvec);
 
-        float s = vpParams->GetOrthoProjectionSize();
-        float x = posvec[0];
-        float y = posvec[1];
-        float aspect = width / (float)height;
+    float s = vpParams->GetOrthoProjectionSize();
+    float x = posvec[0];
+    float y = posvec[1];
+    float aspect = width / (float)height;
 
-        float pixelScale[2] = {s * aspect * 2 / (float)width, s * 2 / (float)height};
+    float pixelScale[2] = {s * aspect * 2 / (float)width, s * 2 / (float)height};
 
-        // Crop to data extents
+    // Crop to data extents
 
-        double cameraMinExtents[2] = {x - s * aspect, y - s};
-        double cameraMaxExtents[2] = {x + s * aspect, y + s};
+    double cameraMinExtents[2] = {x - s * aspect, y - s};
+    double cameraMaxExtents[2] = {x + s * aspect, y + s};
 
-        int    cropMin[2] = {0, 0};
-        double newCameraMinExtents[2] = {cameraMinExtents[0], cameraMinExtents[1]};
-        for (int i = 0; i < 2; i++) {
-            if (cameraMinExtents[i] < dataMinExtents[i]) {
-                newCameraMinExtents[i] = dataMinExtents[i];
-                cropMin[i] = (dataMinExtents[i] - cameraMinExtents[i]) / pixelScale[i];
-            }
+    int    cropMin[2] = {0, 0};
+    double newCameraMinExtents[2] = {cameraMinExtents[0], cameraMinExtents[1]};
+    for (int i = 0; i < 2; i++) {
+        if (cameraMinExtents[i] < dataMinExtents[i]) {
+            newCameraMinExtents[i] = dataMinExtents[i];
+            cropMin[i] = (dataMinExtents[i] - cameraMinExtents[i]) / pixelScale[i];
         }
+    }
 
-        int    cropMax[2] = {(int)width, (int)height};
-        double newCameraMaxExtents[2] = {cameraMaxExtents[0], cameraMaxExtents[1]};
-        for (int i = 0; i < 2; i++) {
-            if (cameraMaxExtents[i] > dataMaxExtents[i]) {
-                newCameraMaxExtents[i] = dataMaxExtents[i];
-                cropMax[i] = cropMax[i] - (cameraMaxExtents[i] - dataMaxExtents[i]) / pixelScale[i];
-            }
+    int    cropMax[2] = {(int)width, (int)height};
+    double newCameraMaxExtents[2] = {cameraMaxExtents[0], cameraMaxExtents[1]};
+    for (int i = 0; i < 2; i++) {
+        if (cameraMaxExtents[i] > dataMaxExtents[i]) {
+            newCameraMaxExtents[i] = dataMaxExtents[i];
+            cropMax[i] = cropMax[i] - (cameraMaxExtents[i] - dataMaxExtents[i]) / pixelScale[i];
         }
+    }
 
-        int croppedWidth = cropMax[0] - cropMin[0];
-        int croppedHeight = cropMax[1] - cropMin[1];
+    int croppedWidth = cropMax[0] - cropMin[0];
+    int croppedHeight = cropMax[1] - cropMin[1];
 
-        if (croppedWidth <= 0 || croppedHeight <= 0) {
-            MyBase::SetErrMsg("Dataset not visible");
-            writeReturn = -1;
-            goto captureImageEnd;
-        }
+    if (croppedWidth <= 0 || croppedHeight <= 0) {
+        MyBase::SetErrMsg("Dataset not visible");
+        return -1;
+    }
 
-        // flip Y
-        int temp = cropMin[1];
-        cropMin[1] = height - cropMax[1];
-        cropMax[1] = height - temp;
+    // flip Y
+    int temp = cropMin[1];
+    cropMin[1] = height - cropMax[1];
+    cropMax[1] = height - temp;
 
-        vector<unsigned char> croppedFB(3 * croppedWidth * croppedHeight);
-        for (int y = 0; y < croppedHeight; y++) memcpy(&croppedFB[3 * y * croppedWidth], &framebuffer[3 * ((y + cropMin[1]) * width + cropMin[0])], 3 * croppedWidth);
+    crop[0] = cropMin[0];
+    crop[1] = cropMin[1];
+    crop[2] = croppedWidth;
+    crop[3] = croppedHeight;
 
-        framebuffer = croppedFB;
+    s *= croppedHeight / (float)height;
+
+    x = (newCameraMaxExtents[0] - newCameraMinExtents[0]) / 2 + newCameraMinExtents[0];
+    y = (newCameraMaxExtents[1] - newCameraMinExtents[1]) / 2 + newCameraMinExtents[1];
+
+    width = croppedWidth;
+    height = croppedHeight;
+    aspect = width / (float)height;
 
-        s *= croppedHeight / (float)height;
+    GeoTIFWriter *geo = (GeoTIFWriter *)writer.get();
+    geo->SetTiePoint(x, y, width / 2.f, height / 2.f);
+    geo->SetPixelScale(s * aspect * 2 / (float)width, s * 2 / (float)height);
+    if (geo->ConfigureFromProj4(projString) < 0) return -1;
 
-        x = (newCameraMaxExtents[0] - newCameraMinExtents[0]) / 2 + newCameraMinExtents[0];
-        y = (newCameraMaxExtents[1] - newCameraMinExtents[1]) / 2 + newCameraMinExtents[1];
+    return 0;
+}
+
+int Visualizer::_captureImageAsync(std::unique_ptr<ImageWriter> writer, int width, int height, const int crop[4])
+{
+    if (!_imageWriterPool) _imageWriterPool.reset(new ImageWriterPool());
+
+    PendingCapture capture;
+    capture.writer = std::move(writer);
+    capture.width = width;
+    capture.height = height;
+    for (int i = 0; i < 4; i++) capture.crop[i] = crop[i];
+
+    if (_freePixelBuffers.size()) {
+        capture.pbo = _freePixelBuffers.back();
+        _freePixelBuffers.pop_back();
+    } else {
+        glGenBuffers(1, &capture.pbo);
+    }
+
+    // Start the read back. glReadPixels() returns without waiting for the
+    // transfer when a pixel pack buffer is bound
+    //
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, 3 * width * height, NULL, GL_STREAM_READ);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-        width = croppedWidth;
-        height = croppedHeight;
-        aspect = width / (float)height;
+    _pendingCaptures.push_back(std::move(capture));
 
-        GeoTIFWriter *geo = (GeoTIFWriter *)writer;
-        geo->SetTiePoint(x, y, width / 2.f, height / 2.f);
-        geo->SetPixelScale(s * aspect * 2 / (float)width, s * 2 / (float)height);
-        if (geo->ConfigureFromProj4(projString) < 0) {
-            writeReturn = -1;
-            goto captureImageEnd;
+    // The previous frame's transfer has had a whole frame to complete
+    //
+    return _flushPendingCaptures(1);
+}
+
+int Visualizer::_flushPendingCaptures(size_t keep)
+{
+    int rc = 0;
+    while (_pendingCaptures.size() > keep) {
+        PendingCapture &capture = _pendingCaptures.front();
+        const int      w = capture.crop[2];
+        const int      h = capture.crop[3];
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo);
+        const unsigned char *src = (const unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, 3 * capture.width * capture.height, GL_MAP_READ_BIT);
+        if (src) {
+            // GL returns the bottom row first. Flip and crop while copying
+            //
+            vector<unsigned char> pixels(3 * w * h);
+            for (int y = 0; y < h; y++) {
+                int row = capture.height - 1 - (capture.crop[1] + y);
+                memcpy(&pixels[3 * y * w], src + 3 * (row * capture.width + capture.crop[0]), 3 * w);
+            }
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+            if (_imageWriterPool->Write(std::move(capture.writer), std::move(pixels), w, h) < 0) rc = -1;
+        } else {
+            SetErrMsg("Error obtaining GL framebuffer data");
+            rc = -1;
         }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        _freePixelBuffers.push_back(capture.pbo);
+        _pendingCaptures.pop_front();
     }
+    return rc;
+}
 
-    writeReturn = writer->Write(framebuffer.data(), width, height);
+int Visualizer::WaitForImageCapture()
+{
+    int rc = _flushPendingCaptures(0);
+    if (_imageWriterPool && _imageWriterPool->Wait() < 0) rc = -1;
+    return rc;
+}
 
-captureImageEnd:
-    if (writer) delete writer;
+void Visualizer::_deletePixelBuffers()
+{
+    for (auto &capture : _pendingCaptures) _freePixelBuffers.push_back(capture.pbo);
+    _pendingCaptures.clear();
 
-    return writeReturn;
+    if (_freePixelBuffers.size()) glDeleteBuffers(_freePixelBuffers.size(), _freePixelBuffers.data());
+    _freePixelBuffers.clear();
 }
 
 bool Visualizer::_getPixelData(unsigned char *data) const
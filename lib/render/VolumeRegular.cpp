@@ -65,35 +65,42 @@ int VolumeRegular::_loadDataDirect(const Grid *grid, Texture3D *dataTexture, Tex
         return -1;
     }
 
-    Progress::Start("Load volume data", nVerts, true);
-    auto dataIt = grid->cbegin();
-    for (size_t i = 0; i < nVerts; ++i, ++dataIt) {
-        Progress::Update(i);
+    *hasMissingData = grid->HasMissingData();
+    const float    missingValue = grid->GetMissingValue();
+    unsigned char *missingMask = *hasMissingData ? new unsigned char[nVerts] : nullptr;
+
+    // The data are copied a Z slice at a time, each slice in parallel, so
+    // that progress can be reported and the load cancelled
+    //
+    Progress::Start("Load volume data", dims[2], true);
+    for (size_t k = 0; k < dims[2]; k++) {
+        Progress::Update(k);
         if (Progress::Cancelled()) {
             delete[] data;
+            if (missingMask) delete[] missingMask;
             return -1;
         }
-        data[i] = *dataIt;
+        grid->ForEachBlock(
+            {0, 0, k}, {dims[0] - 1, dims[1] - 1, k},
+            [&](const float *span, size_t n, const DimsType &origin) {
+                size_t offset = origin[0] + dims[0] * (origin[1] + dims[1] * origin[2]);
+                std::copy(span, span + n, data + offset);
+                if (missingMask) {
+                    for (size_t i = 0; i < n; i++) missingMask[offset + i] = span[i] == missingValue ? 255 : 0;
+                }
+            },
+            true);
     }
     Progress::Finish();
 
     int ret = dataTexture->TexImage(GL_R32F, dims[0], dims[1], dims[2], GL_RED, GL_FLOAT, data);
 
-    *hasMissingData = grid->HasMissingData();
-    if (ret == 0 && *hasMissingData) {
-        const float    missingValue = grid->GetMissingValue();
-        unsigned char *missingMask = new unsigned char[nVerts];
-        memset(missingMask, 0, nVerts);
-
-        for (size_t i = 0; i < nVerts; i++)
-            if (data[i] == missingValue) missingMask[i] = 255;
-
+    if (ret == 0 && missingMask) {
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
         ret = missingTexture->TexImage(GL_R8, dims[0], dims[1], dims[2], GL_RED, GL_UNSIGNED_BYTE, missingMask);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-
-        delete[] missingMask;
     }
+    if (missingMask) delete[] missingMask;
 
     delete[] data;
     return ret;
@@ -1,4 +1,5 @@
 #include <vapor/VolumeResampled.h>
+#include <algorithm>
 #include <vector>
 #include <vapor/glutil.h>
 #include <glm/glm.hpp>
@@ -7,50 +8,56 @@ using std::vector;
 
 using namespace VAPoR;
 
-// static VolumeAlgorithmRegistrar<VolumeResampled> registration;
+static VolumeAlgorithmRegistrar<VolumeResampled> registration;
 
 int VolumeResampled::LoadData(const Grid *grid)
 {
-    VolumeRegular::LoadData(grid);
-#define S 1
-    const vector<size_t> dims = grid->GetDimensions();
-    const size_t         w = dims[0] * S, h = dims[1] * S, d = dims[2] * S;
-    float *              data = new float[w * h * d];
-
-    vector<double> min, max;
-    grid->GetUserExtents(min, max);
-
-    for (int z = 0; z < d; z++) {
-        printf("Resampling... %i/%li\n", z, d);
-        const float zSamplePos = (z + 0.5f) / (float)d * (max[2] - min[2]) + min[2];
-        for (int y = 0; y < h; y++) {
-            const float ySamplePos = (y + 0.5f) / (float)h * (max[1] - min[1]) + min[1];
-            for (int x = 0; x < w; x++) {
-                const float xSamplePos = (x + 0.5f) / (float)w * (max[0] - min[0]) + min[0];
-                data[z * w * h + y * w + x] = grid->GetValue(xSamplePos, ySamplePos, zSamplePos);
-            }
-        }
+    VolumeGLSL::LoadData(grid);
+    if (grid->GetNumDimensions() != 3) {
+        Wasp::MyBase::SetErrMsg("Variable has a volume of 0");
+        return -1;
     }
+    auto tmp = grid->GetDimensions();
+    _dataDimensions = {tmp[0], tmp[1], tmp[2]};
+    _hasSecondData = false;
 
-    _data.TexImage(GL_R32F, w, h, d, GL_RED, GL_FLOAT, data);
+    for (int i = 0; i < 3; i++) _resampledDims[i] = std::max((size_t)1, (size_t)(tmp[i] * _resolutionScale));
 
-    _hasMissingData = grid->HasMissingData();
-    if (_hasMissingData) {
-        printf("Loading missing data...\n");
-        const float    missingValue = grid->GetMissingValue();
-        unsigned char *missingMask = new unsigned char[w * h * d];
-        memset(missingMask, 0, w * h * d);
+    return _loadDataResampled(grid, &_data, &_missing, &_hasMissingData);
+}
 
-        for (size_t i = 0; i < w * h * d; i++)
-            if (data[i] == missingValue) missingMask[i] = 255;
+int VolumeResampled::LoadSecondaryData(const Grid *grid)
+{
+    _hasSecondData = false;
+    auto tmp = grid->GetDimensions();
+    auto dims = std::vector<size_t>{tmp[0], tmp[1], tmp[2]};
+    if (_dataDimensions != dims) {
+        Wasp::MyBase::SetErrMsg("Secondary (color mapped) variable has different grid from primary variable");
+        return -1;
+    }
+    if (!_data2.Initialized()) _data2.Generate();
+    if (!_missing2.Initialized()) _missing2.Generate();
+    int ret = _loadDataResampled(grid, &_data2, &_missing2, &_hasMissingData2);
+    if (ret >= 0) _hasSecondData = true;
+    return ret;
+}
 
+int VolumeResampled::_loadDataResampled(const Grid *grid, Texture3D *dataTexture, Texture3D *missingTexture, bool *hasMissingData)
+{
+    const DimsType &dims = _resampledDims;
+    const size_t    nVerts = dims[0] * dims[1] * dims[2];
+
+    vector<float>         data(nVerts);
+    vector<unsigned char> missingMask(nVerts);
+    *hasMissingData = grid->ResampleRegular(dims, data.data(), missingMask.data());
+
+    int ret = dataTexture->TexImage(GL_R32F, dims[0], dims[1], dims[2], GL_RED, GL_FLOAT, data.data());
+
+    if (ret == 0 && *hasMissingData) {
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-        _missing.TexImage(GL_R8, dims[0], dims[1], dims[2], GL_RED, GL_UNSIGNED_BYTE, missingMask);
+        ret = missingTexture->TexImage(GL_R8, dims[0], dims[1], dims[2], GL_RED, GL_UNSIGNED_BYTE, missingMask.data());
         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
-
-        delete[] missingMask;
     }
 
-    delete[] data;
-    return 0;
+    return ret;
 }
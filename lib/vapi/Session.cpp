@@ -156,9 +156,23 @@ int Session::Render(String imagePath, bool fast)
         return -1;
     }
 
+    // The visualizer is recreated when a session is loaded or reset
+    _controlExec->SetImageCaptureAsync(getWinName(), _imageCaptureAsync);
+
     return _renderManager->Render(imagePath, fast);
 }
 
+void Session::SetImageCaptureAsync(bool enabled) { _imageCaptureAsync = enabled; }
+
+int Session::WaitForImageCapture()
+{
+    if (_controlExec->WaitForImageCapture(getWinName()) < 0) {
+        LogWarning("Failed to write rendered images");
+        return -1;
+    }
+    return 0;
+}
+
 void Session::SetTimestep(int ts) { NavigationUtils::SetTimestep(_controlExec, ts); }
 
 
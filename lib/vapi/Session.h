@@ -13,6 +13,7 @@ class Session {
 public:
     ControlExec *  _controlExec = nullptr;
     RenderManager *_renderManager = nullptr;
+    bool           _imageCaptureAsync = false;
 
     Session();
     virtual ~Session();
@@ -32,6 +33,13 @@ public:
     void DeleteRenderer(String name);
 
     int  Render(String imagePath, bool fast=false);
+
+    //! When enabled, Render() returns once the image file has been queued
+    //! rather than written, and the image is encoded in the background
+    //! while the next one is rendered. Call WaitForImageCapture() after
+    //! the last Render() to make sure every file is complete.
+    void SetImageCaptureAsync(bool enabled);
+    int  WaitForImageCapture();
     void SetTimestep(int ts);
     
     static void SetWaspMyBaseErrMsgFilePtrToSTDERR();
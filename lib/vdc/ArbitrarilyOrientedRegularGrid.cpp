@@ -210,22 +210,43 @@ void ArbitrarilyOrientedRegularGrid::_populateData(
     VAPoR::CoordType min = description.boxMin;
     VAPoR::CoordType max = description.boxMax;
     float missingValue = grid->GetMissingValue();
-    size_t index = 0;
 
-    for (size_t j = 0; j < _sideSize; j++) {
-        for (size_t i = 0; i < _sideSize; i++) {
-            VAPoR::CoordType p;
-            GetUserCoordinates({i,j,1}, p);
-
-            if ( p[0] < min[0] || p[0] > max[0] ||
-                 p[1] < min[1] || p[1] > max[1] ||
-                 p[2] < min[2] || p[2] > max[2] ) {
-                _myBlks[index] = missingValue;
-            }
-            else {
-                _myBlks[index] = grid->GetValue(p);
+    // Rows are sampled in parallel. The points of a row that are inside
+    // the box are sampled with a single call to Grid::GetValues(), which
+    // lets grids such as CurvilinearGrid start each cell search from the
+    // cell containing the previous point, rather than from scratch
+    //
+    #pragma omp parallel
+    {
+        std::vector<VAPoR::CoordType> points;
+        std::vector<size_t>           indices;
+        std::vector<float>            values;
+
+        #pragma omp for schedule(dynamic)
+        for (long j = 0; j < (long)_sideSize; j++) {
+            points.clear();
+            indices.clear();
+
+            for (size_t i = 0; i < _sideSize; i++) {
+                size_t index = j*_sideSize + i;
+                VAPoR::CoordType p;
+                GetUserCoordinates({i,(size_t)j,1}, p);
+
+                if ( p[0] < min[0] || p[0] > max[0] ||
+                     p[1] < min[1] || p[1] > max[1] ||
+                     p[2] < min[2] || p[2] > max[2] ) {
+                    _myBlks[index] = missingValue;
+                }
+                else {
+                    points.push_back(p);
+                    indices.push_back(index);
+                }
             }
-            index++;
+
+            values.resize(points.size());
+            grid->GetValues(points.data(), points.size(), values.data());
+            for (size_t n = 0; n < indices.size(); n++)
+                _myBlks[indices[n]] = values[n];
         }
     }
 }
@@ -14,8 +14,19 @@
 #include <cstdio>
 #include <climits>
 #include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifdef WIN32
+    #include <stdlib.h>
+#else
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 #include <vapor/BOVCollection.h>
+#include <vapor/OpenMPSupport.h>
 
 using namespace VAPoR;
 
@@ -27,9 +38,9 @@ const std::string BOVCollection::VARIABLE_TOKEN = "VARIABLE";
 const std::string BOVCollection::ORIGIN_TOKEN = "BRICK_ORIGIN";
 const std::string BOVCollection::BRICK_SIZE_TOKEN = "BRICK_SIZE";
 const std::string BOVCollection::OFFSET_TOKEN = "BYTE_OFFSET";
+const std::string BOVCollection::ENDIAN_TOKEN = "DATA_ENDIAN";
 
 // These tokens are parsed, but not used in ReadRegion() logic
-const std::string BOVCollection::ENDIAN_TOKEN = "DATA_ENDIAN";
 const std::string BOVCollection::CENTERING_TOKEN = "CENTERING";
 const std::string BOVCollection::DIVIDE_BRICK_TOKEN = "DIVIDE_BRICK";
 const std::string BOVCollection::DATA_BRICKLETS_TOKEN = "DATA_BRICKLETS";
@@ -43,9 +54,9 @@ const std::string           BOVCollection::_defaultFile = "";
 const std::string           BOVCollection::_defaultVar = "brickVar";
 const double                BOVCollection::_defaultTime = FLT_MIN;
 const size_t                BOVCollection::_defaultByteOffset = 0;
+const std::string           BOVCollection::_defaultEndian = "LITTLE";
 
 // Currently unused in ReadRegion() logic
-const std::string           BOVCollection::_defaultEndian = "LITTLE";
 const std::string           BOVCollection::_defaultCentering = "ZONAL";
 const bool                  BOVCollection::_defaultDivBrick = false;
 const std::array<size_t, 3> BOVCollection::_defaultBricklets = {0, 0, 0};
@@ -75,12 +86,11 @@ size_t getFileSize(std::string filename)    // path to file
 }    // namespace
 
 BOVCollection::BOVCollection()
-: _time(_defaultTime), _dataFile(_defaultFile), _dataFormat(_defaultFormat), _variable(_defaultVar), _byteOffset(_defaultByteOffset), _divideBrick(_defaultDivBrick), _dataEndian(_defaultEndian),
-  _centering(_defaultCentering), _dataComponents(_defaultComponents), _tmpDataFormat(_defaultFormat), _tmpByteOffset(_defaultByteOffset), _gridSizeAssigned(false), _formatAssigned(false),
-  _brickOriginAssigned(false), _brickSizeAssigned(false), _byteOffsetAssigned(false), _timeDimension(_timeDim)
+: _time(_defaultTime), _dataFile(_defaultFile), _dataFormat(_defaultFormat), _variable(_defaultVar), _byteOffset(_defaultByteOffset), _dataEndian(_defaultEndian), _divideBrick(_defaultDivBrick),
+  _centering(_defaultCentering), _dataComponents(_defaultComponents), _tmpDataFormat(_defaultFormat), _tmpByteOffset(_defaultByteOffset), _tmpDataEndian(_defaultEndian), _gridSizeAssigned(false),
+  _formatAssigned(false), _brickOriginAssigned(false), _brickSizeAssigned(false), _byteOffsetAssigned(false), _dataEndianAssigned(false), _timeDimension(_timeDim)
 {
     // Note: the following variables are unused in the ReadRegion() logic
-    // _defaultEndian
     // _defaultCentering
     // _defaultDivBrick
     // _defaultBricklets
@@ -227,9 +237,14 @@ int BOVCollection::_parseHeader(std::ifstream &header)
         else if (rc == (int)parseCodes::FOUND)
             continue;
 
+        rc = _findToken(ENDIAN_TOKEN, line, _tmpDataEndian);
+        if (rc == (int)parseCodes::PARSE_ERROR)
+            return _invalidValueError(ENDIAN_TOKEN);
+        else if (rc == (int)parseCodes::FOUND)
+            continue;
+
         // All other variables are currently unused.
         //
-        _findToken(ENDIAN_TOKEN, line, _dataEndian);
         _findToken(CENTERING_TOKEN, line, _centering);
         _findToken(DIVIDE_BRICK_TOKEN, line, _divideBrick);
         _findToken(DATA_BRICKLETS_TOKEN, line, _dataBricklets);
@@ -290,6 +305,16 @@ int BOVCollection::_validateParsedValues()
         _byteOffsetAssigned = true;
     }
 
+    // Validate data endianness
+    if (_tmpDataEndian != "LITTLE" && _tmpDataEndian != "BIG")
+        return _invalidValueError(ENDIAN_TOKEN);
+    else if (_tmpDataEndian != _dataEndian && _dataEndianAssigned == true)
+        return _inconsistentValueError(ENDIAN_TOKEN);
+    else {
+        _dataEndian = _tmpDataEndian;
+        _dataEndianAssigned = true;
+    }
+
     if (_variable.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890_-") != std::string::npos) return _invalidVarNameError();
 
     return 0;
@@ -538,26 +563,231 @@ int BOVCollection::_sizeOfFormat(DC::XType type) const
     }
 }
 
-template<class T> int BOVCollection::ReadRegion(std::string varname, size_t ts, const std::vector<size_t> &min, const std::vector<size_t> &max, T region)
+bool BOVCollection::_swapBytes() const
 {
-    float       time = _times[ts];
-    std::string dataFile = _dataFileMap[varname][time];
+    unsigned long LSBTest = 1;
+    bool          hostIsLittle = *(char *)&LSBTest;
+    return (hostIsLittle != (_dataEndian == "LITTLE"));
+}
+
+// A read only memory mapping of a whole data file
+//
+class BOVCollection::MappedFile {
+public:
+    MappedFile() : _data(NULL), _size(0) {}
+    ~MappedFile()
+    {
+#ifndef WIN32
+        if (_data) munmap(_data, _size);
+#endif
+    }
+
+    // Returns false if the file cannot be mapped
+    //
+    bool Map(const std::string &path)
+    {
+#ifdef WIN32
+        // Windows falls back to stdio
+        //
+        return (false);
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return (false);
+
+        struct stat statbuf;
+        if (fstat(fd, &statbuf) < 0 || statbuf.st_size == 0) {
+            close(fd);
+            return (false);
+        }
+
+        void *data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return (false);
+
+        _data = data;
+        _size = statbuf.st_size;
+        return (true);
+#endif
+    }
+
+    const unsigned char *Data() const { return ((const unsigned char *)_data); }
+    size_t               Size() const { return (_size); }
+
+    // Ask the kernel to start reading [offset, offset+length) into memory
+    //
+    void WillNeed(size_t offset, size_t length) const
+    {
+#ifndef WIN32
+        if (offset >= _size) return;
+        length = std::min(length, _size - offset);
+
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t aligned = offset - (offset % page);
+        (void)madvise((char *)_data + aligned, length + (offset - aligned), MADV_WILLNEED);
+#endif
+    }
+
+private:
+    void * _data;
+    size_t _size;
+};
+
+namespace {
+
+// Byte swapping of a single value. The compilers' intrinsics let the loops
+// below vectorize
+//
+inline uint32_t bswap(uint32_t v)
+{
+#ifdef _MSC_VER
+    return (_byteswap_ulong(v));
+#else
+    return (__builtin_bswap32(v));
+#endif
+}
+
+inline uint64_t bswap(uint64_t v)
+{
+#ifdef _MSC_VER
+    return (_byteswap_uint64(v));
+#else
+    return (__builtin_bswap64(v));
+#endif
+}
+
+template<typename S> struct word {
+};
+template<> struct word<int> {
+    typedef uint32_t type;
+};
+template<> struct word<float> {
+    typedef uint32_t type;
+};
+template<> struct word<double> {
+    typedef uint64_t type;
+};
+
+// Convert n values of type S, stored at src with any alignment, to type D
+//
+template<typename S, typename D> void copyValues(const unsigned char *src, size_t n, bool swap, D *dst)
+{
+    if (std::is_same<S, D>::value && !swap) {
+        memcpy(dst, src, n * sizeof(S));
+        return;
+    }
+
+    typedef typename word<S>::type W;
+    if (swap) {
+        for (size_t i = 0; i < n; i++) {
+            W w;
+            memcpy(&w, src + i * sizeof(S), sizeof(S));
+            w = bswap(w);
+            S v;
+            memcpy(&v, &w, sizeof(S));
+            dst[i] = (D)v;
+        }
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            S v;
+            memcpy(&v, src + i * sizeof(S), sizeof(S));
+            dst[i] = (D)v;
+        }
+    }
+}
+
+template<typename D> void copyValues(DC::XType format, const unsigned char *src, size_t n, bool swap, D *dst)
+{
+    switch (format) {
+    case DC::XType::INT32: copyValues<int>(src, n, swap, dst); break;
+    case DC::XType::FLOAT: copyValues<float>(src, n, swap, dst); break;
+    case DC::XType::DOUBLE: copyValues<double>(src, n, swap, dst); break;
+    default: break;
+    }
+}
+
+};    // namespace
 
+std::shared_ptr<BOVCollection::MappedFile> BOVCollection::_mapFile(const std::string &path)
+{
+    for (auto itr = _mappedFiles.begin(); itr != _mappedFiles.end(); ++itr) {
+        if (itr->first == path) {
+            _mappedFiles.splice(_mappedFiles.begin(), _mappedFiles, itr);
+            return (_mappedFiles.front().second);
+        }
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    if (!file->Map(path)) return (nullptr);
+
+    // Keep the current and read ahead files of a few variables mapped
+    //
+    const size_t maxMapped = 8;
+    _mappedFiles.push_front(std::make_pair(path, file));
+    if (_mappedFiles.size() > maxMapped) _mappedFiles.pop_back();
+
+    return (file);
+}
+
+void BOVCollection::_readAhead(const std::string &varname, size_t ts, const std::vector<size_t> &min, const std::vector<size_t> &max)
+{
+    if (ts + 1 >= _times.size()) return;
+
+    auto varItr = _dataFileMap.find(varname);
+    if (varItr == _dataFileMap.end()) return;
+    auto fileItr = varItr->second.find(_times[ts + 1]);
+    if (fileItr == varItr->second.end()) return;
+
+    std::shared_ptr<MappedFile> file = _mapFile(fileItr->second);
+    if (!file) return;
+
+    // The bytes spanned by the region. Regions are usually whole slabs in Z,
+    // which are contiguous
+    //
+    int    formatSize = _sizeOfFormat(_dataFormat);
+    size_t first = _byteOffset + formatSize * (min[0] + _gridSize[0] * (min[1] + _gridSize[1] * min[2]));
+    size_t last = _byteOffset + formatSize * (max[0] + 1 + _gridSize[0] * (max[1] + _gridSize[1] * max[2]));
+    file->WillNeed(first, last - first);
+}
+
+template<class T> int BOVCollection::_readRegionMapped(const MappedFile &file, const std::vector<size_t> &min, const std::vector<size_t> &max, T region) const
+{
+    int    formatSize = _sizeOfFormat(_dataFormat);
+    size_t last = _byteOffset + formatSize * (max[0] + 1 + _gridSize[0] * (max[1] + _gridSize[1] * max[2]));
+    if (last > file.Size()) {
+        SetErrMsg("Short read on input file");
+        return -1;
+    }
+
+    size_t nx = max[0] - min[0] + 1;
+    size_t ny = max[1] - min[1] + 1;
+    bool   swap = _swapBytes();
+
+    // Each Z slab of the region is independent
+    //
+    #pragma omp parallel for
+    for (long k = min[2]; k <= (long)max[2]; k++) {
+        size_t zOffset = _gridSize[0] * _gridSize[1] * k;
+        T      dst = region + (k - min[2]) * nx * ny;
+        for (size_t j = min[1]; j <= max[1]; j++) {
+            size_t offset = formatSize * (min[0] + _gridSize[0] * j + zOffset) + _byteOffset;
+            copyValues(_dataFormat, file.Data() + offset, nx, swap, dst);
+            dst += nx;
+        }
+    }
+
+    return 0;
+}
+
+template<class T> int BOVCollection::_readRegionStdio(const std::string &dataFile, const std::vector<size_t> &min, const std::vector<size_t> &max, T region) const
+{
     FILE *fp = fopen(dataFile.c_str(), "rb");
     if (!fp) {
-        if (dataFile == "")
-            SetErrMsg("No data file associated with variable '%s' at timestep %d", varname.c_str(), time);
-        else
-            SetErrMsg("Invalid file: %s : %M", dataFile.c_str());
+        SetErrMsg("Invalid file: %s : %M", dataFile.c_str());
         return -1;
     }
 
     int formatSize = _sizeOfFormat(_dataFormat);
-    if (formatSize < 0) {
-        SetErrMsg("Unspecified data format");
-        fclose(fp);
-        return -1;
-    }
+    bool swap = _swapBytes();
 
     // Read a "pencil" of data along the X axis, one row at a time
     size_t count = max[0] - min[0] + 1;
@@ -575,6 +805,7 @@ template<class T> int BOVCollection::ReadRegion(std::string varname, size_t ts,
             int rc = fseek(fp, offset, SEEK_SET);
             if (rc != 0) {
                 MyBase::SetErrMsg("Unable to seek on file: %M");
+                fclose(fp);
                 return -1;
             }
 
@@ -589,16 +820,8 @@ template<class T> int BOVCollection::ReadRegion(std::string varname, size_t ts,
                 return -1;
             }
 
-            if (_dataFormat == DC::XType::INT32) {
-                int *castBuffer = (int *)readBuffer;
-                for (size_t i = 0; i < count; i++) { *region++ = (typename std::remove_pointer<T>::type)castBuffer[i]; }
-            } else if (_dataFormat == DC::XType::FLOAT) {
-                float *castBuffer = (float *)readBuffer;
-                for (size_t i = 0; i < count; i++) { *region++ = (typename std::remove_pointer<T>::type)castBuffer[i]; }
-            } else if (_dataFormat == DC::XType::DOUBLE) {
-                double *castBuffer = (double *)readBuffer;
-                for (size_t i = 0; i < count; i++) { *region++ = (typename std::remove_pointer<T>::type)castBuffer[i]; }
-            }
+            copyValues(_dataFormat, readBuffer, count, swap, region);
+            region += count;
         }
     }
 
@@ -607,6 +830,31 @@ template<class T> int BOVCollection::ReadRegion(std::string varname, size_t ts,
     return 0;
 }
 
+template<class T> int BOVCollection::ReadRegion(std::string varname, size_t ts, const std::vector<size_t> &min, const std::vector<size_t> &max, T region)
+{
+    float       time = _times[ts];
+    std::string dataFile = _dataFileMap[varname][time];
+
+    if (dataFile == "") {
+        SetErrMsg("No data file associated with variable '%s' at timestep %d", varname.c_str(), time);
+        return -1;
+    }
+
+    if (_sizeOfFormat(_dataFormat) < 0) {
+        SetErrMsg("Unspecified data format");
+        return -1;
+    }
+
+    std::shared_ptr<MappedFile> file = _mapFile(dataFile);
+    if (!file) return (_readRegionStdio(dataFile, min, max, region));
+
+    // Start reading the next timestep while this one is copied
+    //
+    _readAhead(varname, ts, min, max);
+
+    return (_readRegionMapped(*file, min, max, region));
+}
+
 // ReadRegion can only be used with int* float* and double*
 template int BOVCollection::ReadRegion<int *>(std::string varname, size_t ts, const std::vector<size_t> &, const std::vector<size_t> &, int *);
 template int BOVCollection::ReadRegion<float *>(std::string varname, size_t ts, const std::vector<size_t> &, const std::vector<size_t> &, float *);
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vapor/VAssert.h>
+#include <vapor/CellIndex3D.h>
+#include <vapor/OpenMPSupport.h>
+
+using namespace VAPoR;
+using namespace std;
+
+namespace {
+
+// Upper bound on bins along an axis, so that flat meshes don't produce
+// absurdly fine lattices along their long axes
+//
+const size_t maxBinDim = 4096;
+
+};    // namespace
+
+CellIndex3D::CellIndex3D(size_t ncells, const std::function<bool(size_t cell, float min[3], float max[3])> &getBox, float cellsPerBin)
+{
+    VAssert(ncells <= std::numeric_limits<uint32_t>::max());
+
+    const float inf = std::numeric_limits<float>::infinity();
+
+    // Bounding boxes of the cells. Cells that are not indexed get an
+    // empty box, which contains no points
+    //
+    _boxes.resize(ncells * 6);
+#pragma omp parallel for
+    for (long i = 0; i < (long)ncells; i++) {
+        float *b = &_boxes[i * 6];
+        if (!getBox(i, b, b + 3)) {
+            b[0] = b[1] = b[2] = inf;
+            b[3] = b[4] = b[5] = -inf;
+        }
+    }
+
+    for (int d = 0; d < 3; d++) {
+        _min[d] = inf;
+        _max[d] = -inf;
+    }
+    for (size_t i = 0; i < ncells; i++) {
+        const float *b = &_boxes[i * 6];
+        if (b[0] > b[3]) continue;
+        for (int d = 0; d < 3; d++) {
+            _min[d] = std::min(_min[d], b[d]);
+            _max[d] = std::max(_max[d], b[d + 3]);
+        }
+    }
+
+    // Size the lattice so that bins are roughly cubes, holding
+    // cellsPerBin cells on average. Flat axes get a single bin
+    //
+    double extents[3];
+    double maxExtent = 0.0;
+    for (int d = 0; d < 3; d++) {
+        extents[d] = _min[d] <= _max[d] ? (double)_max[d] - (double)_min[d] : 0.0;
+        maxExtent = std::max(maxExtent, extents[d]);
+    }
+
+    double nbins = std::max(1.0, (double)ncells / std::max(cellsPerBin, 0.01f));
+    double volume = 1.0;
+    int    ndims = 0;
+    for (int d = 0; d < 3; d++) {
+        if (extents[d] > maxExtent * 1e-6) {
+            volume *= extents[d];
+            ndims++;
+        }
+    }
+    double binSize = ndims ? std::pow(volume / nbins, 1.0 / ndims) : 1.0;
+
+    for (int d = 0; d < 3; d++) {
+        _dims[d] = 1;
+        if (ndims && extents[d] > maxExtent * 1e-6) _dims[d] = std::min(maxBinDim, std::max((size_t)1, (size_t)std::ceil(extents[d] / binSize)));
+        _scale[d] = extents[d] > 0.0 ? _dims[d] / extents[d] : 0.0;
+    }
+    size_t nBins = _dims[0] * _dims[1] * _dims[2];
+
+    // Count the cells overlapping each bin, then fill the bins. The order
+    // cells are added to a bin in is not deterministic, so each bin is
+    // sorted afterwards so that queries are repeatable
+    //
+    vector<size_t> counts(nBins + 1, 0);
+#pragma omp parallel for
+    for (long i = 0; i < (long)ncells; i++) {
+        size_t bmin[3], bmax[3];
+        if (!_binRange(&_boxes[i * 6], &_boxes[i * 6 + 3], bmin, bmax)) continue;
+
+        for (size_t z = bmin[2]; z <= bmax[2]; z++) {
+            for (size_t y = bmin[1]; y <= bmax[1]; y++) {
+                for (size_t x = bmin[0]; x <= bmax[0]; x++) {
+                    size_t b = (z * _dims[1] + y) * _dims[0] + x;
+#pragma omp atomic
+                    counts[b]++;
+                }
+            }
+        }
+    }
+
+    _binStart.resize(nBins + 1);
+    _binStart[0] = 0;
+    for (size_t b = 0; b < nBins; b++) _binStart[b + 1] = _binStart[b] + counts[b];
+
+    _binCells.resize(_binStart[nBins]);
+    std::copy(_binStart.begin(), _binStart.end(), counts.begin());
+
+#pragma omp parallel for
+    for (long i = 0; i < (long)ncells; i++) {
+        size_t bmin[3], bmax[3];
+        if (!_binRange(&_boxes[i * 6], &_boxes[i * 6 + 3], bmin, bmax)) continue;
+
+        for (size_t z = bmin[2]; z <= bmax[2]; z++) {
+            for (size_t y = bmin[1]; y <= bmax[1]; y++) {
+                for (size_t x = bmin[0]; x <= bmax[0]; x++) {
+                    size_t b = (z * _dims[1] + y) * _dims[0] + x;
+                    size_t slot;
+#pragma omp atomic capture
+                    slot = counts[b]++;
+                    _binCells[slot] = (uint32_t)i;
+                }
+            }
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (long b = 0; b < (long)nBins; b++) { std::sort(_binCells.begin() + _binStart[b], _binCells.begin() + _binStart[b + 1]); }
+}
+
+bool CellIndex3D::_binRange(const float min[3], const float max[3], size_t bmin[3], size_t bmax[3]) const
+{
+    if (min[0] > max[0]) return (false);
+
+    for (int d = 0; d < 3; d++) {
+        double lo = ((double)min[d] - (double)_min[d]) * _scale[d];
+        double hi = ((double)max[d] - (double)_min[d]) * _scale[d];
+        bmin[d] = std::min(_dims[d] - 1, (size_t)std::max(0.0, lo));
+        bmax[d] = std::min(_dims[d] - 1, (size_t)std::max(0.0, hi));
+    }
+    return (true);
+}
+
+size_t CellIndex3D::GetCells(const double pt[3], const uint32_t *&cells) const
+{
+    cells = NULL;
+
+    size_t idx[3];
+    for (int d = 0; d < 3; d++) {
+        if (!(pt[d] >= _min[d] && pt[d] <= _max[d])) return (0);
+
+        idx[d] = std::min(_dims[d] - 1, (size_t)((pt[d] - _min[d]) * _scale[d]));
+    }
+
+    size_t b = (idx[2] * _dims[1] + idx[1]) * _dims[0] + idx[0];
+    cells = _binCells.data() + _binStart[b];
+    return (_binStart[b + 1] - _binStart[b]);
+}
+
+void CellIndex3D::GetBinDimensions(size_t dims[3]) const
+{
+    for (int d = 0; d < 3; d++) dims[d] = _dims[d];
+}
@@ -495,9 +495,47 @@ float CurvilinearGrid::GetValueLinear(const CoordType &coords) const
     double z = GetGeometryDim() == 3 ? cCoords[2] : 0.0;
     bool   inside = _insideGrid(x, y, z, i, j, k, lambda, zwgt);
 
-    float mv = GetMissingValue();
+    if (!inside) return (GetMissingValue());
+
+    return (_interpolateLinear(i, j, k, lambda, zwgt));
+}
+
+void CurvilinearGrid::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Same as GetValueLinear() for each point, except that the cell
+    // containing the previous point is tested before querying the quad tree,
+    // and the storage used while searching is reused. For a point on the
+    // boundary between two cells the cell found may differ, but
+    // the interpolated value is the same up to round off.
+    //
+    float            mv = GetMissingValue();
+    double           lambda[4], zwgt[2];
+    size_t           i = 0, j = 0, k = 0;
+    vector<DimsType> nodes(8);
+    vector<double>   zcoords;
+    bool             useHint = false;
+    for (size_t p = 0; p < n; p++) {
+        CoordType cCoords;
+        ClampCoord(coords[p], cCoords);
 
-    if (!inside) return (mv);
+        double z = GetGeometryDim() == 3 ? cCoords[2] : 0.0;
+        bool   inside = _insideGrid(cCoords[0], cCoords[1], z, i, j, k, lambda, zwgt, nodes, zcoords, useHint);
+
+        // The indices are only a good guess for the next point if this one was found
+        //
+        useHint = inside;
+        values[p] = inside ? _interpolateLinear(i, j, k, lambda, zwgt) : mv;
+    }
+}
+
+float CurvilinearGrid::_interpolateLinear(size_t i, size_t j, size_t k, const double lambda[4], const double zwgt[2]) const
+{
+    float mv = GetMissingValue();
 
     // Use Wachspress coordinates as weights to do linear interpolation
     // along XY plane
@@ -561,14 +599,14 @@ void CurvilinearGrid::GetUserExtentsHelper(CoordType &minu, CoordType &maxu) con
     }
 }
 
-bool CurvilinearGrid::_insideGridHelperStretched(double z, size_t &k, double zwgt[2]) const
+bool CurvilinearGrid::_insideGridHelperStretched(double z, size_t &k, double zwgt[2], bool useHint) const
 {
     // Now verify that Z coordinate of point is in grid, and find
     // its interpolation weights if so.
     //
-    size_t kFound = 0;
+    size_t kFound = useHint ? k : 0;
 
-    if (!Wasp::BinarySearchRange(_zcoords, z, kFound)) return (false);
+    if (!(useHint ? Wasp::BinarySearchRangeHint : Wasp::BinarySearchRange)(_zcoords, z, kFound)) return (false);
 
     k = kFound;
     zwgt[0] = 1.0 - (z - _zcoords[k]) / (_zcoords[k + 1] - _zcoords[k]);
@@ -577,7 +615,7 @@ bool CurvilinearGrid::_insideGridHelperStretched(double z, size_t &k, double zwg
     return (true);
 }
 
-bool CurvilinearGrid::_insideGridHelperTerrain(double x, double y, double z, const size_t &i, const size_t &j, size_t &k, double zwgt[2]) const
+bool CurvilinearGrid::_insideGridHelperTerrain(double x, double y, double z, const size_t &i, const size_t &j, size_t &k, double zwgt[2], vector<double> &zcoords, bool useHint) const
 {
     // XZ and YZ cell sides are planar, but XY sides may not be. We divide
     // the XY faces into two triangles (changing hexahedrals into prims)
@@ -611,18 +649,31 @@ bool CurvilinearGrid::_insideGridHelperTerrain(double x, double y, double z, con
 
     float z0, z1;
 
-    // Find k index of cell containing z. Already know i and j indices
+    // Interpolate Z coordinate across triangle
     //
-    size_t         nz = GetDimensions()[2];
-    vector<double> zcoords(nz);
-    for (int kk = 0; kk < nz; kk++) {
-        // Interpolate Z coordinate across triangle
-        //
-        float zk = _zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2];
+    auto zAt = [&](size_t kk) -> float {
+        return (_zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2]);
+    };
 
-        zcoords[kk] = zk;
+    // If the guessed layer contains z there's no need to interpolate the
+    // Z coordinates of the whole column. Same test as BinarySearchRangeHint()
+    //
+    size_t nz = GetDimensions()[2];
+    if (useHint && nz > 1 && k + 1 < nz && zAt(0) <= zAt(nz - 1)) {
+        z0 = zAt(k);
+        z1 = zAt(k + 1);
+        if (z0 <= z && (z < z1 || (k + 2 == nz && z == z1))) {
+            zwgt[0] = 1.0 - (z - z0) / (z1 - z0);
+            zwgt[1] = 1.0 - zwgt[0];
+            return (true);
+        }
     }
 
+    // Find k index of cell containing z. Already know i and j indices
+    //
+    zcoords.resize(nz);
+    for (int kk = 0; kk < nz; kk++) zcoords[kk] = zAt(kk);
+
     if (!Wasp::BinarySearchRange(zcoords, z, k)) return (false);
 
     z0 = zcoords[k];
@@ -674,31 +725,52 @@ bool CurvilinearGrid::_insideFace(const DimsType &face, double pt[2], double lam
 // grid the values of 'lambda', and 'zwgt' are not defined
 //
 bool CurvilinearGrid::_insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double lambda[4], double zwgt[2]) const
+{
+    vector<DimsType> nodes(8);
+    vector<double>   zcoords;
+    return (_insideGrid(x, y, z, i, j, k, lambda, zwgt, nodes, zcoords, false));
+}
+
+bool CurvilinearGrid::_insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double lambda[4], double zwgt[2], vector<DimsType> &nodes, vector<double> &zcoords,
+                                  bool useHint) const
 {
     for (int l = 0; l < 4; l++) lambda[l] = 0.0;
     for (int l = 0; l < 2; l++) zwgt[l] = 0.0;
-    i = j = k = 0;
 
-    // Find the indices for the faces that might contain the point
+    double pt[] = {x, y};
+
+    // Test the face of the guessed cell first
+    //
+    const DimsType &cdims = GetCellDimensions();
+    if (useHint && i < cdims[0] && j < cdims[1]) {
+        DimsType face = {i, j, 0};
+        if (_insideFace(face, pt, lambda, nodes) && _insideColumn(x, y, z, i, j, k, zwgt, zcoords, useHint)) return (true);
+    }
+
+    size_t kHint = k;
+
+    // Find the indices for the faces that might contain the point. Faces
+    // sharing an edge may both claim a point on the edge, so a face is
+    // only accepted if the point is also inside its column of cells
     //
     vector<DimsType> face_indices;
     _qtr->GetPayloadContained(x, y, face_indices);
 
-    bool             inside = false;
-    double           pt[] = {x, y};
-    vector<DimsType> nodes(8);
     for (int ii = 0; ii < face_indices.size(); ii++) {
-        if (_insideFace(face_indices[ii], pt, lambda, nodes)) {
-            i = face_indices[ii][0];
-            j = face_indices[ii][1];
+        if (!_insideFace(face_indices[ii], pt, lambda, nodes)) continue;
 
-            inside = true;
-            break;
-        }
+        i = face_indices[ii][0];
+        j = face_indices[ii][1];
+        k = useHint ? kHint : 0;
+        if (_insideColumn(x, y, z, i, j, k, zwgt, zcoords, useHint)) return (true);
     }
 
-    if (!inside) return (false);
+    i = j = k = 0;
+    return (false);
+}
 
+bool CurvilinearGrid::_insideColumn(double x, double y, double z, size_t i, size_t j, size_t &k, double zwgt[2], vector<double> &zcoords, bool useHint) const
+{
     if (GetGeometryDim() == 2) {
         zwgt[0] = 1.0;
         zwgt[1] = 0.0;
@@ -706,9 +778,9 @@ bool CurvilinearGrid::_insideGrid(double x, double y, double z, size_t &i, size_
     }
 
     if (_terrainFollowing) {
-        return (_insideGridHelperTerrain(x, y, z, i, j, k, zwgt));
+        return (_insideGridHelperTerrain(x, y, z, i, j, k, zwgt, zcoords, useHint));
     } else {
-        return (_insideGridHelperStretched(z, k, zwgt));
+        return (_insideGridHelperStretched(z, k, zwgt, useHint));
     }
 }
 
@@ -71,6 +71,10 @@ int DCCF::initialize(const vector<string> &paths, const std::vector<string> &opt
     if (_ncdfc) delete _ncdfc;
     _paths = paths;
     
+    // Keep the file metadata in an index on disk, if requested
+    //
+    if (std::find(options.begin(), options.end(), "-netcdf_index") != options.end()) ncdfc->SetMetaIndexPath(NetCDFMetaIndex::DefaultPath(paths));
+
     // Initialize the NetCDFCFCollection class.
     //
     int rc = ncdfc->Initialize(paths);
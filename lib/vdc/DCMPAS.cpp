@@ -270,6 +270,10 @@ int DCMPAS::initialize(const vector<string> &files, const std::vector<string> &o
 
     NetCDFCollection *ncdfc = new NetCDFCollection();
 
+    // Keep the file metadata in an index on disk, if requested
+    //
+    if (std::find(options.begin(), options.end(), "-netcdf_index") != options.end()) ncdfc->SetMetaIndexPath(NetCDFMetaIndex::DefaultPath(files));
+
     // Initialize NetCDFCollection class
     //
     vector<string> time_dimnames(1, timeDimName);
@@ -48,6 +48,10 @@ int DCP::initialize(const vector<string> &paths, const std::vector<string> &opti
     NetCDFCollection *ncdfc = new NetCDFCollection();
     _ncdfc = ncdfc;
 
+    // Keep the file metadata in an index on disk, if requested
+    //
+    if (std::find(options.begin(), options.end(), "-netcdf_index") != options.end()) ncdfc->SetMetaIndexPath(NetCDFMetaIndex::DefaultPath(paths));
+
     // Initialize the NetCDFCFCollection class.
     //
     int rc = ncdfc->Initialize(paths, {"time", "T"}, {"time", "T"});
@@ -97,6 +97,10 @@ int DCWRF::initialize(const vector<string> &files, const std::vector<string> &op
 
     NetCDFCollection *ncdfc = new NetCDFCollection();
 
+    // Keep the file metadata in an index on disk, if requested
+    //
+    if (std::find(options.begin(), options.end(), "-netcdf_index") != options.end()) ncdfc->SetMetaIndexPath(NetCDFMetaIndex::DefaultPath(files));
+
     // Initialize the NetCDFCollection class. Need to specify the name
     // of the time dimension ("Time" for WRF), and time coordinate variable
     // names (N/A for WRF)
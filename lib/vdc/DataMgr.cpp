@@ -4,6 +4,8 @@
 #include <cstring>
 #include "vapor/VAssert.h"
 #include <cfloat>
+#include <cmath>
+#include <limits>
 #include <vector>
 #include <map>
 #include <algorithm>
@@ -502,6 +504,9 @@ DataMgr::DataMgr(string format, size_t mem_size, int nthreads)
     _PipeLines.clear();
 
     _regionsList.clear();
+    _regionsIndex.clear();
+    _regionsByBlks.clear();
+    _regionsByVar.clear();
 
     _varInfoCacheSize_T.Clear();
     _varInfoCacheDouble.Clear();
@@ -513,12 +518,24 @@ DataMgr::DataMgr(string format, size_t mem_size, int nthreads)
     _proj4String.clear();
     _proj4StringDefault.clear();
     _bs = {64, 64, 64};
+
+    _prefetchShutdown = false;
+    _prefetchBusy = false;
+    _prefetchNoEvict = false;
+
+    _pyramidEnabled = false;
+    _pyramidShutdown = false;
+
+    _quadTreeCacheEnabled = false;
 }
 
 DataMgr::~DataMgr()
 {
     SetDiagMsg("DataMgr::~DataMgr()");
 
+    _stopPrefetch();
+    _stopPyramid();
+
     if (_dc) delete _dc;
     _dc = NULL;
 
@@ -553,7 +570,11 @@ int DataMgr::_parseOptions(vector<string> &options)
             }
         }
         if (options[i] == "-project_to_pcs") { _doTransformHorizontal = true; }
-        if (options[i] == "-vertical_xform") {
+        if (options[i] == "-pyramid_cache") {
+            _pyramidEnabled = true;
+        } else if (options[i] == "-quadtree_cache") {
+            _quadTreeCacheEnabled = true;
+        } else if (options[i] == "-vertical_xform") {
             _doTransformVertical = true;
         } else {
             newOptions.push_back(options[i]);
@@ -573,6 +594,21 @@ int DataMgr::_parseOptions(vector<string> &options)
 
 int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &options)
 {
+    // The pyramid builder and the prefetch thread lock _mutex, and the
+    // prefetch thread reads from the data collection without it, so they
+    // must be stopped before _mutex is taken and the data collection is
+    // replaced
+    //
+    _stopPyramid();
+    _stopPrefetch();
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    _pyramidEnabled = false;
+    _quadTreeCacheEnabled = false;
+    _pyramidLevelsCache.clear();
+    _pyramidRequested.clear();
+
     vector<string> deviceOptions = options;
     int            rc = _parseOptions(deviceOptions);
     if (rc < 0) return (-1);
@@ -617,6 +653,14 @@ int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &
         return (-1);
     }
 
+    _gridHelper.SetQuadTreeCacheDir(_quadTreeCacheEnabled ? GridHelper::DefaultQuadTreeCacheDir(files) : "");
+
+    if (_pyramidEnabled) {
+        string dir = PyramidCache::DefaultDir(files);
+        _pyramidEnabled = !dir.empty();
+        _pyramid.Initialize(dir, files);
+    }
+
     // Use UDUnits for unit conversion
     //
     rc = _udunits.Initialize();
@@ -683,6 +727,7 @@ int DataMgr::Initialize(const vector<string> &files, const std::vector<string> &
 
 bool DataMgr::GetMesh(string meshname, DC::Mesh &m) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     bool ok = _dvm.GetMesh(meshname, m);
@@ -732,6 +777,7 @@ vector<string> DataMgr::GetDataVarNames() const
 
 vector<string> DataMgr::GetDataVarNames(int ndim, VarType type) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     if (_dataVarNamesCache[std::make_pair(type, ndim)].size()) { return (_dataVarNamesCache[std::make_pair(type, ndim)]); }
@@ -762,6 +808,7 @@ vector<string> DataMgr::GetDataVarNames(int ndim, VarType type) const
 
 vector<string> DataMgr::GetCoordVarNames() const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     vector<string> vars = _dc->GetCoordVarNames();
@@ -773,6 +820,7 @@ vector<string> DataMgr::GetCoordVarNames() const
 
 string DataMgr::GetTimeCoordVarName() const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     // There can be only one time coordinate variable. If a
@@ -789,6 +837,7 @@ string DataMgr::GetTimeCoordVarName() const
 
 bool DataMgr::GetVarCoordVars(string varname, bool spatial, std::vector<string> &coord_vars) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     coord_vars.clear();
@@ -819,6 +868,7 @@ vector<string> DataMgr::GetVarCoordVars(string varname, bool spatial) const
 
 bool DataMgr::GetDataVarInfo(string varname, VAPoR::DC::DataVar &var) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     bool ok = _dvm.GetDataVarInfo(varname, var);
@@ -830,6 +880,7 @@ bool DataMgr::GetDataVarInfo(string varname, VAPoR::DC::DataVar &var) const
 
 bool DataMgr::GetCoordVarInfo(string varname, VAPoR::DC::CoordVar &var) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     bool ok = _dvm.GetCoordVarInfo(varname, var);
@@ -839,6 +890,7 @@ bool DataMgr::GetCoordVarInfo(string varname, VAPoR::DC::CoordVar &var) const
 
 bool DataMgr::GetBaseVarInfo(string varname, VAPoR::DC::BaseVar &var) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     bool ok = _dvm.GetBaseVarInfo(varname, var);
@@ -881,6 +933,7 @@ bool DataMgr::IsCompressed(string varname) const
 
 int DataMgr::GetNumTimeSteps(string varname) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     // If data variable get it's time coordinate variable if it exists
@@ -912,6 +965,15 @@ int DataMgr::GetNumTimeSteps(string varname) const
 int DataMgr::GetNumTimeSteps() const { return (_timeCoordinates.size()); }
 
 size_t DataMgr::GetNumRefLevels(string varname) const
+{
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+    size_t nlevels = _nativeNumRefLevels(varname);
+    if (nlevels == 1) nlevels += _pyramidLevels(varname);
+
+    return (nlevels);
+}
+
+size_t DataMgr::_nativeNumRefLevels(string varname) const
 {
     VAssert(_dc);
 
@@ -923,8 +985,37 @@ size_t DataMgr::GetNumRefLevels(string varname) const
     return (_dc->GetNumRefLevels(varname));
 }
 
+int DataMgr::_pyramidLevels(string varname) const
+{
+    if (!_pyramidEnabled) return (0);
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    auto itr = _pyramidLevelsCache.find(varname);
+    if (itr != _pyramidLevelsCache.end()) return (itr->second);
+
+    // Derived variables aren't cached, as their values may change without
+    // the data set's files changing. Downsampling needs the neighbors of
+    // each sample along every axis, which unstructured grids don't have
+    //
+    int nlevels = 0;
+    if (!_getDerivedVar(varname) && _isDataVar(varname)) {
+        string         gridType = _get_grid_type(varname);
+        vector<size_t> dimsv, bsv;
+        if (!gridType.empty() && !_gridHelper.IsUnstructured(gridType) && _nativeDimLensAtLevel(varname, -1, dimsv, bsv, -1) >= 0) {
+            DimsType dims = {1, 1, 1};
+            Grid::CopyToArr3(dimsv, dims);
+            nlevels = PyramidCache::NumLevels(dims);
+        }
+    }
+
+    _pyramidLevelsCache[varname] = nlevels;
+    return (nlevels);
+}
+
 vector<size_t> DataMgr::GetCRatios(string varname) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     if (varname == "") return vector<size_t>(1, 1);
@@ -937,6 +1028,7 @@ vector<size_t> DataMgr::GetCRatios(string varname) const
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, bool lock)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     SetDiagMsg("DataMgr::GetVariable(%d,%s,%d,%d,%d, %d)", ts, varname.c_str(), level, lod, lock);
 
     int rc = _level_correction(varname, level);
@@ -956,6 +1048,7 @@ Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, bool l
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, CoordType min, CoordType max, bool lock)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
 
     SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
 
@@ -1338,6 +1431,7 @@ Grid *DataMgr::_getVariable(size_t ts, string varname, int level, int lod, DimsT
 
 Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, DimsType min, DimsType max, bool lock)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
 
     SetDiagMsg("DataMgr::GetVariable(%d, %s, %d, %d, %s, %s, %d)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str(), lock);
 
@@ -1371,6 +1465,7 @@ Grid *DataMgr::GetVariable(size_t ts, string varname, int level, int lod, DimsTy
 
 int DataMgr::GetVariableExtents(size_t ts, string varname, int level, int lod, CoordType &min, CoordType &max)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     SetDiagMsg("DataMgr::GetVariableExtents(%d, %s, %d, %d)", ts, varname.c_str(), level, lod);
 
     min = {0.0, 0.0, 0.0};
@@ -1426,6 +1521,7 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, vector<
 
 int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, CoordType min, CoordType max, vector<double> &range)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     SetDiagMsg("DataMgr::GetDataRange(%d,%s)", ts, varname.c_str());
 
     range = {0.0, 0.0};
@@ -1458,6 +1554,11 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, CoordTy
         return (0);
     }
 
+    if (_getDataRangeFromBlocks(ts, varname, level, min_ui, max_ui, range)) {
+        _varInfoCacheDouble.Set(ts, varname, level, lod, key, range);
+        return (0);
+    }
+
     const Grid *sg = DataMgr::GetVariable(ts, varname, level, lod, min_ui, max_ui, false);
     if (!sg) return (-1);
 
@@ -1472,25 +1573,125 @@ int DataMgr::GetDataRange(size_t ts, string varname, int level, int lod, CoordTy
     return (0);
 }
 
+int DataMgr::GetBlockRanges(size_t ts, string varname, vector<size_t> &bdims, vector<double> &ranges)
+{
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+    VAssert(_dc);
+    bdims.clear();
+    ranges.clear();
+
+    if (_getDerivedVar(varname)) return (0);
+
+    // Block ranges are read from disk
+    //
+    std::lock_guard<std::recursive_mutex> dcGuard(_dcMutex);
+    return (_dc->GetBlockRanges(ts, varname, bdims, ranges));
+}
+
+// Bound the range of the voxels min_ui to max_ui with the per-block
+// ranges recorded by the DC. Returns false if block ranges aren't
+// available, or if no block in the region has valid data
+//
+bool DataMgr::_getDataRangeFromBlocks(size_t ts, string varname, int level, const DimsType &min_ui, const DimsType &max_ui, vector<double> &range)
+{
+    vector<size_t> bdims;
+    vector<double> ranges;
+    int            rc = GetBlockRanges(ts, varname, bdims, ranges);
+    if (rc < 0 || bdims.empty() || bdims.size() > min_ui.size()) return (false);
+
+    // The number of blocks doesn't change with refinement level, only
+    // the block size does
+    //
+    vector<size_t> dims_at_level, bs_at_level;
+    rc = GetDimLensAtLevel(varname, level, dims_at_level, bs_at_level, ts);
+    if (rc < 0 || dims_at_level.size() != bdims.size()) return (false);
+
+    DimsType bmin = {0, 0, 0}, bmax = {0, 0, 0};
+    for (int i = 0; i < bdims.size(); i++) {
+        if (bs_at_level[i] < 1) return (false);
+        if ((dims_at_level[i] + bs_at_level[i] - 1) / bs_at_level[i] != bdims[i]) return (false);
+
+        bmin[i] = min_ui[i] / bs_at_level[i];
+        bmax[i] = std::min(max_ui[i] / bs_at_level[i], bdims[i] - 1);
+    }
+    for (int i = bdims.size(); i < 3; i++) bdims.push_back(1);
+
+    double mymin = std::numeric_limits<double>::max();
+    double mymax = std::numeric_limits<double>::lowest();
+    bool   found = false;
+    for (size_t k = bmin[2]; k <= bmax[2]; k++) {
+        for (size_t j = bmin[1]; j <= bmax[1]; j++) {
+            for (size_t i = bmin[0]; i <= bmax[0]; i++) {
+                size_t       idx = (k * bdims[1] * bdims[0]) + (j * bdims[0]) + i;
+                const double bmn = ranges[2 * idx];
+                const double bmx = ranges[2 * idx + 1];
+
+                // Blocks containing only missing values have NaN ranges
+                //
+                if (std::isnan(bmn) || std::isnan(bmx)) continue;
+
+                mymin = std::min(mymin, bmn);
+                mymax = std::max(mymax, bmx);
+                found = true;
+            }
+        }
+    }
+    if (!found) return (false);
+
+    range = {mymin, mymax};
+    return (true);
+}
+
 int DataMgr::GetDimLensAtLevel(string varname, int level, std::vector<size_t> &dims_at_level, std::vector<size_t> &bs_at_level, long ts) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
     dims_at_level.clear();
     bs_at_level.clear();
 
-    int         rc = 0;
-    DerivedVar *dvar = _getDerivedVar(varname);
-    if (dvar) {
-        rc = dvar->GetDimLensAtLevel(level, dims_at_level, bs_at_level);
-    } else {
-        rc = _dc->GetDimLensAtLevel(varname, level, dims_at_level, bs_at_level, ts);
+    // Levels coarser than the native level of a variable stored at a
+    // single resolution are pyramid levels. The native level (-1) never
+    // is, and is needed to count the pyramid levels
+    //
+    int pyramid_level = 0;
+    if (_pyramidEnabled && level != -1 && _nativeNumRefLevels(varname) == 1) {
+        int nlevels = GetNumRefLevels(varname);
+        if (level >= nlevels) level = nlevels - 1;
+        if (level >= 0) level = -(nlevels - level);
+        if (level < -nlevels) level = -nlevels;
+        if (level < -1) {
+            pyramid_level = -1 - level;
+            level = -1;
+        }
     }
+
+    int rc = _nativeDimLensAtLevel(varname, level, dims_at_level, bs_at_level, ts);
     if (rc < 0) return (-1);
 
+    if (pyramid_level) {
+        DimsType dims = {1, 1, 1};
+        Grid::CopyToArr3(dims_at_level, dims);
+        dims = PyramidCache::DimsAtLevel(dims, pyramid_level);
+        for (int i = 0; i < dims_at_level.size(); i++) {
+            dims_at_level[i] = dims[i];
+            bs_at_level[i] = std::min(bs_at_level[i], dims[i]);
+        }
+    }
+
 
     return (0);
 }
 
+int DataMgr::_nativeDimLensAtLevel(string varname, int level, std::vector<size_t> &dims_at_level, std::vector<size_t> &bs_at_level, long ts) const
+{
+    VAssert(_dc);
+
+    DerivedVar *dvar = _getDerivedVar(varname);
+    if (dvar) { return (dvar->GetDimLensAtLevel(level, dims_at_level, bs_at_level)); }
+
+    return (_dc->GetDimLensAtLevel(varname, level, dims_at_level, bs_at_level, ts));
+}
+
 vector<string> DataMgr::_get_var_dependencies_1(string varname) const
 {
     vector<string> varnames;
@@ -1557,6 +1758,7 @@ vector<string> DataMgr::_get_var_dependencies_all(vector<string> varnames, vecto
 
 bool DataMgr::VariableExists(size_t ts, string varname, int level, int lod) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     if (varname.empty()) return (false);
 
     // disable error reporting
@@ -1633,6 +1835,7 @@ bool DataMgr::IsVariableDerived(string name) const { return (_getDerivedVar(name
 
 int DataMgr::AddDerivedVar(DerivedDataVar *derivedVar)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     string varname = derivedVar->GetName();
 
     if (_dvm.HasVar(varname)) {
@@ -1650,12 +1853,14 @@ int DataMgr::AddDerivedVar(DerivedDataVar *derivedVar)
     }
 
     _varInfoCacheSize_T.Purge(vector<string>({varname}));
+    _pyramidLevelsCache.erase(varname);
 
     return (0);
 }
 
 void DataMgr::RemoveDerivedVar(string varname)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     if (!_dvm.HasVar(varname)) return;
 
     _dvm.RemoveVar(_dvm.GetVar(varname));
@@ -1671,10 +1876,22 @@ void DataMgr::RemoveDerivedVar(string varname)
     }
 
     _varInfoCacheSize_T.Purge(vector<string>({varname}));
+    _pyramidLevelsCache.erase(varname);
+}
+
+void DataMgr::PurgeVariable(string varname)
+{
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+    _free_var(varname);
 }
 
 void DataMgr::Clear()
 {
+    CancelPrefetch();
+
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
+
     _PipeLines.clear();
 
     list<region_t>::iterator itr;
@@ -1684,10 +1901,14 @@ void DataMgr::Clear()
         if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
     }
     _regionsList.clear();
+    _regionsIndex.clear();
+    _regionsByBlks.clear();
+    _regionsByVar.clear();
 }
 
 void DataMgr::UnlockGrid(const Grid *rg)
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     SetDiagMsg("DataMgr::UnlockGrid()");
 
     const auto fb = _lockedFloatBlks.find(rg);
@@ -1705,8 +1926,454 @@ void DataMgr::UnlockGrid(const Grid *rg)
     }
 }
 
+int DataMgr::Prefetch(size_t ts, string varname, int level, int lod, CoordType min, CoordType max)
+{
+    SetDiagMsg("DataMgr::Prefetch(%d, %s, %d, %d, %s, %s)", ts, varname.c_str(), level, lod, vector_to_string(min).c_str(), vector_to_string(max).c_str());
+
+    return (_queuePrefetch({ts, varname, level, lod, min, max, true}));
+}
+
+int DataMgr::Prefetch(size_t ts, string varname, int level, int lod)
+{
+    SetDiagMsg("DataMgr::Prefetch(%d, %s, %d, %d)", ts, varname.c_str(), level, lod);
+
+    return (_queuePrefetch({ts, varname, level, lod, CoordType(), CoordType(), false}));
+}
+
+void DataMgr::CancelPrefetch()
+{
+    {
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchQueue.clear();
+    }
+    _prefetchDoneCV.notify_all();
+}
+
+void DataMgr::WaitForPrefetch()
+{
+    std::unique_lock<std::mutex> lk(_prefetchMutex);
+    _prefetchDoneCV.wait(lk, [this] { return (_prefetchQueue.empty() && !_prefetchBusy); });
+}
+
+int DataMgr::_queuePrefetch(const prefetch_req_t &req)
+{
+    if (!_dc) {
+        SetErrMsg("Invalid state : no data");
+        return (-1);
+    }
+
+    std::lock_guard<std::mutex> lk(_prefetchMutex);
+
+    // Ignore duplicate requests
+    //
+    for (const auto &r : _prefetchQueue) {
+        if (r.ts == req.ts && r.varname == req.varname && r.level == req.level && r.lod == req.lod && r.useExts == req.useExts && r.min == req.min && r.max == req.max) return (0);
+    }
+
+    // Start the worker thread on first use
+    //
+    if (!_prefetchThread.joinable()) {
+        _prefetchShutdown = false;
+        _prefetchThread = std::thread(&DataMgr::_prefetchWorker, this);
+    }
+
+    _prefetchQueue.push_back(req);
+    _prefetchCV.notify_one();
+    return (0);
+}
+
+void DataMgr::_prefetchWorker()
+{
+    for (;;) {
+        prefetch_req_t req;
+        {
+            std::unique_lock<std::mutex> lk(_prefetchMutex);
+            _prefetchCV.wait(lk, [this] { return (_prefetchShutdown || !_prefetchQueue.empty()); });
+            if (_prefetchShutdown) return;
+
+            req = _prefetchQueue.front();
+            _prefetchQueue.pop_front();
+            _prefetchBusy = true;
+        }
+
+        // Only silences errors reported by this thread
+        //
+        bool enabled = EnableErrMsg(false);
+
+        vector<prefetch_read_t> reads;
+        int                     rc;
+        {
+            std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+            rc = _planPrefetch(req, reads);
+            if (rc == 1) {
+                // Read the region unlocked so that it is managed by the
+                // cache like any other region, but don't let the read push
+                // data that a client may still be using out of the cache.
+                //
+                _prefetchNoEvict = true;
+
+                Grid *g = NULL;
+                if (req.useExts) {
+                    g = GetVariable(req.ts, req.varname, req.level, req.lod, req.min, req.max, false);
+                } else {
+                    g = GetVariable(req.ts, req.varname, req.level, req.lod, false);
+                }
+                if (g) delete g;
+
+                _prefetchNoEvict = false;
+            }
+        }
+
+        // Read native variables with only the data collection locked, so
+        // that clients may use the cache in the meantime. The regions are
+        // then copied into the cache, unless a client read them first
+        //
+        if (rc == 0 && !reads.empty()) {
+            for (auto &r : reads) {
+                {
+                    std::lock_guard<std::mutex> lk(_prefetchMutex);
+                    if (_prefetchShutdown) break;
+                }
+
+                std::lock_guard<std::recursive_mutex> dcGuard(_dcMutex);
+
+                int status = r.isInt ? _readPrefetch<int>(r) : _readPrefetch<float>(r);
+                if (status < 0) r.blks.clear();
+            }
+
+            std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+            _prefetchNoEvict = true;
+            for (auto &r : reads) {
+                if (r.blks.empty()) continue;
+                if (_regionsIndex.find(region_key_t(r.ts, r.varname, r.level, r.lod, r.grid_bmin, r.grid_bmax)) != _regionsIndex.end()) continue;
+
+                void *blks = _alloc_region(r.ts, r.varname, r.level, r.lod, r.grid_bmin, r.grid_bmax, r.grid_bs, r.isInt ? sizeof(int) : sizeof(float), false, false);
+                if (!blks) break;
+                memcpy(blks, r.blks.data(), r.blks.size());
+            }
+            _prefetchNoEvict = false;
+        }
+
+        EnableErrMsg(enabled);
+
+        {
+            std::lock_guard<std::mutex> lk(_prefetchMutex);
+            _prefetchBusy = false;
+        }
+        _prefetchDoneCV.notify_all();
+    }
+}
+
+int DataMgr::_planPrefetch(const prefetch_req_t &req, vector<prefetch_read_t> &reads)
+{
+    reads.clear();
+
+    string varname = req.varname;
+    int    level = req.level;
+    int    lod = req.lod;
+
+    int rc = _level_correction(varname, level);
+    if (rc < 0) return (-1);
+
+    rc = _lod_correction(varname, lod);
+    if (rc < 0) return (-1);
+
+    if (!VariableExists(req.ts, varname, level, lod)) return (-1);
+
+    // Voxel coordinates of the region, as found by GetVariable()
+    //
+    DimsType min = {0, 0, 0};
+    DimsType max = {0, 0, 0};
+    if (req.useExts) {
+        DimsType min_ui, max_ui;
+        rc = _find_bounding_grid(req.ts, varname, level, lod, req.min, req.max, min_ui, max_ui);
+        if (rc != 0) return (-1);
+
+        vector<string> coord_vars;
+        bool           ok = GetVarCoordVars(varname, true, coord_vars);
+        if (!ok) return (-1);
+
+        for (int i = 0; i < coord_vars.size(); i++) {
+            min[i] = min_ui[i];
+            max[i] = max_ui[i];
+        }
+    } else {
+        vector<size_t> dims_at_level;
+        rc = GetDimLensAtLevel(varname, level, dims_at_level, req.ts);
+        if (rc < 0) return (-1);
+
+        for (int i = 0; i < dims_at_level.size(); i++) max[i] = dims_at_level[i] - 1;
+    }
+
+    string gridType = _get_grid_type(varname);
+    if (gridType.empty()) return (-1);
+    bool structured = !_gridHelper.IsUnstructured(gridType);
+
+    vector<string>   varnames;
+    DimsType         roi_dims;
+    vector<DimsType> dimsvec, bsvec, bminvec, bmaxvec;
+    rc = _setupCoordVecs(req.ts, varname, level, lod, min, max, varnames, roi_dims, dimsvec, bsvec, bminvec, bmaxvec, structured);
+    if (rc < 0) return (-1);
+
+    vector<bool> isInt(varnames.size(), false);
+    if (!structured) {
+        vector<string>   conn_varnames;
+        vector<DimsType> conn_dimsvec, conn_bsvec, conn_bminvec, conn_bmaxvec;
+        rc = _setupConnVecs(req.ts, varname, level, lod, conn_varnames, conn_dimsvec, conn_bsvec, conn_bminvec, conn_bmaxvec);
+        if (rc < 0) return (-1);
+
+        varnames.insert(varnames.end(), conn_varnames.begin(), conn_varnames.end());
+        dimsvec.insert(dimsvec.end(), conn_dimsvec.begin(), conn_dimsvec.end());
+        bsvec.insert(bsvec.end(), conn_bsvec.begin(), conn_bsvec.end());
+        bminvec.insert(bminvec.end(), conn_bminvec.begin(), conn_bminvec.end());
+        bmaxvec.insert(bmaxvec.end(), conn_bmaxvec.begin(), conn_bmaxvec.end());
+        isInt.resize(varnames.size(), true);
+    }
+
+    // Same regions as _get_regions() reads
+    //
+    for (int i = 0; i < varnames.size(); i++) {
+        if (varnames[i].empty()) continue;
+        if (_getDerivedVar(varnames[i])) return (1);
+
+        DC::BaseVar var;
+        bool        ok = GetBaseVarInfo(varnames[i], var);
+        if (!ok) return (-1);
+
+        int nlods = var.GetCRatios().size();
+        int nlevels = _nativeNumRefLevels(varnames[i]);
+        if (level < -nlevels) return (1);
+
+        prefetch_read_t r;
+        r.ts = IsTimeVarying(varnames[i]) ? req.ts : 0;
+        r.varname = varnames[i];
+        r.level = level;
+        r.lod = std::max(lod, -nlods);
+        r.isInt = isInt[i];
+        r.grid_dims = dimsvec[i];
+        r.grid_bs = bsvec[i];
+        r.grid_bmin = bminvec[i];
+        r.grid_bmax = bmaxvec[i];
+
+        if (_regionsIndex.find(region_key_t(r.ts, r.varname, r.level, r.lod, r.grid_bmin, r.grid_bmax)) != _regionsIndex.end()) continue;
+
+        vector<size_t> file_dimsv, file_bsv;
+        rc = GetDimLensAtLevel(r.varname, r.level, file_dimsv, file_bsv, r.ts);
+        if (rc < 0) return (-1);
+
+        r.file_dims = {1, 1, 1};
+        Grid::CopyToArr3(file_dimsv, r.file_dims);
+        r.file_bs = {1, 1, 1};
+        Grid::CopyToArr3(file_bsv, r.file_bs);
+        r.ndims = GetNumDimensions(r.varname);
+
+        reads.push_back(r);
+    }
+
+    return (0);
+}
+
+// Reads like _get_region_from_fs(), using only the data collection and the
+// read request, as it is called without _mutex locked
+//
+template<typename T> int DataMgr::_readPrefetch(prefetch_read_t &r) const
+{
+    size_t size = sizeof(T);
+    for (int i = 0; i < r.grid_bmin.size(); i++) { size *= (r.grid_bmax[i] - r.grid_bmin[i] + 1) * r.grid_bs[i]; }
+    r.blks.resize(size);
+    T *blks = (T *)r.blks.data();
+
+    DimsType grid_min, grid_max;
+    map_blk_to_vox(r.grid_bs, r.grid_dims, r.grid_bmin, r.grid_bmax, grid_min, grid_max);
+
+    int fd = _dc->OpenVariableRead(r.ts, r.varname, r.level, r.lod);
+    if (fd < 0) return (fd);
+
+    auto readRegion = [this, &r, fd](const DimsType &min, const DimsType &max, T *region) {
+        vector<size_t> minv, maxv;
+        Grid::CopyFromArr3(min, minv);
+        minv.resize(r.ndims);
+        Grid::CopyFromArr3(max, maxv);
+        maxv.resize(r.ndims);
+
+        int rc = _dc->ReadRegion(fd, minv, maxv, region);
+        _sanitizeFloats(region, vproduct(box_dims(min, max)));
+        return (rc);
+    };
+
+    int rc = 0;
+    if (!is_blocked(r.file_bs)) {
+        vector<T> region(vproduct(box_dims(grid_min, grid_max)));
+        rc = readRegion(grid_min, grid_max, region.data());
+        if (rc >= 0) copy_block(region.data(), blks, grid_min, grid_max, r.grid_bs, grid_min, grid_max);
+    } else {
+        // Read one slab of disk blocks at a time, as
+        // _get_blocked_region_from_fs() does
+        //
+        DimsType file_bmin, file_bmax;
+        map_vox_to_blk(r.file_bs, grid_min, file_bmin);
+        map_vox_to_blk(r.file_bs, grid_max, file_bmax);
+
+        DimsType bmin = file_bmin;
+        DimsType bmax = file_bmax;
+
+        size_t nreads = 1;
+        if (bmax[2] > bmin[2]) {
+            nreads = bmax[2] - bmin[2] + 1;
+            bmax[2] = bmin[2];
+        }
+
+        DimsType file_min, file_max;
+        map_blk_to_vox(r.file_bs, bmin, bmax, file_min, file_max);
+        vector<T> file_block(vproduct(box_dims(file_min, file_max)));
+
+        for (size_t i = 0; i < nreads && rc >= 0; i++) {
+            map_blk_to_vox(r.file_bs, r.file_dims, bmin, bmax, file_min, file_max);
+
+            rc = readRegion(file_min, file_max, file_block.data());
+            if (rc >= 0) copy_block(file_block.data(), blks, file_min, file_max, r.grid_bs, grid_min, grid_max);
+
+            IncrementCoords(file_bmin.data(), file_bmax.data(), bmin.data(), bmin.size(), 2);
+            IncrementCoords(file_bmin.data(), file_bmax.data(), bmax.data(), bmin.size(), 2);
+        }
+    }
+
+    (void)_dc->CloseVariable(fd);
+    return (rc < 0 ? -1 : 0);
+}
+
+void DataMgr::_stopPrefetch()
+{
+    {
+        std::lock_guard<std::mutex> lk(_prefetchMutex);
+        _prefetchQueue.clear();
+        _prefetchShutdown = true;
+    }
+    _prefetchCV.notify_all();
+
+    if (_prefetchThread.joinable()) _prefetchThread.join();
+}
+
+bool DataMgr::_readPyramid(size_t ts, string varname, int level, int lod, const DimsType &grid_dims, const DimsType &min, const DimsType &max, float *region)
+{
+    if (!_pyramidEnabled || _nativeNumRefLevels(varname) != 1 || _getDerivedVar(varname)) return (false);
+
+    vector<size_t> dimsv, bsv;
+    int            rc = _nativeDimLensAtLevel(varname, -1, dimsv, bsv, ts);
+    if (rc < 0) return (false);
+
+    DimsType dims = {1, 1, 1};
+    Grid::CopyToArr3(dimsv, dims);
+
+    // Only the levels built by PyramidCache::Build() are cached
+    //
+    int pyramid_level = -1 - level;
+    if (pyramid_level > PyramidCache::NumLevels(dims) || PyramidCache::DimsAtLevel(dims, pyramid_level) != grid_dims) return (false);
+
+    if (!_pyramid.ReadRegion(varname, ts, lod, grid_dims, min, max, region)) {
+        _queuePyramid(ts, varname, lod);
+        return (false);
+    }
+
+    _sanitizeFloats(region, vproduct(box_dims(min, max)));
+    return (true);
+}
+
+void DataMgr::_queuePyramid(size_t ts, string varname, int lod)
+{
+    std::lock_guard<std::mutex> lk(_pyramidMutex);
+
+    // Each variable is built at most once per Initialize(), whether or
+    // not building succeeds
+    //
+    if (!_pyramidRequested.insert(std::make_tuple(ts, varname, lod)).second) return;
+
+    // Start the worker thread on first use
+    //
+    if (!_pyramidThread.joinable()) {
+        _pyramidShutdown = false;
+        _pyramidThread = std::thread(&DataMgr::_pyramidWorker, this);
+    }
+
+    _pyramidQueue.push_back({ts, varname, lod});
+    _pyramidCV.notify_one();
+}
+
+void DataMgr::_pyramidWorker()
+{
+    for (;;) {
+        pyramid_req_t req;
+        {
+            std::unique_lock<std::mutex> lk(_pyramidMutex);
+            _pyramidCV.wait(lk, [this] { return (_pyramidShutdown || !_pyramidQueue.empty()); });
+            if (_pyramidShutdown) return;
+
+            req = _pyramidQueue.front();
+            _pyramidQueue.pop_front();
+        }
+
+        DimsType dims = {1, 1, 1};
+        size_t   ndims;
+        {
+            std::lock_guard<std::recursive_mutex> guard(_mutex);
+
+            bool           enabled = EnableErrMsg(false);
+            vector<size_t> dimsv, bsv;
+            int            rc = _nativeDimLensAtLevel(req.varname, -1, dimsv, bsv, req.ts);
+            EnableErrMsg(enabled);
+            if (rc < 0) continue;
+
+            Grid::CopyToArr3(dimsv, dims);
+            ndims = dimsv.size();
+        }
+
+        // The data collection is only locked while a plane is read, so
+        // clients aren't held up while planes are downsampled and written.
+        // Errors are not reported, the levels are simply not cached
+        //
+        auto readPlane = [this, &req, &dims, ndims](size_t z, float *plane) -> int {
+            {
+                std::lock_guard<std::mutex> lk(_pyramidMutex);
+                if (_pyramidShutdown) return (-1);
+            }
+
+            std::lock_guard<std::recursive_mutex> guard(_mutex);
+            std::lock_guard<std::recursive_mutex> dcGuard(_dcMutex);
+
+            bool enabled = EnableErrMsg(false);
+            int  rc = _openVariableRead(req.ts, req.varname, -1, req.lod);
+            if (rc >= 0) {
+                int      fd = rc;
+                DimsType min = {0, 0, z};
+                DimsType max = {dims[0] - 1, dims[1] - 1, z};
+                rc = _readRegion(fd, min, max, ndims, plane);
+                (void)_closeVariable(fd);
+            }
+            EnableErrMsg(enabled);
+            return (rc);
+        };
+
+        (void)_pyramid.Build(req.varname, req.ts, req.lod, dims, readPlane);
+    }
+}
+
+void DataMgr::_stopPyramid()
+{
+    {
+        std::lock_guard<std::mutex> lk(_pyramidMutex);
+        _pyramidQueue.clear();
+        _pyramidShutdown = true;
+    }
+    _pyramidCV.notify_all();
+
+    if (_pyramidThread.joinable()) _pyramidThread.join();
+}
+
 size_t DataMgr::GetNumDimensions(string varname) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     vector<size_t> dims, dummy;
@@ -1721,6 +2388,7 @@ size_t DataMgr::GetNumDimensions(string varname) const
 
 size_t DataMgr::GetVarTopologyDim(string varname) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     DC::DataVar var;
@@ -1738,6 +2406,7 @@ size_t DataMgr::GetVarTopologyDim(string varname) const
 
 size_t DataMgr::GetVarGeometryDim(string varname) const
 {
+    std::lock_guard<std::recursive_mutex> guard(_mutex);
     VAssert(_dc);
 
     DC::DataVar var;
@@ -1755,47 +2424,45 @@ size_t DataMgr::GetVarGeometryDim(string varname) const
 
 template<typename T> T *DataMgr::_get_region_from_cache(size_t ts, string varname, int level, int lod, const DimsType &bmin, const DimsType &bmax, bool lock)
 {
-    list<region_t>::iterator itr;
-    for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
-        region_t &region = *itr;
+    auto itr = _regionsIndex.find(region_key_t(ts, varname, level, lod, bmin, bmax));
+    if (itr == _regionsIndex.end()) return (NULL);
 
-        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax) {
-            // Increment the lock counter
-            region.lock_counter += lock ? 1 : 0;
+    region_t &region = *itr->second;
 
-            // Move region to front of list
-            region_t tmp_region = region;
-            _regionsList.erase(itr);
-            _regionsList.push_back(tmp_region);
+    // Increment the lock counter
+    region.lock_counter += lock ? 1 : 0;
 
-            SetDiagMsg("DataMgr::_get_region_from_cache() - data in cache %xll\n", tmp_region.blks);
-            return ((T *)tmp_region.blks);
-        }
-    }
+    // Move region to the most recently used end of the list. Splicing
+    // relinks the node in place, so no iterators are invalidated.
+    //
+    _regionsList.splice(_regionsList.end(), _regionsList, itr->second);
 
-    return (NULL);
+    SetDiagMsg("DataMgr::_get_region_from_cache() - data in cache %xll\n", region.blks);
+    return ((T *)region.blks);
 }
 
 template<typename T>
 int DataMgr::_get_unblocked_region_from_fs(size_t ts, string varname, int level, int lod, const DimsType &grid_dims, const DimsType &grid_bs, const DimsType &grid_min, const DimsType &grid_max,
                                            T *blks)
 {
-    int fd = _openVariableRead(ts, varname, level, lod);
+    int nlevels = _nativeNumRefLevels(varname);
+
+    int fd = _openVariableRead(ts, varname, std::max(level, -nlevels), lod);
     if (fd < 0) return (fd);
 
     T *region = new T[vproduct(box_dims(grid_min, grid_max))];
 
-    int nlevels = DataMgr::GetNumRefLevels(varname);
-
     // Rank of array describing variable
     //
     size_t ndims = GetNumDimensions(varname);
 
-    // Downsample the data if needed
+    // Downsample the data if needed, unless a downsampled copy is cached
     //
-    if (level < -nlevels) {
+    if (level < -nlevels && _readPyramid(ts, varname, level, lod, grid_dims, grid_min, grid_max, region)) {
+        SetDiagMsg("DataMgr::_get_unblocked_region_from_fs() - data read from pyramid cache\n");
+    } else if (level < -nlevels) {
         vector<size_t> dimsv;
-        int            rc = GetDimLensAtLevel(varname, level, dimsv, ts);
+        int            rc = GetDimLensAtLevel(varname, -nlevels, dimsv, ts);
 
         DimsType dims = {1, 1, 1};
         Grid::CopyToArr3(dimsv, dims);
@@ -1921,7 +2588,9 @@ T *DataMgr::_get_region_from_fs(size_t ts, string varname, int level, int lod, c
     DimsType grid_min, grid_max;
     map_blk_to_vox(grid_bs, grid_dims, grid_bmin, grid_bmax, grid_min, grid_max);
 
-    int nlevels = DataMgr::GetNumRefLevels(varname);
+    int nlevels = _nativeNumRefLevels(varname);
+
+    std::lock_guard<std::recursive_mutex> dcGuard(_dcMutex);
 
     // If data aren't blocked on disk or if the requested level is not
     // available do a non-blocked read
@@ -2026,7 +2695,7 @@ void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, Dims
 
     void *blks;
     while (!(blks = (void *)_blk_mem_mgr->Alloc(nblocks, fill))) {
-        if (!_free_lru()) {
+        if (_prefetchNoEvict || !_free_lru()) {
             SetErrMsg("Failed to allocate requested memory");
             return (NULL);
         }
@@ -2043,43 +2712,48 @@ void *DataMgr::_alloc_region(size_t ts, string varname, int level, int lod, Dims
     region.lock_counter = lock ? 1 : 0;
     region.blks = blks;
 
-    _regionsList.push_back(region);
+    auto itr = _regionsList.insert(_regionsList.end(), region);
+    _regionsIndex[region_key_t(region)] = itr;
+    _regionsByBlks[blks] = itr;
+    _regionsByVar[varname].insert(blks);
 
     return (region.blks);
 }
 
-void DataMgr::_free_region(size_t ts, string varname, int level, int lod, DimsType bmin, DimsType bmax, bool forceFlag)
+void DataMgr::_erase_region(region_itr_t itr)
 {
-    list<region_t>::iterator itr;
-    for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
-        const region_t &region = *itr;
+    const region_t &region = *itr;
 
-        if (region.ts == ts && region.varname.compare(varname) == 0 && region.level == level && region.lod == lod && region.bmin == bmin && region.bmax == bmax) {
-            if (region.lock_counter == 0 || forceFlag) {
-                if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+    _regionsIndex.erase(region_key_t(region));
+    _regionsByBlks.erase(region.blks);
 
-                _regionsList.erase(itr);
-                return;
-            }
-        }
+    auto vitr = _regionsByVar.find(region.varname);
+    if (vitr != _regionsByVar.end()) {
+        vitr->second.erase(region.blks);
+        if (vitr->second.empty()) _regionsByVar.erase(vitr);
     }
 
-    return;
+    if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+
+    _regionsList.erase(itr);
 }
 
-void DataMgr::_free_var(string varname)
+void DataMgr::_free_region(size_t ts, string varname, int level, int lod, DimsType bmin, DimsType bmax, bool forceFlag)
 {
-    list<region_t>::iterator itr;
-    for (itr = _regionsList.begin(); itr != _regionsList.end();) {
-        const region_t &region = *itr;
+    auto itr = _regionsIndex.find(region_key_t(ts, varname, level, lod, bmin, bmax));
+    if (itr == _regionsIndex.end()) return;
 
-        if (region.varname.compare(varname) == 0) {
-            if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
+    if (itr->second->lock_counter == 0 || forceFlag) _erase_region(itr->second);
+}
 
-            _regionsList.erase(itr);
-            itr = _regionsList.begin();
-        } else
-            itr++;
+void DataMgr::_free_var(string varname)
+{
+    auto vitr = _regionsByVar.find(varname);
+    if (vitr != _regionsByVar.end()) {
+        // Copy the block addresses since _erase_region() modifies the set
+        //
+        vector<const void *> blksvec(vitr->second.begin(), vitr->second.end());
+        for (auto blks : blksvec) { _erase_region(_regionsByBlks.at(blks)); }
     }
 
     _varInfoCacheSize_T.Purge(vector<string>(1, varname));
@@ -2093,11 +2767,8 @@ bool DataMgr::_free_lru()
     //
     list<region_t>::iterator itr;
     for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
-        const region_t &region = *itr;
-
-        if (region.lock_counter == 0) {
-            if (region.blks) _blk_mem_mgr->FreeMem(region.blks);
-            _regionsList.erase(itr);
+        if (itr->lock_counter == 0) {
+            _erase_region(itr);
             return (true);
         }
     }
@@ -2799,16 +3470,11 @@ int DataMgr::_find_bounding_grid(size_t ts, string varname, int level, int lod,
 
 void DataMgr::_unlock_blocks(const void *blks)
 {
-    list<region_t>::iterator itr;
-    for (itr = _regionsList.begin(); itr != _regionsList.end(); itr++) {
-        region_t &region = *itr;
+    auto itr = _regionsByBlks.find(blks);
+    if (itr == _regionsByBlks.end()) return;
 
-        if (region.blks == blks && region.lock_counter > 0) {
-            region.lock_counter--;
-            return;
-        }
-    }
-    return;
+    region_t &region = *itr->second;
+    if (region.lock_counter > 0) region.lock_counter--;
 }
 
 vector<string> DataMgr::_getDataVarNamesDerived(int ndim) const
@@ -3099,6 +3765,8 @@ template<class T> int DataMgr::_getVar(size_t ts, string varname, int level, int
         max.push_back(dims_at_level[i] - 1);
     }
 
+    std::lock_guard<std::recursive_mutex> dcGuard(_dcMutex);
+
     int fd = _dc->OpenVariableRead(ts, varname, level, lod);
     if (fd < 0) return (-1);
 
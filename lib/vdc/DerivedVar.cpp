@@ -1,6 +1,7 @@
 #include "vapor/VAssert.h"
 #include <sstream>
 #include <algorithm>
+#include <cstring>
 #include <set>
 #include <vapor/UDUnitsClass.h>
 #include <vapor/NetCDFCollection.h>
@@ -183,6 +184,19 @@ void make2D(float *lonBuf, float *latBuf, vector<size_t> dims)
     }
 }
 
+// FNV-1a hash of the bit patterns of an array of floats
+//
+uint64_t hashFloats(const float *a, size_t n, uint64_t h = 14695981039346656037ULL)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint32_t w;
+        memcpy(&w, &a[i], sizeof(w));
+        h ^= w;
+        h *= 1099511628211ULL;
+    }
+    return (h);
+}
+
 // Transpose a 1D, 2D, or 3D array. For 1D 'a' is simply copied
 // to 'b'. Otherwise 'b' contains a permuted version of 'a' as follows:
 //
@@ -579,9 +593,9 @@ int DerivedCoordVar_PCSFromLatLon::_readRegionHelperCylindrical(DC::FileTable::F
     if (rc < 0) { return (rc); }
 
     if (_lonFlag) {
-        rc = _proj4API.Transform(region, buf.data(), nElements);
+        rc = _transform(min, max, lod, region, buf.data(), nElements, region);
     } else {
-        rc = _proj4API.Transform(buf.data(), region, nElements);
+        rc = _transform(min, max, lod, buf.data(), region, nElements, region);
     }
 
     return (rc);
@@ -630,7 +644,7 @@ int DerivedCoordVar_PCSFromLatLon::_readRegionHelper1D(DC::FileTable::FileObject
     //
     make2D(lonBufPtr, latBufPtr, roidims);
 
-    rc = _proj4API.Transform(lonBufPtr, latBufPtr, vproduct(roidims));
+    rc = _transform(min, max, lod, lonBufPtr, latBufPtr, vproduct(roidims), region);
 
     return (rc);
 }
@@ -665,8 +679,7 @@ int DerivedCoordVar_PCSFromLatLon::_readRegionHelper2D(DC::FileTable::FileObject
     rc = _getVar(_dc, ts, _latName, -1, lod, min, max, latBufPtr);
     if (rc < 0) { return (rc); }
 
-    rc = _proj4API.Transform(lonBufPtr, latBufPtr, nElements);
-
+    rc = _transform(min, max, lod, lonBufPtr, latBufPtr, nElements, region);
 
     return (rc);
 }
@@ -696,6 +709,33 @@ int DerivedCoordVar_PCSFromLatLon::ReadRegion(int fd, const vector<size_t> &min,
     }
 }
 
+int DerivedCoordVar_PCSFromLatLon::_transform(const vector<size_t> &min, const vector<size_t> &max, int lod, float *lonBuf, float *latBuf, size_t n, float *region)
+{
+    uint64_t hash = hashFloats(latBuf, n, hashFloats(lonBuf, n));
+
+    for (auto itr = _projCache.begin(); itr != _projCache.end(); ++itr) {
+        if (itr->min == min && itr->max == max && itr->lod == lod && itr->hash == hash && itr->region.size() == n) {
+            std::copy(itr->region.begin(), itr->region.end(), region);
+            _projCache.splice(_projCache.begin(), _projCache, itr);
+            return (0);
+        }
+    }
+
+    int rc = _proj4API.Transform(lonBuf, latBuf, n);
+    if (rc < 0) return (rc);
+
+    if (_projCache.size() >= _projCacheMaxEntries) _projCache.pop_back();
+    _projCache.push_front(ProjCacheEntry());
+    ProjCacheEntry &entry = _projCache.front();
+    entry.min = min;
+    entry.max = max;
+    entry.lod = lod;
+    entry.hash = hash;
+    entry.region.assign(region, region + n);
+
+    return (0);
+}
+
 bool DerivedCoordVar_PCSFromLatLon::VariableExists(size_t ts, int, int) const { return (_dc->VariableExists(ts, _lonName, -1, -1) && _dc->VariableExists(ts, _latName, -1, -1)); }
 
 int DerivedCoordVar_PCSFromLatLon::_setupVar()
@@ -203,90 +203,42 @@ void Grid::SetValueIJK(size_t i, size_t j, size_t k, float v)
     return (SetValue(indices, v));
 }
 
-void Grid::GetRange(float range[2]) const
-{
-    const auto missingVal = GetMissingValue();
-    const auto num_vals = _dims[0] * _dims[1] * _dims[2];
-    auto num_threads = size_t{1};
-#pragma omp parallel
-    {
-      if (omp_get_thread_num() == 0)
-        num_threads = omp_get_num_threads();
-    }
-    const auto stride_size = num_vals / num_threads;
-
-    auto min_vec = std::vector<float>(num_threads, missingVal);
-    auto max_vec = std::vector<float>(num_threads, missingVal);
-
-#pragma omp parallel for
-    for (size_t i = 0; i < num_threads; i++) {
-      auto beg = this->cbegin() + i * stride_size;
-      auto end = beg;
-      if (i < num_threads - 1) 
-        end += stride_size;
-      else
-        end = this->cend();
-
-      while (*beg == missingVal && beg != end)
-        ++beg;
-
-      if (beg != end) {
-        auto min = *beg;
-        auto max = *beg;
-        for (auto itr  = beg + 1; itr != end; ++itr) {
-          if (*itr != missingVal) {
-            min = std::min(*itr, min);      
-            max = std::max(*itr, max);      
-          }
-        }
-        min_vec[i] = min;
-        max_vec[i] = max;
-      }
-    } // finish omp section
-
-    if (std::all_of(min_vec.begin(), min_vec.end(), 
-        [missingVal](float v){return v == missingVal;})) {
-      range[0] = missingVal;
-      range[1] = missingVal;
-    }
-    else {
-      auto it = std::remove(min_vec.begin(), min_vec.end(), missingVal);
-      range[0] = *std::min_element(min_vec.begin(), it);
-      it = std::remove(max_vec.begin(), max_vec.end(), missingVal);
-      range[1] = *std::max_element(max_vec.begin(), it);
-    }
-}
+void Grid::GetRange(float range[2]) const { GetRange(DimsType{0, 0, 0}, _dims, range); }
 
 void Grid::GetRange(const DimsType &min, const DimsType &max, float range[2]) const
 {
-    DimsType cMin;
-    ClampIndex(min, cMin);
-
-    DimsType cMax;
-    ClampIndex(max, cMax);
+    const float mv = GetMissingValue();
 
-    float mv = GetMissingValue();
-
-    range[0] = range[1] = mv;
-
-    bool first = true;
-    for (size_t k = cMin[2]; k <= cMax[2]; k++) {
-        for (size_t j = cMin[1]; j <= cMax[1]; j++) {
-            for (size_t i = cMin[0]; i <= cMax[0]; i++) {
-                float v = AccessIJK(i, j, k);
-                if (first && v != mv) {
-                    range[0] = range[1] = v;
-                    first = false;
-                }
-
-                if (!first) {
-                    if (v < range[0] && v != mv)
-                        range[0] = v;
-                    else if (v > range[1] && v != mv)
-                        range[1] = v;
-                }
+    // Each thread keeps its own range. A range of {max, lowest} is empty
+    //
+    int           nThreads = omp_get_max_threads();
+    vector<float> minVec(nThreads, std::numeric_limits<float>::max());
+    vector<float> maxVec(nThreads, std::numeric_limits<float>::lowest());
+
+    ForEachBlock(
+        min, max,
+        [&](const float *span, size_t n, const DimsType &) {
+            int   t = omp_get_thread_num();
+            float lo = minVec[t];
+            float hi = maxVec[t];
+            for (size_t i = 0; i < n; i++) {
+                float v = span[i];
+                if (v == mv) continue;
+                lo = std::min(lo, v);
+                hi = std::max(hi, v);
             }
-        }
+            minVec[t] = lo;
+            maxVec[t] = hi;
+        },
+        true);
+
+    float lo = *std::min_element(minVec.begin(), minVec.end());
+    float hi = *std::max_element(maxVec.begin(), maxVec.end());
+    if (lo > hi) {
+        range[0] = range[1] = mv;
+    } else {
+        range[0] = lo;
+        range[1] = hi;
     }
 }
 
@@ -306,6 +258,52 @@ float Grid::GetValue(const CoordType &coords) const
     }
 }
 
+void Grid::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    for (size_t i = 0; i < n; i++) values[i] = GetValue(coords[i]);
+}
+
+bool Grid::ResampleRegular(const DimsType &dims, float *values, unsigned char *missingMask) const
+{
+    // Also caches the extents before they are needed by several threads
+    //
+    CoordType minu, maxu;
+    GetUserExtents(minu, maxu);
+
+    const float mv = GetMissingValue();
+    const long  nRows = dims[1] * dims[2];
+    bool        hasMissing = false;
+
+    #pragma omp parallel
+    {
+        vector<CoordType> coords(dims[0]);
+
+        #pragma omp for schedule(dynamic) reduction(|| : hasMissing)
+        for (long row = 0; row < nRows; row++) {
+            size_t y = row % dims[1];
+            size_t z = row / dims[1];
+            for (size_t x = 0; x < dims[0]; x++) {
+                coords[x][0] = (x + 0.5) / dims[0] * (maxu[0] - minu[0]) + minu[0];
+                coords[x][1] = (y + 0.5) / dims[1] * (maxu[1] - minu[1]) + minu[1];
+                coords[x][2] = (z + 0.5) / dims[2] * (maxu[2] - minu[2]) + minu[2];
+            }
+
+            float *rowValues = values + row * dims[0];
+            GetValues(coords.data(), dims[0], rowValues);
+
+            // The missing mask is computed while the row is still in cache
+            //
+            for (size_t x = 0; x < dims[0]; x++) {
+                bool missing = rowValues[x] == mv;
+                hasMissing = hasMissing || missing;
+                if (missingMask) missingMask[row * dims[0] + x] = missing ? 255 : 0;
+            }
+        }
+    }
+
+    return (hasMissing);
+}
+
 
 void Grid::GetUserCoordinates(size_t i, double &x, double &y, double &z) const
 {
@@ -2,6 +2,11 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vapor/FileUtils.h>
 #include <vapor/QuadTreeRectangleP.h>
 #include <vapor/GridHelper.h>
 #include <vapor/UnstructuredGrid3D.h>
@@ -100,12 +105,103 @@ bool isCurvilinear(const DC::Mesh &m, const vector<DC::CoordVar> &cvarsinfo, con
     return (true);
 }
 
+// 64 bit FNV-1a hash of the coordinates and connectivity a quad tree is
+// built from. Hashes a word, rather than a byte, at a time as the arrays
+// hashed can be hundreds of MBs
+//
+class fingerprint_t {
+public:
+    fingerprint_t() : _h(14695981039346656037ULL) {}
+
+    void add(uint64_t v) { _h = (_h ^ v) * 1099511628211ULL; }
+
+    void add(const DimsType &v)
+    {
+        for (auto d : v) add((uint64_t)d);
+    }
+
+    void add(const string &s) { add(s.data(), s.size()); }
+
+    template<typename T> void add(const T *data, size_t n)
+    {
+        const unsigned char *p = (const unsigned char *)data;
+        size_t               nbytes = n * sizeof(T);
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= nbytes; i += sizeof(uint64_t)) {
+            uint64_t w;
+            memcpy(&w, p + i, sizeof(w));
+            add(w);
+        }
+        if (i < nbytes) {
+            uint64_t w = 0;
+            memcpy(&w, p + i, nbytes - i);
+            add(w);
+        }
+        add((uint64_t)nbytes);
+    }
+
+    // Add the dims[0] x dims[1] values of a blocked 2D array with nbx
+    // blocks along X. Padding in partially filled blocks is skipped, as it
+    // isn't initialized
+    //
+    void add(const vector<float *> &blks, const DimsType &dims, const DimsType &bs, size_t nbx)
+    {
+        size_t nbxData = std::min(nbx, (dims[0] + bs[0] - 1) / bs[0]);
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t bx = 0; bx < nbxData; bx++) {
+                const float *blk = blks[(j / bs[1]) * nbx + bx];
+                size_t       n = std::min(bs[0], dims[0] - bx * bs[0]);
+                add(blk + (j % bs[1]) * bs[0], n);
+            }
+        }
+    }
+
+    uint64_t get() const { return (_h); }
+
+private:
+    uint64_t _h;
+};
 
 };    // namespace
 
 using namespace VAPoR;
 using namespace Wasp;
 
+string GridHelper::DefaultQuadTreeCacheDir(const vector<string> &files)
+{
+    if (const char *s = getenv("VAPOR_QUADTREE_CACHE")) return (string(s));
+
+    if (files.empty()) return ("");
+    return (FileUtils::JoinPaths({FileUtils::Dirname(files[0]), ".vapor_quadtree"}));
+}
+
+std::shared_ptr<const QuadTreeRectangleP> GridHelper::_readQuadTreeRectangle(const string &key, uint64_t fingerprint)
+{
+    if (_qtrCacheDir.empty()) return (nullptr);
+
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx.vqtr", (unsigned long long)fingerprint);
+
+    std::shared_ptr<const QuadTreeRectangleP> qtr = QuadTreeRectangleP::Read(FileUtils::JoinPaths({_qtrCacheDir, name}), fingerprint);
+    if (qtr) (void)_qtrCache.put(key, qtr);
+    return (qtr);
+}
+
+void GridHelper::_writeQuadTreeRectangle(uint64_t fingerprint, const QuadTreeRectangleP &qtr) const
+{
+    if (_qtrCacheDir.empty()) return;
+
+    if (!FileUtils::IsDirectory(_qtrCacheDir) && FileUtils::MakeDir(_qtrCacheDir) != 0) return;
+
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx.vqtr", (unsigned long long)fingerprint);
+
+    // Failing to save the tree only costs rebuilding it next session
+    //
+    (void)qtr.Write(FileUtils::JoinPaths({_qtrCacheDir, name}), fingerprint);
+}
+
 string GridHelper::_getQuadTreeRectangleKey(size_t ts, int level, int lod, const vector<DC::CoordVar> &cvarsinfo, const DimsType &bmin, const DimsType &bmax) const
 {
     VAssert(cvarsinfo.size() >= 2);
@@ -299,6 +395,20 @@ CurvilinearGrid *GridHelper::_make_grid_curvilinear(size_t ts, int level, int lo
     //
     std::shared_ptr<const QuadTreeRectangleP> qtr = _qtrCache.get(qtr_key);
 
+    // Not in memory. Look for a tree saved by an earlier session
+    //
+    uint64_t fingerprint = 0;
+    if (!qtr && !_qtrCacheDir.empty()) {
+        fingerprint_t f;
+        f.add(CurvilinearGrid::GetClassType());
+        f.add(dims2d);
+        f.add(xcblkptrs, dims2d, bs2d, bmax2d[0] - bmin2d[0] + 1);
+        f.add(ycblkptrs, dims2d, bs2d, bmax2d[0] - bmin2d[0] + 1);
+        fingerprint = f.get();
+
+        qtr = _readQuadTreeRectangle(qtr_key, fingerprint);
+    }
+
     CurvilinearGrid *g;
     if (Grid::GetNumDimensions(dims) == 3 && cvarsinfo[2].GetDimNames().size() == 3) {
         // Terrain following vertical
@@ -333,6 +443,7 @@ CurvilinearGrid *GridHelper::_make_grid_curvilinear(size_t ts, int level, int lo
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
         (void)_qtrCache.put(qtr_key, qtr);
+        _writeQuadTreeRectangle(fingerprint, *qtr);
     }
 
     return (g);
@@ -392,6 +503,25 @@ UnstructuredGrid2D *GridHelper::_make_grid_unstructured2d(size_t ts, int level,
     //
     std::shared_ptr<const QuadTreeRectangleP> qtr = _qtrCache.get(qtr_key);
 
+    // Not in memory. Look for a tree saved by an earlier session
+    //
+    uint64_t fingerprint = 0;
+    if (!qtr && !_qtrCacheDir.empty()) {
+        fingerprint_t f;
+        f.add(UnstructuredGrid2D::GetClassType());
+        f.add(vertexDims);
+        f.add(faceDims);
+        f.add((uint64_t)maxVertexPerFace);
+        f.add((uint64_t)vertexOffset);
+        f.add((uint64_t)faceOffset);
+        f.add(blkvec[1], vertexDims[0]);
+        f.add(blkvec[2], vertexDims[0]);
+        f.add(vertexOnFace, faceDims[0] * maxVertexPerFace);
+        fingerprint = f.get();
+
+        qtr = _readQuadTreeRectangle(qtr_key, fingerprint);
+    }
+
     UnstructuredGrid2D *g = new UnstructuredGrid2D(vertexDims, faceDims, edgeDims, bs, blkptrs, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, vertexOffset,
                                                    faceOffset, xug, yug, zug, qtr);
 
@@ -402,6 +532,7 @@ UnstructuredGrid2D *GridHelper::_make_grid_unstructured2d(size_t ts, int level,
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
         (void)_qtrCache.put(qtr_key, qtr);
+        _writeQuadTreeRectangle(fingerprint, *qtr);
     }
 
     return (g);
@@ -488,6 +619,26 @@ UnstructuredGridLayered *GridHelper::_make_grid_unstructured_layered(size_t ts,
     //
     std::shared_ptr<const QuadTreeRectangleP> qtr = _qtrCache.get(qtr_key);
 
+    // Not in memory. Look for a tree saved by an earlier session. The tree
+    // only depends on the horizontal coordinates
+    //
+    uint64_t fingerprint = 0;
+    if (!qtr && !_qtrCacheDir.empty()) {
+        fingerprint_t f;
+        f.add(UnstructuredGridLayered::GetClassType());
+        f.add(vertexDims1D);
+        f.add(faceDims1D);
+        f.add((uint64_t)maxVertexPerFace);
+        f.add((uint64_t)vertexOffset);
+        f.add((uint64_t)faceOffset);
+        f.add(blkvec[1], vertexDims[0]);
+        f.add(blkvec[2], vertexDims[0]);
+        f.add(vertexOnFace, faceDims[0] * maxVertexPerFace);
+        fingerprint = f.get();
+
+        qtr = _readQuadTreeRectangle(qtr_key, fingerprint);
+    }
+
     UnstructuredGridLayered *g = new UnstructuredGridLayered(vertexDims, faceDims, edgeDims, bs, blkptrs, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex,
                                                              vertexOffset, faceOffset, xug, yug, zug, qtr);
 
@@ -498,6 +649,7 @@ UnstructuredGridLayered *GridHelper::_make_grid_unstructured_layered(size_t ts,
     if (!qtr) {
         qtr = g->GetQuadTreeRectangle();
         (void)_qtrCache.put(qtr_key, qtr);
+        _writeQuadTreeRectangle(fingerprint, *qtr);
     }
 
     return (g);
@@ -578,9 +730,19 @@ UnstructuredGrid3D *GridHelper::_make_grid_unstructured_3d(size_t ts, int level,
     UnstructuredGridCoordless zug(vertexDims, faceDims, edgeDims, bs, zcblkptrs, 3, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, vertexOffset, faceOffset);
 
 
+    // Building the index used to locate points is expensive too, so it
+    // is cached the same way as QuadTreeRectangles are for 2D grids
+    //
+    string                             index_key = _getQuadTreeRectangleKey(ts, level, lod, cvarsinfo, bmin, bmax);
+    std::shared_ptr<const CellIndex3D> index = _cellIndexCache.get(index_key);
+
     UnstructuredGrid3D *g = new UnstructuredGrid3D(vertexDims, faceDims, edgeDims, bs, blkptrs, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, vertexOffset,
-                                                   faceOffset, xug, yug, zug);
+                                                   faceOffset, xug, yug, zug, index);
 
+    if (!index) {
+        index = g->GetCellIndex();
+        (void)_cellIndexCache.put(index_key, index);
+    }
 
     return (g);
 }
@@ -677,6 +839,7 @@ UnstructuredGrid *GridHelper::MakeGridUnstructured(string gridType, size_t ts, i
 GridHelper::~GridHelper()
 {
     while ((_qtrCache.remove_lru()) != NULL) {}
+    while ((_cellIndexCache.remove_lru()) != NULL) {}
 }
 
 string GridHelper::GetGridType(const DC::Mesh &m, const vector<DC::CoordVar> &cvarsinfo, const vector<vector<string>> &cdimnames) const
@@ -120,10 +120,16 @@ void LayeredGrid::GetBoundingBox(const DimsType &min, const DimsType &max, Coord
 }
 
 bool LayeredGrid::_insideGrid(const CoordType &coords, DimsType &indices, double wgts[3]) const
+{
+    vector<double> zcoords;
+    return (_insideGrid(coords, indices, wgts, zcoords, false));
+}
+
+bool LayeredGrid::_insideGrid(const CoordType &coords, DimsType &indices, double wgts[3], vector<double> &zcoords, bool useHint) const
 {
     // Get indices and weights for horizontal slice
     //
-    bool found = _sg2d.GetIndicesCell(coords, indices, wgts);
+    bool found = useHint ? _sg2d.GetIndicesCellHint(coords, indices, wgts) : _sg2d.GetIndicesCell(coords, indices, wgts);
     if (!found) return (found);
 
     // XZ and YZ cell sides are planar, but XY sides may not be. We divide
@@ -160,20 +166,31 @@ bool LayeredGrid::_insideGrid(const CoordType &coords, DimsType &indices, double
 
     float z0, z1;
 
-    // Find k index of cell containing z. Already know i and j indices
+    // Interpolate Z coordinate across triangle
     //
-    vector<double> zcoords;
+    auto zAt = [&](size_t kk) -> float {
+        return (_zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2]);
+    };
 
+    // If the guessed layer contains z there's no need to interpolate the
+    // Z coordinates of the whole column. Same test as BinarySearchRangeHint()
+    //
     size_t nz = GetDimensions()[2];
-    zcoords.reserve(nz);
-    for (int kk = 0; kk < nz; kk++) {
-        // Interpolate Z coordinate across triangle
-        //
-        float zk = _zrg.AccessIJK(iv[0], jv[0], kk) * lambda[0] + _zrg.AccessIJK(iv[1], jv[1], kk) * lambda[1] + _zrg.AccessIJK(iv[2], jv[2], kk) * lambda[2];
-
-        zcoords.push_back(zk);
+    size_t k = indices[2];
+    if (useHint && nz > 1 && k + 1 < nz && zAt(0) <= zAt(nz - 1)) {
+        z0 = zAt(k);
+        z1 = zAt(k + 1);
+        if (z0 <= coords[2] && (coords[2] < z1 || (k + 2 == nz && coords[2] == z1))) {
+            wgts[2] = z0 == z1 ? 1.0 : (1.0 - (coords[2] - z0) / (z1 - z0));
+            return (true);
+        }
     }
 
+    // Find k index of cell containing z. Already know i and j indices
+    //
+    zcoords.resize(nz);
+    for (int kk = 0; kk < nz; kk++) zcoords[kk] = zAt(kk);
+
     if (!Wasp::BinarySearchRange(zcoords, coords[2], indices[2])) return (false);
 
     z0 = zcoords[indices[2]];
@@ -233,6 +250,38 @@ float LayeredGrid::GetValue(const CoordType &coords) const
     return _getValueQuadratic(cCoords.data());
 }
 
+void LayeredGrid::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    // Figure out interpolation order, as in GetValue(). Only linear
+    // interpolation is batched.
+    //
+    int interp_order = _interpolationOrder;
+    if (interp_order == 2) {
+        if (GetDimensions()[2] < 3) interp_order = 1;
+    }
+
+    if (!GetBlks().size() || interp_order != 1) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Same as GetValueLinear() for each point, except that the cell
+    // containing the previous point is tested before searching the grid,
+    // and the storage for the Z coordinates of a column is reused
+    //
+    float          mv = GetMissingValue();
+    DimsType       indices = {0, 0, 0};
+    vector<double> zcoords;
+    for (size_t p = 0; p < n; p++) {
+        CoordType cCoords;
+        ClampCoord(coords[p], cCoords);
+
+        double wgts[3];
+        bool   found = _insideGrid(cCoords, indices, wgts, zcoords, true);
+        values[p] = found ? TrilinearInterpolate(indices[0], indices[1], indices[2], wgts[0], wgts[1], wgts[2]) : mv;
+    }
+}
+
 void LayeredGrid::SetInterpolationOrder(int order)
 {
     if (order < 0 || order > 3) order = 2;
@@ -36,9 +36,15 @@ NetCDFCollection::NetCDFCollection()
     _ovr_table.clear();
     _ncdfmap.clear();
     _failedVars.clear();
+    _metaIndex = NULL;
 }
 
-NetCDFCollection::~NetCDFCollection() { ReInitialize(); }
+NetCDFCollection::~NetCDFCollection()
+{
+    ReInitialize();
+
+    if (_metaIndex) delete _metaIndex;
+}
 
 void NetCDFCollection::ReInitialize()
 {
@@ -68,6 +74,11 @@ int NetCDFCollection::Initialize(const vector<string> &files, const vector<strin
 
     ReInitialize();
 
+    // Use the metadata index, if any, instead of reading the header of
+    // every file
+    //
+    _LoadMetaIndex();
+
     //
     // Build a hash table to map a variable's time dimension
     // to its time coordinates
@@ -87,7 +98,7 @@ int NetCDFCollection::Initialize(const vector<string> &files, const vector<strin
         NetCDFSimple *netcdf = new NetCDFSimple();
         _ncdfmap[files[i]] = netcdf;
 
-        rc = netcdf->Initialize(files[i]);
+        rc = netcdf->Initialize(files[i], _metaIndex);
         if (rc < 0) {
             SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
             return (-1);
@@ -158,9 +169,35 @@ int NetCDFCollection::Initialize(const vector<string> &files, const vector<strin
         tvvref.Sort();
     }
 
+    // Failing to write the index only costs time on the next open
+    //
+    if (_metaIndex) {
+        bool enable = EnableErrMsg(false);
+        if (_metaIndex->Save() < 0) SetErrCode(0);
+        (void)EnableErrMsg(enable);
+    }
+
     return (0);
 }
 
+void NetCDFCollection::_LoadMetaIndex()
+{
+    const string &path = _metaIndexPath;
+    if (path.empty()) {
+        if (_metaIndex) delete _metaIndex;
+        _metaIndex = NULL;
+        return;
+    }
+
+    // NetCDFCFCollection initializes the collection more than once. Only
+    // read the index the first time
+    //
+    if (_metaIndex && _metaIndex->GetPath() == path) return;
+
+    if (!_metaIndex) _metaIndex = new NetCDFMetaIndex();
+    (void)_metaIndex->Load(path);
+}
+
 #include <vapor/STLUtils.h>
 
 long NetCDFCollection::GetDimLengthAtTime(string name, long ts)
@@ -664,7 +701,7 @@ int NetCDFCollection::_InitializeTimesMapCase1(const vector<string> &files, map<
     for (int i = 0; i < files.size(); i++) {
         NetCDFSimple *netcdf = new NetCDFSimple();
 
-        int rc = netcdf->Initialize(files[i]);
+        int rc = netcdf->Initialize(files[i], _metaIndex);
         if (rc < 0) {
             SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
             return (-1);
@@ -715,7 +752,7 @@ int NetCDFCollection::_InitializeTimesMapCase2(const vector<string> &files, cons
     for (int i = 0; i < files.size(); i++) {
         NetCDFSimple *netcdf = new NetCDFSimple();
 
-        int rc = netcdf->Initialize(files[i]);
+        int rc = netcdf->Initialize(files[i], _metaIndex);
         if (rc < 0) {
             SetErrMsg("NetCDFSimple::Initialize(%s)", files[i].c_str());
             return (-1);
@@ -786,7 +823,7 @@ int NetCDFCollection::_InitializeTimesMapCase3(const vector<string> &files, cons
     for (int i = 0; i < files.size(); i++) {
         NetCDFSimple *netcdf = new NetCDFSimple();
 
-        int rc = netcdf->Initialize(files[i]);
+        int rc = netcdf->Initialize(files[i], _metaIndex);
         if (rc < 0) return (-1);
 
         const vector<NetCDFSimple::Variable> &variables = netcdf->GetVariables();
@@ -804,19 +841,28 @@ int NetCDFCollection::_InitializeTimesMapCase3(const vector<string> &files, cons
 
             tcvcount[time_coordvars[j]] += 1;
 
-            // Read TCV
-            double *buf = _Get1DVar(netcdf, variables[index]);
-            if (!buf) {
+            if (variables[index].GetDimNames().size() != 1) {
                 SetErrMsg("Failed to read time coordinate variable \"%s\"", time_coordvars[j].c_str());
                 return (-1);
             }
-
             string timedim = variables[index].GetDimNames()[0];
             size_t timedimlen = netcdf->DimLen(timedim);
 
+            // Read TCV, unless its values are in the metadata index
+            //
             vector<double> times;
-            for (int t = 0; t < timedimlen; t++) { times.push_back(buf[t]); }
-            delete[] buf;
+            if (!_metaIndex || !_metaIndex->GetCoordVar(files[i], time_coordvars[j], times)) {
+                double *buf = _Get1DVar(netcdf, variables[index]);
+                if (!buf) {
+                    SetErrMsg("Failed to read time coordinate variable \"%s\"", time_coordvars[j].c_str());
+                    return (-1);
+                }
+
+                for (int t = 0; t < timedimlen; t++) { times.push_back(buf[t]); }
+                delete[] buf;
+
+                if (_metaIndex) _metaIndex->SetCoordVar(files[i], time_coordvars[j], times);
+            }
 
             //
             // The hash key for timesMap is the file plus the
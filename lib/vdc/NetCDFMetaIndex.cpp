@@ -0,0 +1,398 @@
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <vapor/FileUtils.h>
+#include <vapor/NetCDFMetaIndex.h>
+
+using namespace VAPoR;
+using namespace Wasp;
+using namespace std;
+
+namespace {
+
+// Bump whenever the layout of the index file changes. Index files with a
+// different version are ignored and rebuilt
+//
+const char      magic[] = "VAPORNCIDX";
+const long long version = 1;
+
+// Binary (de)serialization of the index. Values are written in native
+// byte order: the index is a cache for the machine that wrote it
+//
+class writer {
+public:
+    writer(ostream &o) : _o(o) {}
+
+    void put(long long v) { _o.write((const char *)&v, sizeof(v)); }
+    void put(const string &s)
+    {
+        put((long long)s.size());
+        _o.write(s.data(), s.size());
+    }
+    void put(const vector<string> &v)
+    {
+        put((long long)v.size());
+        for (auto &s : v) put(s);
+    }
+    void put(const vector<double> &v)
+    {
+        put((long long)v.size());
+        _o.write((const char *)v.data(), v.size() * sizeof(double));
+    }
+    void put(const vector<long> &v)
+    {
+        put((long long)v.size());
+        for (auto l : v) put((long long)l);
+    }
+    template<typename T> void put(const vector<pair<string, T>> &atts)
+    {
+        put((long long)atts.size());
+        for (auto &att : atts) {
+            put(att.first);
+            put(att.second);
+        }
+    }
+
+private:
+    ostream &_o;
+};
+
+class reader {
+public:
+    reader(istream &i) : _i(i) {}
+
+    bool good() const { return (_i.good()); }
+
+    // Guards against allocating garbage sized buffers from a corrupt index
+    //
+    bool get(long long &v)
+    {
+        _i.read((char *)&v, sizeof(v));
+        return (_i.good());
+    }
+    bool getsize(size_t &n)
+    {
+        long long v;
+        if (!get(v) || v < 0 || v > (1LL << 40)) return (false);
+        n = v;
+        return (true);
+    }
+    bool get(string &s)
+    {
+        size_t n;
+        if (!getsize(n)) return (false);
+        s.resize(n);
+        _i.read(&s[0], n);
+        return (_i.good());
+    }
+    bool get(vector<string> &v)
+    {
+        size_t n;
+        if (!getsize(n)) return (false);
+        v.resize(n);
+        for (auto &s : v) {
+            if (!get(s)) return (false);
+        }
+        return (true);
+    }
+    bool get(vector<double> &v)
+    {
+        size_t n;
+        if (!getsize(n)) return (false);
+        v.resize(n);
+        _i.read((char *)v.data(), n * sizeof(double));
+        return (_i.good());
+    }
+    bool get(vector<long> &v)
+    {
+        size_t n;
+        if (!getsize(n)) return (false);
+        v.resize(n);
+        for (auto &l : v) {
+            long long ll;
+            if (!get(ll)) return (false);
+            l = ll;
+        }
+        return (true);
+    }
+    template<typename T> bool get(vector<pair<string, T>> &atts)
+    {
+        size_t n;
+        if (!getsize(n)) return (false);
+        atts.resize(n);
+        for (auto &att : atts) {
+            if (!get(att.first) || !get(att.second)) return (false);
+        }
+        return (true);
+    }
+
+private:
+    istream &_i;
+};
+
+void put_variable(writer &w, const NetCDFSimple::Variable &var)
+{
+    vector<pair<string, vector<double>>> flt_atts;
+    vector<pair<string, vector<long>>>   int_atts;
+    vector<pair<string, string>>         str_atts;
+
+    vector<string> attnames = var.GetAttNames();
+    for (auto &name : attnames) {
+        int type = var.GetAttType(name);
+        if (NetCDFSimple::IsNCTypeFloat(type)) {
+            flt_atts.push_back(make_pair(name, vector<double>()));
+            var.GetAtt(name, flt_atts.back().second);
+        } else if (NetCDFSimple::IsNCTypeInt(type)) {
+            int_atts.push_back(make_pair(name, vector<long>()));
+            var.GetAtt(name, int_atts.back().second);
+        } else if (NetCDFSimple::IsNCTypeText(type)) {
+            str_atts.push_back(make_pair(name, string()));
+            var.GetAtt(name, str_atts.back().second);
+        }
+    }
+
+    w.put(var.GetName());
+    w.put(var.GetDimNames());
+    w.put((long long)var.GetXType());
+    w.put(flt_atts);
+    w.put(int_atts);
+    w.put(str_atts);
+}
+
+bool get_variable(reader &r, NetCDFSimple::Variable &var)
+{
+    string                               name;
+    vector<string>                       dimnames;
+    long long                            xtype;
+    vector<pair<string, vector<double>>> flt_atts;
+    vector<pair<string, vector<long>>>   int_atts;
+    vector<pair<string, string>>         str_atts;
+
+    if (!r.get(name) || !r.get(dimnames) || !r.get(xtype)) return (false);
+    if (!r.get(flt_atts) || !r.get(int_atts) || !r.get(str_atts)) return (false);
+
+    var = NetCDFSimple::Variable(name, dimnames, (int)xtype);
+    for (auto &att : flt_atts) var.SetAtt(att.first, att.second);
+    for (auto &att : int_atts) var.SetAtt(att.first, att.second);
+    for (auto &att : str_atts) var.SetAtt(att.first, att.second);
+    return (true);
+}
+
+void put_info(writer &w, const NetCDFMetaIndex::FileInfo &info)
+{
+    w.put(info.mtime);
+    w.put(info.size);
+    w.put(info.dimnames);
+    w.put((long long)info.dims.size());
+    for (auto d : info.dims) w.put((long long)d);
+    w.put(info.unlimited_dimnames);
+    w.put(info.flt_atts);
+    w.put(info.int_atts);
+    w.put(info.str_atts);
+
+    w.put((long long)info.variables.size());
+    for (auto &var : info.variables) put_variable(w, var);
+
+    w.put((long long)info.coordvars.size());
+    for (auto &itr : info.coordvars) {
+        w.put(itr.first);
+        w.put(itr.second);
+    }
+}
+
+bool get_info(reader &r, NetCDFMetaIndex::FileInfo &info)
+{
+    if (!r.get(info.mtime) || !r.get(info.size) || !r.get(info.dimnames)) return (false);
+
+    size_t n;
+    if (!r.getsize(n)) return (false);
+    info.dims.resize(n);
+    for (auto &d : info.dims) {
+        long long v;
+        if (!r.get(v)) return (false);
+        d = v;
+    }
+
+    if (!r.get(info.unlimited_dimnames)) return (false);
+    if (!r.get(info.flt_atts) || !r.get(info.int_atts) || !r.get(info.str_atts)) return (false);
+
+    if (!r.getsize(n)) return (false);
+    info.variables.resize(n);
+    for (auto &var : info.variables) {
+        if (!get_variable(r, var)) return (false);
+    }
+
+    if (!r.getsize(n)) return (false);
+    for (size_t i = 0; i < n; i++) {
+        string name;
+        if (!r.get(name) || !r.get(info.coordvars[name])) return (false);
+    }
+    return (true);
+}
+
+};    // namespace
+
+NetCDFMetaIndex::NetCDFMetaIndex()
+{
+    _path.clear();
+    _entries.clear();
+    _dirty = false;
+    _hits = 0;
+    _misses = 0;
+}
+
+NetCDFMetaIndex::~NetCDFMetaIndex() {}
+
+string NetCDFMetaIndex::DefaultPath(const vector<string> &files)
+{
+    if (const char *s = getenv("VAPOR_NETCDF_INDEX")) return (string(s));
+
+    if (files.empty()) return ("");
+    return (FileUtils::JoinPaths({FileUtils::Dirname(files[0]), ".vapor_netcdf_index"}));
+}
+
+int NetCDFMetaIndex::Load(const string &path)
+{
+    _path = path;
+    _entries.clear();
+    _dirty = false;
+
+    ifstream in(path.c_str(), ios::in | ios::binary);
+    if (!in) return (0);    // No index yet
+
+    char      magicbuf[sizeof(magic)];
+    long long fileversion = 0;
+    in.read(magicbuf, sizeof(magicbuf));
+    reader r(in);
+    if (!in || string(magicbuf, sizeof(magicbuf) - 1) != magic || !r.get(fileversion) || fileversion != version) { return (0); }
+
+    size_t n;
+    if (!r.getsize(n)) return (0);
+
+    for (size_t i = 0; i < n; i++) {
+        string file;
+        Entry  entry;
+        if (!r.get(file) || !get_info(r, entry.info)) {
+            // A truncated or corrupt index. Keep what was read, and
+            // rewrite the index on the next Save()
+            //
+            _dirty = true;
+            break;
+        }
+        _entries[file] = entry;
+    }
+    return (0);
+}
+
+int NetCDFMetaIndex::Save()
+{
+    if (!_dirty || _path.empty()) return (0);
+
+    string   tmppath = _path + ".tmp";
+    ofstream out(tmppath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!out) {
+        SetErrMsg("Failed to open file \"%s\" for writing", tmppath.c_str());
+        return (-1);
+    }
+
+    writer w(out);
+    out.write(magic, sizeof(magic));
+    w.put(version);
+    w.put((long long)_entries.size());
+    for (auto &itr : _entries) {
+        w.put(itr.first);
+        put_info(w, itr.second.info);
+    }
+    out.close();
+    if (!out) {
+        SetErrMsg("Failed to write file \"%s\"", tmppath.c_str());
+        (void)remove(tmppath.c_str());
+        return (-1);
+    }
+
+    // rename() fails on Windows if the target exists
+    //
+#ifdef WIN32
+    (void)remove(_path.c_str());
+#endif
+    if (rename(tmppath.c_str(), _path.c_str()) != 0) {
+        SetErrMsg("Failed to rename file \"%s\" to \"%s\"", tmppath.c_str(), _path.c_str());
+        (void)remove(tmppath.c_str());
+        return (-1);
+    }
+
+    _dirty = false;
+    return (0);
+}
+
+const NetCDFMetaIndex::FileInfo *NetCDFMetaIndex::Find(const string &file)
+{
+    auto itr = _entries.find(file);
+    if (itr == _entries.end()) {
+        _misses++;
+        return (NULL);
+    }
+
+    // Only stat each file once per Load(). The collection looks up every
+    // file more than once while it is initialized
+    //
+    Entry &entry = itr->second;
+    if (!entry.checked) {
+        long long mtime, size;
+        if (!_fingerprint(file, mtime, size) || mtime != entry.info.mtime || size != entry.info.size) {
+            _entries.erase(itr);
+            _dirty = true;
+            _misses++;
+            return (NULL);
+        }
+        entry.checked = true;
+        _hits++;
+    }
+    return (&entry.info);
+}
+
+void NetCDFMetaIndex::Insert(const string &file, const FileInfo &info)
+{
+    Entry entry;
+    entry.info = info;
+    if (!_fingerprint(file, entry.info.mtime, entry.info.size)) return;
+    entry.checked = true;
+
+    _entries[file] = entry;
+    _dirty = true;
+}
+
+bool NetCDFMetaIndex::GetCoordVar(const string &file, const string &varname, vector<double> &values)
+{
+    values.clear();
+
+    const FileInfo *info = Find(file);
+    if (!info) return (false);
+
+    auto itr = info->coordvars.find(varname);
+    if (itr == info->coordvars.end()) return (false);
+
+    values = itr->second;
+    return (true);
+}
+
+void NetCDFMetaIndex::SetCoordVar(const string &file, const string &varname, const vector<double> &values)
+{
+    auto itr = _entries.find(file);
+    if (itr == _entries.end()) return;
+
+    itr->second.info.coordvars[varname] = values;
+    _dirty = true;
+}
+
+bool NetCDFMetaIndex::_fingerprint(const string &file, long long &mtime, long long &size)
+{
+    struct STAT64_T statbuf;
+    if (STAT64(file.c_str(), &statbuf) < 0) return (false);
+
+    mtime = statbuf.st_mtime;
+    size = statbuf.st_size;
+    return (true);
+}
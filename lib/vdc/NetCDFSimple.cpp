@@ -2,6 +2,7 @@
 #include "vapor/VAssert.h"
 #include <netcdf.h>
 #include <vapor/NetCDFSimple.h>
+#include <vapor/NetCDFMetaIndex.h>
 
 using namespace VAPoR;
 using namespace Wasp;
@@ -138,6 +139,39 @@ int NetCDFSimple::Initialize(string path)
     return (0);
 }
 
+int NetCDFSimple::Initialize(string path, NetCDFMetaIndex *index)
+{
+    if (!index) return (NetCDFSimple::Initialize(path));
+
+    const NetCDFMetaIndex::FileInfo *info = index->Find(path);
+    if (info) {
+        _dimnames = info->dimnames;
+        _dims = info->dims;
+        _unlimited_dimnames = info->unlimited_dimnames;
+        _flt_atts = info->flt_atts;
+        _int_atts = info->int_atts;
+        _str_atts = info->str_atts;
+        _variables = info->variables;
+        _path = path;
+        return (0);
+    }
+
+    int rc = NetCDFSimple::Initialize(path);
+    if (rc < 0) return (rc);
+
+    NetCDFMetaIndex::FileInfo newinfo;
+    newinfo.dimnames = _dimnames;
+    newinfo.dims = _dims;
+    newinfo.unlimited_dimnames = _unlimited_dimnames;
+    newinfo.flt_atts = _flt_atts;
+    newinfo.int_atts = _int_atts;
+    newinfo.str_atts = _str_atts;
+    newinfo.variables = _variables;
+    index->Insert(path, newinfo);
+
+    return (0);
+}
+
 int NetCDFSimple::OpenRead(const NetCDFSimple::Variable &variable)
 {
     //
@@ -1,13 +1,74 @@
 #define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H 1
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
 #include <proj_api.h>
 #include <vapor/ResourcePath.h>
+#include <vapor/OpenMPSupport.h>
 #include <vapor/Proj4API.h>
 
 using namespace VAPoR;
 using namespace Wasp;
 
+namespace {
+
+// Arrays with fewer points than this per thread are transformed serially:
+// each thread has to initialize its own projections, which isn't free
+//
+const size_t minPointsPerThread = 65536;
+
+// Returns the pj_transform() error code
+//
+int transform(projPJ pjSrc, projPJ pjDst, double *x, double *y, double *z, size_t n, int offset)
+{
+    //
+    // Convert from degrees to radians if source is in
+    // geographic coordinates
+    //
+    if (pj_is_latlong(pjSrc)) {
+        if (x) {
+            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+        if (y) {
+            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+        if (z) {
+            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= DEG_TO_RAD; }
+        }
+    }
+
+    int rc = pj_transform(pjSrc, pjDst, n, offset, x, y, NULL);
+    if (rc != 0) return (rc);
+
+    //
+    // Convert from radians degrees if destination is in
+    // geographic coordinates
+    //
+    if (pj_is_latlong(pjDst)) {
+        if (x) {
+            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+        if (y) {
+            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+        if (z) {
+            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= RAD_TO_DEG; }
+        }
+    }
+    return (0);
+}
+
+string getDef(projPJ pj)
+{
+    char * def = pj_get_def(pj, 0);
+    string s = def ? def : "";
+    if (def) pj_dalloc(def);
+    return (s);
+}
+
+};    // namespace
+
 Proj4API::Proj4API()
 {
     _pjSrc = NULL;
@@ -134,41 +195,52 @@ int Proj4API::_Transform(void *pjSrc, void *pjDst, double *x, double *y, double
     //
     if (pjSrc == NULL || pjDst == NULL) return (0);
 
-    //
-    // Convert from degrees to radians if source is in
-    // geographic coordinates
-    //
-    if (pj_is_latlong(pjSrc)) {
-        if (x) {
-            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= DEG_TO_RAD; }
-        }
-        if (y) {
-            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= DEG_TO_RAD; }
-        }
-        if (z) {
-            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= DEG_TO_RAD; }
+    int nThreads = std::min((size_t)omp_get_max_threads(), n / minPointsPerThread);
+    if (nThreads < 2) {
+        int rc = transform(pjSrc, pjDst, x, y, z, n, offset);
+        if (rc != 0) {
+            SetErrMsg("pj_transform() : %s", pj_strerrno(rc));
+            return (-1);
         }
+        return (0);
     }
 
-    int rc = pj_transform(pjSrc, pjDst, n, offset, x, y, NULL);
-    if (rc != 0) {
-        SetErrMsg("pj_transform() : %s", ProjErr().c_str());
-        return (-1);
-    }
-
+    // Projections may not be shared between threads. Each thread
+    // transforms a contiguous chunk of the points with its own copies,
+    // initialized in its own context
     //
-    // Convert from radians degrees if destination is in
-    // geographic coordinates
-    //
-    if (pj_is_latlong(pjDst)) {
-        if (x) {
-            for (size_t i = 0; i < n; i++) { x[i * (size_t)offset] *= RAD_TO_DEG; }
+    string      srcdef = getDef(pjSrc);
+    string      dstdef = getDef(pjDst);
+    vector<int> rcs(nThreads, 0);
+
+    #pragma omp parallel num_threads(nThreads)
+    {
+        int    t = omp_get_thread_num();
+        int    nt = omp_get_num_threads();
+        size_t first = n * t / nt;
+        size_t last = n * (t + 1) / nt;
+
+        projCtx ctx = pj_ctx_alloc();
+        projPJ  src = pj_init_plus_ctx(ctx, srcdef.c_str());
+        projPJ  dst = pj_init_plus_ctx(ctx, dstdef.c_str());
+
+        if (!src || !dst) {
+            rcs[t] = pj_ctx_get_errno(ctx);
+            if (rcs[t] == 0) rcs[t] = -1;
+        } else {
+            size_t o = first * (size_t)offset;
+            rcs[t] = transform(src, dst, x ? x + o : NULL, y ? y + o : NULL, z ? z + o : NULL, last - first, offset);
         }
-        if (y) {
-            for (size_t i = 0; i < n; i++) { y[i * (size_t)offset] *= RAD_TO_DEG; }
-        }
-        if (z) {
-            for (size_t i = 0; i < n; i++) { z[i * (size_t)offset] *= RAD_TO_DEG; }
+
+        if (src) pj_free(src);
+        if (dst) pj_free(dst);
+        pj_ctx_free(ctx);
+    }
+
+    for (int rc : rcs) {
+        if (rc != 0) {
+            SetErrMsg("pj_transform() : %s", pj_strerrno(rc));
+            return (-1);
         }
     }
     return (0);
@@ -0,0 +1,378 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <sys/stat.h>
+#include "vapor/VAssert.h"
+#include <vapor/FileUtils.h>
+#include <vapor/OpenMPSupport.h>
+#include <vapor/PyramidCache.h>
+
+using namespace VAPoR;
+using namespace Wasp;
+using namespace std;
+
+namespace {
+
+// Bump whenever the layout of a level file changes. Files with a
+// different version are ignored and rebuilt
+//
+const char      magic[] = "VAPORPYR";
+const long long version = 1;
+
+const size_t tileSize = 128;    // XY tile edge length, in voxels
+const size_t minDim = 64;
+const int    maxLevels = 8;
+
+// magic, version, fingerprint, dims[3], tile size
+//
+const size_t headerSize = sizeof(magic) + 6 * sizeof(long long);
+
+unsigned long long fnv1a(const void *data, size_t n, unsigned long long h = 14695981039346656037ULL)
+{
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return (h);
+}
+
+// Sample positions of nOut points spread evenly over nIn. Same sampling as
+// DataMgr's downsample()
+//
+void compute_weights(size_t nIn, size_t nOut, vector<float> &wgts)
+{
+    VAssert(nOut <= nIn);
+    wgts.resize(nOut, 0.0);
+
+    float deltax = (float)nIn / (float)nOut;
+    float shift = ((nIn - 1) - (deltax * (nOut - 1))) / 2.0;
+    for (int i = 0; i < nOut; i++) { wgts[i] = (i * deltax) + shift; }
+}
+
+// Linearly interpolate sample position 'wgt' of 'nIn' values spaced
+// 'stride' apart
+//
+inline float sample(const float *in, size_t nIn, size_t stride, float wgt)
+{
+    size_t i0 = wgt;
+    size_t i1 = std::min(i0 + 1, nIn - 1);
+    float  w = wgt - i0;
+    return ((in[i0 * stride] * (1.0 - w)) + (in[i1 * stride] * w));
+}
+
+// One level of a pyramid under construction. Input planes are downsampled
+// in XY as they arrive. Output planes are interpolated in Z from the two
+// most recent XY downsampled planes, and written as soon as both are
+// available
+//
+class level_builder {
+public:
+    level_builder(const DimsType &inDims, const DimsType &outDims) : _inDims(inDims), _outDims(outDims), _next(0)
+    {
+        compute_weights(inDims[0], outDims[0], _wx);
+        compute_weights(inDims[1], outDims[1], _wy);
+        compute_weights(inDims[2], outDims[2], _wz);
+
+        _tmp.resize(outDims[0] * inDims[1]);
+        _planes[0].resize(outDims[0] * outDims[1]);
+        _planes[1].resize(outDims[0] * outDims[1]);
+        _out.resize(outDims[0] * outDims[1]);
+        _tile.resize(tileSize * outDims[0]);
+    }
+
+    bool open(const string &path, unsigned long long fingerprint)
+    {
+        _file.open(path.c_str(), ios::out | ios::binary | ios::trunc);
+        if (!_file) return (false);
+
+        long long header[] = {version, (long long)fingerprint, (long long)_outDims[0], (long long)_outDims[1], (long long)_outDims[2], (long long)tileSize};
+        _file.write(magic, sizeof(magic));
+        _file.write((const char *)header, sizeof(header));
+        return (_file.good());
+    }
+
+    // Add native plane 'z'
+    //
+    bool add(size_t z, const float *plane)
+    {
+        size_t nx = _inDims[0];
+        size_t ny = _inDims[1];
+        size_t ox = _outDims[0];
+        size_t oy = _outDims[1];
+
+        // Along X, then along Y
+        //
+        float *tmp = _tmp.data();
+#pragma omp parallel for
+        for (long y = 0; y < ny; y++) {
+            for (size_t x = 0; x < ox; x++) tmp[y * ox + x] = sample(plane + y * nx, nx, 1, _wx[x]);
+        }
+
+        float *dst = _planes[z % 2].data();
+#pragma omp parallel for
+        for (long y = 0; y < oy; y++) {
+            for (size_t x = 0; x < ox; x++) dst[y * ox + x] = sample(tmp + x, ny, ox, _wy[y]);
+        }
+
+        // Along Z. The planes needed by an output plane are z - 1 and z
+        // when it is first possible to compute it
+        //
+        while (_next < _outDims[2]) {
+            size_t i0 = _wz[_next];
+            size_t i1 = std::min(i0 + 1, _inDims[2] - 1);
+            float  w = _wz[_next] - i0;
+            if (i1 > z) break;
+
+            const float *p0 = _planes[i0 % 2].data();
+            const float *p1 = _planes[i1 % 2].data();
+            float *      out = _out.data();
+#pragma omp parallel for
+            for (long i = 0; i < ox * oy; i++) out[i] = (p0[i] * (1.0 - w)) + (p1[i] * w);
+
+            if (!write_plane(out)) return (false);
+            _next++;
+        }
+        return (true);
+    }
+
+    bool close()
+    {
+        _file.close();
+        return (_next == _outDims[2] && _file.good());
+    }
+
+private:
+    DimsType      _inDims;
+    DimsType      _outDims;
+    vector<float> _wx, _wy, _wz;
+    vector<float> _tmp;          // plane downsampled along X only
+    vector<float> _planes[2];    // XY downsampled planes, indexed by native z modulo 2
+    vector<float> _out;
+    vector<float> _tile;         // one row of tiles
+    size_t        _next;         // next output plane
+    ofstream      _file;
+
+    // Planes are stored as rows of tiles, each tile X fastest. The last
+    // row and column of tiles are clipped to the plane
+    //
+    bool write_plane(const float *plane)
+    {
+        size_t ox = _outDims[0];
+        size_t oy = _outDims[1];
+
+        for (size_t ty = 0; ty < oy; ty += tileSize) {
+            size_t th = std::min(tileSize, oy - ty);
+
+            float *tile = _tile.data();
+            for (size_t tx = 0; tx < ox; tx += tileSize) {
+                size_t tw = std::min(tileSize, ox - tx);
+                for (size_t y = 0; y < th; y++) {
+                    const float *src = plane + (ty + y) * ox + tx;
+                    std::copy(src, src + tw, tile + y * tw);
+                }
+                tile += tw * th;
+            }
+            _file.write((const char *)_tile.data(), th * ox * sizeof(float));
+        }
+        return (_file.good());
+    }
+};
+
+};    // namespace
+
+PyramidCache::PyramidCache()
+{
+    _dir.clear();
+    _prefix.clear();
+    _fingerprint = 0;
+}
+
+PyramidCache::~PyramidCache() {}
+
+string PyramidCache::DefaultDir(const vector<string> &files)
+{
+    if (const char *s = getenv("VAPOR_PYRAMID_CACHE")) return (string(s));
+
+    if (files.empty()) return ("");
+    return (FileUtils::JoinPaths({FileUtils::Dirname(files[0]), ".vapor_pyramid"}));
+}
+
+void PyramidCache::Initialize(const string &dir, const vector<string> &files)
+{
+    _dir = dir;
+
+    // Data sets sharing a cache directory are told apart by their file
+    // paths. Changes to their contents are detected by the fingerprint
+    //
+    unsigned long long id = fnv1a(NULL, 0);
+    _fingerprint = fnv1a(NULL, 0);
+    for (auto &file : files) {
+        id = fnv1a(file.c_str(), file.size() + 1, id);
+
+        long long       stamp[] = {0, 0};
+        struct STAT64_T statbuf;
+        if (STAT64(file.c_str(), &statbuf) == 0) {
+            stamp[0] = statbuf.st_mtime;
+            stamp[1] = statbuf.st_size;
+        }
+        _fingerprint = fnv1a(file.c_str(), file.size() + 1, _fingerprint);
+        _fingerprint = fnv1a(stamp, sizeof(stamp), _fingerprint);
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%016llx", id);
+    _prefix = buf;
+}
+
+int PyramidCache::NumLevels(const DimsType &dims)
+{
+    int n = 0;
+    while (n < maxLevels) {
+        DimsType d = DimsAtLevel(dims, n + 1);
+        if (*std::max_element(d.begin(), d.end()) < minDim) break;
+        n++;
+    }
+    return (n);
+}
+
+DimsType PyramidCache::DimsAtLevel(const DimsType &dims, int level)
+{
+    DimsType d;
+    for (int i = 0; i < dims.size(); i++) { d[i] = std::max((size_t)1, (dims[i] + ((size_t)1 << level) - 1) >> level); }
+    return (d);
+}
+
+bool PyramidCache::ReadRegion(const string &varname, size_t ts, int lod, const DimsType &dims, const DimsType &min, const DimsType &max, float *region) const
+{
+    if (_dir.empty()) return (false);
+
+    ifstream in(_path(varname, ts, lod, dims).c_str(), ios::in | ios::binary);
+    if (!in) return (false);
+
+    char      magicbuf[sizeof(magic)];
+    long long header[6];
+    in.read(magicbuf, sizeof(magicbuf));
+    in.read((char *)header, sizeof(header));
+    if (!in || string(magicbuf, sizeof(magicbuf) - 1) != magic || header[0] != version) return (false);
+    if ((unsigned long long)header[1] != _fingerprint) return (false);
+    if (header[2] != dims[0] || header[3] != dims[1] || header[4] != dims[2] || header[5] <= 0) return (false);
+
+    size_t tile = header[5];
+    size_t nx = dims[0];
+    size_t ny = dims[1];
+    size_t rx = max[0] - min[0] + 1;
+    size_t ry = max[1] - min[1] + 1;
+
+    // Read the tiles of each row of tiles overlapping the region, which
+    // are contiguous, with a single read
+    //
+    size_t        tx0 = min[0] / tile;
+    size_t        tx1 = max[0] / tile;
+    vector<float> buf(tile * ((tx1 - tx0 + 1) * tile));
+    for (size_t z = min[2]; z <= max[2]; z++) {
+        for (size_t ty = min[1] / tile; ty <= max[1] / tile; ty++) {
+            size_t th = std::min(tile, ny - ty * tile);
+            size_t first = tx0 * tile;
+            size_t last = std::min(nx, (tx1 + 1) * tile);
+
+            size_t offset = z * nx * ny + ty * tile * nx + first * th;
+            in.seekg(headerSize + offset * sizeof(float));
+            in.read((char *)buf.data(), (last - first) * th * sizeof(float));
+            if (!in) return (false);
+
+            size_t y0 = std::max(min[1], ty * tile);
+            size_t y1 = std::min(max[1], ty * tile + th - 1);
+            for (size_t tx = tx0; tx <= tx1; tx++) {
+                size_t       tw = std::min(tile, nx - tx * tile);
+                const float *t = buf.data() + (tx - tx0) * tile * th;
+
+                size_t x0 = std::max(min[0], tx * tile);
+                size_t x1 = std::min(max[0], tx * tile + tw - 1);
+                for (size_t y = y0; y <= y1; y++) {
+                    const float *src = t + (y - ty * tile) * tw + (x0 - tx * tile);
+                    float *      dst = region + ((z - min[2]) * ry + (y - min[1])) * rx + (x0 - min[0]);
+                    std::copy(src, src + (x1 - x0 + 1), dst);
+                }
+            }
+        }
+    }
+    return (true);
+}
+
+int PyramidCache::Build(const string &varname, size_t ts, int lod, const DimsType &dims, const std::function<int(size_t z, float *plane)> &readPlane) const
+{
+    if (_dir.empty()) return (-1);
+    if (!FileUtils::IsDirectory(_dir) && FileUtils::MakeDir(_dir) != 0) return (-1);
+
+    int nlevels = NumLevels(dims);
+
+    vector<unique_ptr<level_builder>> builders;
+    vector<string>                    paths;
+    for (int l = 1; l <= nlevels; l++) {
+        DimsType d = DimsAtLevel(dims, l);
+        paths.push_back(_path(varname, ts, lod, d));
+        builders.push_back(unique_ptr<level_builder>(new level_builder(dims, d)));
+    }
+
+    auto cleanup = [&paths]() {
+        for (auto &path : paths) (void)remove((path + ".tmp").c_str());
+    };
+
+    for (int l = 0; l < nlevels; l++) {
+        if (!builders[l]->open(paths[l] + ".tmp", _fingerprint)) {
+            cleanup();
+            return (-1);
+        }
+    }
+
+    vector<float> plane(dims[0] * dims[1]);
+    for (size_t z = 0; z < dims[2]; z++) {
+        int rc = readPlane(z, plane.data());
+        if (rc < 0) {
+            cleanup();
+            return (-1);
+        }
+
+        for (auto &b : builders) {
+            if (!b->add(z, plane.data())) {
+                cleanup();
+                return (-1);
+            }
+        }
+    }
+
+    for (int l = 0; l < nlevels; l++) {
+        if (!builders[l]->close()) {
+            cleanup();
+            return (-1);
+        }
+
+        // rename() fails on Windows if the target exists
+        //
+#ifdef WIN32
+        (void)remove(paths[l].c_str());
+#endif
+        if (rename((paths[l] + ".tmp").c_str(), paths[l].c_str()) != 0) {
+            cleanup();
+            return (-1);
+        }
+    }
+    return (0);
+}
+
+string PyramidCache::_path(const string &varname, size_t ts, int lod, const DimsType &dims) const
+{
+    string name = varname;
+    for (auto &c : name) {
+        if (!isalnum((unsigned char)c) && c != '_' && c != '-') c = '_';
+    }
+
+    ostringstream oss;
+    oss << _prefix << "." << name << "." << ts << "." << lod << "." << dims[0] << "x" << dims[1] << "x" << dims[2] << ".vpyr";
+    return (FileUtils::JoinPaths({_dir, oss.str()}));
+}
@@ -1,7 +1,16 @@
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
 #include <vapor/VAssert.h>
 #include <vapor/utils.h>
 #include <cstdint>
+#include <sys/stat.h>
+#include <fcntl.h>
+#ifndef WIN32
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 #include <vapor/QuadTreeRectangleP.h>
 #include <vapor/OpenMPSupport.h>
 
@@ -10,6 +19,106 @@ using namespace std;
 
 using UInt32_tArr2 = std::array<uint32_t, 2>;
 using pType = UInt32_tArr2;
+using flat_node_t = QuadTreeRectangle<float, pType>::flat_node_t;
+
+namespace {
+
+// Bump whenever the file layout, or the layout of flat_node_t, changes.
+// Files with a different version are ignored
+//
+const char     magic[] = "VAPORQTR";
+const uint32_t version = 1;
+
+// File header. It is followed by one bin_t for each subtree, and then by
+// the node and payload arrays of each subtree. Every array starts on an
+// 8 byte boundary so that it can be used in place when the file is
+// memory mapped
+//
+class header_t {
+public:
+    char     _magic[8];
+    uint32_t _version;
+    uint32_t _nodeSize;       // sizeof(flat_node_t)
+    uint32_t _payloadSize;    // sizeof(pType)
+    uint32_t _nbins;
+    uint64_t _fingerprint;
+    float    _left;
+    float    _right;
+};
+
+class bin_t {
+public:
+    uint64_t _nodeOffset;
+    uint64_t _nnodes;
+    uint64_t _payloadOffset;
+    uint64_t _npayloads;
+};
+
+uint64_t align8(uint64_t offset) { return ((offset + 7) & ~(uint64_t)7); }
+
+};    // namespace
+
+// The contents of a file written by QuadTreeRectangleP::Write(). Memory
+// mapped if possible, otherwise read into memory
+//
+class QuadTreeRectangleP::storage {
+public:
+    storage() : _data(NULL), _size(0), _mapped(false) {}
+    ~storage()
+    {
+#ifndef WIN32
+        if (_mapped) munmap(_data, _size);
+#endif
+    }
+
+    bool Open(const string &path)
+    {
+#ifndef WIN32
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return (false);
+
+        struct stat statbuf;
+        if (fstat(fd, &statbuf) < 0 || statbuf.st_size == 0) {
+            close(fd);
+            return (false);
+        }
+
+        void *data = mmap(NULL, statbuf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data != MAP_FAILED) {
+            _data = data;
+            _size = statbuf.st_size;
+            _mapped = true;
+            return (true);
+        }
+#endif
+
+        ifstream in(path.c_str(), ios::in | ios::binary);
+        if (!in) return (false);
+
+        in.seekg(0, ios::end);
+        size_t size = in.tellg();
+        in.seekg(0, ios::beg);
+
+        // uint64_t elements so that the arrays in the file are aligned
+        //
+        _buf.resize((size + 7) / 8);
+        if (!in.read((char *)_buf.data(), size)) return (false);
+
+        _data = _buf.data();
+        _size = size;
+        return (true);
+    }
+
+    const unsigned char *Data() const { return ((const unsigned char *)_data); }
+    size_t               Size() const { return (_size); }
+
+private:
+    void *                _data;
+    size_t                _size;
+    bool                  _mapped;
+    std::vector<uint64_t> _buf;
+};
 
 QuadTreeRectangleP::QuadTreeRectangleP(float left, float top, float right, float bottom, size_t max_depth, size_t reserve_size) : _left(left), _right(right)
 {
@@ -66,6 +175,9 @@ QuadTreeRectangleP::QuadTreeRectangleP(const QuadTreeRectangleP &rhs)
 
     _qtrs.resize(rhs._qtrs.size());
     for (int i = 0; i < _qtrs.size(); i++) { _qtrs[i] = new QuadTreeRectangle<float, pType>(*(rhs._qtrs[i])); }
+
+    _flat = rhs._flat;
+    _storage = rhs._storage;
 }
 
 QuadTreeRectangleP &QuadTreeRectangleP::operator=(const QuadTreeRectangleP &rhs)
@@ -78,6 +190,9 @@ QuadTreeRectangleP &QuadTreeRectangleP::operator=(const QuadTreeRectangleP &rhs)
 
     _qtrs.resize(rhs._qtrs.size());
     for (size_t i = 0; i < rhs._qtrs.size(); i++) { _qtrs[i] = new QuadTreeRectangle<float, pType>(*(rhs._qtrs[i])); }
+
+    _flat = rhs._flat;
+    _storage = rhs._storage;
     return *this;
 }
 
@@ -91,6 +206,8 @@ QuadTreeRectangleP::~QuadTreeRectangleP()
 
 bool QuadTreeRectangleP::Insert(float left, float top, float right, float bottom, DimsType payload)
 {
+    if (_qtrs.empty()) return (false);    // Read only
+
     // Serial insertion of a single element
     //
     bool  status = true;
@@ -114,6 +231,7 @@ bool QuadTreeRectangleP::Insert(float left, float top, float right, float bottom
 bool QuadTreeRectangleP::Insert(std::vector<class QuadTreeRectangle<float, pType>::rectangle_t> rectangles, std::vector<pType> payloads)
 {
     VAssert(rectangles.size() == payloads.size());
+    if (_qtrs.empty()) return (false);    // Read only
 
     bool status = true;
 
@@ -131,8 +249,8 @@ bool QuadTreeRectangleP::Insert(std::vector<class QuadTreeRectangle<float, pType
     // need to be inserted into each subtree
     //
     float bin_width = (_right - _left) / ((float)_qtrs.size());
-    float binLeft = _left;
     for (size_t j = 0; j < rectangles.size(); j++) {
+        float binLeft = _left;
         for (int i = 0; i < _qtrs.size(); i++) {
             float binRight = binLeft + bin_width;
 
@@ -160,6 +278,8 @@ bool QuadTreeRectangleP::Insert(std::vector<class QuadTreeRectangle<float, pType
 
 bool QuadTreeRectangleP::Insert(const Grid *grid, size_t ncells)
 {
+    if (_qtrs.empty()) return (false);    // Read only
+
     if (ncells == 0) { ncells = Wasp::VProduct(grid->GetCellDimensions().data(), grid->GetNumCellDimensions()); }
 
     // parRectangles and parPayloads will contain the rectangles and their
@@ -257,26 +377,35 @@ bool QuadTreeRectangleP::Insert(const Grid *grid, size_t ncells)
     return (status);
 }
 
-void QuadTreeRectangleP::GetPayloadContained(float x, float y, std::vector<DimsType> &payloads) const
+int QuadTreeRectangleP::_getBin(float x) const
 {
-    payloads.clear();
+    size_t nbins = _qtrs.empty() ? _flat.size() : _qtrs.size();
 
-    int   bin = 0;
-    float bin_width = ((float)_right - (float)_left) / ((float)_qtrs.size());
+    float bin_width = ((float)_right - (float)_left) / ((float)nbins);
     float binLeft = _left;
-    for (int i = 0; i < _qtrs.size(); i++) {
+    for (int i = 0; i < nbins; i++) {
         float binRight = binLeft + bin_width;
-        if (i == _qtrs.size() - 1) binRight = _right;
+        if (i == nbins - 1) binRight = _right;
 
-        if (x >= binLeft && x <= binRight) {
-            bin = i;
-            break;
-        }
+        if (x >= binLeft && x <= binRight) { return (i); }
         binLeft = binRight;
     }
+    return (0);
+}
+
+void QuadTreeRectangleP::GetPayloadContained(float x, float y, std::vector<DimsType> &payloads) const
+{
+    payloads.clear();
+
+    int bin = _getBin(x);
 
     std::vector<pType> p;
-    _qtrs[bin]->GetPayloadContained(x, y, p);
+    if (_qtrs.empty()) {
+        const flat_tree_t &t = _flat[bin];
+        QuadTreeRectangle<float, pType>::GetPayloadContained(t._nodes, t._payloads, x, y, p);
+    } else {
+        _qtrs[bin]->GetPayloadContained(x, y, p);
+    }
 
     for (auto itr = p.begin(); itr != p.end(); ++itr) { payloads.push_back(DimsType{(*itr)[0], (*itr)[1], 0}); }
 }
@@ -286,12 +415,140 @@ void QuadTreeRectangleP::GetStats(std::vector<size_t> &payload_histo, std::vecto
     payload_histo.clear();
     level_histo.clear();
 
-    for (int i = 0; i < _qtrs.size(); i++) {
+    size_t nbins = _qtrs.empty() ? _flat.size() : _qtrs.size();
+    for (int i = 0; i < nbins; i++) {
         std::vector<size_t> p;
         std::vector<size_t> l;
 
-        _qtrs[i]->GetStats(p, l);
+        if (_qtrs.empty()) {
+            QuadTreeRectangle<float, pType>::GetStats(_flat[i]._nodes, _flat[i]._nnodes, p, l);
+        } else {
+            _qtrs[i]->GetStats(p, l);
+        }
         payload_histo.insert(payload_histo.end(), p.begin(), p.end());
         level_histo.insert(level_histo.end(), l.begin(), l.end());
     }
 }
+
+bool QuadTreeRectangleP::Write(const string &path, uint64_t fingerprint) const
+{
+    // Trees that were read are already on disk
+    //
+    if (_qtrs.empty()) return (false);
+
+    size_t nbins = _qtrs.size();
+
+    vector<vector<flat_node_t>> nodes(nbins);
+    vector<vector<pType>>       payloads(nbins);
+
+#pragma omp parallel for
+    for (int i = 0; i < nbins; i++) { _qtrs[i]->Flatten(nodes[i], payloads[i]); }
+
+    header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header._magic, magic, sizeof(header._magic));
+    header._version = version;
+    header._nodeSize = sizeof(flat_node_t);
+    header._payloadSize = sizeof(pType);
+    header._nbins = nbins;
+    header._fingerprint = fingerprint;
+    header._left = _left;
+    header._right = _right;
+
+    vector<bin_t> bins(nbins);
+    uint64_t      offset = align8(sizeof(header_t) + nbins * sizeof(bin_t));
+    for (int i = 0; i < nbins; i++) {
+        bins[i]._nodeOffset = offset;
+        bins[i]._nnodes = nodes[i].size();
+        offset = align8(offset + nodes[i].size() * sizeof(flat_node_t));
+
+        bins[i]._payloadOffset = offset;
+        bins[i]._npayloads = payloads[i].size();
+        offset = align8(offset + payloads[i].size() * sizeof(pType));
+    }
+
+    string   tmppath = path + ".tmp";
+    ofstream out(tmppath.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!out) return (false);
+
+    const char zeros[8] = {0};
+    uint64_t   written = 0;
+    auto       put = [&](const void *data, uint64_t size, uint64_t at) {
+        if (at > written) out.write(zeros, at - written);
+        out.write((const char *)data, size);
+        written = at + size;
+    };
+
+    put(&header, sizeof(header), 0);
+    put(bins.data(), nbins * sizeof(bin_t), sizeof(header));
+    for (int i = 0; i < nbins; i++) {
+        put(nodes[i].data(), nodes[i].size() * sizeof(flat_node_t), bins[i]._nodeOffset);
+        put(payloads[i].data(), payloads[i].size() * sizeof(pType), bins[i]._payloadOffset);
+    }
+
+    out.close();
+    if (!out) {
+        (void)remove(tmppath.c_str());
+        return (false);
+    }
+
+    // rename() fails on Windows if the target exists
+    //
+#ifdef WIN32
+    (void)remove(path.c_str());
+#endif
+    if (rename(tmppath.c_str(), path.c_str()) != 0) {
+        (void)remove(tmppath.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+std::shared_ptr<const QuadTreeRectangleP> QuadTreeRectangleP::Read(const string &path, uint64_t fingerprint)
+{
+    std::shared_ptr<storage> s(new storage());
+    if (!s->Open(path)) return (nullptr);
+
+    const unsigned char *data = s->Data();
+    size_t               size = s->Size();
+
+    if (size < sizeof(header_t)) return (nullptr);
+
+    header_t header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header._magic, magic, sizeof(header._magic)) != 0 || header._version != version || header._nodeSize != sizeof(flat_node_t) || header._payloadSize != sizeof(pType)
+        || header._fingerprint != fingerprint || header._nbins == 0) {
+        return (nullptr);
+    }
+
+    size_t nbins = header._nbins;
+    if (size < sizeof(header_t) + nbins * sizeof(bin_t)) return (nullptr);
+
+    const bin_t *bins = (const bin_t *)(data + sizeof(header_t));
+
+    // Files are written in one piece and renamed, so only check that the
+    // arrays lie within the file
+    //
+    vector<flat_tree_t> flat(nbins);
+    for (size_t i = 0; i < nbins; i++) {
+        const bin_t &b = bins[i];
+        if (b._nnodes == 0 || b._nodeOffset % 8 || b._payloadOffset % 8) return (nullptr);
+        if (b._nodeOffset + b._nnodes * sizeof(flat_node_t) > size) return (nullptr);
+        if (b._payloadOffset + b._npayloads * sizeof(pType) > size) return (nullptr);
+
+        flat[i]._nodes = (const flat_node_t *)(data + b._nodeOffset);
+        flat[i]._nnodes = b._nnodes;
+        flat[i]._payloads = (const pType *)(data + b._payloadOffset);
+    }
+
+    std::shared_ptr<QuadTreeRectangleP> qtr(new QuadTreeRectangleP());
+    for (size_t i = 0; i < qtr->_qtrs.size(); i++) delete qtr->_qtrs[i];
+    qtr->_qtrs.clear();
+
+    qtr->_left = header._left;
+    qtr->_right = header._right;
+    qtr->_flat = flat;
+    qtr->_storage = s;
+
+    return (qtr);
+}
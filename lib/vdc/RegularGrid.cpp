@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "vapor/VAssert.h"
 #include <cmath>
 #include <time.h>
@@ -157,6 +158,68 @@ float RegularGrid::GetValueLinear(const CoordType &coords) const
     return (TrilinearInterpolate(i, j, k, xwgt, ywgt, zwgt));
 }
 
+void RegularGrid::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Points are processed in chunks. For each chunk the cell indices and
+    // interpolation weights are computed first, one axis at a time, which
+    // involves no data access and can be vectorized. Then the values are
+    // interpolated. Indices and weights are computed exactly as in
+    // GetValueLinear().
+    //
+    const size_t chunkSize = 64;
+    double       cCoords[3][chunkSize];
+    size_t       indices[3][chunkSize];
+    double       wgts[3][chunkSize];
+    int          inside[chunkSize];
+
+    const float mv = GetMissingValue();
+    const int   gDim = GetGeometryDim();
+
+    for (size_t p0 = 0; p0 < n; p0 += chunkSize) {
+        const size_t m = std::min(chunkSize, n - p0);
+
+        for (size_t p = 0; p < m; p++) {
+            CoordType c;
+            ClampCoord(coords[p0 + p], c);
+            for (int d = 0; d < 3; d++) cCoords[d][p] = c[d];
+            inside[p] = 1;
+        }
+
+        for (int d = 0; d < 3; d++) {
+            const double minu = _minu[d];
+            const double maxu = _maxu[d];
+            const double delta = _delta[d];
+            const bool   checkRange = d < gDim;
+#pragma omp simd
+            for (size_t p = 0; p < m; p++) {
+                const double x = cCoords[d][p];
+                if (checkRange && (x < minu || x > maxu)) inside[p] = 0;
+                size_t i = 0;
+                double w = 0.0;
+                if (delta != 0.0 && x >= minu) {
+                    i = (size_t)floor((x - minu) / delta);
+                    w = 1.0 - (((x - minu) - (i * delta)) / delta);
+                }
+                indices[d][p] = i;
+                wgts[d][p] = w;
+            }
+        }
+
+        for (size_t p = 0; p < m; p++) {
+            if (!inside[p]) {
+                values[p0 + p] = mv;
+                continue;
+            }
+            values[p0 + p] = TrilinearInterpolate(indices[0][p], indices[1][p], indices[2][p], wgts[0][p], wgts[1][p], wgts[2][p]);
+        }
+    }
+}
+
 void RegularGrid::GetUserExtentsHelper(CoordType &minu, CoordType &maxu) const
 {
     minu = _minu;
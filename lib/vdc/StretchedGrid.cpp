@@ -98,6 +98,33 @@ void StretchedGrid::GetUserCoordinates(const DimsType &indices, CoordType &coord
     if (GetGeometryDim() > 2) { coords[2] = _zcoords[cIndices[2]]; }
 }
 
+bool StretchedGrid::GetIndicesCellHint(const CoordType &coords, DimsType &indices, double wgts[3]) const
+{
+    CoordType cCoords;
+    ClampCoord(coords, cCoords);
+
+    double x = cCoords[0];
+    double y = cCoords[1];
+    double z = GetGeometryDim() == 3 ? cCoords[2] : 0.0;
+
+    size_t i = indices[0], j = indices[1], k = indices[2];
+    wgts[0] = 0.0;
+    wgts[1] = 0.0;
+    wgts[2] = 0.0;
+    bool inside = _insideGrid(x, y, z, i, j, k, wgts[0], wgts[1], wgts[2], true);
+
+    if (!inside) return (false);
+
+    indices[0] = i;
+    indices[1] = j;
+
+    if (GetGeometryDim() == 2) return (true);
+
+    indices[2] = k;
+
+    return (true);
+}
+
 bool StretchedGrid::GetIndicesCell(const CoordType &coords, DimsType &indices, double wgts[3]) const
 {
     // Clamp coordinates on periodic boundaries to grid extents
@@ -282,6 +309,30 @@ float StretchedGrid::GetValueLinear(const CoordType &coords) const
     return (TrilinearInterpolate(i, j, k, wgts[0], wgts[1], wgts[2]));
 }
 
+void StretchedGrid::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Same as GetValueLinear() for each point, except that the cell
+    // containing the previous point is tested before searching the grid
+    //
+    float  mv = GetMissingValue();
+    size_t i = 0, j = 0, k = 0;
+    for (size_t p = 0; p < n; p++) {
+        CoordType cCoords;
+        ClampCoord(coords[p], cCoords);
+
+        double wgts[] = {0.0, 0.0, 0.0};
+        double z = GetGeometryDim() == 3 ? cCoords[2] : 0.0;
+        bool   inside = _insideGrid(cCoords[0], cCoords[1], z, i, j, k, wgts[0], wgts[1], wgts[2], true);
+
+        values[p] = inside ? TrilinearInterpolate(i, j, k, wgts[0], wgts[1], wgts[2]) : mv;
+    }
+}
+
 void StretchedGrid::GetUserExtentsHelper(CoordType &minext, CoordType &maxext) const
 {
     auto dims = StructuredGrid::GetDimensions();
@@ -307,14 +358,16 @@ void StretchedGrid::GetUserExtentsHelper(CoordType &minext, CoordType &maxext) c
 // If the point is outside of the
 // grid the values of 'xwgt', 'ywgt', and 'zwgt' are not defined
 //
-bool StretchedGrid::_insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double &xwgt, double &ywgt, double &zwgt) const
+bool StretchedGrid::_insideGrid(double x, double y, double z, size_t &i, size_t &j, size_t &k, double &xwgt, double &ywgt, double &zwgt, bool useHint) const
 {
     xwgt = 0.0;
     ywgt = 0.0;
     zwgt = 0.0;
-    i = j = k = 0;
+    if (!useHint) i = j = k = 0;
+
+    auto search = useHint ? Wasp::BinarySearchRangeHint : Wasp::BinarySearchRange;
 
-    if (!Wasp::BinarySearchRange(_xcoords, x, i)) return (false);
+    if (!search(_xcoords, x, i)) return (false);
 
     if (_xcoords.size() > 1) {
         xwgt = 1.0 - (x - _xcoords[i]) / (_xcoords[i + 1] - _xcoords[i]);
@@ -323,7 +376,7 @@ bool StretchedGrid::_insideGrid(double x, double y, double z, size_t &i, size_t
     }
 
 
-    if (!Wasp::BinarySearchRange(_ycoords, y, j)) return (false);
+    if (!search(_ycoords, y, j)) return (false);
 
     if (_ycoords.size() > 1) {
         ywgt = 1.0 - (y - _ycoords[j]) / (_ycoords[j + 1] - _ycoords[j]);
@@ -339,7 +392,7 @@ bool StretchedGrid::_insideGrid(double x, double y, double z, size_t &i, size_t
     // Now verify that Z coordinate of point is in grid, and find
     // its interpolation weights if so.
     //
-    if (!Wasp::BinarySearchRange(_zcoords, z, k)) return (false);
+    if (!search(_zcoords, z, k)) return (false);
 
     if (_zcoords.size() > 1) {
         zwgt = 1.0 - (z - _zcoords[k]) / (_zcoords[k + 1] - _zcoords[k]);
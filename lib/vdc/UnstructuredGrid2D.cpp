@@ -140,22 +140,32 @@ void UnstructuredGrid2D::GetUserCoordinates(const DimsType &indices, CoordType &
     if (GetGeometryDim() == 3) { coords[2] = _zug.GetValueAtIndex(cIndices); }
 }
 
+bool UnstructuredGrid2D::GetIndicesCell(const CoordType &coords, DimsType &indices) const
+{
+    FaceBuffer<size_t> nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    size_t             face;
+
+    bool status = FindFace(coords, face, nodes.data(), lambda.data(), nlambda, false);
+    if (status) indices[0] = face;
+
+    return (status);
+}
+
 bool UnstructuredGrid2D::GetIndicesCell(const CoordType &coords, DimsType &cindices, std::vector<std::vector<size_t>> &nodes, std::vector<double> &lambdav) const
 {
     nodes.clear();
     lambdav.clear();
 
-    CoordType cCoords;
-    ClampCoord(coords, cCoords);
-
-    std::vector<double> lambda(_maxVertexPerFace);
-    int     nlambda;
+    FaceBuffer<size_t> my_nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
 
     // See if point is inside any cells (faces)
     //
-    size_t              my_index;
-    std::vector<size_t> my_nodes;
-    bool                status = _insideGridNodeCentered(cCoords, my_index, my_nodes, lambda.data(), nlambda);
+    size_t my_index;
+    bool   status = FindFace(coords, my_index, my_nodes.data(), lambda.data(), nlambda, false);
 
     if (status) {
         cindices[0] = my_index;
@@ -168,21 +178,24 @@ bool UnstructuredGrid2D::GetIndicesCell(const CoordType &coords, DimsType &cindi
     return (status);
 }
 
-bool UnstructuredGrid2D::InsideGrid(const CoordType &coords) const
+bool UnstructuredGrid2D::FindFace(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const
 {
     CoordType cCoords;
     ClampCoord(coords, cCoords);
 
-    std::vector<double> lambda(_maxVertexPerFace);
-    int            nlambda;
-    size_t         face;
-    vector<size_t> nodes;
+    return (_insideGridNodeCentered(cCoords, face, nodes, lambda, nlambda, useHint));
+}
+
+bool UnstructuredGrid2D::InsideGrid(const CoordType &coords) const
+{
+    FaceBuffer<size_t> nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    size_t             face;
 
     // See if point is inside any cells (faces)
     //
-    bool status = _insideGridNodeCentered(cCoords, face, nodes, lambda.data(), nlambda);
-
-    return (status);
+    return (FindFace(coords, face, nodes.data(), lambda.data(), nlambda, false));
 }
 
 float UnstructuredGrid2D::GetValueNearestNeighbor(const CoordType &coords) const
@@ -193,19 +206,18 @@ float UnstructuredGrid2D::GetValueNearestNeighbor(const CoordType &coords) const
     CoordType cCoords;
     ClampCoord(coords, cCoords);
 
-    std::vector<double> lambda(_maxVertexPerFace);
-    int            nlambda;
-    size_t         face;
-    vector<size_t> nodes;
+    FaceBuffer<size_t> nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    size_t             face;
 
     // See if point is inside any cells (faces)
     //
-    bool inside = _insideGrid(cCoords, face, nodes, lambda.data(), nlambda);
+    bool inside = _insideGrid(cCoords, face, nodes.data(), lambda.data(), nlambda, false);
 
     if (!inside) {
         return (GetMissingValue());
     }
-    VAssert(nodes.size() == nlambda);
     VAssert(face < GetCellDimensions()[0]);
 
     int maxindx = 0;
@@ -218,6 +230,25 @@ float UnstructuredGrid2D::GetValueNearestNeighbor(const CoordType &coords) const
     return ((float)value);
 }
 
+float UnstructuredGrid2D::_interpolateLinear(const size_t *nodes, const double *lambda, int nlambda) const
+{
+    double value = 0;
+    float  mv = GetMissingValue();
+    for (int i = 0; i < nlambda; i++) {
+        float v = AccessIJK(nodes[i], 0, 0);
+        if (v == mv) {
+            if (lambda[i] != 0.0)
+                return (mv);
+            else
+                v = 0.0;
+        }
+
+        value += v * lambda[i];
+    }
+
+    return ((float)value);
+}
+
 float UnstructuredGrid2D::GetValueLinear(const CoordType &coords) const
 {
     // Clamp coordinates on periodic boundaries to reside within the
@@ -226,37 +257,54 @@ float UnstructuredGrid2D::GetValueLinear(const CoordType &coords) const
     CoordType cCoords;
     ClampCoord(coords, cCoords);
 
-    std::vector<double> lambda(_maxVertexPerFace);
-    int            nlambda;
-    size_t         face;
-    vector<size_t> nodes;
+    FaceBuffer<size_t> nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    size_t             face;
 
     // See if point is inside any cells (faces)
     //
-    bool inside = _insideGrid(cCoords, face, nodes, lambda.data(), nlambda);
+    bool inside = _insideGrid(cCoords, face, nodes.data(), lambda.data(), nlambda, false);
 
     if (!inside) {
         return (GetMissingValue());
     }
 
-    VAssert(nodes.size() == nlambda);
     VAssert(face < GetCellDimensions()[0]);
 
-    double value = 0;
-    float  mv = GetMissingValue();
-    for (int i = 0; i < nodes.size(); i++) {
-        float v = AccessIJK(nodes[i], 0, 0);
-        if (v == mv) {
-            if (lambda[i] != 0.0)
-                return (mv);
-            else
-                v = 0.0;
-        }
+    return (_interpolateLinear(nodes.data(), lambda.data(), nlambda));
+}
 
-        value += v * lambda[i];
+void UnstructuredGrid2D::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
     }
 
-    return ((float)value);
+    // Same as GetValueLinear() for each point, except that the face
+    // containing the previous point, and its neighbors, are tested before
+    // searching the quad tree. For a point on the edge between two faces
+    // the face found may differ, but the interpolated value is the same
+    // up to round off.
+    //
+    float              mv = GetMissingValue();
+    FaceBuffer<size_t> nodes(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    size_t             face = 0;
+    bool               useHint = false;
+    for (size_t p = 0; p < n; p++) {
+        CoordType cCoords;
+        ClampCoord(coords[p], cCoords);
+
+        bool inside = _insideGrid(cCoords, face, nodes.data(), lambda.data(), nlambda, useHint);
+
+        // The face is only a good guess for the next point if this one was found
+        //
+        useHint = inside;
+        values[p] = inside ? _interpolateLinear(nodes.data(), lambda.data(), nlambda) : mv;
+    }
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -336,29 +384,33 @@ std::ostream &operator<<(std::ostream &o, const UnstructuredGrid2D &ug)
 // the face containing the point in XY, and the linear
 // interpolation weights/coordinates along Z.
 //
-bool UnstructuredGrid2D::_insideGrid(const CoordType &coords, size_t &face, vector<size_t> &nodes, double *lambda, int &nlambda) const
+bool UnstructuredGrid2D::_insideGrid(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const
 {
-    nodes.clear();
-
     if (_location == NODE) {
-        return (_insideGridNodeCentered(coords, face, nodes, lambda, nlambda));
+        return (_insideGridNodeCentered(coords, face, nodes, lambda, nlambda, useHint));
     } else {
-        return (_insideGridFaceCentered(coords, face, nodes, lambda, nlambda));
+        return (_insideGridFaceCentered(coords, face, nodes, lambda, nlambda, useHint));
     }
 }
 
-bool UnstructuredGrid2D::_insideGridFaceCentered(const CoordType &coords, size_t &face, vector<size_t> &nodes, double *lambda, int &nlambda) const
+bool UnstructuredGrid2D::_insideGridFaceCentered(const CoordType &coords, size_t &face, size_t *nodes, double *lambda, int &nlambda, bool useHint) const
 {
     VAssert(0 && "Not supported");
     return false;
 }
 
-bool UnstructuredGrid2D::_insideGridNodeCentered(const CoordType &coords, size_t &face_index, vector<size_t> &nodes, double *lambda, int &nlambda) const
+bool UnstructuredGrid2D::_insideGridNodeCentered(const CoordType &coords, size_t &face_index, size_t *nodes, double *lambda, int &nlambda, bool useHint) const
 {
-    nodes.clear();
-
     double pt[] = {coords[0], coords[1]};
 
+    // Coherent queries usually land in the face containing the previous
+    // point, or one next to it
+    //
+    if (useHint && face_index < GetCellDimensions()[0]) {
+        if (_insideFace(face_index, pt, nodes, lambda, nlambda)) return (true);
+        if (_insideNeighborFace(face_index, pt, nodes, lambda, nlambda)) return (true);
+    }
+
     // Find the indices for the faces that might contain the point
     //
     vector<DimsType> face_indices;
@@ -374,12 +426,56 @@ bool UnstructuredGrid2D::_insideGridNodeCentered(const CoordType &coords, size_t
     return (false);
 }
 
-bool UnstructuredGrid2D::_insideFace(size_t face, double pt[2], vector<size_t> &node_indices, double *lambda, int &nlambda) const
+bool UnstructuredGrid2D::_insideNeighborFace(size_t &face, const double pt[2], size_t *node_indices, double *lambda, int &nlambda) const
+{
+    long   cellOffset = GetCellOffset();
+    size_t nfaces = GetCellDimensions()[0];
+
+    auto testFace = [&](int id) {
+        if (id == GetBoundaryID()) return (false);
+
+        long f = id + cellOffset;
+        if (f < 0 || f >= (long)nfaces || f == (long)face) return (false);
+        if (!_insideFace(f, pt, node_indices, lambda, nlambda)) return (false);
+
+        face = f;
+        return (true);
+    };
+
+    // Faces sharing an edge if the face-face connectivity is known,
+    // otherwise faces sharing a vertex
+    //
+    if (_faceOnFace) {
+        const int *ptr = _faceOnFace + (face * _maxVertexPerFace);
+        for (int i = 0; i < _maxVertexPerFace; i++, ptr++) {
+            if (*ptr == GetMissingID()) break;
+            if (testFace(*ptr)) return (true);
+        }
+    } else if (_faceOnVertex) {
+        const int *vptr = _vertexOnFace + (face * _maxVertexPerFace);
+        long       nodeOffset = GetNodeOffset();
+        for (int i = 0; i < _maxVertexPerFace; i++, vptr++) {
+            if (*vptr == GetMissingID()) break;
+
+            long vertex = *vptr + nodeOffset;
+            if (vertex < 0) break;
+
+            const int *ptr = _faceOnVertex + (vertex * _maxFacePerVertex);
+            for (int j = 0; j < _maxFacePerVertex; j++, ptr++) {
+                if (*ptr == GetMissingID()) break;
+                if (testFace(*ptr)) return (true);
+            }
+        }
+    }
+
+    return (false);
+}
+
+bool UnstructuredGrid2D::_insideFace(size_t face, const double pt[2], size_t *node_indices, double *lambda, int &nlambda) const
 {
-    node_indices.clear();
     nlambda = 0;
 
-    double *verts = new double[_maxVertexPerFace * 2];
+    FaceBuffer<double> verts(_maxVertexPerFace * 2);
 
     const int *ptr = _vertexOnFace + (face * _maxVertexPerFace);
     long       offset = GetNodeOffset();
@@ -392,28 +488,18 @@ bool UnstructuredGrid2D::_insideFace(size_t face, double pt[2], vector<size_t> &
 
         verts[i * 2 + 0] = _xug.AccessIJK(vertex, 0, 0);
         verts[i * 2 + 1] = _yug.AccessIJK(vertex, 0, 0);
-        node_indices.push_back(*ptr + offset);
+        node_indices[i] = vertex;
         ptr++;
         nlambda++;
     }
 
     // Should we test the line case where nlambda == 2?
     //
-    if (nlambda < 3) {
-        delete[] verts;
-        return (false);
-    }
-
-    if (!Grid::PointInsideBoundingRectangle(pt, verts, nlambda)) {
-        delete[] verts;
-        return (false);
-    }
-
-    bool ret = WachspressCoords2D(verts, pt, nlambda, lambda);
+    if (nlambda < 3) return (false);
 
-    delete[] verts;
+    if (!Grid::PointInsideBoundingRectangle(pt, verts.data(), nlambda)) return (false);
 
-    return ret;
+    return (WachspressCoords2D(verts.data(), pt, nlambda, lambda));
 }
 
 std::shared_ptr<QuadTreeRectangleP> UnstructuredGrid2D::_makeQuadTreeRectangle() const
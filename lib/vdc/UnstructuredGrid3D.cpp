@@ -1,5 +1,6 @@
 #include <iostream>
 #include <vector>
+#include <algorithm>
 #include "vapor/VAssert.h"
 #include <cmath>
 #include <time.h>
@@ -23,30 +24,34 @@ UnstructuredGrid3D::UnstructuredGrid3D(const DimsType &vertexDims, const DimsTyp
                                        const int *faceOnVertex, const int *faceOnFace,
                                        Location location,    // node,face, edge
                                        size_t maxVertexPerFace, size_t maxFacePerVertex, long nodeOffset, long cellOffset, const UnstructuredGridCoordless &xug, const UnstructuredGridCoordless &yug,
-                                       const UnstructuredGridCoordless &zug)
+                                       const UnstructuredGridCoordless &zug, std::shared_ptr<const CellIndex3D> index)
 : UnstructuredGrid(vertexDims, faceDims, edgeDims, bs, blks, 3, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, nodeOffset, cellOffset), _xug(xug), _yug(yug),
-  _zug(zug)
+  _zug(zug), _index(index)
 {
     VAssert(xug.GetNumDimensions() == 1);
     VAssert(yug.GetNumDimensions() == 1);
     VAssert(zug.GetNumDimensions() == 1);
 
     VAssert(location == NODE);
+
+    if (!_index) { _index = _makeCellIndex(); }
 }
 
 UnstructuredGrid3D::UnstructuredGrid3D(const std::vector<size_t> &vertexDims, const std::vector<size_t> &faceDims, const std::vector<size_t> &edgeDims, const std::vector<size_t> &bs,
                                        const std::vector<float *> &blks, const int *vertexOnFace, const int *faceOnVertex, const int *faceOnFace,
                                        Location location,    // node,face, edge
                                        size_t maxVertexPerFace, size_t maxFacePerVertex, long nodeOffset, long cellOffset, const UnstructuredGridCoordless &xug, const UnstructuredGridCoordless &yug,
-                                       const UnstructuredGridCoordless &zug)
+                                       const UnstructuredGridCoordless &zug, std::shared_ptr<const CellIndex3D> index)
 : UnstructuredGrid(vertexDims, faceDims, edgeDims, bs, blks, 3, vertexOnFace, faceOnVertex, faceOnFace, location, maxVertexPerFace, maxFacePerVertex, nodeOffset, cellOffset), _xug(xug), _yug(yug),
-  _zug(zug)
+  _zug(zug), _index(index)
 {
     VAssert(xug.GetNumDimensions() == 1);
     VAssert(yug.GetNumDimensions() == 1);
     VAssert(zug.GetNumDimensions() == 1);
 
     VAssert(location == NODE);
+
+    if (!_index) { _index = _makeCellIndex(); }
 }
 
 
@@ -131,43 +136,240 @@ void UnstructuredGrid3D::GetUserCoordinates(const DimsType &indices, CoordType &
 
 bool UnstructuredGrid3D::GetIndicesCell(const CoordType &coords, DimsType &indices) const
 {
-    vector<size_t> nodes2D;
-    vector<double> lambda;
-    float          zwgt[2];
+    size_t nodes[maxCellNodes];
+    double lambda[maxCellNodes];
+    int    nnodes;
+    size_t cell;
 
-    return (_insideGrid(coords, indices, nodes2D, lambda, zwgt));
+    if (!_insideGrid(coords, cell, nodes, lambda, nnodes, false)) return (false);
+
+    indices = {cell, 0, 0};
+    return (true);
 }
 
 
 bool UnstructuredGrid3D::InsideGrid(const CoordType &coords) const
 {
-    DimsType            indices;
-    std::vector<size_t> nodes2D;
-    vector<double>      lambda;
-    float               zwgt[2];
+    size_t nodes[maxCellNodes];
+    double lambda[maxCellNodes];
+    int    nnodes;
+    size_t cell;
+
+    return (_insideGrid(coords, cell, nodes, lambda, nnodes, false));
+}
+
+
+int UnstructuredGrid3D::_cellNodes(size_t cell, size_t nodes[maxCellNodes]) const
+{
+    // _vertexOnFace is dimensioned ncells x _maxVertexPerFace
+    //
+    const int *ptr = _vertexOnFace + (_maxVertexPerFace * cell);
+    long       offset = GetNodeOffset();
+    long       nnodes = GetNodeDimensions()[0];
+
+    int n = 0;
+    for (int i = 0; i < _maxVertexPerFace; i++, ptr++) {
+        if (*ptr == GetMissingID()) break;
+
+        long node = *ptr + offset;
+        if (node < 0 || node >= nnodes || n == maxCellNodes) return (0);
+
+        nodes[n++] = node;
+    }
+
+    return ((n == 4 || n == 5 || n == 6 || n == 8) ? n : 0);
+}
+
 
-    return (_insideGrid(coords, indices, nodes2D, lambda, zwgt));
+std::shared_ptr<CellIndex3D> UnstructuredGrid3D::_makeCellIndex() const
+{
+    auto getBox = [this](size_t cell, float min[3], float max[3]) {
+        size_t nodes[maxCellNodes];
+        int    n = _cellNodes(cell, nodes);
+        if (!n) return (false);
+
+        for (int i = 0; i < n; i++) {
+            float c[] = {_xug.AccessIJK(nodes[i], 0, 0), _yug.AccessIJK(nodes[i], 0, 0), _zug.AccessIJK(nodes[i], 0, 0)};
+            for (int d = 0; d < 3; d++) {
+                min[d] = i ? std::min(min[d], c[d]) : c[d];
+                max[d] = i ? std::max(max[d], c[d]) : c[d];
+            }
+        }
+        return (true);
+    };
+
+    return (std::make_shared<CellIndex3D>(GetCellDimensions()[0], getBox));
 }
 
 
-bool UnstructuredGrid3D::_insideGrid(const CoordType &coords, DimsType &cindices, std::vector<size_t> &nodes2D, std::vector<double> &lambda, float zwgt[2]) const
+bool UnstructuredGrid3D::_insideCell(size_t cell, const double pt[3], size_t nodes[maxCellNodes], double lambda[maxCellNodes], int &nnodes) const
 {
-    VAssert(!"Not implemented");
-    return false;
+    if (!_index->InsideBox(cell, pt)) return (false);
+
+    nnodes = _cellNodes(cell, nodes);
+    if (!nnodes) return (false);
+
+    double verts[maxCellNodes * 3];
+    for (int i = 0; i < nnodes; i++) {
+        verts[i * 3 + 0] = _xug.AccessIJK(nodes[i], 0, 0);
+        verts[i * 3 + 1] = _yug.AccessIJK(nodes[i], 0, 0);
+        verts[i * 3 + 2] = _zug.AccessIJK(nodes[i], 0, 0);
+    }
+
+    if (nnodes == 8) return (TrilinearCoordsHex(verts, pt, lambda));
+    if (nnodes == 4) return (BarycentricCoordsTet(verts, pt, lambda));
+
+    // Pyramids and wedges are treated as hexahedra with collapsed edges, and
+    // the weights of coincident vertices summed. Their quadrilateral faces
+    // are then bilinear, like those of hexahedra, so the cells sharing a
+    // non-planar face agree on where it is and leave no gaps between them
+    //
+    static const int pyramidHex[8] = {0, 1, 2, 3, 4, 4, 4, 4};
+    static const int wedgeHex[8] = {0, 1, 2, 2, 3, 4, 5, 5};
+
+    const int *hex = nnodes == 5 ? pyramidHex : wedgeHex;
+
+    double hexVerts[8 * 3];
+    for (int i = 0; i < 8; i++) {
+        for (int d = 0; d < 3; d++) hexVerts[i * 3 + d] = verts[hex[i] * 3 + d];
+    }
+
+    double hexLambda[8];
+    if (!TrilinearCoordsHex(hexVerts, pt, hexLambda)) return (false);
+
+    for (int i = 0; i < nnodes; i++) lambda[i] = 0.0;
+    for (int i = 0; i < 8; i++) lambda[hex[i]] += hexLambda[i];
+    return (true);
+}
+
+
+bool UnstructuredGrid3D::_insideGrid(const CoordType &coords, size_t &cell, size_t nodes[maxCellNodes], double lambda[maxCellNodes], int &nnodes, bool useHint) const
+{
+    CoordType cCoords;
+    ClampCoord(coords, cCoords);
+
+    double pt[] = {cCoords[0], cCoords[1], cCoords[2]};
+
+    if (useHint && cell < _index->GetNumCells()) {
+        if (_insideCell(cell, pt, nodes, lambda, nnodes)) return (true);
+
+        // Coherent queries usually move into a cell sharing a node with
+        // the previous one
+        //
+        if (_faceOnVertex) {
+            size_t hintNodes[maxCellNodes];
+            int    nHintNodes = _cellNodes(cell, hintNodes);
+            long   offset = GetCellOffset();
+
+            for (int i = 0; i < nHintNodes; i++) {
+                const int *ptr = _faceOnVertex + (_maxFacePerVertex * hintNodes[i]);
+                for (int j = 0; j < _maxFacePerVertex; j++, ptr++) {
+                    if (*ptr == GetMissingID()) break;
+                    if (*ptr == GetBoundaryID()) continue;
+
+                    long c = *ptr + offset;
+                    if (c < 0 || c == (long)cell || c >= (long)_index->GetNumCells()) continue;
+
+                    if (_insideCell(c, pt, nodes, lambda, nnodes)) {
+                        cell = c;
+                        return (true);
+                    }
+                }
+            }
+        }
+    }
+
+    const uint32_t *cells;
+    size_t          ncells = _index->GetCells(pt, cells);
+    for (size_t i = 0; i < ncells; i++) {
+        if (_insideCell(cells[i], pt, nodes, lambda, nnodes)) {
+            cell = cells[i];
+            return (true);
+        }
+    }
+
+    return (false);
+}
+
+
+float UnstructuredGrid3D::_interpolateLinear(const size_t nodes[maxCellNodes], const double lambda[maxCellNodes], int nnodes) const
+{
+    double value = 0;
+    float  mv = GetMissingValue();
+    for (int i = 0; i < nnodes; i++) {
+        float v = AccessIJK(nodes[i], 0, 0);
+        if (v == mv) {
+            if (lambda[i] != 0.0)
+                return (mv);
+            else
+                v = 0.0;
+        }
+
+        value += v * lambda[i];
+    }
+
+    return ((float)value);
 }
 
 
 float UnstructuredGrid3D::GetValueNearestNeighbor(const CoordType &coords) const
 {
-    VAssert(!"Not implemented");
-    return NAN;
+    size_t nodes[maxCellNodes];
+    double lambda[maxCellNodes];
+    int    nnodes;
+    size_t cell;
+
+    if (!_insideGrid(coords, cell, nodes, lambda, nnodes, false)) return (GetMissingValue());
+
+    int maxindx = 0;
+    for (int i = 1; i < nnodes; i++) {
+        if (lambda[i] > lambda[maxindx]) maxindx = i;
+    }
+
+    return (AccessIJK(nodes[maxindx], 0, 0));
 }
 
 
 float UnstructuredGrid3D::GetValueLinear(const CoordType &coords) const
 {
-    VAssert(!"Not implemented");
-    return NAN;
+    size_t nodes[maxCellNodes];
+    double lambda[maxCellNodes];
+    int    nnodes;
+    size_t cell;
+
+    if (!_insideGrid(coords, cell, nodes, lambda, nnodes, false)) return (GetMissingValue());
+
+    return (_interpolateLinear(nodes, lambda, nnodes));
+}
+
+
+void UnstructuredGrid3D::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Same as GetValueLinear() for each point, except that the cell
+    // containing the previous point, and the cells around it, are tested
+    // before querying the index. For a point on the boundary between two
+    // cells the cell found may differ, but the interpolated value is the
+    // same up to round off.
+    //
+    float  mv = GetMissingValue();
+    size_t nodes[maxCellNodes];
+    double lambda[maxCellNodes];
+    int    nnodes;
+    size_t cell = 0;
+    bool   useHint = false;
+    for (size_t p = 0; p < n; p++) {
+        bool inside = _insideGrid(coords[p], cell, nodes, lambda, nnodes, useHint);
+
+        // The cell is only a good guess for the next point if this one was found
+        //
+        useHint = inside;
+        values[p] = inside ? _interpolateLinear(nodes, lambda, nnodes) : mv;
+    }
 }
 
 
@@ -116,46 +116,105 @@ void UnstructuredGridLayered::GetUserCoordinates(const DimsType &indices, CoordT
     coords[2] = _zug.GetValueAtIndex(cIndices);
 }
 
-bool UnstructuredGridLayered::_insideGrid(const CoordType &coords, DimsType &cindices, std::vector<size_t> &nodes2D, std::vector<double> &lambda, float zwgt[2]) const
+// Interpolate the Z coordinate of layer k at the horizontal position
+// given by the weights of the vertices of a face
+//
+float UnstructuredGridLayered::_layerZ(const size_t *nodes2D, const double *lambda, int nlambda, size_t k) const
 {
-    VAssert(_location == NODE);
+    float z = 0.0;
+    for (int i = 0; i < nlambda; i++) { z += _zug.AccessIJK(nodes2D[i], k) * lambda[i]; }
+
+    return (z);
+}
+
+// Find the layer containing z, returning the same layer k as
+// Wasp::BinarySearchRange() would for a vector of the Z coordinates of
+// every layer. Only the layers probed by the search are interpolated,
+// so the cost is O(log(nz)) rather than O(nz). If useHint is true the
+// layer k passed in is tested first.
+//
+bool UnstructuredGridLayered::_findLayer(const size_t *nodes2D, const double *lambda, int nlambda, double z, size_t &k, double &z0, double &z1, bool useHint) const
+{
+    size_t nz = GetDimensions()[1];
+
+    if (nz < 2) {
+        k = 0;
+        z0 = z1 = _layerZ(nodes2D, lambda, nlambda, 0);
+        return (z == z0);
+    }
+
+    if (useHint && k + 1 < nz) {
+        z0 = _layerZ(nodes2D, lambda, nlambda, k);
+        z1 = _layerZ(nodes2D, lambda, nlambda, k + 1);
+
+        bool last = k + 2 == nz && z == z1;
+        if (z0 < z1 && z0 <= z && (z < z1 || last)) return (true);
+        if (z0 > z1 && z0 >= z && (z > z1 || last)) return (true);
+    }
 
-    nodes2D.clear();
-    lambda.clear();
+    double zfirst = _layerZ(nodes2D, lambda, nlambda, 0);
+    double zlast = _layerZ(nodes2D, lambda, nlambda, nz - 1);
+    bool   ascending = zfirst <= zlast;
+
+    if (ascending ? z < zfirst : z < zlast) return (false);
+
+    if (z == zlast) {
+        k = nz - 2;
+        z0 = _layerZ(nodes2D, lambda, nlambda, k);
+        z1 = zlast;
+        return (true);
+    }
+
+    if (ascending ? z > zlast : z > zfirst) return (false);
+
+    // Invariant: z lies between layers lo and hi
+    //
+    size_t lo = 0;
+    size_t hi = nz - 1;
+    z0 = zfirst;
+    z1 = zlast;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        double zmid = _layerZ(nodes2D, lambda, nlambda, mid);
+        if (ascending ? zmid <= z : zmid >= z) {
+            lo = mid;
+            z0 = zmid;
+        } else {
+            hi = mid;
+            z1 = zmid;
+        }
+    }
+    k = lo;
+
+    return (true);
+}
+
+bool UnstructuredGridLayered::_insideGrid(const CoordType &coords, DimsType &cindices, size_t *nodes2D, double *lambda, int &nlambda, float zwgt[2], bool useHint) const
+{
+    VAssert(_location == NODE);
 
     CoordType cCoords;
     ClampCoord(coords, cCoords);
 
     // Find the 2D horizontal cell containing the X,Y coordinates
     //
-    std::vector<std::vector<size_t>> nodes;
-
-    bool status = _ug2d.GetIndicesCell(cCoords, cindices, nodes, lambda);
+    size_t face = cindices[0];
+    bool   status = _ug2d.FindFace(cCoords, face, nodes2D, lambda, nlambda, useHint);
     if (!status) return (status);
 
-    VAssert(lambda.size() == nodes.size());
-    for (int i = 0; i < nodes.size(); i++) { nodes2D.push_back(nodes[i][0]); }
+    cindices[0] = face;
 
     // Find k index of cell containing z
     //
-    vector<double> zcoords;
-
-    size_t nz = GetDimensions()[1];
-    for (int kk = 0; kk < nz; kk++) {
-        float z = 0.0;
-        for (int i = 0; i < lambda.size(); i++) { z += _zug.AccessIJK(nodes2D[i], kk) * lambda[i]; }
-
-        zcoords.push_back(z);
-    }
-
-    size_t k;
-    if (!Wasp::BinarySearchRange(zcoords, cCoords[2], k)) return (false);
+    size_t k = cindices[1];
+    double z0, z1;
+    if (!_findLayer(nodes2D, lambda, nlambda, cCoords[2], k, z0, z1, useHint)) return (false);
 
-    VAssert(k >= 0 && k < nz);
+    VAssert(k >= 0 && k < GetDimensions()[1]);
     cindices[1] = k;
 
     float z = cCoords[2];
-    zwgt[0] = 1.0 - (z - zcoords[k]) / (zcoords[k + 1] - zcoords[k]);
+    zwgt[0] = z1 != z0 ? 1.0 - (z - z0) / (z1 - z0) : 1.0;
     zwgt[1] = 1.0 - zwgt[0];
 
     return (true);
@@ -163,31 +222,34 @@ bool UnstructuredGridLayered::_insideGrid(const CoordType &coords, DimsType &cin
 
 bool UnstructuredGridLayered::GetIndicesCell(const CoordType &coords, DimsType &indices) const
 {
-    vector<size_t> nodes2D;
-    vector<double> lambda;
-    float          zwgt[2];
+    FaceBuffer<size_t> nodes2D(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    float              zwgt[2];
 
-    return (_insideGrid(coords, indices, nodes2D, lambda, zwgt));
+    return (_insideGrid(coords, indices, nodes2D.data(), lambda.data(), nlambda, zwgt, false));
 }
 
 bool UnstructuredGridLayered::InsideGrid(const CoordType &coords) const
 {
-    DimsType            indices;
-    std::vector<size_t> nodes2D;
-    vector<double>      lambda;
-    float               zwgt[2];
+    DimsType           indices;
+    FaceBuffer<size_t> nodes2D(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    float              zwgt[2];
 
-    return (_insideGrid(coords, indices, nodes2D, lambda, zwgt));
+    return (_insideGrid(coords, indices, nodes2D.data(), lambda.data(), nlambda, zwgt, false));
 }
 
 float UnstructuredGridLayered::GetValueNearestNeighbor(const CoordType &coords) const
 {
-    DimsType            indices;
-    std::vector<size_t> nodes2D;
-    vector<double>      lambda;
-    float               zwgt[2];
+    DimsType           indices;
+    FaceBuffer<size_t> nodes2D(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    float              zwgt[2];
 
-    bool inside = _insideGrid(coords, indices, nodes2D, lambda, zwgt);
+    bool inside = _insideGrid(coords, indices, nodes2D.data(), lambda.data(), nlambda, zwgt, false);
     if (!inside) return (GetMissingValue());
 
     // Find nearest node in XY plane (the curvilinear part of grid)
@@ -195,7 +257,7 @@ float UnstructuredGridLayered::GetValueNearestNeighbor(const CoordType &coords)
     //
     float max_lambda = 0.0;
     int   max_nodes2d_index = 0;
-    for (int i = 0; i < lambda.size(); i++) {
+    for (int i = 0; i < nlambda; i++) {
         if (lambda[i] > max_lambda) {
             max_lambda = lambda[i];
             max_nodes2d_index = i;
@@ -212,23 +274,14 @@ float UnstructuredGridLayered::GetValueNearestNeighbor(const CoordType &coords)
     return (AccessIJK(nodes2D[max_nodes2d_index], max_vert_id));
 }
 
-float UnstructuredGridLayered::GetValueLinear(const CoordType &coords) const
+float UnstructuredGridLayered::_interpolateLinear(const size_t *nodes2D, const double *lambda, int nlambda, size_t k0, const float zwgt[2]) const
 {
-    DimsType            indices;
-    std::vector<size_t> nodes2D;
-    vector<double>      lambda;
-    float               zwgt[2];
-
-    bool inside = _insideGrid(coords, indices, nodes2D, lambda, zwgt);
-    if (!inside) return (GetMissingValue());
-
     // Interpolate value inside bottom face
     //
     float mv = GetMissingValue();
 
-    float  z0 = 0.0;
-    size_t k0 = indices[1];
-    for (size_t i = 0; i < lambda.size(); i++) {
+    float z0 = 0.0;
+    for (int i = 0; i < nlambda; i++) {
         float v = AccessIJK(nodes2D[i], k0, 0);
         if (v == mv) {
             if (lambda[i] != 0.0) {
@@ -249,7 +302,7 @@ float UnstructuredGridLayered::GetValueLinear(const CoordType &coords) const
     // Interpolate value inside top face
     //
     float z1 = 0.0;
-    for (int i = 0; i < lambda.size(); i++) {
+    for (int i = 0; i < nlambda; i++) {
         float v = AccessIJK(nodes2D[i], k1, 0);
         if (v == mv) {
             if (lambda[i] != 0.0) {
@@ -267,6 +320,49 @@ float UnstructuredGridLayered::GetValueLinear(const CoordType &coords) const
     return (z0 * zwgt[0] + z1 * zwgt[1]);
 }
 
+float UnstructuredGridLayered::GetValueLinear(const CoordType &coords) const
+{
+    DimsType           indices;
+    FaceBuffer<size_t> nodes2D(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    float              zwgt[2];
+
+    bool inside = _insideGrid(coords, indices, nodes2D.data(), lambda.data(), nlambda, zwgt, false);
+    if (!inside) return (GetMissingValue());
+
+    return (_interpolateLinear(nodes2D.data(), lambda.data(), nlambda, indices[1], zwgt));
+}
+
+void UnstructuredGridLayered::GetValues(const CoordType *coords, size_t n, float *values) const
+{
+    if (!GetBlks().size() || GetInterpolationOrder() == 0) {
+        Grid::GetValues(coords, n, values);
+        return;
+    }
+
+    // Same as GetValueLinear() for each point, except that the face and
+    // layer containing the previous point are tested first. For a point
+    // on the boundary between two faces the face found may differ, but
+    // the interpolated value is the same up to round off.
+    //
+    float              mv = GetMissingValue();
+    DimsType           indices = {0, 0, 0};
+    FaceBuffer<size_t> nodes2D(_maxVertexPerFace);
+    FaceBuffer<double> lambda(_maxVertexPerFace);
+    int                nlambda;
+    float              zwgt[2];
+    bool               useHint = false;
+    for (size_t p = 0; p < n; p++) {
+        bool inside = _insideGrid(coords[p], indices, nodes2D.data(), lambda.data(), nlambda, zwgt, useHint);
+
+        // The cell is only a good guess for the next point if this one was found
+        //
+        useHint = inside;
+        values[p] = inside ? _interpolateLinear(nodes2D.data(), lambda.data(), nlambda, indices[1], zwgt) : mv;
+    }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Iterators
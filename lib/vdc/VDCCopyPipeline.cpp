@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include "vapor/VDCCopyPipeline.h"
+
+using namespace VAPoR;
+using namespace Wasp;
+
+namespace {
+
+size_t vproduct(const vector<size_t> &a)
+{
+    size_t ntotal = 1;
+
+    for (int i = 0; i < a.size(); i++) ntotal *= a[i];
+    return (ntotal);
+}
+
+double elapsed(const std::chrono::steady_clock::time_point &start) { return (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()); }
+
+};    // namespace
+
+VDCCopyPipeline::VDCCopyPipeline(DC &dc, VDCNetCDF &vdc, int inflight) : _dc(dc), _vdc(vdc), _inflight(std::max(inflight, 2)), _nfree(0), _abort(false), _wallTime(0.0) {}
+
+VDCCopyPipeline::~VDCCopyPipeline() {}
+
+int VDCCopyPipeline::Copy(const vector<string> &varnames, int numts, bool stopOnError)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    // From here on the VDC expects its caller to hold the I/O lock
+    //
+    _vdc.SetIOMutex(&_ioMutex);
+
+    _queue.clear();
+    _nfree = _inflight;
+    _abort = false;
+
+    std::thread reader(&VDCCopyPipeline::_reader, this, varnames, numts);
+
+    // The calling thread is the writer
+    //
+    int  estatus = 0;
+    bool stop = false;
+    while (true) {
+        std::unique_ptr<Item> item;
+        {
+            const auto                   t0 = std::chrono::steady_clock::now();
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCond.wait(lock, [this] { return (!_queue.empty()); });
+            item = std::move(_queue.front());
+            _queue.pop_front();
+            _writeStats.stalled += elapsed(t0);
+        }
+
+        // A null item marks the end of the input
+        //
+        if (!item) break;
+
+        // After a failure with stopOnError set, drain the time steps
+        // already read without writing them
+        //
+        int rc = 0;
+        if (!stop) {
+            rc = item->status;
+            if (rc >= 0) {
+                const auto t0 = std::chrono::steady_clock::now();
+                rc = _write(*item);
+                _writeStats.busy += elapsed(t0);
+            }
+
+            if (rc >= 0) {
+                _writeStats.items++;
+                _writeStats.bytes += item->fdata.size() * sizeof(float) + item->idata.size() * sizeof(int) + item->mask.size();
+                if (_progress) _progress(item->varname, item->ts);
+            } else {
+                std::lock_guard<std::mutex> lock(_ioMutex);
+                SetErrMsg("Failed to copy variable %s, time step %d", item->varname.c_str(), (int)item->ts);
+                estatus = -1;
+            }
+        }
+
+        // Release the buffer before letting the reader fill another one
+        //
+        item.reset();
+        {
+            std::lock_guard<std::mutex> lock(_queueMutex);
+            _nfree++;
+            if (rc < 0 && stopOnError) _abort = stop = true;
+        }
+        _queueCond.notify_all();
+    }
+
+    reader.join();
+
+    _vdc.SetIOMutex(NULL);
+
+    _wallTime += elapsed(start);
+
+    return (estatus);
+}
+
+void VDCCopyPipeline::_reader(vector<string> varnames, int numts)
+{
+    bool done = false;
+    for (int i = 0; i < varnames.size() && !done; i++) {
+        size_t nts;
+        {
+            std::lock_guard<std::mutex> lock(_ioMutex);
+            nts = _dc.GetNumTimeSteps(varnames[i]);
+        }
+        if (numts >= 0 && nts > numts) nts = numts;
+
+        for (size_t ts = 0; ts < nts && !done; ts++) {
+            // Wait for a free buffer
+            //
+            {
+                const auto                   t0 = std::chrono::steady_clock::now();
+                std::unique_lock<std::mutex> lock(_queueMutex);
+                _queueCond.wait(lock, [this] { return (_nfree > 0 || _abort); });
+                _readStats.stalled += elapsed(t0);
+                if (_abort) {
+                    done = true;
+                    break;
+                }
+                _nfree--;
+            }
+
+            std::unique_ptr<Item> item(new Item);
+            item->varname = varnames[i];
+            item->ts = ts;
+
+            const auto t0 = std::chrono::steady_clock::now();
+            item->status = _read(*item);
+            _readStats.busy += elapsed(t0);
+
+            if (item->status >= 0) {
+                _readStats.items++;
+                _readStats.bytes += item->fdata.size() * sizeof(float) + item->idata.size() * sizeof(int);
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_queueMutex);
+                _queue.push_back(std::move(item));
+            }
+            _queueCond.notify_all();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queue.push_back(std::unique_ptr<Item>());
+    }
+    _queueCond.notify_all();
+}
+
+int VDCCopyPipeline::_read(Item &item)
+{
+    vector<size_t> dims;
+    vector<size_t> hslice_dims;
+    size_t         nslice = 0;
+    int            fd = -1;
+    {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+
+        DC::BaseVar varInfo;
+        if (!_dc.GetBaseVarInfo(item.varname, varInfo)) {
+            SetErrMsg("Invalid source variable name : %s", item.varname.c_str());
+            return (-1);
+        }
+        item.isFloat = varInfo.GetXType() == DC::FLOAT || varInfo.GetXType() == DC::DOUBLE;
+
+        int rc = _dc.GetDimLens(item.varname, dims, item.ts);
+        if (rc < 0) return (rc);
+
+        if (item.isFloat) {
+            item.fdata.resize(vproduct(dims));
+        } else {
+            item.idata.resize(vproduct(dims));
+        }
+
+        if (dims.empty()) {
+            if (item.isFloat) return (_dc.GetVar(item.ts, item.varname, -1, -1, item.fdata.data()));
+            return (_dc.GetVar(item.ts, item.varname, -1, -1, item.idata.data()));
+        }
+
+        rc = _dc.GetHyperSliceInfo(item.varname, -1, hslice_dims, nslice);
+        if (rc < 0) return (rc);
+
+        fd = _dc.OpenVariableRead(item.ts, item.varname, -1);
+        if (fd < 0) return (fd);
+    }
+
+    // Read one hyper slice at a time so that the writer's threads can
+    // store compressed blocks in between. The last slice may be partial
+    //
+    size_t slice_size = vproduct(hslice_dims);
+    int    rc = 0;
+    for (size_t i = 0; i < nslice && rc >= 0; i++) {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        if (item.isFloat) {
+            rc = _dc.ReadSlice(fd, item.fdata.data() + i * slice_size);
+        } else {
+            rc = _dc.ReadSlice(fd, item.idata.data() + i * slice_size);
+        }
+    }
+
+    double mv;
+    {
+        std::lock_guard<std::mutex> lock(_ioMutex);
+        _dc.CloseVariable(fd);
+        if (rc < 0) return (rc);
+
+        // Only data variables with two or more dimensions have masks
+        //
+        if (dims.size() < 2 || !_vdc.IsDataVar(item.varname)) return (0);
+
+        DC::DataVar varInfo;
+        if (!_vdc.GetDataVarInfo(item.varname, varInfo)) {
+            SetErrMsg("Invalid destination variable name : %s", item.varname.c_str());
+            return (-1);
+        }
+        item.maskvar = varInfo.GetMaskvar();
+        if (item.maskvar.empty()) return (0);
+
+        if (!_dc.GetDataVarInfo(item.varname, varInfo)) {
+            SetErrMsg("Invalid source variable name : %s", item.varname.c_str());
+            return (-1);
+        }
+        mv = varInfo.GetMissingValue();
+    }
+
+    size_t n = vproduct(dims);
+    item.mask.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        float v = item.isFloat ? item.fdata[i] : (float)item.idata[i];
+        item.mask[i] = v == mv ? 0 : 1;
+    }
+
+    return (0);
+}
+
+int VDCCopyPipeline::_write(Item &item)
+{
+    std::lock_guard<std::mutex> lock(_ioMutex);
+
+    // Several variables may share a mask. Only write it once
+    //
+    if (!item.maskvar.empty() && !_vdc.VariableExists(item.ts, item.maskvar, 0, -1)) {
+        int rc = _writeMask(item);
+        if (rc < 0) return (rc);
+    }
+
+    if (item.isFloat) return (_vdc.PutVar(item.ts, item.varname, -1, item.fdata.data()));
+    return (_vdc.PutVar(item.ts, item.varname, -1, item.idata.data()));
+}
+
+int VDCCopyPipeline::_writeMask(const Item &item)
+{
+    vector<size_t> hslice_dims;
+    size_t         nslice;
+    int            rc = _vdc.GetHyperSliceInfo(item.varname, -1, hslice_dims, nslice);
+    if (rc < 0) return (rc);
+
+    int fd = _vdc.OpenVariableWrite(item.ts, item.maskvar, -1);
+    if (fd < 0) return (fd);
+
+    size_t slice_size = vproduct(hslice_dims);
+    for (size_t i = 0; i < nslice && rc >= 0; i++) { rc = _vdc.WriteSlice(fd, item.mask.data() + i * slice_size); }
+
+    _vdc.CloseVariable(fd);
+
+    return (rc);
+}
+
+void VDCCopyPipeline::PrintStats(std::ostream &o) const
+{
+    char buf[256];
+
+    snprintf(buf, sizeof(buf), "Elapsed time %.2f s, %d time steps in flight\n", _wallTime, _inflight);
+    o << buf;
+    snprintf(buf, sizeof(buf), "%-6s %10s %12s %10s %12s %10s\n", "stage", "time steps", "MBytes", "busy (s)", "stalled (s)", "MBytes/s");
+    o << buf;
+
+    const Stats *stats[] = {&_readStats, &_writeStats};
+    const char * names[] = {"read", "write"};
+    for (int i = 0; i < 2; i++) {
+        double mbytes = stats[i]->bytes / (1024.0 * 1024.0);
+        double rate = stats[i]->busy > 0.0 ? mbytes / stats[i]->busy : 0.0;
+        snprintf(buf, sizeof(buf), "%-6s %10zu %12.1f %10.2f %12.2f %10.1f\n", names[i], stats[i]->items, mbytes, stats[i]->busy, stats[i]->stalled, rate);
+        o << buf;
+    }
+}
@@ -123,12 +123,153 @@ bool isblocked(vector<size_t> bs)
 
 };    // namespace
 
-VDCNetCDF::VDCNetCDF(int nthreads, size_t master_threshold, size_t variable_threshold) : VDC()
+VDCNetCDF::WASPPool::WASPPool(int nthreads, size_t capacity) : _nthreads(nthreads), _capacity(capacity), _ioMutex(NULL), _hits(0), _misses(0), _opens(0) {}
+
+VDCNetCDF::WASPPool::~WASPPool() { Clear(); }
+
+WASP *VDCNetCDF::WASPPool::_open(string path)
+{
+    _misses++;
+
+    WASP *wasp = new WASP(_nthreads);
+    wasp->SetIOMutex(_ioMutex);
+    int rc = wasp->Open(path, NC_NOWRITE);
+    if (rc < 0) {
+        delete wasp;
+        return (NULL);
+    }
+    _opens++;
+
+    return (wasp);
+}
+
+WASP *VDCNetCDF::WASPPool::Acquire(string path, string varname, int level, int lod)
+{
+    // A file already reading the same variable can be shared as is
+    //
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->path == path && it->varOpen && it->varname == varname && it->level == level && it->lod == lod) {
+            it->refcount++;
+            _hits++;
+            _entries.splice(_entries.begin(), _entries, it);
+            return (_entries.front().wasp);
+        }
+    }
+
+    // Otherwise reuse an idle file
+    //
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->path != path || it->refcount > 0) continue;
+
+        if (it->varOpen) {
+            it->wasp->CloseVar();
+            it->varOpen = false;
+        }
+        int rc = it->wasp->OpenVarRead(varname, level, lod);
+        if (rc < 0) return (NULL);
+
+        it->varname = varname;
+        it->level = level;
+        it->lod = lod;
+        it->varOpen = true;
+        it->refcount = 1;
+        _hits++;
+        _entries.splice(_entries.begin(), _entries, it);
+        return (_entries.front().wasp);
+    }
+
+    WASP *wasp = _open(path);
+    if (!wasp) return (NULL);
+
+    int rc = wasp->OpenVarRead(varname, level, lod);
+    if (rc < 0) {
+        wasp->Close();
+        delete wasp;
+        return (NULL);
+    }
+
+    _entries.push_front({wasp, path, varname, level, lod, true, 1});
+    _evict();
+
+    return (wasp);
+}
+
+WASP *VDCNetCDF::WASPPool::Acquire(string path)
+{
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->path == path) {
+            it->refcount++;
+            _hits++;
+            _entries.splice(_entries.begin(), _entries, it);
+            return (_entries.front().wasp);
+        }
+    }
+
+    WASP *wasp = _open(path);
+    if (!wasp) return (NULL);
+
+    _entries.push_front({wasp, path, "", 0, 0, false, 1});
+    _evict();
+
+    return (wasp);
+}
+
+bool VDCNetCDF::WASPPool::Release(WASP *wasp)
+{
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->wasp == wasp) {
+            VAssert(it->refcount > 0);
+            it->refcount--;
+            _evict();
+            return (true);
+        }
+    }
+    return (false);
+}
+
+void VDCNetCDF::WASPPool::_evict()
+{
+    auto it = _entries.end();
+    while (_entries.size() > _capacity && it != _entries.begin()) {
+        --it;
+        if (it->refcount > 0) continue;
+
+        if (it->varOpen) it->wasp->CloseVar();
+        it->wasp->Close();
+        delete it->wasp;
+        it = _entries.erase(it);
+    }
+}
+
+void VDCNetCDF::WASPPool::Clear()
+{
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+        if (it->varOpen) it->wasp->CloseVar();
+        it->wasp->Close();
+        delete it->wasp;
+    }
+    _entries.clear();
+}
+
+void VDCNetCDF::WASPPool::SetCapacity(size_t capacity)
+{
+    _capacity = capacity;
+    _evict();
+}
+
+void VDCNetCDF::WASPPool::SetIOMutex(std::mutex *mutex)
+{
+    _ioMutex = mutex;
+    for (auto it = _entries.begin(); it != _entries.end(); ++it) it->wasp->SetIOMutex(mutex);
+}
+
+VDCNetCDF::VDCNetCDF(int nthreads, size_t master_threshold, size_t variable_threshold) : VDC(), _pool(nthreads, 32)
 {
     _nthreads = nthreads;
     _master_threshold = master_threshold;
     _variable_threshold = variable_threshold;
     _chunksizehint = 0;
+    _ioMutex = NULL;
     _master = new WASP(nthreads);
     _version = 1;
 }
@@ -138,6 +279,8 @@ VDCNetCDF::~VDCNetCDF()
     vector<int> fds = _fileTable.GetEntries();
     for (int i = 0; i < fds.size(); i++) { (void)closeVariable(i); }
 
+    _pool.Clear();
+
     if (_master) {
         _master->Close();
         delete _master;
@@ -370,12 +513,17 @@ WASP *VDCNetCDF::_OpenVariableRead(size_t ts, string varname, int clevel, int lo
     if (lod < 0) lod = lod + ncratios;
     if (lod < 0) lod = 0;
 
+    // Files are pooled only if nothing will be written to them
+    //
+    if (path.compare(_master_path) != 0 && _mode == VDC::R) { return (_pool.Acquire(path, varname, clevel, lod)); }
+
     WASP *wasp = NULL;
 
     if (path.compare(_master_path) == 0) {
         wasp = _master;
     } else {
         wasp = new WASP(_nthreads);
+        wasp->SetIOMutex(_ioMutex);
         rc = wasp->Open(path, NC_NOWRITE);
         if (rc < 0) return (NULL);
     }
@@ -473,9 +621,11 @@ int VDCNetCDF::OpenVariableWrite(size_t ts, string varname, int lod)
         wasp = _master;
     } else if (_master->ValidFile(path)) {
         wasp = new WASP(_nthreads);
+        wasp->SetIOMutex(_ioMutex);
         rc = wasp->Open(path, NC_WRITE);
     } else {
         wasp = new WASP(_nthreads);
+        wasp->SetIOMutex(_ioMutex);
         string dir;
         dir = FileUtils::Dirname(path);
         rc = MkDirHier(dir);
@@ -535,17 +685,21 @@ int VDCNetCDF::closeVariable(int fd)
     }
     WASP *wasp = o->GetWaspData();
 
-    if (wasp) { wasp->CloseVar(); }
-    if (wasp && wasp != _master) {
-        wasp->Close();
-        delete wasp;
+    if (wasp && !_pool.Release(wasp)) {
+        wasp->CloseVar();
+        if (wasp != _master) {
+            wasp->Close();
+            delete wasp;
+        }
     }
 
     WASP *wasp_mask = o->GetWaspMask();
-    if (wasp_mask) { wasp_mask->CloseVar(); }
-    if (wasp_mask && wasp_mask != _master) {
-        wasp_mask->Close();
-        delete wasp_mask;
+    if (wasp_mask && !_pool.Release(wasp_mask)) {
+        wasp_mask->CloseVar();
+        if (wasp_mask != _master) {
+            wasp_mask->Close();
+            delete wasp_mask;
+        }
     }
 
     _fileTable.RemoveEntry(fd);
@@ -1005,6 +1159,94 @@ bool VDCNetCDF::variableExists(size_t ts, string varname, int level, int lod) co
     return (true);
 }
 
+int VDCNetCDF::getBlockRanges(size_t ts, string varname, vector<size_t> &bdims, vector<double> &ranges)
+{
+    bdims.clear();
+    ranges.clear();
+
+    vector<Dimension> dimensions;
+    if (!GetVarDimensions(varname, true, dimensions, -1)) {
+        SetErrMsg("Undefined variable name : %s", varname.c_str());
+        return (-1);
+    }
+
+    // Missing values are only excluded from the block ranges when they are
+    // identified by a mask variable
+    //
+    VDC::DataVar dvar;
+    if (VDC::getDataVarInfo(varname, dvar) && dvar.GetHasMissing() && dvar.GetMaskvar().empty()) return (0);
+
+    string path;
+    size_t file_ts;
+    size_t max_ts;
+    int    rc = GetPath(varname, ts, path, file_ts, max_ts);
+    if (rc < 0) return (-1);
+
+    WASP *wasp = NULL;
+    if (path.compare(_master_path) == 0) {
+        wasp = _master;
+    } else if (_mode == VDC::R) {
+        wasp = _pool.Acquire(path);
+        if (!wasp) return (-1);
+    } else {
+        wasp = new WASP(_nthreads);
+        wasp->SetIOMutex(_ioMutex);
+        rc = wasp->Open(path, NC_NOWRITE);
+        if (rc < 0) {
+            delete wasp;
+            return (-1);
+        }
+    }
+
+    vector<size_t> wasp_bdims;
+    vector<double> wasp_ranges;
+    rc = wasp->InqVarBlockRanges(varname, wasp_bdims, wasp_ranges);
+
+    if (wasp != _master && !_pool.Release(wasp)) {
+        (void)wasp->Close();
+        delete wasp;
+    }
+    if (rc < 0) return (-1);
+
+    // Older files don't record block ranges
+    //
+    if (wasp_bdims.size() < dimensions.size()) return (0);
+
+    // WASP dimensions are ordered slowest varying first. For time varying
+    // variables the slowest dimension is time, which indexes the time
+    // steps stored in this file.
+    //
+    size_t nblocks = 1;
+    for (int i = 0; i < dimensions.size(); i++) { nblocks *= wasp_bdims[wasp_bdims.size() - 1 - i]; }
+
+    size_t offset = 0;
+    if (wasp_bdims.size() > dimensions.size()) {
+        if (file_ts >= wasp_bdims[0]) return (0);
+        offset = file_ts * nblocks * 2;
+    }
+
+    bdims.assign(wasp_bdims.rbegin(), wasp_bdims.rbegin() + dimensions.size());
+    ranges.assign(wasp_ranges.begin() + offset, wasp_ranges.begin() + offset + nblocks * 2);
+
+    return (0);
+}
+
+void VDCNetCDF::SetIOMutex(std::mutex *mutex)
+{
+    _ioMutex = mutex;
+    _master->SetIOMutex(mutex);
+    _pool.SetIOMutex(mutex);
+}
+
+void VDCNetCDF::SetOpenFileLimit(size_t n) { _pool.SetCapacity(n); }
+
+void VDCNetCDF::GetOpenFileStats(size_t &hits, size_t &misses, size_t &opens) const
+{
+    hits = _pool.GetHits();
+    misses = _pool.GetMisses();
+    opens = _pool.GetOpens();
+}
+
 int VDCNetCDF::SetFill(int fillmode)
 {
     int last;
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -8,6 +9,20 @@ namespace {
 
 double dot2d(const double a[], const double b[]) { return ((a[0] * b[0]) + (a[1] * b[1])); }
 
+double det3(const double a[3], const double b[3], const double c[3]) { return (a[0] * (b[1] * c[2] - b[2] * c[1]) - a[1] * (b[0] * c[2] - b[2] * c[0]) + a[2] * (b[0] * c[1] - b[1] * c[0])); }
+
+// Parametric coordinates of the hexahedron vertices, in the order
+// expected by TrilinearCoordsHex()
+//
+const double hexParam[8][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+
+void hexWeights(const double r[3], double lambda[8])
+{
+    for (int i = 0; i < 8; i++) {
+        lambda[i] = (hexParam[i][0] ? r[0] : 1.0 - r[0]) * (hexParam[i][1] ? r[1] : 1.0 - r[1]) * (hexParam[i][2] ? r[2] : 1.0 - r[2]);
+    }
+}
+
 };    // namespace
 
 void VAPoR::HexahedronToTets(const int hexahedron[8], int tets[5 * 4])
@@ -195,6 +210,94 @@ bool VAPoR::BarycentricCoordsTri(const double verts[], const double pt[], double
     return (lambda[0] >= 0.0 && lambda[1] >= 0.0 && lambda[2] >= 0.0);
 }
 
+bool VAPoR::BarycentricCoordsTet(const double verts[], const double pt[], double lambda[])
+{
+    double v1[] = {verts[3] - verts[0], verts[4] - verts[1], verts[5] - verts[2]};
+    double v2[] = {verts[6] - verts[0], verts[7] - verts[1], verts[8] - verts[2]};
+    double v3[] = {verts[9] - verts[0], verts[10] - verts[1], verts[11] - verts[2]};
+    double p[] = {pt[0] - verts[0], pt[1] - verts[1], pt[2] - verts[2]};
+
+    double denom = det3(v1, v2, v3);
+    if (denom == 0.0) return (false);
+
+    lambda[1] = det3(p, v2, v3) / denom;
+    lambda[2] = det3(v1, p, v3) / denom;
+    lambda[3] = det3(v1, v2, p) / denom;
+    lambda[0] = 1.0 - lambda[1] - lambda[2] - lambda[3];
+
+    // Points on a face shared by two tetrahedra must be found in one of them
+    //
+    const double epsilon = 1e-10;
+    for (int i = 0; i < 4; i++) {
+        if ((lambda[i] < 0.0) && ((lambda[i] + epsilon) >= 0.0)) lambda[i] = 0.0;
+    }
+
+    return (lambda[0] >= 0.0 && lambda[1] >= 0.0 && lambda[2] >= 0.0 && lambda[3] >= 0.0);
+}
+
+bool VAPoR::TrilinearCoordsHex(const double verts[], const double pt[], double lambda[])
+{
+    const double epsilon = 1e-8;
+    const int    maxIter = 20;
+
+    // Newton's method, solving x(r) = pt for the parametric coordinates r
+    //
+    double r[] = {0.5, 0.5, 0.5};
+    bool   converged = false;
+    for (int iter = 0; iter < maxIter && !converged; iter++) {
+        double f[] = {-pt[0], -pt[1], -pt[2]};
+        double J[3][3] = {{0.0}};    // J[i][j] = d x_j / d r_i
+
+        hexWeights(r, lambda);
+        for (int n = 0; n < 8; n++) {
+            const double *v = &verts[n * 3];
+
+            double dr[3];
+            for (int i = 0; i < 3; i++) {
+                // Derivative of the weight of vertex n with respect to r[i]
+                //
+                double d = hexParam[n][i] ? 1.0 : -1.0;
+                for (int k = 0; k < 3; k++) {
+                    if (k != i) d *= hexParam[n][k] ? r[k] : 1.0 - r[k];
+                }
+                dr[i] = d;
+            }
+
+            for (int j = 0; j < 3; j++) {
+                f[j] += lambda[n] * v[j];
+                for (int i = 0; i < 3; i++) J[i][j] += dr[i] * v[j];
+            }
+        }
+
+        // Solve J^T delta = -f with Cramer's rule
+        //
+        double c0[] = {J[0][0], J[0][1], J[0][2]};
+        double c1[] = {J[1][0], J[1][1], J[1][2]};
+        double c2[] = {J[2][0], J[2][1], J[2][2]};
+        double nf[] = {-f[0], -f[1], -f[2]};
+
+        double denom = det3(c0, c1, c2);
+        if (denom == 0.0) return (false);
+
+        double delta[] = {det3(nf, c1, c2) / denom, det3(c0, nf, c2) / denom, det3(c0, c1, nf) / denom};
+        for (int i = 0; i < 3; i++) r[i] += delta[i];
+
+        converged = std::fabs(delta[0]) < epsilon && std::fabs(delta[1]) < epsilon && std::fabs(delta[2]) < epsilon;
+
+        // Far outside. No need to converge
+        //
+        if (std::fabs(r[0] - 0.5) > 2.0 || std::fabs(r[1] - 0.5) > 2.0 || std::fabs(r[2] - 0.5) > 2.0) return (false);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (r[i] < -epsilon || r[i] > 1.0 + epsilon) return (false);
+        r[i] = std::min(1.0, std::max(0.0, r[i]));
+    }
+
+    hexWeights(r, lambda);
+    return (converged);
+}
+
 bool VAPoR::WachspressCoords2D(const double verts[], const double pt[], int n, double lambda[])
 {
     if (n == 0) return (false);
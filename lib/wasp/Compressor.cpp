@@ -25,6 +25,7 @@ void Compressor::_Compressor(vector<size_t> dims)
     _L = NULL;
     _LLen = 0;
     _keepapp = true;
+    _full_sort_flag = false;
     _clamp_min_flag = false;
     _clamp_max_flag = false;
     _epsilon_flag = false;
@@ -110,21 +111,61 @@ Compressor::~Compressor()
 }
 
 //
-// Comparision functions for the C++ Std Lib sort function
+// Comparision functions for the C++ Std Lib sort and selection functions.
+// Coefficients are ordered by decreasing magnitude. Ties are broken by
+// address so that the ordering is total, and the set of coefficients
+// selected is the same whether it is found by sorting or by selection.
 //
-inline bool my_compare_f(const void *x1, const void *x2) { return (fabsf(*(float *)x1) > fabsf(*(float *)x2)); }
+inline bool my_compare_f(const void *x1, const void *x2)
+{
+    float a1 = fabsf(*(float *)x1);
+    float a2 = fabsf(*(float *)x2);
+    return (a1 > a2 || (a1 == a2 && x1 < x2));
+}
 
-inline bool my_compare_d(const void *x1, const void *x2) { return (fabs(*(double *)x1) > fabs(*(double *)x2)); }
+inline bool my_compare_d(const void *x1, const void *x2)
+{
+    double a1 = fabs(*(double *)x1);
+    double a2 = fabs(*(double *)x2);
+    return (a1 > a2 || (a1 == a2 && x1 < x2));
+}
 
-inline bool my_compare_i(const void *x1, const void *x2) { return (abs(*(int *)x1) > abs(*(int *)x2)); }
+inline bool my_compare_i(const void *x1, const void *x2)
+{
+    int a1 = abs(*(int *)x1);
+    int a2 = abs(*(int *)x2);
+    return (a1 > a2 || (a1 == a2 && x1 < x2));
+}
 
-inline bool my_compare_l(const void *x1, const void *x2) { return (labs(*(long *)x1) > labs(*(long *)x2)); }
+inline bool my_compare_l(const void *x1, const void *x2)
+{
+    long a1 = labs(*(long *)x1);
+    long a2 = labs(*(long *)x2);
+    return (a1 > a2 || (a1 == a2 && x1 < x2));
+}
 
 namespace {
 
+// Partition the coefficient index array so that the n largest
+// coefficients (as ordered by my_compare) occupy the first n elements,
+// and the remainder follow. The order within each partition is unspecified.
+// If full_sort is true the entire array is sorted, otherwise a linear time
+// selection algorithm is used.
+//
+void partition_coeffs(vector<void *>::iterator first, vector<void *>::iterator nth, vector<void *>::iterator last, bool full_sort, bool my_compare(const void *, const void *))
+{
+    if (nth == first || nth >= last) return;
+
+    if (full_sort) {
+        sort(first, last, my_compare);
+    } else {
+        nth_element(first, nth, last, my_compare);
+    }
+}
+
 template<class T>
 int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_arr_len, T *C, size_t clen, size_t *L, SignificanceMap *sigmap, const vector<size_t> &dims, size_t nlevels,
-                      vector<void *> indexvec, bool my_compare(const void *, const void *))
+                      vector<void *> &indexvec, bool my_compare(const void *, const void *))
 {
     if (!C) {
         Compressor::SetErrMsg("Invalid state");
@@ -166,9 +207,9 @@ int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_
 
     sigmap->Clear();
 
-    // Data has been transformed. Now we need to sort it and find
-    // the threshold value. Note: we don't actually move the data. We
-    // sort an index array that references the data array.
+    // Data has been transformed. Now we need to find the threshold
+    // value. Note: we don't actually move the data. We partition an index
+    // array that references the data array.
 
     for (size_t i = 0; i < dst_arr_len; i++) dst_arr[i] = 0.0;
 
@@ -187,7 +228,7 @@ int compress_template(Compressor *cmp, const T *src_arr, T *dst_arr, size_t dst_
 
     indexvec.clear();
     for (size_t i = numkeep; i < clen; i++) indexvec.push_back(&C[i]);
-    sort(indexvec.begin(), indexvec.end(), my_compare);
+    partition_coeffs(indexvec.begin(), indexvec.begin() + dst_arr_len, indexvec.end(), cmp->FullSortOnOff(), my_compare);
 
     // Copy coefficients that are larger than the threshold to
     // the destination array. Record their location in the significance
@@ -306,7 +347,7 @@ int Compressor::Decompress(const long *src_arr, long *dst_arr, SignificanceMap *
 namespace {
 template<class T>
 int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vector<size_t> &dst_arr_lens, T *C, size_t clen, size_t *L, vector<SignificanceMap> &sigmaps, const vector<size_t> &dims,
-                       size_t nlevels, vector<void *> indexvec, bool my_compare(const void *, const void *))
+                       size_t nlevels, vector<void *> &indexvec, bool my_compare(const void *, const void *))
 {
     if (!C) {
         Compressor::SetErrMsg("Invalid state");
@@ -361,9 +402,9 @@ int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vect
         sigmaps[i].Clear();
     }
 
-    // Data has been transformed. Now we need to sort it and find
-    // the threshold value. Note: we don't actually move the data. We
-    // sort an index array that references the data array.
+    // Data has been transformed. Now we need to find the threshold
+    // values. Note: we don't actually move the data. We partition an
+    // index array that references the data array.
 
     for (size_t i = 0; i < tlen; i++) dst_arr[i] = 0.0;
 
@@ -381,15 +422,20 @@ int decompose_template(Compressor *cmp, const T *src_arr, T *dst_arr, const vect
     }
 
     //
-    // sort the **indecies** of the coefficients based on the
-    // coefficient's magnitude
+    // Partition the **indecies** of the coefficients based on the
+    // coefficient's magnitude. Each successive selection places the next
+    // my_dst_arr_lens[j] largest coefficients in order. With a full sort
+    // the first pass orders everything and the rest are no-ops.
     //
     indexvec.clear();
     for (size_t i = numkeep; i < clen; i++) indexvec.push_back(&C[i]);
-    sort(indexvec.begin(), indexvec.end(), my_compare);
+
+    bool full_sort = cmp->FullSortOnOff();
+    if (full_sort) sort(indexvec.begin(), indexvec.end(), my_compare);
 
     vector<void *>::iterator itr = indexvec.begin();
     for (int j = 0, idx = 0; j < my_dst_arr_lens.size(); j++) {
+        if (!full_sort) partition_coeffs(itr, itr + my_dst_arr_lens[j], indexvec.end(), false, my_compare);
         sort(itr, itr + my_dst_arr_lens[j]);    // sort coefficient's indecies
         itr += my_dst_arr_lens[j];
         for (int i = 0; i < my_dst_arr_lens[j]; i++, idx++) {
@@ -11,6 +11,20 @@
     #define isfinite _finite
 #endif
 
+// Mark a loop as free of dependencies between iterations. The wasp library
+// is not built with OpenMP, so "omp simd" would be an unknown pragma; use
+// the compiler's own equivalent instead.
+//
+#if defined(__clang__)
+    #define VAPOR_LOOP_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+    #define VAPOR_LOOP_IVDEP _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+    #define VAPOR_LOOP_IVDEP __pragma(loop(ivdep))
+#else
+    #define VAPOR_LOOP_IVDEP
+#endif
+
 using namespace VAPoR;
 using namespace Wasp;
 
@@ -381,11 +395,305 @@ template<class T, class U> void transpose(const T *a, U *b, size_t p1, size_t p2
 
 template<class T, class U> void transpose(const T *a, U *b, size_t s1, size_t s2) { transpose(a, b, 0, 0, s1, s2, s1, s2); }
 
+/*-------------------------------------------
+ * Lifting scheme
+ *-----------------------------------------*/
+
+//
+// Lifting factorization of an odd length, symmetric biorthogonal filter
+// pair. Even indexed samples become approximation coefficients and odd
+// indexed samples become detail coefficients. Lifting steps alternate,
+// starting with a predict step that updates the odd samples from their
+// even neighbors, followed by an update step that modifies the even samples
+// from their odd neighbors. Finally the even and odd samples are scaled by
+// ka and kd, respectively.
+//
+// Whole sample symmetric extension (symw) is preserved by every lifting
+// step, so the boundaries are handled by simply reflecting the neighbor
+// index.
+//
+// See I. Daubechies and W. Sweldens, "Factoring Wavelet Transforms into
+// Lifting Steps", J. Fourier Anal. Appl., 1998
+//
+struct lifting_t {
+    int    nsteps;
+    double steps[4];
+    double ka;
+    double kd;
+};
+
+// bior2.2, a.k.a. CDF 5/3
+//
+const lifting_t lifting_bior22 = {2, {-0.5, 0.25}, 1.4142135623730950488016887242097, -0.7071067811865475244008443621048};
+
+// bior4.4, a.k.a. CDF 9/7
+//
+const lifting_t lifting_bior44 = {4, {-1.586134342059924, -0.052980118572961, 0.882911075530934, 0.443506852043971}, 1.149604398860245, -0.869864451624778};
+
+//
+// Return the lifting scheme that computes the same transform as the
+// current wavelet and boundary extension mode, or NULL if there is none
+//
+template<class T> const lifting_t *lifting_scheme(MatWaveDwt *dwt, const T *)
+{
+    if (!dwt->LiftingOnOff()) return (NULL);
+    if (std::numeric_limits<T>::is_integer) return (NULL);
+    if (dwt->dwtmodeenum() != MatWaveBase::SYMW) return (NULL);
+
+    if (dwt->wavelet_name() == "bior2.2") return (&lifting_bior22);
+    if (dwt->wavelet_name() == "bior4.4") return (&lifting_bior44);
+    return (NULL);
+}
+
+//
+// Perform the lifting steps on a single signal that has been split into
+// its even (s) and odd (d) samples. ns is either equal to nd, or nd + 1
+// for odd length signals.
+//
+template<class T> void lift_line(T *s, T *d, size_t ns, size_t nd, const lifting_t &ls, bool inverse)
+{
+    if (inverse) {
+        const T ska = (T)(1.0 / ls.ka);
+        const T skd = (T)(1.0 / ls.kd);
+        for (size_t i = 0; i < ns; i++) s[i] *= ska;
+        for (size_t i = 0; i < nd; i++) d[i] *= skd;
+    }
+
+    for (int k = 0; k < ls.nsteps; k++) {
+        int     step = inverse ? ls.nsteps - 1 - k : k;
+        const T c = (T)(inverse ? -ls.steps[step] : ls.steps[step]);
+
+        if (step % 2 == 0) {
+            // Predict: d[i] += c * (s[i] + s[i+1])
+            //
+            size_t n = ns - 1;
+            for (size_t i = 0; i < n; i++) d[i] += c * (s[i] + s[i + 1]);
+            if (nd == ns) d[nd - 1] += c * (s[ns - 1] + s[ns - 1]);
+        } else {
+            // Update: s[i] += c * (d[i-1] + d[i])
+            //
+            s[0] += c * (d[0] + d[0]);
+            for (size_t i = 1; i < nd; i++) s[i] += c * (d[i - 1] + d[i]);
+            if (ns > nd) s[ns - 1] += c * (d[nd - 1] + d[nd - 1]);
+        }
+    }
+
+    if (!inverse) {
+        const T ka = (T)ls.ka;
+        const T kd = (T)ls.kd;
+        for (size_t i = 0; i < ns; i++) s[i] *= ka;
+        for (size_t i = 0; i < nd; i++) d[i] *= kd;
+    }
+}
+
+//
+// Perform the lifting steps in place on n interleaved rows of width w,
+// separated by stride elements. Even indexed rows hold the approximation
+// coefficients, odd indexed rows the detail coefficients. All w signals
+// are processed simultaneously, with unit stride inner loops over the
+// row, avoiding the need to transpose the data. Rows that are updated
+// never alias the rows they are updated from.
+//
+template<class T> void lift_rows(T *x, size_t n, size_t stride, size_t w, const lifting_t &ls, bool inverse)
+{
+    if (inverse) {
+        const T ska = (T)(1.0 / ls.ka);
+        const T skd = (T)(1.0 / ls.kd);
+        for (size_t j = 0; j < n; j++) {
+            T *     row = x + j * stride;
+            const T k = j % 2 ? skd : ska;
+            VAPOR_LOOP_IVDEP
+            for (size_t i = 0; i < w; i++) row[i] *= k;
+        }
+    }
+
+    for (int k = 0; k < ls.nsteps; k++) {
+        int     step = inverse ? ls.nsteps - 1 - k : k;
+        const T c = (T)(inverse ? -ls.steps[step] : ls.steps[step]);
+
+        for (size_t j = (step % 2 == 0) ? 1 : 0; j < n; j += 2) {
+            size_t l = j > 0 ? j - 1 : j + 1;
+            size_t r = j + 1 < n ? j + 1 : j - 1;
+
+            T *      row = x + j * stride;
+            const T *a = x + l * stride;
+            const T *b = x + r * stride;
+            VAPOR_LOOP_IVDEP
+            for (size_t i = 0; i < w; i++) row[i] += c * (a[i] + b[i]);
+        }
+    }
+
+    if (!inverse) {
+        const T ka = (T)ls.ka;
+        const T kd = (T)ls.kd;
+        for (size_t j = 0; j < n; j++) {
+            T *     row = x + j * stride;
+            const T k = j % 2 ? kd : ka;
+            VAPOR_LOOP_IVDEP
+            for (size_t i = 0; i < w; i++) row[i] *= k;
+        }
+    }
+}
+
+//
+// Forward transform of nrows contiguous rows of length nx along X. The
+// approximation coefficients for each row are returned in cA, and the
+// detail coefficients in cD, with row strides of nax and nx - nax,
+// respectively.
+//
+template<class T, class U> int lift_dwtx(const lifting_t &ls, const T *sigIn, size_t nx, size_t nrows, U *cA, U *cD, bool invalid_float_abort)
+{
+    size_t nax = (nx + 1) / 2;
+    size_t ndx = nx / 2;
+
+    for (size_t r = 0; r < nrows; r++) {
+        const T *row = sigIn + r * nx;
+        U *      s = cA + r * nax;
+        U *      d = cD + r * ndx;
+
+        for (size_t i = 0; i < ndx; i++) {
+            s[i] = row[2 * i];
+            d[i] = row[2 * i + 1];
+        }
+        if (nax > ndx) s[nax - 1] = row[nx - 1];
+
+        if (valid_float(s, nax, invalid_float_abort) < 0) return (-1);
+        if (valid_float(d, ndx, invalid_float_abort) < 0) return (-1);
+
+        lift_line(s, d, nax, ndx, ls, false);
+    }
+    return (0);
+}
+
+//
+// Inverse of lift_dwtx(). cA and cD are overwritten.
+//
+template<class T, class U> void lift_idwtx(const lifting_t &ls, T *cA, T *cD, size_t nx, size_t nrows, U *sigOut)
+{
+    size_t nax = (nx + 1) / 2;
+    size_t ndx = nx / 2;
+
+    for (size_t r = 0; r < nrows; r++) {
+        T *s = cA + r * nax;
+        T *d = cD + r * ndx;
+        U *row = sigOut + r * nx;
+
+        lift_line(s, d, nax, ndx, ls, true);
+
+        for (size_t i = 0; i < ndx; i++) {
+            row[2 * i] = (U)s[i];
+            row[2 * i + 1] = (U)d[i];
+        }
+        if (nax > ndx) row[nx - 1] = (U)s[nax - 1];
+    }
+}
+
+//
+// Check that every dimension can be transformed
+//
+bool lift_valid(MatWaveDwt *dwt, const size_t *dims, int ndims)
+{
+    for (int i = 0; i < ndims; i++) {
+        if (dwt->wmaxlev(dims[i]) < 1) {
+            MatWaveDwt::SetErrMsg("Can't transform signal of length : %d", dims[i]);
+            return (false);
+        }
+    }
+    return (true);
+}
+
+//
+// Forward 2D (ndims == 2) or 3D (ndims == 3) transform. The X pass splits
+// each row into approximation and detail halves, stored in two separate
+// blocks of the work buffer. The Y and Z passes are then performed in
+// place on each block, leaving the coefficients interleaved along Y and
+// Z, which are finally copied to the sub-bands. The sub-bands are ordered
+// as the convolution transforms order them: for 3D LLL, LLH, LHL, LHH, HLL,
+// HLH, HHL, HHH, where the letters refer to the X, Y, and Z axes,
+// respectively, and for 2D LL, LH, HL, HH.
+//
+template<class T, class U> int lift_dwtnd(const lifting_t &ls, const T *sigIn, const size_t dims[3], int ndims, U *subbands[8], SmartBuf &sbuf, bool invalid_float_abort)
+{
+    size_t nx = dims[0];
+    size_t ny = dims[1];
+    size_t nz = ndims == 3 ? dims[2] : 1;
+    size_t na[3] = {(nx + 1) / 2, (ny + 1) / 2, (nz + 1) / 2};
+    size_t nd[3] = {nx / 2, ny / 2, nz / 2};
+
+    U *buf = (U *)sbuf.Alloc(sizeof(U) * nx * ny * nz);
+    U *blocks[2] = {buf, buf + na[0] * ny * nz};
+
+    int rc = lift_dwtx(ls, sigIn, nx, ny * nz, blocks[0], blocks[1], invalid_float_abort);
+    if (rc < 0) return (-1);
+
+    for (int xb = 0; xb < 2; xb++) {
+        size_t w = xb ? nd[0] : na[0];
+
+        for (size_t z = 0; z < nz; z++) { lift_rows(blocks[xb] + z * w * ny, ny, w, w, ls, false); }
+        if (ndims == 3) lift_rows(blocks[xb], nz, w * ny, w * ny, ls, false);
+
+        for (size_t z = 0; z < nz; z++) {
+            for (size_t y = 0; y < ny; y++) {
+                int    yb = y % 2;
+                int    zb = z % 2;
+                size_t nyb = yb ? nd[1] : na[1];
+                U *    dst = ndims == 3 ? subbands[xb * 4 + yb * 2 + zb] : subbands[xb * 2 + yb];
+                dst += ((z / 2) * nyb + (y / 2)) * w;
+
+                const U *src = blocks[xb] + (z * ny + y) * w;
+                for (size_t i = 0; i < w; i++) dst[i] = src[i];
+            }
+        }
+    }
+    return (0);
+}
+
+//
+// Inverse of lift_dwtnd()
+//
+template<class T, class U> int lift_idwtnd(const lifting_t &ls, const T *const subbands[8], const size_t dims[3], int ndims, U *sigOut, SmartBuf &sbuf, bool invalid_float_abort)
+{
+    size_t nx = dims[0];
+    size_t ny = dims[1];
+    size_t nz = ndims == 3 ? dims[2] : 1;
+    size_t na[3] = {(nx + 1) / 2, (ny + 1) / 2, (nz + 1) / 2};
+    size_t nd[3] = {nx / 2, ny / 2, nz / 2};
+
+    U *buf = (U *)sbuf.Alloc(sizeof(U) * nx * ny * nz);
+    U *blocks[2] = {buf, buf + na[0] * ny * nz};
+
+    for (int xb = 0; xb < 2; xb++) {
+        size_t w = xb ? nd[0] : na[0];
+
+        for (size_t z = 0; z < nz; z++) {
+            for (size_t y = 0; y < ny; y++) {
+                int      yb = y % 2;
+                int      zb = z % 2;
+                size_t   nyb = yb ? nd[1] : na[1];
+                const T *src = ndims == 3 ? subbands[xb * 4 + yb * 2 + zb] : subbands[xb * 2 + yb];
+                src += ((z / 2) * nyb + (y / 2)) * w;
+
+                U *dst = blocks[xb] + (z * ny + y) * w;
+                for (size_t i = 0; i < w; i++) dst[i] = (U)src[i];
+            }
+        }
+
+        int rc = valid_float(blocks[xb], w * ny * nz, invalid_float_abort);
+        if (rc < 0) return (-1);
+
+        if (ndims == 3) lift_rows(blocks[xb], nz, w * ny, w * ny, ls, true);
+        for (size_t z = 0; z < nz; z++) { lift_rows(blocks[xb] + z * w * ny, ny, w, w, ls, true); }
+    }
+
+    lift_idwtx(ls, blocks[0], blocks[1], nx, ny * nz, sigOut);
+    return (0);
+}
+
 };    // namespace
 
-MatWaveDwt::MatWaveDwt(const string &wname, const string &mode) : MatWaveBase(wname, mode) {}
+MatWaveDwt::MatWaveDwt(const string &wname, const string &mode) : MatWaveBase(wname, mode) { _lifting = true; }
 
-MatWaveDwt::MatWaveDwt(const string &wname) : MatWaveBase(wname) {}
+MatWaveDwt::MatWaveDwt(const string &wname) : MatWaveBase(wname) { _lifting = true; }
 
 MatWaveDwt::~MatWaveDwt() {}
 
@@ -410,6 +718,9 @@ int dwt_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInLen, const WaveFil
     L[1] = dwt->detaillength(sigInLen);
     L[2] = sigInLen;
 
+    const lifting_t *ls = lifting_scheme(dwt, cA);
+    if (ls) return (lift_dwtx(*ls, sigIn, sigInLen, 1, cA, cD, dwt->InvalidFloatAbortOnOff()));
+
     int filterLen = wf->GetLength();
 
     //
@@ -566,6 +877,19 @@ int idwt_template(MatWaveDwt *dwt, const T *cA, const T *cD, const size_t L[3],
         return (-1);
     }
 
+    const lifting_t *ls = lifting_scheme(dwt, sigOut);
+    if (ls) {
+        U *buf = (U *)sbuf.Alloc(sizeof(U) * (L[0] + L[1]));
+        for (size_t i = 0; i < L[0]; i++) buf[i] = (U)cA[i];
+        for (size_t i = 0; i < L[1]; i++) buf[L[0] + i] = (U)cD[i];
+
+        int rc = valid_float(buf, L[0] + L[1], dwt->InvalidFloatAbortOnOff());
+        if (rc < 0) return (-1);
+
+        lift_idwtx(*ls, buf, buf + L[0], L[2], 1, sigOut);
+        return (0);
+    }
+
     int filterLen = wf->GetLength();
 
     bool                   do_sym_conv = false;
@@ -803,6 +1127,15 @@ int dwt2d_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInX, size_t sigInY
     L[8] = sigInX;
     L[9] = sigInY;
 
+    const lifting_t *ls = lifting_scheme(dwt, cA);
+    if (ls) {
+        size_t dims[] = {sigInX, sigInY, 1};
+        if (!lift_valid(dwt, dims, 2)) return (-1);
+
+        U *subbands[8] = {cA, cDh, cDv, cDd};
+        return (lift_dwtnd(*ls, sigIn, dims, 2, subbands, sbuf2d, dwt->InvalidFloatAbortOnOff()));
+    }
+
     // First: transform rows
     //
     size_t passXLen = (L[0] + L[4]) * sigInY;
@@ -956,6 +1289,13 @@ int idwt2d_template(MatWaveDwt *dwt, const T *cA, const T *cDh, const T *cDv, co
         return (-1);
     }
 
+    const lifting_t *ls = lifting_scheme(dwt, sigOut);
+    if (ls) {
+        size_t   dims[] = {L[8], L[9], 1};
+        const T *subbands[8] = {cA, cDh, cDv, cDd};
+        return (lift_idwtnd(*ls, subbands, dims, 2, sigOut, sbuf2d, dwt->InvalidFloatAbortOnOff()));
+    }
+
     size_t passYLen = max(L[0], L[4]) * (L[1] + L[3]);
     size_t transposeLen = max(L[0], L[4]) * L[9];
     size_t passXLen = (L[0] + L[4]) * L[9];
@@ -1240,6 +1580,15 @@ int dwt3d_template(MatWaveDwt *dwt, const T *sigIn, size_t sigInX, size_t sigInY
     T *cHHL = cHLH + L[15] * L[16] * L[17];
     T *cHHH = cHHL + L[18] * L[19] * L[20];
 
+    const lifting_t *ls = lifting_scheme(dwt, C);
+    if (ls) {
+        size_t dims[] = {sigInX, sigInY, sigInZ};
+        if (!lift_valid(dwt, dims, 3)) return (-1);
+
+        T *subbands[8] = {cLLL, cLLH, cLHL, cLHH, cHLL, cHLH, cHHL, cHHH};
+        return (lift_dwtnd(*ls, sigIn, dims, 3, subbands, sbuf3d1, dwt->InvalidFloatAbortOnOff()));
+    }
+
     // First: transform XY planes
     //
     size_t passXYLen = (L[0] + L[12]) * (L[1] + L[7]) * sigInZ;
@@ -1369,6 +1718,13 @@ int idwt3d_template(MatWaveDwt *dwt, const T *cLLL, const T *cLLH, const T *cLHL
         return (-1);
     }
 
+    const lifting_t *ls = lifting_scheme(dwt, sigOut);
+    if (ls) {
+        size_t   dims[] = {L[24], L[25], L[26]};
+        const T *subbands[8] = {cLLL, cLLH, cLHL, cLHH, cHLL, cHLH, cHHL, cHHH};
+        return (lift_idwtnd(*ls, subbands, dims, 3, sigOut, sbuf3d1, dwt->InvalidFloatAbortOnOff()));
+    }
+
     size_t passXYLen = (L[0] + L[12]) * (L[1] + L[7]) * L[26];
 
     V *buf3d1 = (V *)sbuf3d1.Alloc(sizeof(dummy) * passXYLen);
@@ -2,6 +2,9 @@
 #include <sstream>
 #include <sstream>
 #include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <sys/stat.h>
 #include "vapor/utils.h"
 #include "vapor/MatWaveBase.h"
@@ -216,17 +219,41 @@ public:
     unsigned char *      _maps;           // private (not shared)
     int                  _level;
     bool                 _unblock_flag;    // unblock the data after reconstruction?
-    static int           _status;          // error indicator
+    string               _range_varname;   // block range variable, if any
+    std::mutex *         _io_mutex;        // application's NetCDF lock, if any
+
+    // Blocks [_first, _last) were fetched into _slabs by the calling
+    // thread (see FetchBlocksCompressed()), and can be decoded without
+    // taking the NetCDF lock. Unused if _slabs is empty
+    //
+    vector<unsigned char *> _slabs;
+    size_t                  _first;
+    size_t                  _last;
+    static int              _status;    // error indicator
 
     thread_state(int id, EasyThreads *et, int nthreads, string &varname, const vector<NetCDFCpp *> &ncdfcptrs, const vector<size_t> &start, const vector<size_t> &count, const vector<size_t> &bs,
                  const vector<size_t> &udims, const vector<size_t> &ncoeffs, const vector<size_t> &encoded_dims, const vector<Compressor *> &compressors, void *data, int data_type,
                  unsigned char *mask, void *block, void *coeffs, int block_type, int xtype, unsigned char *maps, int level, bool unblock_flag)
     : _id(id), _et(et), _nthreads(nthreads), _varname(varname), _ncdfcptrs(ncdfcptrs), _start(start), _count(count), _bs(bs), _udims(udims), _ncoeffs(ncoeffs), _encoded_dims(encoded_dims),
       _compressors(compressors), _data(data), _data_type(data_type), _mask(mask), _block(block), _coeffs(coeffs), _block_type(block_type), _xtype(xtype), _maps(maps), _level(level),
-      _unblock_flag(unblock_flag)
+      _unblock_flag(unblock_flag), _io_mutex(NULL), _first(0), _last(0)
     {
         _status = 0;
     }
+
+    // Acquire exclusive access to the NetCDF library
+    //
+    void IOLock()
+    {
+        _et->MutexLock();
+        if (_io_mutex) _io_mutex->lock();
+    }
+
+    void IOUnlock()
+    {
+        if (_io_mutex) _io_mutex->unlock();
+        _et->MutexUnlock();
+    }
 };
 int thread_state::_status = 0;
 
@@ -433,8 +460,10 @@ vector<size_t> vdiff(vector<size_t> a, vector<size_t> b)
 // block : pointer to start of block where data should be copied
 // bs : dimensions of block.
 // min, max : range of data values within block
+// nvalid : if not NULL, the number of values within the block not
+// excluded by 'mask'
 //
-template<class T, class U> void Block(const T *data, const unsigned char *mask, vector<size_t> dims, vector<size_t> start, U *block, vector<size_t> bs, string mode, U &min, U &max)
+template<class T, class U> void Block(const T *data, const unsigned char *mask, vector<size_t> dims, vector<size_t> start, U *block, vector<size_t> bs, string mode, U &min, U &max, size_t *nvalid = NULL)
 {
     min = 0;
     max = 0;
@@ -494,6 +523,7 @@ template<class T, class U> void Block(const T *data, const unsigned char *mask,
     double ave = 0.0;
     min = (U)data[0];
     max = (U)data[0];
+    if (nvalid) *nvalid = xstop * ystop * zstop;
     if (mask) {
         size_t n = 0;
         double total = 0.0;
@@ -511,6 +541,7 @@ template<class T, class U> void Block(const T *data, const unsigned char *mask,
             }
         }
         if (n) { ave = total / (double)n; }
+        if (nvalid) *nvalid = n;
     }
 
     // copy data to block and handle mask if there is one
@@ -568,6 +599,54 @@ template<class T, class U> void Block(const T *data, const unsigned char *mask,
     }
 }
 
+// Compute the range of the values of a single block of an array that are
+// not excluded by a mask, without copying the block. Arguments are as
+// for Block().
+//
+// min, max : range of unmasked data values within block
+// nvalid : the number of unmasked values within the block
+//
+template<class T> void MaskedBlockRange(const T *data, const unsigned char *mask, vector<size_t> dims, vector<size_t> start, vector<size_t> bs, T &min, T &max, size_t &nvalid)
+{
+    min = 0;
+    max = 0;
+    nvalid = 0;
+
+    size_t offset = linearize_coords(start, dims);
+    data += offset;
+    mask += offset;
+
+    while (bs.size() && bs[0] == 1) {
+        bs.erase(bs.begin());
+        dims.erase(dims.begin());
+        start.erase(start.begin());
+    }
+
+    int rank = bs.size();
+
+    size_t nx = rank >= 1 ? dims[rank - 1] : 1;
+    size_t ny = rank >= 2 ? dims[rank - 2] : 1;
+
+    size_t xstop = rank >= 1 ? std::min(bs[rank - 1], dims[rank - 1] - start[rank - 1]) : 1;
+    size_t ystop = rank >= 2 ? std::min(bs[rank - 2], dims[rank - 2] - start[rank - 2]) : 1;
+    size_t zstop = rank >= 3 ? std::min(bs[rank - 3], dims[rank - 3] - start[rank - 3]) : 1;
+
+    for (size_t z = 0; z < zstop; z++) {
+        for (size_t y = 0; y < ystop; y++) {
+            for (size_t x = 0; x < xstop; x++) {
+                size_t index = nx * ny * z + nx * y + x;
+                if (!mask[index]) continue;
+
+                T v = data[index];
+                if (nvalid == 0) min = max = v;
+                if (v < min) min = v;
+                if (v > max) max = v;
+                nvalid++;
+            }
+        }
+    }
+}
+
 // Copy a block of blocked data into a contiguous array (unblocking
 // the data). Handles 1D, 2D, and 3D arrays
 //
@@ -776,6 +855,30 @@ int StoreBlock(string varname, NetCDFCpp *ncdfcptr, vector<size_t> bcoords, size
     return (0);
 }
 
+// Record the range of values of a single block, if the file has a
+// block range variable for 'varname'
+//
+// varname : name of variable
+// ncdfcptr : NetCDFCpp file pointer to base file
+// bcoords : coordinates of block
+// nvalid : number of unmasked values in block. The range is NaN if zero
+//
+template<class T> int StoreBlockRange(string varname, NetCDFCpp *ncdfcptr, vector<size_t> bcoords, T min, T max, size_t nvalid)
+{
+    if (varname.empty()) return (0);
+
+    vector<size_t> start = bcoords;
+    start.push_back(0);
+
+    vector<size_t> count(start.size(), 1);
+    count[count.size() - 1] = 2;
+
+    double range[] = {(double)min, (double)max};
+    if (!nvalid) range[0] = range[1] = std::numeric_limits<double>::quiet_NaN();
+
+    return (ncdfcptr->NetCDFCpp::PutVara(varname, start, count, range));
+}
+
 // Write a single transformed & compressed block to disk
 //
 // varname : name of variable
@@ -968,6 +1071,91 @@ int FetchBlockCompressed(string varname, vector<NetCDFCpp *> ncdfcptrs, vector<s
     return (0);
 }
 
+// Convert 'n' values of external type 'xtype', read without conversion
+// from disk, to type T. Returns false if 'xtype' isn't supported
+//
+template<class T> bool ConvertXType(const unsigned char *src, int xtype, size_t n, T *dst)
+{
+    switch (xtype) {
+    case NC_FLOAT: std::copy((const float *)src, (const float *)src + n, dst); return (true);
+    case NC_DOUBLE: std::copy((const double *)src, (const double *)src + n, dst); return (true);
+    case NC_INT: std::copy((const int *)src, (const int *)src + n, dst); return (true);
+    case NC_INT64: std::copy((const long long *)src, (const long long *)src + n, dst); return (true);
+    case NC_SHORT: std::copy((const int16_t *)src, (const int16_t *)src + n, dst); return (true);
+    default: return (false);
+    }
+}
+
+bool IsStagingXType(int xtype) { return (xtype == NC_FLOAT || xtype == NC_DOUBLE || xtype == NC_INT || xtype == NC_INT64 || xtype == NC_SHORT); }
+
+// Read the encoded blocks in the block coordinate range [bstart,
+// bstart+bcount) for every compression level with a single read per
+// file. The blocks for file i are stored contiguously in 'slabs[i]', in
+// row major block order, each occupying encoded_dims[i] words of
+// external type 'xtype'
+//
+int FetchBlocksCompressed(string varname, vector<NetCDFCpp *> ncdfcptrs, vector<size_t> bstart, vector<size_t> bcount, vector<size_t> encoded_dims, const vector<unsigned char *> &slabs)
+{
+    VAssert(ncdfcptrs.size() >= encoded_dims.size());
+    VAssert(slabs.size() >= encoded_dims.size());
+
+    vector<size_t> start = bstart;
+    vector<size_t> count = bcount;
+    start.push_back(0);
+    count.push_back(0);
+
+    for (int i = 0; i < encoded_dims.size(); i++) {
+        count[count.size() - 1] = encoded_dims[i];
+
+        int rc = ncdfcptrs[i]->NetCDFCpp::GetVara(varname, start, count, (void *)slabs[i]);
+        if (rc < 0) return (rc);
+    }
+    return (0);
+}
+
+// Extract block 'index' from slabs read with FetchBlocksCompressed().
+// Arguments and results are as for FetchBlockCompressed()
+//
+template<class T>
+int ExtractBlockCompressed(const vector<unsigned char *> &slabs, size_t index, vector<size_t> ncoeffs, vector<size_t> encoded_dims, T *coeffs, T *datarange, unsigned char *maps, int xtype)
+{
+    unsigned long LSBTest = 1;
+    bool          do_swapbytes = false;
+    if (!(*(char *)&LSBTest)) {
+        // swap to MSBFirst
+        do_swapbytes = true;
+    }
+
+    size_t xsize = NetCDFCpp::SizeOf(xtype);
+
+    for (int i = 0; i < ncoeffs.size(); i++) {
+        const unsigned char *ptr = slabs[i] + index * encoded_dims[i] * xsize;
+
+        // Header (first two elements contain data range)
+        //
+        if (i == 0) {
+            if (!ConvertXType(ptr, xtype, BLK_HDR_SZ, datarange)) return (-1);
+            ptr += BLK_HDR_SZ * xsize;
+        }
+
+        if (!ConvertXType(ptr, xtype, ncoeffs[i], coeffs)) return (-1);
+        ptr += ncoeffs[i] * xsize;
+        coeffs += ncoeffs[i];
+
+        VAssert(encoded_dims[i] >= ncoeffs[i]);
+        size_t n = encoded_dims[i] - ncoeffs[i];
+        if (i == 0) n -= BLK_HDR_SZ;
+
+        if (n != 0) {
+            memcpy(maps, ptr, n * xsize);
+            if (do_swapbytes) { swapbytes((void *)maps, xsize, n); }
+
+            maps += n * xsize;
+        }
+    }
+    return (0);
+}
+
 template<class T> void *RunWriteThreadTemplate(thread_state &s, T dummy)
 {
     vectorinc vec(s._start, s._count, s._udims, s._bs);
@@ -993,8 +1181,13 @@ template<class T> void *RunWriteThreadTemplate(thread_state &s, T dummy)
         // Extract the block with coordinates 'start' from the
         // array, 'data'.
         //
-        T min, max;
-        Block((T *)s._data, NULL, s._count, roi_start, (T *)s._block, s._bs, "symh", min, max);
+        // Blocks are stored unmodified, so the mask only restricts the
+        // recorded range
+        //
+        T      min, max;
+        size_t nvalid;
+        Block((T *)s._data, NULL, s._count, roi_start, (T *)s._block, s._bs, "symh", min, max, &nvalid);
+        if (s._mask) MaskedBlockRange((T *)s._data, s._mask, s._count, roi_start, s._bs, min, max, nvalid);
 
         // Convert from voxel to block coordinates
         //
@@ -1007,10 +1200,11 @@ template<class T> void *RunWriteThreadTemplate(thread_state &s, T dummy)
         // NetCDF library is not thread safe
         //
         //
-        s._et->MutexLock();
+        s.IOLock();
         int rc = StoreBlock(s._varname, s._ncdfcptrs[0], bcoords, s._encoded_dims[0], (T *)s._block);
+        if (rc >= 0) rc = StoreBlockRange(s._range_varname, s._ncdfcptrs[0], bcoords, min, max, nvalid);
         if (rc < 0) { s._status = -1; }
-        s._et->MutexUnlock();
+        s.IOUnlock();
         if (s._status < 0) break;
     }
     return (0);
@@ -1069,8 +1263,9 @@ template<class T, class U> void *RunWriteThreadCompressedTemplate(thread_state &
         // Extract the block with coordinates 'start' from the
         // array, 'data'.
         //
-        U datarange[2];
-        Block((T *)s._data, s._mask, s._count, roi_start, (U *)s._block, s._bs, s._compressors[s._id]->dwtmode(), datarange[0], datarange[1]);
+        U      datarange[2];
+        size_t nvalid;
+        Block((T *)s._data, s._mask, s._count, roi_start, (U *)s._block, s._bs, s._compressors[s._id]->dwtmode(), datarange[0], datarange[1], &nvalid);
 
         //
         // Wavelet transform the current block
@@ -1092,10 +1287,11 @@ template<class T, class U> void *RunWriteThreadCompressedTemplate(thread_state &
         // NetCDF library is not thread safe
         //
         //
-        s._et->MutexLock();
+        s.IOLock();
         rc = StoreBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+        if (rc >= 0) rc = StoreBlockRange(s._range_varname, s._ncdfcptrs[0], bcoords, datarange[0], datarange[1], nvalid);
         if (rc < 0) { s._status = -1; }
-        s._et->MutexUnlock();
+        s.IOUnlock();
         if (s._status < 0) break;
     }
     return (0);
@@ -1211,10 +1407,10 @@ template<class T> void *RunReadThreadTemplate(thread_state &s, T dummy)
         // Read wavelet coefficients from disk. Need a mutex because
         // NetCDF API is not thread safe
         //
-        s._et->MutexLock();
+        s.IOLock();
         int rc = FetchBlock(s._varname, s._ncdfcptrs[0], bcoords, s._encoded_dims[0], blockptr);
         if (rc < 0) s._status = -1;
-        s._et->MutexUnlock();
+        s.IOUnlock();
         if (s._status < 0) break;
 
         if (unblock_flag) {
@@ -1274,26 +1470,37 @@ template<class T, class U> void *RunReadThreadCompressedTemplate(thread_state &s
 
     s._status = 0;
 
-    int n = vec.num();
-    for (int i = s._id; i < n; i += s._nthreads) {
+    // Only blocks [first, last) if they have already been fetched
+    //
+    size_t first = s._slabs.empty() ? 0 : s._first;
+    size_t last = s._slabs.empty() ? vec.num() : s._last;
+    for (size_t i = first + s._id; i < last; i += s._nthreads) {
         size_t         offset;
         vector<size_t> start;
 
         vec.ith(i, start, offset);
 
-        vector<size_t> bcoords;
-        size_t         residual;
-        to_block_coords(start, s._bs, bcoords, residual);
-        VAssert(residual == 0);
+        U   datarange[2];
+        int rc;
+        if (!s._slabs.empty()) {
+            // Coefficients are already in memory. No lock needed
+            //
+            rc = ExtractBlockCompressed(s._slabs, i - first, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+            if (rc < 0) s._status = -1;
+        } else {
+            vector<size_t> bcoords;
+            size_t         residual;
+            to_block_coords(start, s._bs, bcoords, residual);
+            VAssert(residual == 0);
 
-        // Read wavelet coefficients from disk. Need a mutex because
-        // NetCDF API is not thread safe
-        //
-        U datarange[2];
-        s._et->MutexLock();
-        int rc = FetchBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
-        if (rc < 0) s._status = -1;
-        s._et->MutexUnlock();
+            // Read wavelet coefficients from disk. Need a mutex because
+            // NetCDF API is not thread safe
+            //
+            s.IOLock();
+            rc = FetchBlockCompressed(s._varname, s._ncdfcptrs, bcoords, s._ncoeffs, s._encoded_dims, (U *)s._coeffs, datarange, s._maps, s._xtype);
+            if (rc < 0) s._status = -1;
+            s.IOUnlock();
+        }
         if (s._status < 0) break;
 
         // Transform coordinates from global to the region-of-interest
@@ -1400,7 +1607,9 @@ WASP::WASP(int nthreads)
 
     _waspFile = false;
     _nthreads = 1;
-    _currentVersion = 3;
+    _currentVersion = 4;
+    _ioMutex = NULL;
+    _stagedReads = true;
     _fileVersion = 0;
 
     _open = false;
@@ -1725,6 +1934,24 @@ int WASP::DefVar(string name, int xtype, vector<string> dimnames, string wname,
         if (rc < 0) return (rc);
     }
 
+    // Range of values of each block, stored in the base file. Files
+    // created before version 4 don't have them
+    //
+    if (_fileVersion >= 4) {
+        size_t len;
+        rc = _InqDimlen(DimNameBlockRange(), len);
+        if (len == 0) {
+            rc = WASP::DefDim(DimNameBlockRange(), 2);
+            if (rc < 0) return (rc);
+        }
+
+        vector<string> rangedimnames = cdimnames;
+        rangedimnames.push_back(DimNameBlockRange());
+
+        rc = NetCDFCpp::DefVar(BlockRangeVarName(name), NC_DOUBLE, rangedimnames);
+        if (rc < 0) return (rc);
+    }
+
     // Attributes needed to encode or decode the variable later
     //
 
@@ -2012,6 +2239,59 @@ int WASP::InqVarCompressed(string varname, bool &compressed) const
     return (0);
 }
 
+bool WASP::_hasBlockRanges(string varname) const
+{
+    // disable error reporting otherwise an error is generated
+    // if the variable doesn't exist
+    //
+    bool enabled = MyBase::EnableErrMsg(false);
+
+    int varid;
+    int rc = NetCDFCpp::InqVarid(BlockRangeVarName(varname), varid);
+    if (rc < 0) WASP::SetErrCode(0);
+
+    (void)MyBase::EnableErrMsg(enabled);
+
+    return (rc >= 0);
+}
+
+int WASP::InqVarBlockRanges(string varname, vector<size_t> &bdims, vector<double> &ranges) const
+{
+    bdims.clear();
+    ranges.clear();
+
+    if (!_waspFile) {
+        SetErrMsg("Not a WASP file");
+        return (-1);
+    }
+
+    if (!_hasBlockRanges(varname)) return (0);
+
+    vector<string> dimnames;
+    vector<size_t> dims;
+    int            rc = NetCDFCpp::InqVarDims(BlockRangeVarName(varname), dimnames, dims);
+    if (rc < 0) return (rc);
+
+    VAssert(dims.size() >= 1 && dims.back() == 2);
+    dims.pop_back();
+
+    vector<double> buf(vproduct(dims) * 2);
+    rc = NetCDFCpp::GetVar(BlockRangeVarName(varname), buf.data());
+    if (rc < 0) return (rc);
+
+    // Blocks that were never written hold the fill value. Without a
+    // range for every block there is nothing to report
+    //
+    for (size_t i = 0; i < buf.size(); i++) {
+        if (buf[i] == NC_FILL_DOUBLE) return (0);
+    }
+
+    bdims = dims;
+    ranges = std::move(buf);
+
+    return (0);
+}
+
 int WASP::OpenVarWrite(string name, int lod)
 {
     vector<size_t> bs;
@@ -2319,13 +2599,24 @@ template<class T, class U> int WASP::_PutVara(vector<size_t> start, vector<size_
     //
     // Set up thread state for parallel (threaded) execution
     //
+    string rangeVarname = _hasBlockRanges(_open_varname) ? BlockRangeVarName(_open_varname) : "";
+
     vector<void *> argvec;
     for (int i = 0; i < _nthreads; i++) {
-        argvec.push_back((void *)new thread_state(i, _et, _nthreads, _open_varname, _ncdfcptrs, start, count, _open_bs, _open_udims, ncoeffs, encoded_dims, _open_compressors, (void *)data, data_type,
-                                                  (unsigned char *)mask, block + i * block_size, coeffs + i * coeffs_size, block_type, _open_varxtype,
-                                                  maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), 0, true));
+        thread_state *s = new thread_state(i, _et, _nthreads, _open_varname, _ncdfcptrs, start, count, _open_bs, _open_udims, ncoeffs, encoded_dims, _open_compressors, (void *)data, data_type,
+                                           (unsigned char *)mask, block + i * block_size, coeffs + i * coeffs_size, block_type, _open_varxtype,
+                                           maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), 0, true);
+        s->_range_varname = rangeVarname;
+        s->_io_mutex = _ioMutex;
+        argvec.push_back((void *)s);
     }
 
+    // Other application threads may use the NetCDF library while blocks
+    // are being transformed
+    //
+    if (_ioMutex) _ioMutex->unlock();
+
+    int rc = 0;
     if (_nthreads == 1) {
         if (_open_wname.empty()) {
             RunWriteThread(argvec[0]);
@@ -2333,17 +2624,18 @@ template<class T, class U> int WASP::_PutVara(vector<size_t> start, vector<size_
             RunWriteThreadCompressed(argvec[0]);
         }
     } else {
-        int rc;
         if (_open_wname.empty()) {
             rc = _et->ParRun(RunWriteThread, argvec);
         } else {
             rc = _et->ParRun(RunWriteThreadCompressed, argvec);
         }
+    }
 
-        if (rc < 0) {
-            SetErrMsg("Error spawning threads");
-            return (-1);
-        }
+    if (_ioMutex) _ioMutex->lock();
+
+    if (rc < 0) {
+        SetErrMsg("Error spawning threads");
+        return (-1);
     }
     for (int i = 0; i < argvec.size(); i++) delete (thread_state *)argvec[i];
 
@@ -2542,33 +2834,128 @@ template<class T, class U> int WASP::_GetVara(vector<size_t> start, vector<size_
     for (int i = 0; i < _nthreads; i++) {
         U *blkptr = block + i * block_size;
 
-        argvec.push_back((void *)new thread_state(i, _et, _nthreads, _open_varname, _ncdfcptrs, start, count, bs_at_level, dims_at_level, ncoeffs, encoded_dims, _open_compressors, data, data_type,
-                                                  NULL, blkptr, coeffs + i * coeffs_size, block_type, _open_varxtype, maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), _open_level,
-                                                  unblock_flag));
+        thread_state *s = new thread_state(i, _et, _nthreads, _open_varname, _ncdfcptrs, start, count, bs_at_level, dims_at_level, ncoeffs, encoded_dims, _open_compressors, data, data_type, NULL,
+                                           blkptr, coeffs + i * coeffs_size, block_type, _open_varxtype, maps + i * maps_size * NetCDFCpp::SizeOf(_open_varxtype), _open_level, unblock_flag);
+        s->_io_mutex = _ioMutex;
+        argvec.push_back((void *)s);
     }
 
-    if (_nthreads == 1) {
-        if (_open_wname.empty()) {
-            RunReadThread(argvec[0]);
+    int rc = 0;
+    if (!_open_wname.empty() && _stagedReads && IsStagingXType(_open_varxtype)) {
+        rc = _getVaraStaged(start, count, bs_at_level, encoded_dims, argvec);
+    } else {
+        // Other application threads may use the NetCDF library while
+        // blocks are being reconstructed
+        //
+        if (_ioMutex) _ioMutex->unlock();
+
+        if (_nthreads == 1) {
+            if (_open_wname.empty()) {
+                RunReadThread(argvec[0]);
+            } else {
+                RunReadThreadCompressed(argvec[0]);
+            }
         } else {
-            RunReadThreadCompressed(argvec[0]);
+            if (_open_wname.empty()) {
+                rc = _et->ParRun(RunReadThread, argvec);
+            } else {
+                rc = _et->ParRun(RunReadThreadCompressed, argvec);
+            }
         }
-    } else {
-        int rc;
-        if (_open_wname.empty()) {
-            rc = _et->ParRun(RunReadThread, argvec);
+
+        if (_ioMutex) _ioMutex->lock();
+
+        if (rc < 0) SetErrMsg("Error spawning threads");
+    }
+
+    for (int i = 0; i < argvec.size(); i++) delete (thread_state *)argvec[i];
+
+    if (rc < 0) return (-1);
+    return (thread_state::_status);
+}
+
+int WASP::_getVaraStaged(const vector<size_t> &start, const vector<size_t> &count, const vector<size_t> &bs, const vector<size_t> &encoded_dims, const vector<void *> &argvec)
+{
+    // Upper bound on the staging buffer, unless a single plane of blocks
+    // is larger. The buffer isn't kept between reads, as many WASP
+    // objects may be open at once (see VDCNetCDF::WASPPool)
+    //
+    const size_t maxStagingBytes = 64 * 1024 * 1024;
+
+    vector<size_t> aligned_start;
+    vector<size_t> aligned_count;
+    block_align(start, count, bs, aligned_start, aligned_count);
+
+    vector<size_t> bstart(bs.size());
+    vector<size_t> bcount(bs.size());
+    for (int i = 0; i < bs.size(); i++) {
+        bstart[i] = aligned_start[i] / bs[i];
+        bcount[i] = aligned_count[i] / bs[i];
+    }
+
+    // Blocks are read a plane at a time along the slowest varying
+    // dimension, so that each batch is a contiguous range of block
+    // indices in the order RunReadThreadCompressed() visits them
+    //
+    if (!vproduct(bcount)) return (0);
+
+    size_t xsize = NetCDFCpp::SizeOf(_open_varxtype);
+    size_t bytesPerBlock = vsum(encoded_dims) * xsize;
+    size_t nplanes = bcount.empty() ? 1 : bcount[0];
+    size_t blocksPerPlane = vproduct(bcount) / nplanes;
+    size_t planesPerBatch = std::max((size_t)1, maxStagingBytes / (blocksPerPlane * bytesPerBlock));
+    planesPerBatch = std::min(planesPerBatch, nplanes);
+
+    std::unique_ptr<unsigned char[]> staging(new unsigned char[planesPerBatch * blocksPerPlane * bytesPerBlock]);
+    unsigned char *                  stagebuf = staging.get();
+    vector<unsigned char *>          slabs;
+    for (int i = 0; i < encoded_dims.size(); i++) {
+        slabs.push_back(stagebuf);
+        stagebuf += planesPerBatch * blocksPerPlane * encoded_dims[i] * xsize;
+    }
+
+    for (size_t plane = 0; plane < nplanes; plane += planesPerBatch) {
+        size_t nbatch = std::min(planesPerBatch, nplanes - plane);
+
+        // Phase 1: a single, coalesced read per file. The caller holds
+        // the application's NetCDF lock, if any
+        //
+        vector<size_t> batch_start = bstart;
+        vector<size_t> batch_count = bcount;
+        if (!bcount.empty()) {
+            batch_start[0] += plane;
+            batch_count[0] = nbatch;
+        }
+        int rc = FetchBlocksCompressed(_open_varname, _ncdfcptrs, batch_start, batch_count, encoded_dims, slabs);
+        if (rc < 0) return (-1);
+
+        for (int i = 0; i < argvec.size(); i++) {
+            thread_state *s = (thread_state *)argvec[i];
+            s->_slabs = slabs;
+            s->_first = plane * blocksPerPlane;
+            s->_last = (plane + nbatch) * blocksPerPlane;
+        }
+
+        // Phase 2: decode in parallel without touching the NetCDF
+        // library, so other application threads may use it
+        //
+        if (_ioMutex) _ioMutex->unlock();
+
+        if (_nthreads == 1) {
+            RunReadThreadCompressed(argvec[0]);
         } else {
             rc = _et->ParRun(RunReadThreadCompressed, argvec);
         }
+
+        if (_ioMutex) _ioMutex->lock();
+
         if (rc < 0) {
             SetErrMsg("Error spawning threads");
             return (-1);
         }
+        if (thread_state::_status < 0) break;
     }
-
-    for (int i = 0; i < argvec.size(); i++) delete (thread_state *)argvec[i];
-
-    return (thread_state::_status);
+    return (0);
 }
 
 template<class T> int WASP::_GetVara(vector<size_t> start, vector<size_t> count, bool unblock_flag, T *data)
@@ -0,0 +1,100 @@
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <vapor/CFuncs.h>
+#include <vapor/MyBase.h>
+#include <vapor/ParamsMgr.h>
+#include <vapor/ViewpointParams.h>
+
+using namespace Wasp;
+using namespace VAPoR;
+
+// Benchmark for the ParamsMgr undo/redo state saving. A large session is
+// created with many visualizers, each holding a sizeable array, and then
+// NumEdits single value edits are made to randomly chosen visualizers. Every
+// edit saves the state tree on the undo stack. The edits are then undone and
+// redone, checking that each restores the expected value.
+//
+
+const string valueTag = "BenchmarkValue";
+
+string WinName(int i) { return ("window" + std::to_string(i)); }
+
+int main(int argc, char *argv[])
+{
+    if (argc > 4) {
+        std::cout << "Help:  This program creates a session with NumWindows (default 100)\n"
+                     "       visualizers, each with an array of ArraySize (default 10000)\n"
+                     "       values, and times NumEdits (default 10000) undoable edits\n"
+                     "       followed by undoing and redoing them.\n"
+                     "Usage: ./UndoBenchmark [NumEdits] [NumWindows] [ArraySize]\n";
+        return 1;
+    }
+    const int    nedits = argc > 1 ? std::stoi(argv[1]) : 10000;
+    const int    nwins = argc > 2 ? std::stoi(argv[2]) : 100;
+    const size_t arraySize = argc > 3 ? std::stol(argv[3]) : 10000;
+
+    MyBase::SetErrMsgFilePtr(stderr);
+
+    ParamsMgr pm;
+    pm.SetSaveStateEnabled(false);
+
+    for (int i = 0; i < nwins; i++) {
+        ViewpointParams *vp = pm.CreateVisualizerParamsInstance(WinName(i));
+        vp->SetValueDoubleVec("BenchmarkArray", "", vector<double>(arraySize, (double)i));
+        vp->SetValueDouble(valueTag, "", 0.0);
+    }
+
+    pm.SetSaveStateEnabled(true);
+    pm.UndoRedoClear();
+
+    // history[i] is the window edited by edit i, and the value it had
+    // before the edit
+    //
+    vector<std::pair<int, double>> history;
+    vector<double>                 values(nwins, 0.0);
+    std::mt19937                   rng(0);
+
+    double t0 = Wasp::GetTime();
+    for (int i = 0; i < nedits; i++) {
+        int win = rng() % nwins;
+        history.push_back(std::make_pair(win, values[win]));
+        values[win] = i + 1;
+        pm.GetViewpointParams(WinName(win))->SetValueDouble(valueTag, "Benchmark edit", values[win]);
+    }
+    double editTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    // Only the most recent edits are kept on the undo stack
+    //
+    const size_t nundo = pm.UndoSize();
+    bool         ok = nundo > 0 || nedits == 0;
+
+    t0 = Wasp::GetTime();
+    for (size_t i = 0; i < nundo && ok; i++) {
+        const std::pair<int, double> &h = history[history.size() - 1 - i];
+        ok = pm.Undo() && pm.GetViewpointParams(WinName(h.first))->GetValueDouble(valueTag, -1.0) == h.second;
+    }
+    double undoTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    if (!ok) std::cerr << "Undo restored the wrong state" << std::endl;
+
+    t0 = Wasp::GetTime();
+    for (size_t i = 0; i < nundo && ok; i++) {
+        int win = history[history.size() - nundo + i].first;
+        ok = pm.Redo() && pm.GetViewpointParams(WinName(win))->GetValueDouble(valueTag, -1.0) == (double)(nedits - nundo + i + 1);
+    }
+    double redoTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    if (!ok) std::cerr << "Redo restored the wrong state" << std::endl;
+
+    std::printf("%d windows, %zu values per window\n", nwins, arraySize);
+    std::printf("edit %10.1f ms (%d edits, %.3f ms per edit)\n", editTime, nedits, nedits ? editTime / nedits : 0.0);
+    std::printf("undo %10.1f ms (%zu undos)\n", undoTime, nundo);
+    std::printf("redo %10.1f ms (%zu redos)\n", redoTime, nundo);
+
+    return (ok ? 0 : 1);
+}
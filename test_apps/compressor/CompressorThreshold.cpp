@@ -0,0 +1,129 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "vapor/Compressor.h"
+#include "vapor/SignificanceMap.h"
+#include "vapor/CFuncs.h"
+
+// Compare the selection based coefficient thresholding in
+// Compressor::Decompose() against the original full sort, for a range of
+// block sizes and compression ratios. Verifies that both paths produce
+// identical coefficients and significance maps.
+//
+
+// Number of coefficients retained for each compression ratio, similar to
+// WASP::_get_encoding_vectors(), but clamped so that ratios too large for
+// small blocks still yield a valid decomposition
+//
+std::vector<size_t> GetNumCoeffs(VAPoR::Compressor &cmp, const std::vector<size_t> &cratios)
+{
+    size_t              ntotal = cmp.GetNumWaveCoeffs();
+    std::vector<size_t> ncoeffs;
+    size_t              naccum = 0;
+    for (size_t i = 0; i < cratios.size(); i++) {
+        size_t n = std::max(ntotal / cratios[i], cmp.GetMinCompression());
+        if (n <= naccum) n = naccum + 1;
+        n -= naccum;
+        naccum += n;
+        ncoeffs.push_back(n);
+    }
+    return (ncoeffs);
+}
+
+// Time nloops decompositions. Returns milliseconds
+//
+double Decompose(VAPoR::Compressor &cmp, const std::vector<float> &src, const std::vector<size_t> &ncoeffs, std::vector<float> &dst, std::vector<VAPoR::SignificanceMap> &sigmaps, int nloops)
+{
+    double t0 = Wasp::GetTime();
+    for (int i = 0; i < nloops; i++) {
+        if (cmp.Decompose(src.data(), dst.data(), ncoeffs, sigmaps) < 0) {
+            std::cerr << "Decompose() failed" << std::endl;
+            exit(1);
+        }
+    }
+    return ((Wasp::GetTime() - t0) * 1000.0);
+}
+
+bool Equal(const std::vector<float> &dst0, const std::vector<float> &dst1, std::vector<VAPoR::SignificanceMap> &sigmaps0, std::vector<VAPoR::SignificanceMap> &sigmaps1)
+{
+    if (dst0 != dst1) return (false);
+
+    for (size_t j = 0; j < sigmaps0.size(); j++) {
+        if (sigmaps0[j].GetNumSignificant() != sigmaps1[j].GetNumSignificant()) return (false);
+
+        sigmaps0[j].GetNextEntryRestart();
+        sigmaps1[j].GetNextEntryRestart();
+        for (size_t i = 0; i < sigmaps0[j].GetNumSignificant(); i++) {
+            size_t idx0, idx1;
+            sigmaps0[j].GetNextEntry(&idx0);
+            sigmaps1[j].GetNextEntry(&idx1);
+            if (idx0 != idx1) return (false);
+        }
+    }
+    return (true);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program measures the time taken by Compressor::Decompose() using\n"
+                     "       selection and full sort coefficient thresholding on random 3D blocks.\n"
+                     "Usage: ./CompressorThreshold [NumLoops]\n";
+        return 1;
+    }
+    const int nloops = argc == 2 ? std::stoi(argv[1]) : 10;
+
+    const std::vector<size_t>              bsizes = {16, 32, 64};
+    const std::vector<std::vector<size_t>> cratiosvec = {{500, 100, 10, 1}, {100}, {10}, {1}};
+
+    std::mt19937                          gen(0);
+    std::uniform_real_distribution<float> dist(-1.0, 1.0);
+
+    bool ok = true;
+    for (auto bs : bsizes) {
+        std::vector<size_t> dims = {bs, bs, bs};
+        std::vector<float>  src(bs * bs * bs);
+
+        // Smooth field plus noise, with some repeated values to exercise ties
+        //
+        for (size_t k = 0; k < bs; k++) {
+            for (size_t j = 0; j < bs; j++) {
+                for (size_t i = 0; i < bs; i++) {
+                    float v = std::sin(i * 0.3) * std::cos(j * 0.2) + k * 0.01 + 0.1 * dist(gen);
+                    src[k * bs * bs + j * bs + i] = (i % 7 == 0) ? 0.5 : v;
+                }
+            }
+        }
+
+        VAPoR::Compressor cmp(dims, "bior4.4", "symh");
+
+        for (const auto &cratios : cratiosvec) {
+            std::vector<size_t> ncoeffs = GetNumCoeffs(cmp, cratios);
+            size_t              tlen = 0;
+            for (auto n : ncoeffs) tlen += n;
+
+            std::vector<float>                  dst0(tlen), dst1(tlen);
+            std::vector<VAPoR::SignificanceMap> sigmaps0(ncoeffs.size()), sigmaps1(ncoeffs.size());
+
+            cmp.FullSortOnOff() = true;
+            double tsort = Decompose(cmp, src, ncoeffs, dst0, sigmaps0, nloops);
+
+            cmp.FullSortOnOff() = false;
+            double tselect = Decompose(cmp, src, ncoeffs, dst1, sigmaps1, nloops);
+
+            bool equal = Equal(dst0, dst1, sigmaps0, sigmaps1);
+            ok = ok && equal;
+
+            std::printf("block %3ld^3, cratios", bs);
+            for (auto c : cratios) std::printf(" %ld", c);
+            std::printf(": sort %8.3f ms, select %8.3f ms, speedup %5.2fx %s\n", tsort / nloops, tselect / nloops, tsort / tselect, equal ? "" : "MISMATCH");
+        }
+    }
+
+    return (ok ? 0 : 1);
+}
@@ -0,0 +1,127 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+#include "vapor/MatWaveDwt.h"
+#include "vapor/CFuncs.h"
+
+// Compare the lifting scheme implementation of the bior2.2 and bior4.4
+// wavelet transforms in MatWaveDwt against the convolution based reference,
+// for 1D, 2D, and 3D signals with even and odd dimensions. Both the
+// coefficients and the reconstructed signals must agree to within a
+// tolerance. Also reports the time taken by each implementation.
+//
+
+template<class T> double MaxRelDiff(const std::vector<T> &a, const std::vector<T> &b)
+{
+    double maxdiff = 0.0;
+    double maxval = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        maxdiff = std::max(maxdiff, (double)std::fabs(a[i] - b[i]));
+        maxval = std::max(maxval, (double)std::fabs(a[i]));
+    }
+    return (maxval > 0.0 ? maxdiff / maxval : maxdiff);
+}
+
+// Forward and inverse transform of src. Returns the coefficients and
+// the reconstructed signal, and adds the elapsed time to fwdTime and
+// invTime.
+//
+template<class T>
+int Transform(VAPoR::MatWaveDwt &dwt, const std::vector<size_t> &dims, const std::vector<T> &src, std::vector<T> &C, std::vector<T> &recon, int nloops, double &fwdTime, double &invTime)
+{
+    size_t L[27];
+    size_t clen = 1;
+    for (auto d : dims) clen *= dwt.coefflength(d);
+    C.resize(clen);
+    recon.resize(src.size());
+
+    double t0 = Wasp::GetTime();
+    for (int i = 0; i < nloops; i++) {
+        int rc;
+        if (dims.size() == 1) {
+            rc = dwt.dwt(src.data(), dims[0], C.data(), L);
+        } else if (dims.size() == 2) {
+            rc = dwt.dwt2d(src.data(), dims[0], dims[1], C.data(), L);
+        } else {
+            rc = dwt.dwt3d(src.data(), dims[0], dims[1], dims[2], C.data(), L);
+        }
+        if (rc < 0) return (-1);
+    }
+    fwdTime += (Wasp::GetTime() - t0) * 1000.0;
+
+    t0 = Wasp::GetTime();
+    for (int i = 0; i < nloops; i++) {
+        int rc;
+        if (dims.size() == 1) {
+            rc = dwt.idwt(C.data(), L, recon.data());
+        } else if (dims.size() == 2) {
+            rc = dwt.idwt2d(C.data(), L, recon.data());
+        } else {
+            rc = dwt.idwt3d(C.data(), L, recon.data());
+        }
+        if (rc < 0) return (-1);
+    }
+    invTime += (Wasp::GetTime() - t0) * 1000.0;
+    return (0);
+}
+
+template<class T> bool Test(const std::string &wname, const std::vector<size_t> &dims, int nloops, double tolerance)
+{
+    size_t n = 1;
+    for (auto d : dims) n *= d;
+
+    std::mt19937                           gen(0);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<T>                         src(n);
+    for (size_t i = 0; i < n; i++) src[i] = std::sin(i * 0.01) + 0.1 * dist(gen);
+
+    VAPoR::MatWaveDwt dwt(wname);
+
+    std::vector<T> C0, C1, recon0, recon1;
+    double         fwd0 = 0.0, inv0 = 0.0, fwd1 = 0.0, inv1 = 0.0;
+
+    dwt.LiftingOnOff() = false;
+    if (Transform(dwt, dims, src, C0, recon0, nloops, fwd0, inv0) < 0) return (false);
+
+    dwt.LiftingOnOff() = true;
+    if (Transform(dwt, dims, src, C1, recon1, nloops, fwd1, inv1) < 0) return (false);
+
+    double cdiff = MaxRelDiff(C0, C1);
+    double rdiff = MaxRelDiff(src, recon1);
+    bool   ok = cdiff < tolerance && rdiff < tolerance;
+
+    std::printf("%s %-6s", wname.c_str(), sizeof(T) == sizeof(float) ? "float" : "double");
+    for (size_t i = 0; i < dims.size(); i++) std::printf("%s%ld", i ? "x" : " ", dims[i]);
+    std::printf(": coeff diff %.2e, recon diff %.2e, fwd speedup %5.2fx, inv speedup %5.2fx %s\n", cdiff, rdiff, fwd0 / fwd1, inv0 / inv1, ok ? "" : "FAILED");
+
+    return (ok);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program compares the lifting scheme and convolution based\n"
+                     "       wavelet transforms in MatWaveDwt.\n"
+                     "Usage: ./MatWaveLifting [NumLoops]\n";
+        return 1;
+    }
+    const int nloops = argc == 2 ? std::stoi(argv[1]) : 10;
+
+    const std::vector<std::string>         wnames = {"bior2.2", "bior4.4"};
+    const std::vector<std::vector<size_t>> dimsvec = {{4096}, {1023}, {256, 256}, {255, 129}, {64, 64, 64}, {63, 33, 17}};
+
+    bool ok = true;
+    for (const auto &wname : wnames) {
+        for (const auto &dims : dimsvec) {
+            ok = Test<double>(wname, dims, nloops, 1e-10) && ok;
+            ok = Test<float>(wname, dims, nloops, 1e-5) && ok;
+        }
+    }
+
+    return (ok ? 0 : 1);
+}
@@ -0,0 +1,187 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <netcdf.h>
+#include "vapor/WASP.h"
+
+using namespace VAPoR;
+
+// Check the per-block value ranges recorded by WASP when a variable is
+// written against ranges computed from the data. Compressed and
+// uncompressed (blocked only) variables are written with and without a
+// mask, each to its own file. The mask excludes a box of fill values that
+// must not appear in the ranges, and a region covering whole blocks, whose
+// ranges must be NaN. Values read back at the native level at every level
+// of detail must lie within the range of their block.
+//
+
+const std::vector<size_t> dims = {40, 50, 70};    // NetCDF order, slowest first
+const std::vector<size_t> bs = {16, 16, 16};
+const std::vector<size_t> cratios = {1, 4, 8};    // at most 8 for 16^3 blocks
+const float               fillValue = 1e30;
+
+float Field(size_t i, size_t j, size_t k) { return (100.0 * std::sin(0.05 * i) * std::cos(0.07 * j) + 0.5 * k); }
+
+bool Masked(size_t i, size_t j, size_t k) { return ((i >= 20 && i < 30 && j >= 10 && j < 25 && k >= 5 && k < 12) || (k < 16 && j < 16 && i < 16)); }
+
+void MakeData(bool masked, std::vector<float> &data, std::vector<unsigned char> &mask)
+{
+    data.resize(dims[0] * dims[1] * dims[2]);
+    mask.resize(data.size());
+    for (size_t k = 0; k < dims[0]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[2]; i++) {
+                size_t index = (k * dims[1] + j) * dims[2] + i;
+                mask[index] = !(masked && Masked(i, j, k));
+                data[index] = mask[index] ? Field(i, j, k) : fillValue;
+            }
+        }
+    }
+}
+
+// Range of the unmasked values of each block, in the order of
+// WASP::InqVarBlockRanges()
+//
+std::vector<double> BlockRanges(const std::vector<float> &data, const std::vector<unsigned char> &mask, std::vector<size_t> &bdims)
+{
+    bdims.clear();
+    for (int d = 0; d < 3; d++) bdims.push_back((dims[d] + bs[d] - 1) / bs[d]);
+
+    std::vector<double> ranges;
+    for (size_t bk = 0; bk < bdims[0]; bk++) {
+        for (size_t bj = 0; bj < bdims[1]; bj++) {
+            for (size_t bi = 0; bi < bdims[2]; bi++) {
+                double min = NAN, max = NAN;
+                for (size_t k = bk * bs[0]; k < std::min((bk + 1) * bs[0], dims[0]); k++) {
+                    for (size_t j = bj * bs[1]; j < std::min((bj + 1) * bs[1], dims[1]); j++) {
+                        for (size_t i = bi * bs[2]; i < std::min((bi + 1) * bs[2], dims[2]); i++) {
+                            size_t index = (k * dims[1] + j) * dims[2] + i;
+                            if (!mask[index]) continue;
+                            if (std::isnan(min) || data[index] < min) min = data[index];
+                            if (std::isnan(max) || data[index] > max) max = data[index];
+                        }
+                    }
+                }
+                ranges.push_back(min);
+                ranges.push_back(max);
+            }
+        }
+    }
+    return (ranges);
+}
+
+int WriteFile(const std::string &path, const std::string &wname, const std::vector<float> &data, const std::vector<unsigned char> &mask, bool masked)
+{
+    WASP   wasp;
+    size_t chsz = 0;
+    if (wasp.Create(path, NC_WRITE | NC_64BIT_OFFSET, 0, chsz, cratios.size()) < 0) return (-1);
+
+    std::vector<std::string> dimnames = {"z", "y", "x"};
+    for (int i = 0; i < 3; i++) {
+        if (wasp.DefDim(dimnames[i], dims[i]) < 0) return (-1);
+    }
+    int rc = masked ? wasp.DefVar("var", NC_FLOAT, dimnames, wname, bs, cratios, fillValue) : wasp.DefVar("var", NC_FLOAT, dimnames, wname, bs, cratios);
+    if (rc < 0) return (-1);
+    if (wasp.EndDef() < 0) return (-1);
+
+    if (wasp.OpenVarWrite("var", -1) < 0) return (-1);
+    if (wasp.PutVar(data.data(), masked ? mask.data() : NULL) < 0) return (-1);
+    if (wasp.CloseVar() < 0) return (-1);
+    return (wasp.Close());
+}
+
+bool Same(double a, double b) { return (std::isnan(a) ? std::isnan(b) : a == b); }
+
+bool Test(const std::string &path, const std::string &wname, bool masked)
+{
+    const std::string label = std::string(wname.empty() ? "uncompressed" : "compressed") + (masked ? ", masked" : "");
+
+    std::vector<float>         data;
+    std::vector<unsigned char> mask;
+    MakeData(masked, data, mask);
+    if (WriteFile(path, wname, data, mask, masked) < 0) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return (false);
+    }
+
+    std::vector<size_t> refBdims;
+    std::vector<double> ref = BlockRanges(data, mask, refBdims);
+
+    WASP wasp;
+    if (wasp.Open(path, NC_NOWRITE) < 0) {
+        std::cerr << "Failed to open " << path << std::endl;
+        return (false);
+    }
+
+    std::vector<size_t> bdims;
+    std::vector<double> ranges;
+    if (wasp.InqVarBlockRanges("var", bdims, ranges) < 0) {
+        std::cerr << "InqVarBlockRanges() failed" << std::endl;
+        return (false);
+    }
+
+    size_t nbad = 0;
+    if (bdims != refBdims || ranges.size() != ref.size()) {
+        nbad++;
+    } else {
+        for (size_t i = 0; i < ref.size(); i++) nbad += !Same(ranges[i], ref[i]);
+    }
+    std::printf("%-20s block ranges: %s\n", label.c_str(), nbad ? "MISMATCH" : "ok");
+    bool ok = nbad == 0;
+
+    // Values of unmasked voxels are bounded by the range of their block
+    //
+    int nlods = wname.empty() ? 1 : cratios.size();
+    for (int lod = 0; lod < nlods && ok; lod++) {
+        std::vector<float> values(data.size());
+        if (wasp.OpenVarRead("var", -1, lod) < 0 || wasp.GetVar(values.data()) < 0) {
+            std::cerr << "Failed to read var" << std::endl;
+            return (false);
+        }
+        wasp.CloseVar();
+
+        size_t nout = 0;
+        for (size_t k = 0; k < dims[0]; k++) {
+            for (size_t j = 0; j < dims[1]; j++) {
+                for (size_t i = 0; i < dims[2]; i++) {
+                    size_t index = (k * dims[1] + j) * dims[2] + i;
+                    if (!mask[index]) continue;
+
+                    size_t b = ((k / bs[0]) * bdims[1] + j / bs[1]) * bdims[2] + i / bs[2];
+                    nout += values[index] < ranges[2 * b] || values[index] > ranges[2 * b + 1];
+                }
+            }
+        }
+        std::printf("%-20s lod %d values in range: %s\n", label.c_str(), lod, nout ? "NO" : "ok");
+        ok = ok && nout == 0;
+    }
+    wasp.Close();
+
+    for (auto &f : WASP::GetPaths(path, cratios.size())) (void)remove(f.c_str());
+    return (ok);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program checks the block ranges recorded by WASP, writing\n"
+                     "       test files to Path (default wasp_block_ranges.nc), which are\n"
+                     "       removed afterwards.\n"
+                     "Usage: ./WASPBlockRanges [Path]\n";
+        return 1;
+    }
+    const std::string path = argc == 2 ? argv[1] : "wasp_block_ranges.nc";
+
+    bool ok = true;
+    for (std::string wname : {"bior4.4", ""}) {
+        for (bool masked : {false, true}) ok = Test(path, wname, masked) && ok;
+    }
+
+    std::cout << (ok ? "Passed" : "FAILED") << std::endl;
+    return (ok ? 0 : 1);
+}
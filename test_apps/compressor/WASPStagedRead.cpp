@@ -0,0 +1,133 @@
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <netcdf.h>
+#include "vapor/WASP.h"
+
+using namespace VAPoR;
+
+// Compare staged reads of compressed WASP variables, which fetch encoded
+// blocks in batches before reconstructing them, against reading each block
+// individually (WASP::SetStagedReads(false)). A variable of each external
+// type handled by staged reads is written, each to its own file as the
+// encoded dimensions depend on the type, then read back both ways at
+// every refinement level and level of detail, over the whole domain and
+// over regions that start and end inside blocks. The results must be
+// identical.
+//
+
+const std::vector<size_t> dims = {70, 90, 150};    // NetCDF order, slowest first
+const std::vector<size_t> bs = {32, 32, 32};
+const std::vector<size_t> cratios = {1, 10, 50};    // at most 64 for 32^3 blocks
+
+double Field(size_t i, size_t j, size_t k) { return (100.0 * std::sin(0.05 * i) * std::cos(0.07 * j) + 0.5 * k); }
+
+int WriteFile(const std::string &path, const std::string &name, int xtype)
+{
+    // 64-bit integers need the CDF-5 format
+    //
+    WASP   wasp;
+    size_t chsz = 0;
+    int    format = xtype == NC_INT64 ? NC_64BIT_DATA : NC_64BIT_OFFSET;
+    if (wasp.Create(path, NC_WRITE | format, 0, chsz, cratios.size()) < 0) return (-1);
+
+    std::vector<std::string> dimnames = {"z", "y", "x"};
+    for (int i = 0; i < 3; i++) {
+        if (wasp.DefDim(dimnames[i], dims[i]) < 0) return (-1);
+    }
+    if (wasp.DefVar(name, xtype, dimnames, "bior4.4", bs, cratios) < 0) return (-1);
+    if (wasp.EndDef() < 0) return (-1);
+
+    std::vector<float> data(dims[0] * dims[1] * dims[2]);
+    for (size_t k = 0; k < dims[0]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[2]; i++) data[(k * dims[1] + j) * dims[2] + i] = Field(i, j, k);
+        }
+    }
+    if (wasp.OpenVarWrite(name, -1) < 0) return (-1);
+    if (wasp.PutVar(data.data()) < 0) return (-1);
+    if (wasp.CloseVar() < 0) return (-1);
+    return (wasp.Close());
+}
+
+int Read(WASP &wasp, bool staged, const std::string &name, int level, int lod, const std::vector<size_t> &start, const std::vector<size_t> &count, std::vector<float> &data)
+{
+    wasp.SetStagedReads(staged);
+    if (wasp.OpenVarRead(name, level, lod) < 0) return (-1);
+    data.assign(count[0] * count[1] * count[2], 0.f);
+    int rc = wasp.GetVara(start, count, data.data());
+    wasp.CloseVar();
+    return (rc);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program compares staged and per-block reads of compressed WASP\n"
+                     "       variables, writing test files to Path (default wasp_staged_read.nc),\n"
+                     "       which are removed afterwards.\n"
+                     "Usage: ./WASPStagedRead [Path]\n";
+        return 1;
+    }
+    const std::string path = argc == 2 ? argv[1] : "wasp_staged_read.nc";
+
+    const std::vector<std::pair<std::string, int>> vars = {{"float", NC_FLOAT}, {"double", NC_DOUBLE}, {"int", NC_INT}, {"int64", NC_INT64}, {"short", NC_SHORT}};
+
+    bool ok = true;
+    for (auto &v : vars) {
+        if (WriteFile(path, v.first, v.second) < 0) {
+            std::cerr << "Failed to write " << path << std::endl;
+            return 1;
+        }
+
+        WASP wasp(4);
+        if (wasp.Open(path, NC_NOWRITE) < 0) {
+            std::cerr << "Failed to open " << path << std::endl;
+            return 1;
+        }
+
+        int nlevels = wasp.InqVarNumRefLevels(v.first);
+        for (int level = 0; level < nlevels; level++) {
+            std::vector<size_t> ldims, lbs;
+            wasp.InqVarDimlens(v.first, level, ldims, lbs);
+
+            // The whole variable, a region starting and ending inside
+            // blocks, and a few voxels
+            //
+            std::vector<std::pair<std::vector<size_t>, std::vector<size_t>>> rois = {{{0, 0, 0}, ldims}};
+            std::vector<size_t>                                              start(3), count(3);
+            for (int i = 0; i < 3; i++) {
+                start[i] = ldims[i] / 5;
+                count[i] = std::max((size_t)1, ldims[i] - start[i] - ldims[i] / 7);
+            }
+            rois.push_back({start, count});
+            for (int i = 0; i < 3; i++) count[i] = std::min((size_t)3, ldims[i] - start[i]);
+            rois.push_back({start, count});
+
+            for (int lod = 0; lod < (int)cratios.size(); lod++) {
+                size_t nbad = 0;
+                for (auto &roi : rois) {
+                    std::vector<float> staged, perBlock;
+                    if (Read(wasp, true, v.first, level, lod, roi.first, roi.second, staged) < 0 || Read(wasp, false, v.first, level, lod, roi.first, roi.second, perBlock) < 0) {
+                        std::cerr << "Failed to read " << v.first << std::endl;
+                        return 1;
+                    }
+                    for (size_t i = 0; i < staged.size(); i++) nbad += staged[i] != perBlock[i];
+                }
+                std::printf("%-7s level %d lod %d: %s\n", v.first.c_str(), level, lod, nbad ? "MISMATCH" : "ok");
+                ok = ok && nbad == 0;
+            }
+        }
+        wasp.Close();
+
+        for (auto &f : WASP::GetPaths(path, cratios.size())) (void)remove(f.c_str());
+    }
+
+    std::cout << (ok ? "Passed" : "FAILED") << std::endl;
+    return (ok ? 0 : 1);
+}
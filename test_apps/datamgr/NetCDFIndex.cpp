@@ -0,0 +1,139 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <netcdf.h>
+
+#include "vapor/CFuncs.h"
+#include "vapor/NetCDFCollection.h"
+#include "vapor/FileUtils.h"
+
+using namespace VAPoR;
+using namespace Wasp;
+
+// Benchmark for the netCDF metadata index. A synthetic collection of WRF-like
+// files, each with one time step, a time coordinate variable, and a handful
+// of 3D variables with attributes, is written to a directory. The collection
+// is then opened with NetCDFCollection::Initialize() cold (no index, so every
+// file header and time coordinate is read) and warm (metadata come from the
+// index, which the cold open wrote to the same directory).
+//
+
+#define CHECK(rc)                                                       \
+    if ((rc) != NC_NOERR) {                                             \
+        std::cerr << "netCDF error : " << nc_strerror(rc) << std::endl; \
+        return (-1);                                                    \
+    }
+
+int WriteFile(const std::string &path, size_t ts, int nvars)
+{
+    int ncid;
+    CHECK(nc_create(path.c_str(), NC_CLOBBER, &ncid));
+
+    int dimids[4];
+    CHECK(nc_def_dim(ncid, "Time", NC_UNLIMITED, &dimids[0]));
+    CHECK(nc_def_dim(ncid, "z", 4, &dimids[1]));
+    CHECK(nc_def_dim(ncid, "y", 8, &dimids[2]));
+    CHECK(nc_def_dim(ncid, "x", 8, &dimids[3]));
+
+    const char *title = "Synthetic collection";
+    CHECK(nc_put_att_text(ncid, NC_GLOBAL, "title", strlen(title), title));
+
+    int timeid;
+    CHECK(nc_def_var(ncid, "Time", NC_DOUBLE, 1, dimids, &timeid));
+    CHECK(nc_put_att_text(ncid, timeid, "units", 7, "seconds"));
+
+    std::vector<int> varids(nvars);
+    for (int i = 0; i < nvars; i++) {
+        std::string name = "var" + std::to_string(i);
+        CHECK(nc_def_var(ncid, name.c_str(), NC_FLOAT, 4, dimids, &varids[i]));
+        CHECK(nc_put_att_text(ncid, varids[i], "units", 1, "K"));
+        float mv = 1e37;
+        CHECK(nc_put_att_float(ncid, varids[i], "_FillValue", NC_FLOAT, 1, &mv));
+    }
+    CHECK(nc_enddef(ncid));
+
+    size_t start[] = {0, 0, 0, 0};
+    size_t count[] = {1, 4, 8, 8};
+    double time = ts * 3600.0;
+    CHECK(nc_put_vara_double(ncid, timeid, start, count, &time));
+
+    std::vector<float> data(4 * 8 * 8, (float)ts);
+    for (int i = 0; i < nvars; i++) { CHECK(nc_put_vara_float(ncid, varids[i], start, count, data.data())); }
+
+    CHECK(nc_close(ncid));
+    return (0);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2 || argc > 4) {
+        std::cout << "Help:  This program writes NumFiles (default 10000) small netCDF files, each\n"
+                     "       with NumVars (default 8) variables, to Directory and opens them as a\n"
+                     "       NetCDFCollection without (cold) and with (warm) a metadata index.\n"
+                     "Usage: ./NetCDFIndex Directory [NumFiles] [NumVars]\n";
+        return 1;
+    }
+    const std::string dir = argv[1];
+    const size_t      nfiles = argc > 2 ? std::stol(argv[2]) : 10000;
+    const int         nvars = argc > 3 ? std::stoi(argv[3]) : 8;
+
+    if (!FileUtils::IsDirectory(dir) && FileUtils::MakeDir(dir) != 0) {
+        std::cerr << "Failed to create directory " << dir << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files;
+    for (size_t i = 0; i < nfiles; i++) {
+        char name[64];
+        snprintf(name, sizeof(name), "synthetic_%06zu.nc", i);
+        files.push_back(FileUtils::JoinPaths({dir, name}));
+        if (!FileUtils::Exists(files.back()) && WriteFile(files.back(), i, nvars) < 0) return 1;
+    }
+
+    // The index is kept next to the files written here, never at a location
+    // given by VAPOR_NETCDF_INDEX, as it is removed before the cold open
+    //
+    const std::string index = FileUtils::JoinPaths({dir, "synthetic.vapor_netcdf_index"});
+    std::printf("Opening %zu files with %d variables, index %s\n", nfiles, nvars, index.c_str());
+
+    const std::vector<std::string> timeNames = {"Time"};
+
+    // Each open uses a new collection so that nothing is cached in memory
+    //
+    auto open = [&](size_t &nvarsFound, size_t &nts) {
+        NetCDFCollection ncdfc;
+        ncdfc.SetMetaIndexPath(index);
+        if (ncdfc.Initialize(files, timeNames, timeNames) < 0) {
+            std::cerr << "Failed to initialize collection" << std::endl;
+            exit(1);
+        }
+        nvarsFound = ncdfc.GetVariableNames(3, true).size();
+        nts = ncdfc.GetTimes().size();
+    };
+
+    (void)remove(index.c_str());
+
+    size_t coldVars, coldTS, warmVars, warmTS;
+
+    double t0 = Wasp::GetTime();
+    open(coldVars, coldTS);
+    double cold = (Wasp::GetTime() - t0) * 1000.0;
+
+    t0 = Wasp::GetTime();
+    open(warmVars, warmTS);
+    double warm = (Wasp::GetTime() - t0) * 1000.0;
+
+    std::printf("cold %10.1f ms (%zu variables, %zu time steps)\n", cold, coldVars, coldTS);
+    std::printf("warm %10.1f ms (%zu variables, %zu time steps)\n", warm, warmVars, warmTS);
+    std::printf("speedup %5.1fx\n", cold / warm);
+
+    bool ok = coldVars == warmVars && coldTS == warmTS && coldTS == nfiles;
+    if (!ok) std::cerr << "Cold and warm opens differ" << std::endl;
+
+    (void)remove(index.c_str());
+
+    return (ok ? 0 : 1);
+}
@@ -0,0 +1,285 @@
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vapor/CFuncs.h>
+#include <vapor/FileUtils.h>
+#include <vapor/PyramidCache.h>
+#include <vapor/PythonDataMgr.h>
+
+using namespace VAPoR;
+using namespace Wasp;
+
+// Tests the on-disk pyramid cache. Levels built by PyramidCache::Build()
+// are compared with a trilinear downsampling of the native data, and read
+// back whole and in regions that cross, start and end on tile edges. Then
+// a RAM backed data manager with the -pyramid_cache option is checked to
+// map refinement levels to pyramid levels, and to read the same values
+// from the cache as it computes without it.
+//
+
+double Field(double x, double y, double z) { return (std::sin(0.05 * x) * std::cos(0.07 * y) + 0.02 * z); }
+
+// Same sample positions as PyramidCache and DataMgr's downsample()
+//
+std::vector<double> Weights(size_t nIn, size_t nOut)
+{
+    std::vector<double> w(nOut);
+    float               deltax = (float)nIn / (float)nOut;
+    float               shift = ((nIn - 1) - (deltax * (nOut - 1))) / 2.0;
+    for (size_t i = 0; i < nOut; i++) w[i] = (i * deltax) + shift;
+    return (w);
+}
+
+std::vector<float> Downsample(const std::vector<float> &in, const DimsType &dims, const DimsType &outDims)
+{
+    std::vector<double> w[3];
+    for (int d = 0; d < 3; d++) w[d] = Weights(dims[d], outDims[d]);
+
+    std::vector<float> out(outDims[0] * outDims[1] * outDims[2]);
+    for (size_t k = 0; k < outDims[2]; k++) {
+        for (size_t j = 0; j < outDims[1]; j++) {
+            for (size_t i = 0; i < outDims[0]; i++) {
+                size_t idx[3] = {i, j, k};
+                size_t i0[3], i1[3];
+                double f[3];
+                for (int d = 0; d < 3; d++) {
+                    i0[d] = w[d][idx[d]];
+                    i1[d] = std::min(i0[d] + 1, dims[d] - 1);
+                    f[d] = w[d][idx[d]] - i0[d];
+                }
+
+                double v = 0.0;
+                for (int c = 0; c < 8; c++) {
+                    size_t x = c & 1 ? i1[0] : i0[0];
+                    size_t y = c & 2 ? i1[1] : i0[1];
+                    size_t z = c & 4 ? i1[2] : i0[2];
+                    double wgt = (c & 1 ? f[0] : 1.0 - f[0]) * (c & 2 ? f[1] : 1.0 - f[1]) * (c & 4 ? f[2] : 1.0 - f[2]);
+                    v += wgt * in[(z * dims[1] + y) * dims[0] + x];
+                }
+                out[(k * outDims[1] + j) * outDims[0] + i] = v;
+            }
+        }
+    }
+    return (out);
+}
+
+std::vector<float> MakeData(const DimsType &dims)
+{
+    std::vector<float> data(dims[0] * dims[1] * dims[2]);
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) data[(k * dims[1] + j) * dims[0] + i] = Field(i, j, k);
+        }
+    }
+    return (data);
+}
+
+void RemoveCache(const std::string &dir)
+{
+    if (!FileUtils::IsDirectory(dir)) return;
+    for (auto &f : FileUtils::ListFiles(dir)) (void)remove(FileUtils::JoinPaths({dir, f}).c_str());
+}
+
+size_t CountLevelFiles(const std::string &dir)
+{
+    size_t n = 0;
+    if (!FileUtils::IsDirectory(dir)) return (n);
+    for (auto &f : FileUtils::ListFiles(dir)) n += FileUtils::Extension(f) == "vpyr";
+    return (n);
+}
+
+const float tol = 1e-5;
+
+bool TestRoundTrip(const std::string &dir)
+{
+    const DimsType           dims = {600, 300, 40};
+    const std::vector<float> data = MakeData(dims);
+    const std::vector<std::string> files = {FileUtils::JoinPaths({dir, "data.nc"})};
+
+    PyramidCache cache;
+    cache.Initialize(dir, files);
+
+    int rc = cache.Build("var", 0, 0, dims, [&](size_t z, float *plane) {
+        std::copy(data.begin() + z * dims[0] * dims[1], data.begin() + (z + 1) * dims[0] * dims[1], plane);
+        return (0);
+    });
+    if (rc < 0) {
+        std::cerr << "Build failed" << std::endl;
+        return (false);
+    }
+
+    bool      ok = true;
+    const int nlevels = PyramidCache::NumLevels(dims);
+    for (int l = 1; l <= nlevels; l++) {
+        DimsType                 d = PyramidCache::DimsAtLevel(dims, l);
+        const std::vector<float> ref = Downsample(data, dims, d);
+
+        // The whole level, a voxel on each side of an interior tile
+        // corner, regions spanning tiles, and the last (partial) tile
+        //
+        std::vector<std::pair<DimsType, DimsType>> rois = {
+            {{0, 0, 0}, {d[0] - 1, d[1] - 1, d[2] - 1}},
+            {{127, 127, 0}, {128, 128, 0}},
+            {{100, 20, 1}, {d[0] - 1, d[1] - 3, d[2] - 2}},
+            {{128, 0, 0}, {d[0] - 1, 127, 0}},
+            {{d[0] - 1, d[1] - 1, d[2] - 1}, {d[0] - 1, d[1] - 1, d[2] - 1}},
+        };
+
+        size_t nbad = 0, nskipped = 0;
+        for (auto &roi : rois) {
+            DimsType min = roi.first, max = roi.second;
+            for (int i = 0; i < 3; i++) max[i] = std::min(max[i], d[i] - 1);
+            if (min[0] > max[0] || min[1] > max[1] || min[2] > max[2]) {
+                nskipped++;
+                continue;
+            }
+
+            size_t             rx = max[0] - min[0] + 1, ry = max[1] - min[1] + 1, rz = max[2] - min[2] + 1;
+            std::vector<float> region(rx * ry * rz);
+            if (!cache.ReadRegion("var", 0, 0, d, min, max, region.data())) {
+                std::cerr << "Level " << l << " not found" << std::endl;
+                return (false);
+            }
+
+            for (size_t k = 0; k < rz; k++) {
+                for (size_t j = 0; j < ry; j++) {
+                    for (size_t i = 0; i < rx; i++) {
+                        float expected = ref[((k + min[2]) * d[1] + j + min[1]) * d[0] + i + min[0]];
+                        if (std::fabs(region[(k * ry + j) * rx + i] - expected) > tol) nbad++;
+                    }
+                }
+            }
+        }
+        std::printf("Level %d (%zux%zux%zu): %zu regions %s\n", l, d[0], d[1], d[2], rois.size() - nskipped, nbad ? "MISMATCH" : "ok");
+        ok = ok && nbad == 0;
+    }
+
+    // Levels of another data set, or of a data set that changed, are
+    // ignored
+    //
+    PyramidCache    other;
+    const DimsType  d = PyramidCache::DimsAtLevel(dims, 1);
+    std::vector<float> region(1);
+    other.Initialize(dir, {FileUtils::JoinPaths({dir, "other.nc"})});
+    if (other.ReadRegion("var", 0, 0, d, {0, 0, 0}, {0, 0, 0}, region.data())) {
+        std::cerr << "Read levels of another data set" << std::endl;
+        ok = false;
+    }
+    return (ok);
+}
+
+// Refinement levels counted from the coarsest, and negative levels counted
+// from the native level, map to pyramid levels
+//
+bool TestDataMgr(const std::string &dir)
+{
+    const DimsType           dims = {256, 192, 160};
+    const std::vector<float> data = MakeData(dims);
+    const int                npyramid = PyramidCache::NumLevels(dims);
+
+    std::vector<std::vector<float>> computed(npyramid + 1);
+    for (int pass = 0; pass < 2; pass++) {
+        PythonDataMgr dm("ram", 512);
+        if (dm.Initialize({"ram"}, {"-pyramid_cache"}) < 0) {
+            std::cerr << "Failed to initialize data manager" << std::endl;
+            return (false);
+        }
+        dm.AddRegularData("var", data.data(), {(int)dims[0], (int)dims[1], (int)dims[2]});
+
+        int nlevels = dm.GetNumRefLevels("var");
+        if (nlevels != npyramid + 1) {
+            std::cerr << "GetNumRefLevels() returned " << nlevels << ", expected " << npyramid + 1 << std::endl;
+            return (false);
+        }
+
+        bool ok = true;
+        for (int level = -nlevels - 2; level <= nlevels + 1; level++) {
+            int pyramid_level;
+            if (level >= nlevels)
+                pyramid_level = 0;
+            else if (level >= 0)
+                pyramid_level = nlevels - 1 - level;
+            else
+                pyramid_level = std::min(-1 - level, npyramid);
+
+            std::vector<size_t> dimsv;
+            DimsType            expected = PyramidCache::DimsAtLevel(dims, pyramid_level);
+            if (dm.GetDimLensAtLevel("var", level, dimsv, 0) < 0 || dimsv != std::vector<size_t>(expected.begin(), expected.end())) {
+                std::cerr << "Wrong dimensions at level " << level << std::endl;
+                ok = false;
+            }
+        }
+        if (!ok) return (false);
+
+        // Levels are computed by downsampling on the first pass, which
+        // queues the cache to be built, and read from the cache on the
+        // second
+        //
+        for (int l = 1; l <= npyramid; l++) {
+            std::unique_ptr<Grid> g(dm.GetVariable(0, "var", -1 - l, 0, false));
+            if (!g) {
+                std::cerr << "Failed to read level " << -1 - l << std::endl;
+                return (false);
+            }
+
+            DimsType            d = PyramidCache::DimsAtLevel(dims, l);
+            std::vector<float> &values = computed[l];
+            size_t              nbad = 0;
+            for (size_t k = 0; k < d[2]; k++) {
+                for (size_t j = 0; j < d[1]; j++) {
+                    for (size_t i = 0; i < d[0]; i++) {
+                        float v = g->GetValueAtIndex(DimsType{i, j, k});
+                        if (pass == 0)
+                            values.push_back(v);
+                        else if (std::fabs(v - values[(k * d[1] + j) * d[0] + i]) > tol)
+                            nbad++;
+                    }
+                }
+            }
+            if (pass == 1) std::printf("DataMgr level %d (%zux%zux%zu): cached %s\n", -1 - l, d[0], d[1], d[2], nbad ? "MISMATCH" : "ok");
+            if (nbad) return (false);
+        }
+
+        if (pass == 0) {
+            double t0 = Wasp::GetTime();
+            while (CountLevelFiles(dir) < npyramid && Wasp::GetTime() - t0 < 60.0) std::this_thread::yield();
+            if (CountLevelFiles(dir) < npyramid) {
+                std::cerr << "Pyramid cache was not built" << std::endl;
+                return (false);
+            }
+        }
+    }
+    return (true);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program tests the pyramid cache, storing levels in CacheDir\n"
+                     "       (default pyramid_cache_test), which is emptied afterwards.\n"
+                     "Usage: ./PyramidCache [CacheDir]\n";
+        return 1;
+    }
+    const std::string dir = argc == 2 ? argv[1] : "pyramid_cache_test";
+
+    RemoveCache(dir);
+    bool ok = TestRoundTrip(dir);
+    RemoveCache(dir);
+
+#ifdef WIN32
+    _putenv_s("VAPOR_PYRAMID_CACHE", dir.c_str());
+#else
+    setenv("VAPOR_PYRAMID_CACHE", dir.c_str(), 1);
+#endif
+    ok = TestDataMgr(dir) && ok;
+    RemoveCache(dir);
+
+    std::cout << (ok ? "Passed" : "FAILED") << std::endl;
+    return (ok ? 0 : 1);
+}
@@ -0,0 +1,101 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+
+#include "vapor/BlkMemMgr.h"
+#include "vapor/PythonDataMgr.h"
+#include "vapor/CFuncs.h"
+
+// Microbenchmark for the DataMgr region cache. A RAM backed data manager is
+// populated with many small variables so that every GetVariable() call after
+// the first pass is a cache hit, and the cost measured is dominated by the
+// region cache lookup itself.
+//
+int main(int argc, char *argv[])
+{
+    if (argc > 2) {
+        std::cout << "Help:  This program measures DataMgr region cache lookup, eviction and purge\n"
+                     "       times with NumRegions cached regions (default 10000).\n"
+                     "Usage: ./RegionCache [NumRegions]\n";
+        return 1;
+    }
+    const size_t nregions = argc == 2 ? std::stol(argv[1]) : 10000;
+
+    const std::vector<int> dims = {8, 8};
+    std::vector<float>     buf(dims[0] * dims[1], 1.0);
+
+    // Regions hold whole grid blocks, so that a region of a small variable
+    // is larger than the variable. Read one variable to find its size.
+    //
+    size_t regionSize = sizeof(float);
+    {
+        VAPoR::PythonDataMgr probe("ram", 4);
+        probe.Initialize({"ram"}, {});
+        probe.AddRegularData("var", buf.data(), dims);
+        VAPoR::Grid *g = probe.GetVariable(0, "var", -1, -1, false);
+        if (!g) {
+            std::cerr << "Failed to read var" << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < dims.size(); i++) regionSize *= g->GetDimensionInBlks()[i] * g->GetBlockSize()[i];
+        delete g;
+    }
+
+    // The data manager allocates regions in 1MB blocks, so that 10k regions
+    // would need 10GB. The memory pool is shared by all BlkMemMgr instances,
+    // so set it up here with one region per block, plus room for the
+    // coordinate variables, before the data manager does. It is allocated
+    // up front, as the pool grows on demand with the most recently
+    // requested block size, which the data manager sets to 1MB.
+    //
+    const size_t nblocks = nregions + 64;
+    VAPoR::BlkMemMgr::RequestMemSize(regionSize, nblocks);
+    VAPoR::BlkMemMgr pool;
+    pool.FreeMem(pool.Alloc(nblocks));
+
+    VAPoR::PythonDataMgr dm("ram", (regionSize * nblocks + 1048575) / 1048576);
+    if (dm.Initialize({"ram"}, {}) < 0) {
+        std::cerr << "Failed to initialize data manager" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> varnames;
+    for (size_t i = 0; i < nregions; i++) {
+        varnames.push_back("var" + std::to_string(i));
+        dm.AddRegularData(varnames.back(), buf.data(), dims);
+    }
+
+    auto timeit = [&](const char *label, const std::vector<std::string> &names) {
+        double t0 = Wasp::GetTime();
+        for (const auto &v : names) {
+            VAPoR::Grid *g = dm.GetVariable(0, v, -1, -1, false);
+            if (!g) {
+                std::cerr << "Failed to read " << v << std::endl;
+                exit(1);
+            }
+            delete g;
+        }
+        double us = (Wasp::GetTime() - t0) * 1000000.0;
+        std::cout << label << " (microseconds per GetVariable): " << us / names.size() << std::endl;
+    };
+
+    std::printf("Testing a region cache with %ld regions (%.1f MB)...\n", nregions, (double)(regionSize * nblocks) / 1048576);
+
+    timeit("Cold reads", varnames);
+    timeit("Sequential cache hits", varnames);
+
+    std::vector<std::string> shuffled = varnames;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(0));
+    timeit("Random cache hits", shuffled);
+
+    double t0 = Wasp::GetTime();
+    for (const auto &v : shuffled) dm.PurgeVariable(v);
+    double us = (Wasp::GetTime() - t0) * 1000000.0;
+    std::cout << "PurgeVariable (microseconds per variable): " << us / shuffled.size() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <random>
+#include <cmath>
+
+#include "vapor/PythonDataMgr.h"
+#include "vapor/FlowParams.h"
+#include "vapor/VaporField.h"
+#include "vapor/OpenMPSupport.h"
+#include "vapor/CFuncs.h"
+
+// Thread scaling benchmark for VaporField::GetVelocity(), the query every RK4
+// stage of Advection::AdvectSteps() and AdvectTillTime() performs. The field
+// is queried at random positions from 1 to 64 threads,
+//   1) without locking params, so every query builds a grid key and looks the
+//      grid up in the cache,
+//   2) as a steady field with locked params, and
+//   3) as an unsteady field with locked params and a locked time range, so
+//      grids come from the grid table.
+//
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        std::cout << "Help:  This program measures VaporField::GetVelocity() throughput with 1 to 64\n"
+                     "       threads, on a (Dim x Dim x Dim) velocity field (default 64), using\n"
+                     "       NumQueries queries (default 2000000).\n"
+                     "Usage: ./VaporFieldScaling [Dim] [NumQueries]\n";
+        return 1;
+    }
+    const int    dim = argc > 1 ? std::stoi(argv[1]) : 64;
+    const size_t nqueries = argc > 2 ? std::stol(argv[2]) : 2000000;
+
+    VAPoR::PythonDataMgr dm("ram", 1024);
+    if (dm.Initialize({"ram"}, {}) < 0) {
+        std::cerr << "Failed to initialize data manager" << std::endl;
+        return 1;
+    }
+
+    // A solid body rotation about the Z axis, with a constant upward component
+    //
+    std::vector<float> u(dim * dim * dim), v(dim * dim * dim), w(dim * dim * dim, 0.1);
+    for (int k = 0; k < dim; k++) {
+        for (int j = 0; j < dim; j++) {
+            for (int i = 0; i < dim; i++) {
+                u[k * dim * dim + j * dim + i] = -(j - dim / 2.0);
+                v[k * dim * dim + j * dim + i] = i - dim / 2.0;
+            }
+        }
+    }
+    dm.AddRegularData("u", u.data(), {dim, dim, dim});
+    dm.AddRegularData("v", v.data(), {dim, dim, dim});
+    dm.AddRegularData("w", w.data(), {dim, dim, dim});
+
+    VAPoR::ParamsBase::StateSave ssave;
+    VAPoR::FlowParams            params(&dm, &ssave);
+    params.SetFieldVariableNames({"u", "v", "w"});
+    params.Initialize();
+
+    flow::VaporField field(9);
+    field.AssignDataManager(&dm);
+    field.UpdateParams(&params);
+    field.VelocityNames = {{"u", "v", "w"}};
+
+    const double time = dm.GetTimeCoordinates().at(0);
+    glm::vec3    minxyz, maxxyz;
+    if (field.GetVelocityIntersection(0, minxyz, maxxyz) != 0) {
+        std::cerr << "Failed to read the velocity field" << std::endl;
+        return 1;
+    }
+
+    std::mt19937                          gen(0);
+    std::uniform_real_distribution<float> dist(0.0, 1.0);
+    std::vector<glm::vec3>                positions(nqueries);
+    for (auto &p : positions) p = minxyz + (maxxyz - minxyz) * glm::vec3(dist(gen), dist(gen), dist(gen));
+
+    // Returns millions of queries per second
+    //
+    auto timeit = [&](int nthreads) {
+        omp_set_num_threads(nthreads);
+        long   nfailed = 0;
+        double t0 = Wasp::GetTime();
+        #pragma omp parallel for reduction(+ : nfailed)
+        for (long i = 0; i < (long)positions.size(); i++) {
+            glm::vec3 vel;
+            if (field.GetVelocity(time, positions[i], vel) != 0) nfailed++;
+        }
+        double us = (Wasp::GetTime() - t0) * 1000000.0;
+        if (nfailed) std::cerr << nfailed << " queries failed" << std::endl;
+        return (positions.size() / us);
+    };
+
+    const std::vector<int> threads = {1, 2, 4, 8, 16, 32, 64};
+
+    std::printf("Testing a (%d, %d, %d) field with %ld queries...\n", dim, dim, dim, nqueries);
+    std::printf("threads   unlocked   steady   unsteady (Mqueries/s)\n");
+    for (auto nt : threads) {
+        field.IsSteady = true;
+        double unlocked = timeit(nt);
+
+        field.LockParams();
+        double steady = timeit(nt);
+        field.UnlockParams();
+
+        field.IsSteady = false;
+        field.LockParams();
+        if (field.LockTimeRange(time, time) != 0) {
+            std::cerr << "Failed to lock the time range" << std::endl;
+            return 1;
+        }
+        double unsteady = timeit(nt);
+        field.UnlockParams();
+
+        std::printf("%7d %10.2f %8.2f %10.2f\n", nt, unlocked, steady, unsteady);
+    }
+
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <memory>
+
+#include "vapor/CFuncs.h"
+#include "vapor/RegularGrid.h"
+#include "vapor/StretchedGrid.h"
+#include "vapor/LayeredGrid.h"
+#include "vapor/CurvilinearGrid.h"
+
+using namespace VAPoR;
+
+// Compare Grid::GetValues() against calling Grid::GetValue() for each point,
+// on regular, stretched, layered and curvilinear (terrain following) grids.
+// Points are sampled along short random trajectories, like the RK4 stages of
+// particles moving through a velocity field, plus some points outside of the
+// grid. Reports the time taken by both methods. Then checks that
+// Grid::ResampleRegular() gives the same values and missing mask as calling
+// Grid::GetValue() at each lattice point, on grids with a box of missing
+// values.
+//
+
+std::vector<std::unique_ptr<float[]>> Heap;
+
+std::vector<float *> AllocBlocks(const DimsType &bs, const DimsType &dims)
+{
+    size_t block_size = 1;
+    size_t nblocks = 1;
+    for (int i = 0; i < 3; i++) {
+        block_size *= bs[i];
+        nblocks *= ((dims[i] - 1) / bs[i]) + 1;
+    }
+
+    Heap.emplace_back(new float[nblocks * block_size]);
+    std::vector<float *> blks;
+    for (size_t i = 0; i < nblocks; i++) blks.push_back(Heap.back().get() + i * block_size);
+    return (blks);
+}
+
+const float missingValue = 1e30;
+
+// If missing is true, nodes in a box in the first octant of the grid are set
+// to the missing value
+//
+void FillGrid(Grid *g, bool missing)
+{
+    auto dims = g->GetDimensions();
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                bool inBox = i > dims[0] / 8 && i < dims[0] / 3 && j > dims[1] / 8 && j < dims[1] / 3 && k < dims[2] / 3;
+                g->SetValueIJK(i, j, k, missing && inBox ? missingValue : std::sin(0.2 * i) * std::cos(0.15 * j) + 0.05 * k);
+            }
+        }
+    }
+    g->SetMissingValue(missingValue);
+    g->SetHasMissingValues(missing);
+}
+
+// Non-uniform coordinates in [0, 1]
+//
+std::vector<double> Stretched(size_t n)
+{
+    std::vector<double> c(n);
+    for (size_t i = 0; i < n; i++) c[i] = std::pow(double(i) / (n - 1), 1.5);
+    return (c);
+}
+
+Grid *MakeGrid(const std::string &type, const DimsType &dims, bool missing = false)
+{
+    const DimsType bs = {32, 32, 32};
+    const DimsType dims2d = {dims[0], dims[1], 1};
+    const DimsType bs2d = {32, 32, 1};
+    Grid *         g = nullptr;
+
+    if (type == "regular") {
+        g = new RegularGrid(dims, bs, AllocBlocks(bs, dims), {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+    } else if (type == "stretched") {
+        g = new StretchedGrid(dims, bs, AllocBlocks(bs, dims), Stretched(dims[0]), Stretched(dims[1]), Stretched(dims[2]));
+    } else if (type == "layered") {
+        RegularGrid zrg(dims, bs, AllocBlocks(bs, dims), {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+        for (size_t k = 0; k < dims[2]; k++) {
+            for (size_t j = 0; j < dims[1]; j++) {
+                for (size_t i = 0; i < dims[0]; i++) zrg.SetValueIJK(i, j, k, double(k) / (dims[2] - 1) * (1.0 + 0.1 * std::sin(0.3 * i)));
+            }
+        }
+        g = new LayeredGrid(dims, bs, AllocBlocks(bs, dims), Stretched(dims[0]), Stretched(dims[1]), zrg);
+    } else if (type == "curvilinear") {
+        RegularGrid xrg(dims2d, bs2d, AllocBlocks(bs2d, dims2d), {0.0, 0.0, 0.0}, {1.0, 1.0, 0.0});
+        RegularGrid yrg(dims2d, bs2d, AllocBlocks(bs2d, dims2d), {0.0, 0.0, 0.0}, {1.0, 1.0, 0.0});
+        RegularGrid zrg(dims, bs, AllocBlocks(bs, dims), {0.0, 0.0, 0.0}, {1.0, 1.0, 1.0});
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                double x = double(i) / (dims[0] - 1);
+                double y = double(j) / (dims[1] - 1);
+                xrg.SetValueIJK(i, j, 0, x + 0.1 * y);
+                yrg.SetValueIJK(i, j, 0, y + 0.05 * std::sin(3.0 * x));
+                for (size_t k = 0; k < dims[2]; k++) zrg.SetValueIJK(i, j, k, double(k) / (dims[2] - 1) + 0.1 * x * y);
+            }
+        }
+        g = new CurvilinearGrid(dims, bs, AllocBlocks(bs, dims), xrg, yrg, zrg, nullptr);
+    }
+
+    FillGrid(g, missing);
+    g->SetInterpolationOrder(1);
+    return (g);
+}
+
+// Compares Grid::ResampleRegular() with Grid::GetValue() at the center of
+// each lattice cell. Returns the number of mismatched values and mask
+// entries
+//
+size_t TestResample(const Grid *g, const DimsType &dims, float tol, size_t &nmissing)
+{
+    const size_t               n = dims[0] * dims[1] * dims[2];
+    std::vector<float>         values(n);
+    std::vector<unsigned char> mask(n);
+    bool                       hasMissing = g->ResampleRegular(dims, values.data(), mask.data());
+
+    CoordType minu, maxu;
+    g->GetUserExtents(minu, maxu);
+    const float mv = g->GetMissingValue();
+
+    size_t nbad = 0;
+    nmissing = 0;
+    for (size_t k = 0; k < dims[2]; k++) {
+        for (size_t j = 0; j < dims[1]; j++) {
+            for (size_t i = 0; i < dims[0]; i++) {
+                size_t    idx = (k * dims[1] + j) * dims[0] + i;
+                DimsType  ijk = {i, j, k};
+                CoordType p;
+                for (int d = 0; d < 3; d++) p[d] = (ijk[d] + 0.5) / dims[d] * (maxu[d] - minu[d]) + minu[d];
+
+                float expected = g->GetValue(p);
+                bool  same = values[idx] == expected || (values[idx] != mv && expected != mv && std::fabs(values[idx] - expected) <= tol);
+                if (!same || mask[idx] != (values[idx] == mv ? 255 : 0)) nbad++;
+                if (expected == mv) nmissing++;
+            }
+        }
+    }
+    if (hasMissing != (nmissing > 0)) nbad++;
+    return (nbad);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        std::cout << "Help:  This program compares Grid::GetValues() against Grid::GetValue() on\n"
+                     "       (Dim x Dim x Dim) grids of each type (default 64), using NumPoints\n"
+                     "       points (default 200000).\n"
+                     "Usage: ./GridGetValues [Dim] [NumPoints]\n";
+        return 1;
+    }
+    const size_t dim = argc > 1 ? std::stol(argv[1]) : 64;
+    const size_t npts = argc > 2 ? std::stol(argv[2]) : 200000;
+
+    // Trajectories of 32 nearby points, starting anywhere in (and slightly
+    // beyond) the unit cube
+    //
+    std::mt19937                           gen(0);
+    std::uniform_real_distribution<double> start(-0.05, 1.05);
+    std::uniform_real_distribution<double> step(-0.004, 0.004);
+    std::vector<CoordType>                 pts(npts);
+    for (size_t i = 0; i < npts; i++) {
+        if (i % 32 == 0)
+            pts[i] = {start(gen), start(gen), start(gen)};
+        else
+            pts[i] = {pts[i - 1][0] + step(gen), pts[i - 1][1] + step(gen), pts[i - 1][2] + step(gen)};
+    }
+
+    bool ok = true;
+    for (auto type : {"regular", "stretched", "layered", "curvilinear"}) {
+        std::unique_ptr<Grid> g(MakeGrid(type, {dim, dim, dim}));
+
+        std::vector<float> single(npts), batch(npts);
+
+        double t0 = Wasp::GetTime();
+        for (size_t i = 0; i < npts; i++) single[i] = g->GetValue(pts[i]);
+        double tsingle = (Wasp::GetTime() - t0) * 1000.0;
+
+        t0 = Wasp::GetTime();
+        g->GetValues(pts.data(), npts, batch.data());
+        double tbatch = (Wasp::GetTime() - t0) * 1000.0;
+
+        // Points on the boundary between curvilinear cells may be found in a
+        // different cell, which only changes round off
+        //
+        const float tol = std::string(type) == "curvilinear" ? 1e-5 : 0.0;
+        size_t      nbad = 0;
+        for (size_t i = 0; i < npts; i++) {
+            bool same = single[i] == batch[i] || std::fabs(single[i] - batch[i]) <= tol;
+            if (!same) nbad++;
+        }
+        ok = ok && nbad == 0;
+
+        std::printf("%-12s GetValue %8.2f ms, GetValues %8.2f ms, speedup %5.2fx %s\n", type, tsingle, tbatch, tsingle / tbatch, nbad ? "MISMATCH" : "");
+    }
+
+    // Lattices finer and coarser than the grid along different axes, so
+    // that samples don't fall on grid nodes
+    //
+    const DimsType resampled = {dim * 3 / 2, dim - 5, dim / 2 + 3};
+    for (auto type : {"regular", "stretched", "layered", "curvilinear"}) {
+        std::unique_ptr<Grid> g(MakeGrid(type, {dim, dim, dim}, true));
+
+        const float tol = std::string(type) == "curvilinear" ? 1e-5 : 0.0;
+        size_t      nmissing;
+        size_t      nbad = TestResample(g.get(), resampled, tol, nmissing);
+        ok = ok && nbad == 0 && nmissing > 0;
+
+        std::printf("%-12s ResampleRegular %zux%zux%zu (%zu missing) %s\n", type, resampled[0], resampled[1], resampled[2], nmissing, nbad || !nmissing ? "MISMATCH" : "ok");
+    }
+
+    return (ok ? 0 : 1);
+}
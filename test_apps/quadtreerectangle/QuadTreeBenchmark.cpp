@@ -0,0 +1,152 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vapor/CFuncs.h>
+#include <vapor/QuadTreeRectangleP.h>
+
+using namespace VAPoR;
+
+// Benchmark for saving and reading QuadTreeRectangleP trees. A tree is
+// built for an N x N curvilinear mesh, with sinusoidally perturbed
+// vertices like those of a map projected grid, and written to a file. The
+// time to build the tree is compared with the time to read it back, and
+// every cell center is located in both trees, checking that they return
+// the same cells.
+//
+
+void Vertex(size_t i, size_t j, size_t n, float &x, float &y)
+{
+    float u = (float)i / (float)n;
+    float v = (float)j / (float)n;
+    x = u + 0.02f * std::sin(6.2832f * v);
+    y = v + 0.02f * std::sin(6.2832f * u);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        std::cout << "Help:  This program builds a quad tree for an N x N (default 2000)\n"
+                     "       cell curvilinear mesh, writes it to File (default\n"
+                     "       qtr_benchmark.vqtr) and times reading it back.\n"
+                     "Usage: ./QuadTreeBenchmark [N] [File]\n";
+        return 1;
+    }
+    const size_t      n = argc > 1 ? std::stol(argv[1]) : 2000;
+    const std::string path = argc > 2 ? argv[2] : "qtr_benchmark.vqtr";
+    const uint64_t    fingerprint = n;
+
+    std::vector<QuadTreeRectangle<float, pType>::rectangle_t> rectangles;
+    std::vector<pType>                                        payloads;
+    rectangles.reserve(n * n);
+    payloads.reserve(n * n);
+
+    float left = 0.0, top = 0.0, right = 0.0, bottom = 0.0;
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = 0; i < n; i++) {
+            float x[4], y[4];
+            Vertex(i, j, n, x[0], y[0]);
+            Vertex(i + 1, j, n, x[1], y[1]);
+            Vertex(i + 1, j + 1, n, x[2], y[2]);
+            Vertex(i, j + 1, n, x[3], y[3]);
+
+            QuadTreeRectangle<float, pType>::rectangle_t r(x[0], y[0], x[0], y[0]);
+            for (int k = 1; k < 4; k++) {
+                r._left = std::min(r._left, x[k]);
+                r._right = std::max(r._right, x[k]);
+                r._top = std::min(r._top, y[k]);
+                r._bottom = std::max(r._bottom, y[k]);
+            }
+            rectangles.push_back(r);
+            payloads.push_back(pType{(uint32_t)i, (uint32_t)j});
+
+            left = std::min(left, r._left);
+            right = std::max(right, r._right);
+            top = std::min(top, r._top);
+            bottom = std::max(bottom, r._bottom);
+        }
+    }
+
+    QuadTreeRectangleP *built = NULL;
+
+    double t0 = Wasp::GetTime();
+    built = new QuadTreeRectangleP(left, top, right, bottom, 12, n * n);
+    built->Insert(rectangles, payloads);
+    double buildTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    bool   ok = true;
+
+    t0 = Wasp::GetTime();
+    ok = built->Write(path, fingerprint);
+    double writeTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    if (!ok) {
+        std::cerr << "Failed to write " << path << std::endl;
+        delete built;
+        return 1;
+    }
+
+    std::shared_ptr<const QuadTreeRectangleP> read;
+
+    t0 = Wasp::GetTime();
+    read = QuadTreeRectangleP::Read(path, fingerprint);
+    double readTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    if (!read) {
+        std::cerr << "Failed to read " << path << std::endl;
+        delete built;
+        return 1;
+    }
+
+    ok = !QuadTreeRectangleP::Read(path, fingerprint + 1);
+    if (!ok) std::cerr << "Read a tree with the wrong fingerprint" << std::endl;
+
+    // Locate the center of every cell in both trees
+    //
+    std::vector<std::vector<DimsType>> found(n);
+    std::vector<DimsType>              p;
+
+    t0 = Wasp::GetTime();
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = 0; i < n; i++) {
+            const auto &r = rectangles[j * n + i];
+            built->GetPayloadContained((r._left + r._right) / 2, (r._top + r._bottom) / 2, p);
+            found[j].insert(found[j].end(), p.begin(), p.end());
+        }
+    }
+    double builtQueryTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    size_t wrong = 0;
+
+    t0 = Wasp::GetTime();
+    for (size_t j = 0; j < n; j++) {
+        std::vector<DimsType> all;
+        for (size_t i = 0; i < n; i++) {
+            const auto &r = rectangles[j * n + i];
+            read->GetPayloadContained((r._left + r._right) / 2, (r._top + r._bottom) / 2, p);
+            all.insert(all.end(), p.begin(), p.end());
+        }
+        if (all.size() != found[j].size() || !std::equal(all.begin(), all.end(), found[j].begin())) wrong++;
+    }
+    double readQueryTime = (Wasp::GetTime() - t0) * 1000.0;
+
+    if (wrong) {
+        std::cerr << wrong << " rows of cells located differently in the tree read" << std::endl;
+        ok = false;
+    }
+
+    delete built;
+    (void)remove(path.c_str());
+
+    std::printf("%zu x %zu cells\n", n, n);
+    std::printf("build      %10.1f ms\n", buildTime);
+    std::printf("write      %10.1f ms\n", writeTime);
+    std::printf("read       %10.1f ms (%.0fx faster than build)\n", readTime, readTime > 0.0 ? buildTime / readTime : 0.0);
+    std::printf("query      %10.1f ms built, %.1f ms read (%zu points)\n", builtQueryTime, readQueryTime, n * n);
+
+    return (ok ? 0 : 1);
+}
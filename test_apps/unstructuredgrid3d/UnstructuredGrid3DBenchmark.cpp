@@ -0,0 +1,209 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <vapor/CFuncs.h>
+#include <vapor/UnstructuredGrid3D.h>
+
+using namespace VAPoR;
+
+// Tests and benchmarks point location in UnstructuredGrid3D. The unit cube
+// is divided into N x N x N hexahedra, with interior nodes perturbed, and
+// meshed with hexahedra, tetrahedra (six per hexahedron) and wedges (two
+// per hexahedron). The nodes hold the linear field x + 2y + 3z, which
+// interpolation on every cell type reproduces exactly. Points are sampled
+// along short random trajectories, plus some outside of the mesh, and
+// Grid::GetValue() is compared with Grid::GetValues().
+//
+
+const int tetsOnHex[6][4] = {{0, 1, 2, 6}, {0, 2, 3, 6}, {0, 3, 7, 6}, {0, 7, 4, 6}, {0, 4, 5, 6}, {0, 5, 1, 6}};
+const int wedgesOnHex[2][6] = {{0, 1, 2, 4, 5, 6}, {0, 2, 3, 4, 6, 7}};
+
+double Field(double x, double y, double z) { return (x + 2.0 * y + 3.0 * z); }
+
+struct Mesh {
+    std::vector<float> x, y, z, data;
+    std::vector<int>   vertexOnFace;
+    std::vector<int>   faceOnVertex;
+    size_t             maxVertexPerFace;
+    size_t             maxFacePerVertex;
+    size_t             ncells;
+};
+
+void MakeNodes(size_t n, Mesh &m)
+{
+    size_t nn = n + 1;
+    for (size_t k = 0; k < nn; k++) {
+        for (size_t j = 0; j < nn; j++) {
+            for (size_t i = 0; i < nn; i++) {
+                double x = double(i) / n;
+                double y = double(j) / n;
+                double z = double(k) / n;
+
+                // Boundary nodes stay on the faces of the cube
+                //
+                double d = 0.2 / n;
+                if (i > 0 && i < n) x += d * std::sin(7.0 * y + 3.0 * z);
+                if (j > 0 && j < n) y += d * std::sin(5.0 * z + 2.0 * x);
+                if (k > 0 && k < n) z += d * std::sin(4.0 * x + 6.0 * y);
+
+                m.x.push_back(x);
+                m.y.push_back(y);
+                m.z.push_back(z);
+                m.data.push_back(Field(x, y, z));
+            }
+        }
+    }
+}
+
+void MakeCells(size_t n, const std::string &type, Mesh &m)
+{
+    size_t nn = n + 1;
+    m.maxVertexPerFace = type == "hexahedra" ? 8 : (type == "tetrahedra" ? 4 : 6);
+    m.vertexOnFace.clear();
+
+    for (size_t k = 0; k < n; k++) {
+        for (size_t j = 0; j < n; j++) {
+            for (size_t i = 0; i < n; i++) {
+                int hex[8];
+                for (int c = 0; c < 8; c++) {
+                    size_t ii = i + ((c == 1 || c == 2 || c == 5 || c == 6) ? 1 : 0);
+                    size_t jj = j + ((c == 2 || c == 3 || c == 6 || c == 7) ? 1 : 0);
+                    size_t kk = k + (c >= 4 ? 1 : 0);
+                    hex[c] = (kk * nn + jj) * nn + ii;
+                }
+
+                if (type == "hexahedra") {
+                    m.vertexOnFace.insert(m.vertexOnFace.end(), hex, hex + 8);
+                } else if (type == "tetrahedra") {
+                    for (auto &t : tetsOnHex)
+                        for (int c : t) m.vertexOnFace.push_back(hex[c]);
+                } else {
+                    for (auto &w : wedgesOnHex)
+                        for (int c : w) m.vertexOnFace.push_back(hex[c]);
+                }
+            }
+        }
+    }
+    m.ncells = m.vertexOnFace.size() / m.maxVertexPerFace;
+
+    // Cells on each node, padded with the missing ID
+    //
+    std::vector<std::vector<int>> cellsOnNode(m.x.size());
+    for (size_t c = 0; c < m.ncells; c++) {
+        for (size_t v = 0; v < m.maxVertexPerFace; v++) cellsOnNode[m.vertexOnFace[c * m.maxVertexPerFace + v]].push_back(c);
+    }
+    m.maxFacePerVertex = 0;
+    for (auto &c : cellsOnNode) m.maxFacePerVertex = std::max(m.maxFacePerVertex, c.size());
+
+    m.faceOnVertex.assign(m.x.size() * m.maxFacePerVertex, -1);
+    for (size_t v = 0; v < cellsOnNode.size(); v++) std::copy(cellsOnNode[v].begin(), cellsOnNode[v].end(), m.faceOnVertex.begin() + v * m.maxFacePerVertex);
+}
+
+UnstructuredGrid3D *MakeGrid(Mesh &m, bool useFaceOnVertex)
+{
+    size_t                    nnodes = m.x.size();
+    const DimsType            vertexDims = {nnodes, 1, 1};
+    const DimsType            faceDims = {m.ncells, 1, 1};
+    const DimsType            edgeDims = {1, 1, 1};
+    const DimsType            bs = {nnodes, 1, 1};
+    const int *               faceOnVertex = useFaceOnVertex ? m.faceOnVertex.data() : nullptr;
+    const UnstructuredGrid::Location location = UnstructuredGrid::NODE;
+
+    UnstructuredGridCoordless xug(vertexDims, faceDims, edgeDims, bs, {m.x.data()}, 2, m.vertexOnFace.data(), faceOnVertex, nullptr, location, m.maxVertexPerFace, m.maxFacePerVertex, 0, 0);
+    UnstructuredGridCoordless yug(vertexDims, faceDims, edgeDims, bs, {m.y.data()}, 2, m.vertexOnFace.data(), faceOnVertex, nullptr, location, m.maxVertexPerFace, m.maxFacePerVertex, 0, 0);
+    UnstructuredGridCoordless zug(vertexDims, faceDims, edgeDims, bs, {m.z.data()}, 2, m.vertexOnFace.data(), faceOnVertex, nullptr, location, m.maxVertexPerFace, m.maxFacePerVertex, 0, 0);
+
+    UnstructuredGrid3D *g = new UnstructuredGrid3D(vertexDims, faceDims, edgeDims, bs, {m.data.data()}, m.vertexOnFace.data(), faceOnVertex, nullptr, location, m.maxVertexPerFace, m.maxFacePerVertex,
+                                                   0, 0, xug, yug, zug);
+    g->SetInterpolationOrder(1);
+    return (g);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 3) {
+        std::cout << "Help:  This program tests point location in (N x N x N) hexahedral,\n"
+                     "       tetrahedral and wedge meshes (default 32), using NumPoints\n"
+                     "       points (default 200000).\n"
+                     "Usage: ./UnstructuredGrid3DBenchmark [N] [NumPoints]\n";
+        return 1;
+    }
+    const size_t n = argc > 1 ? std::stol(argv[1]) : 32;
+    const size_t npts = argc > 2 ? std::stol(argv[2]) : 200000;
+
+    // Trajectories of 32 nearby points, starting anywhere in (and slightly
+    // beyond) the unit cube
+    //
+    std::mt19937                           gen(0);
+    std::uniform_real_distribution<double> start(-0.05, 1.05);
+    std::uniform_real_distribution<double> step(-0.004, 0.004);
+    std::vector<CoordType>                 pts(npts);
+    for (size_t i = 0; i < npts; i++) {
+        if (i % 32 == 0)
+            pts[i] = {start(gen), start(gen), start(gen)};
+        else
+            pts[i] = {pts[i - 1][0] + step(gen), pts[i - 1][1] + step(gen), pts[i - 1][2] + step(gen)};
+    }
+
+    Mesh m;
+    MakeNodes(n, m);
+
+    bool ok = true;
+    for (auto type : {"hexahedra", "tetrahedra", "wedges"}) {
+        MakeCells(n, type, m);
+
+        std::unique_ptr<UnstructuredGrid3D> g;
+
+        double t0 = Wasp::GetTime();
+        g.reset(MakeGrid(m, true));
+        double tindex = (Wasp::GetTime() - t0) * 1000.0;
+
+        std::unique_ptr<UnstructuredGrid3D> gNoHint(MakeGrid(m, false));
+        const float                         mv = g->GetMissingValue();
+
+        std::vector<float> single(npts), batch(npts), batchNoHint(npts);
+
+        t0 = Wasp::GetTime();
+        for (size_t i = 0; i < npts; i++) single[i] = g->GetValue(pts[i]);
+        double tsingle = (Wasp::GetTime() - t0) * 1000.0;
+
+        t0 = Wasp::GetTime();
+        g->GetValues(pts.data(), npts, batch.data());
+        double tbatch = (Wasp::GetTime() - t0) * 1000.0;
+
+        t0 = Wasp::GetTime();
+        gNoHint->GetValues(pts.data(), npts, batchNoHint.data());
+        double tbatchNoHint = (Wasp::GetTime() - t0) * 1000.0;
+
+        // Points inside the cube must reproduce the field, points outside
+        // must be missing. Points on the boundary between cells may be
+        // found in a different cell, which only changes round off.
+        //
+        const float tol = 1e-4;
+        size_t      nbad = 0;
+        for (size_t i = 0; i < npts; i++) {
+            const auto &p = pts[i];
+            bool        inside = p[0] >= 0.0 && p[0] <= 1.0 && p[1] >= 0.0 && p[1] <= 1.0 && p[2] >= 0.0 && p[2] <= 1.0;
+            float       expected = inside ? Field(p[0], p[1], p[2]) : mv;
+            for (float v : {single[i], batch[i], batchNoHint[i]}) {
+                bool same = inside ? std::fabs(v - expected) <= tol : v == mv;
+                if (!same) nbad++;
+            }
+        }
+        ok = ok && nbad == 0;
+
+        size_t binDims[3];
+        g->GetCellIndex()->GetBinDimensions(binDims);
+        std::printf("%-10s %8zu cells, index %zux%zux%zu bins %7.1f ms\n", type, m.ncells, binDims[0], binDims[1], binDims[2], tindex);
+        std::printf("           GetValue %8.2f ms, GetValues %8.2f ms (%8.2f ms without cells on nodes), speedup %5.2fx %s\n", tsingle, tbatch, tbatchNoHint, tsingle / tbatch,
+                    nbad ? "MISMATCH" : "");
+    }
+
+    return (ok ? 0 : 1);
+}
@@ -0,0 +1,269 @@
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <vapor/CFuncs.h>
+#include <vapor/utils.h>
+#include <vapor/UnstructuredGrid2D.h>
+#include <vapor/UnstructuredGridLayered.h>
+
+using namespace VAPoR;
+
+// Benchmark for point queries on layered unstructured grids, like those of
+// MPAS-A data. The horizontal mesh is made of N x N hexagons, with
+// perturbed vertices, three faces on each vertex and no face-face
+// connectivity, as VAPoR reads MPAS meshes. The layers follow terrain.
+// Points are sampled along short random trajectories, like the RK4 stages
+// of particles advected through a velocity field, plus some outside of the
+// mesh, and Grid::GetValue() is compared with Grid::GetValues() and with
+// a reference that interpolates the Z coordinate of every layer in the
+// column containing the point, then searches them with
+// Wasp::BinarySearchRange().
+//
+
+struct Mesh {
+    std::vector<float> x, y, z, data;
+    std::vector<int>   vertexOnFace;
+    std::vector<int>   faceOnVertex;
+    size_t             nfaces = 0;
+};
+
+const size_t maxVertexPerFace = 6;
+const size_t maxFacePerVertex = 3;
+
+double Terrain(double x, double y) { return (0.1 + 0.1 * std::sin(0.3 * x) * std::cos(0.2 * y)); }
+
+double Field(double x, double y, double z) { return (std::sin(0.4 * x) * std::cos(0.3 * y) + z); }
+
+void MakeMesh(size_t n, size_t nz, Mesh &m)
+{
+    // Hexagons of unit width, in rows offset by half a hexagon. Vertices
+    // shared by neighboring hexagons are merged
+    //
+    const double                         r = 1.0 / std::sqrt(3.0);
+    std::map<std::pair<long, long>, int> vertexIds;
+    std::vector<double>                  vx, vy;
+
+    for (size_t j = 0; j < n; j++) {
+        for (size_t i = 0; i < n; i++) {
+            double cx = i + 0.5 * (j % 2);
+            double cy = j * 1.5 * r;
+            for (int v = 0; v < 6; v++) {
+                double a = M_PI / 6.0 + v * M_PI / 3.0;
+                double x = cx + r * std::cos(a);
+                double y = cy + r * std::sin(a);
+
+                auto key = std::make_pair(std::lround(x * 1000.0), std::lround(y * 1000.0));
+                auto itr = vertexIds.find(key);
+                if (itr == vertexIds.end()) {
+                    itr = vertexIds.insert(std::make_pair(key, (int)vx.size())).first;
+                    vx.push_back(x);
+                    vy.push_back(y);
+                }
+                m.vertexOnFace.push_back(itr->second);
+            }
+        }
+    }
+    m.nfaces = n * n;
+
+    size_t nnodes = vx.size();
+    m.faceOnVertex.assign(nnodes * maxFacePerVertex, -1);
+    std::vector<size_t> count(nnodes, 0);
+    for (size_t f = 0; f < m.nfaces; f++) {
+        for (size_t v = 0; v < maxVertexPerFace; v++) {
+            int node = m.vertexOnFace[f * maxVertexPerFace + v];
+            m.faceOnVertex[node * maxFacePerVertex + count[node]++] = f;
+        }
+    }
+
+    // Perturb the vertices, keeping the hexagons convex
+    //
+    std::mt19937                           gen(1);
+    std::uniform_real_distribution<double> perturb(-0.05, 0.05);
+    for (size_t i = 0; i < nnodes; i++) {
+        m.x.push_back(vx[i] + perturb(gen));
+        m.y.push_back(vy[i] + perturb(gen));
+    }
+
+    // Z and data are dimensioned nz x nnodes
+    //
+    for (size_t k = 0; k < nz; k++) {
+        for (size_t i = 0; i < nnodes; i++) {
+            double t = Terrain(m.x[i], m.y[i]);
+            double z = t + (1.0 - t) * std::pow(double(k) / (nz - 1), 1.5);
+            m.z.push_back(z);
+            m.data.push_back(Field(m.x[i], m.y[i], z));
+        }
+    }
+}
+
+UnstructuredGridLayered *MakeGrid(Mesh &m, size_t nz)
+{
+    size_t                           nnodes = m.x.size();
+    const DimsType                   vertexDims = {nnodes, nz, 1};
+    const DimsType                   faceDims = {m.nfaces, nz - 1, 1};
+    const DimsType                   edgeDims = {1, 1, 1};
+    const DimsType                   bs = {nnodes, nz, 1};
+    const DimsType                   vertexDims1D = {nnodes, 1, 1};
+    const DimsType                   faceDims1D = {m.nfaces, 1, 1};
+    const DimsType                   bs1D = {nnodes, 1, 1};
+    const UnstructuredGrid::Location location = UnstructuredGrid::NODE;
+    const int *                      vertexOnFace = m.vertexOnFace.data();
+    const int *                      faceOnVertex = m.faceOnVertex.data();
+
+    UnstructuredGridCoordless xug(vertexDims1D, faceDims1D, edgeDims, bs1D, {m.x.data()}, 2, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0);
+    UnstructuredGridCoordless yug(vertexDims1D, faceDims1D, edgeDims, bs1D, {m.y.data()}, 2, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0);
+    UnstructuredGridCoordless zug(vertexDims, faceDims, edgeDims, bs, {m.z.data()}, 3, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0);
+
+    UnstructuredGridLayered *g = new UnstructuredGridLayered(vertexDims, faceDims, edgeDims, bs, {m.data.data()}, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex,
+                                                             0, 0, xug, yug, zug, nullptr);
+    g->SetInterpolationOrder(1);
+    return (g);
+}
+
+// The horizontal mesh and the Z coordinates, for the reference
+//
+struct Reference {
+    std::unique_ptr<UnstructuredGrid2D>        ug2d;
+    std::unique_ptr<UnstructuredGridCoordless> zug;
+};
+
+void MakeReference(Mesh &m, size_t nz, Reference &r)
+{
+    size_t                           nnodes = m.x.size();
+    const DimsType                   vertexDims = {nnodes, 1, 1};
+    const DimsType                   faceDims = {m.nfaces, 1, 1};
+    const DimsType                   edgeDims = {1, 1, 1};
+    const DimsType                   bs = {nnodes, 1, 1};
+    const UnstructuredGrid::Location location = UnstructuredGrid::NODE;
+    const int *                      vertexOnFace = m.vertexOnFace.data();
+    const int *                      faceOnVertex = m.faceOnVertex.data();
+
+    UnstructuredGridCoordless xug(vertexDims, faceDims, edgeDims, bs, {m.x.data()}, 2, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0);
+    UnstructuredGridCoordless yug(vertexDims, faceDims, edgeDims, bs, {m.y.data()}, 2, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0);
+
+    r.ug2d.reset(new UnstructuredGrid2D(vertexDims, faceDims, edgeDims, bs, {}, vertexOnFace, faceOnVertex, nullptr, location, maxVertexPerFace, maxFacePerVertex, 0, 0, xug, yug,
+                                        UnstructuredGridCoordless(), nullptr));
+    r.zug.reset(new UnstructuredGridCoordless({nnodes, nz, 1}, {m.nfaces, nz - 1, 1}, edgeDims, {nnodes, nz, 1}, {m.z.data()}, 3, vertexOnFace, faceOnVertex, nullptr, location,
+                                              maxVertexPerFace, maxFacePerVertex, 0, 0));
+}
+
+// Reference linear interpolation at p. Finds the face containing p, then
+// the layer, from the Z coordinates of the whole column
+//
+float ReferenceValue(const UnstructuredGridLayered &g, const Reference &r, const CoordType &p)
+{
+    const float                      mv = g.GetMissingValue();
+    const size_t                     nz = g.GetDimensions()[1];
+    DimsType                         cindices;
+    std::vector<std::vector<size_t>> nodes;
+    std::vector<double>              lambda;
+    if (!r.ug2d->GetIndicesCell(p, cindices, nodes, lambda)) return (mv);
+
+    std::vector<double> zcoords(nz);
+    for (size_t k = 0; k < nz; k++) {
+        float z = 0.0;
+        for (size_t i = 0; i < lambda.size(); i++) z += r.zug->AccessIJK(nodes[i][0], k) * lambda[i];
+        zcoords[k] = z;
+    }
+
+    size_t k;
+    if (!Wasp::BinarySearchRange(zcoords, p[2], k)) return (mv);
+
+    float z = p[2];
+    float zwgt0 = 1.0 - (z - zcoords[k]) / (zcoords[k + 1] - zcoords[k]);
+    float zwgt1 = 1.0 - zwgt0;
+
+    float v0 = 0.0, v1 = 0.0;
+    for (size_t i = 0; i < lambda.size(); i++) {
+        v0 += g.AccessIJK(nodes[i][0], k) * lambda[i];
+        v1 += g.AccessIJK(nodes[i][0], k + 1) * lambda[i];
+    }
+    if (zwgt1 == 0.0) return (v0);
+    return (v0 * zwgt0 + v1 * zwgt1);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 4) {
+        std::cout << "Help:  This program compares Grid::GetValues() and Grid::GetValue() against\n"
+                     "       a full column search on a layered grid of N x N hexagons (default 200) and NZ layers\n"
+                     "       (default 55), using NumPoints points (default 500000).\n"
+                     "Usage: ./UnstructuredGridLayeredBenchmark [N] [NZ] [NumPoints]\n";
+        return 1;
+    }
+    const size_t n = argc > 1 ? std::stol(argv[1]) : 200;
+    const size_t nz = argc > 2 ? std::stol(argv[2]) : 55;
+    const size_t npts = argc > 3 ? std::stol(argv[3]) : 500000;
+
+    Mesh m;
+    MakeMesh(n, nz, m);
+
+    std::unique_ptr<UnstructuredGridLayered> g;
+
+    double t0 = Wasp::GetTime();
+    g.reset(MakeGrid(m, nz));
+    double tbuild = (Wasp::GetTime() - t0) * 1000.0;
+
+    CoordType minu, maxu;
+    g->GetUserExtents(minu, maxu);
+
+    // Trajectories of 32 nearby points, starting anywhere in (and slightly
+    // beyond) the grid extents
+    //
+    std::mt19937                           gen(0);
+    std::uniform_real_distribution<double> start(-0.02, 1.02);
+    std::uniform_real_distribution<double> step(-0.5, 0.5);
+    std::vector<CoordType>                 pts(npts);
+    for (size_t i = 0; i < npts; i++) {
+        if (i % 32 == 0) {
+            for (int d = 0; d < 3; d++) pts[i][d] = minu[d] + start(gen) * (maxu[d] - minu[d]);
+        } else {
+            pts[i] = {pts[i - 1][0] + 0.2 * step(gen), pts[i - 1][1] + 0.2 * step(gen), pts[i - 1][2] + 0.005 * step(gen)};
+        }
+    }
+
+    std::vector<float> single(npts), batch(npts);
+
+    t0 = Wasp::GetTime();
+    for (size_t i = 0; i < npts; i++) single[i] = g->GetValue(pts[i]);
+    double tsingle = (Wasp::GetTime() - t0) * 1000.0;
+
+    t0 = Wasp::GetTime();
+    g->GetValues(pts.data(), npts, batch.data());
+    double tbatch = (Wasp::GetTime() - t0) * 1000.0;
+
+    Reference          r;
+    std::vector<float> reference(npts);
+    MakeReference(m, nz, r);
+
+    t0 = Wasp::GetTime();
+    for (size_t i = 0; i < npts; i++) reference[i] = ReferenceValue(*g, r, pts[i]);
+    double treference = (Wasp::GetTime() - t0) * 1000.0;
+
+    // Points on the edge between two faces may be found in a different
+    // face, which only changes round off
+    //
+    const float mv = g->GetMissingValue();
+    auto        same = [mv](float a, float b) { return (a == b || (a != mv && b != mv && std::fabs(a - b) <= 1e-5)); };
+
+    size_t nbad = 0, nbadReference = 0, nmissing = 0;
+    for (size_t i = 0; i < npts; i++) {
+        if (single[i] == mv) nmissing++;
+        if (!same(single[i], batch[i])) nbad++;
+        if (!same(single[i], reference[i])) nbadReference++;
+    }
+
+    std::printf("%zu faces, %zu nodes, %zu layers, grid built in %.1f ms\n", m.nfaces, m.x.size(), nz, tbuild);
+    std::printf("%zu points (%zu outside)\n", npts, nmissing);
+    std::printf("Full column %8.2f ms, GetValue %8.2f ms %s\n", treference, tsingle, nbadReference ? "MISMATCH" : "");
+    std::printf("GetValue %8.2f ms, GetValues %8.2f ms, speedup %5.2fx %s\n", tsingle, tbatch, tsingle / tbatch, nbad ? "MISMATCH" : "");
+
+    return (nbad || nbadReference ? 1 : 0);
+}